@@ -23,5 +23,7 @@
 #define RQ_HEADER_ONLY
 #include "RaptorQ/v1/caches.ipp"
 #include "RaptorQ/v1/RFC.hpp"
+#include "RaptorQ/v1/RFC_Planner.hpp"
+#include "RaptorQ/v1/RFC_Stream.hpp"
 #include "RaptorQ/v1/Thread_Pool.hpp"
 
@@ -23,6 +23,10 @@
 #include "RaptorQ/v1/common.hpp"
 #include "RaptorQ/v1/Decoder.hpp"
 #include "RaptorQ/v1/Interleaver.hpp"
+#include "RaptorQ/v1/util/contiguous.hpp"
+#include "RaptorQ/v1/util/div.hpp"
+#include <algorithm>
+#include <cstring>
 
 namespace RFC6330__v1 {
 namespace Impl {
@@ -36,7 +40,7 @@ public:
     De_Interleaver& operator= (const De_Interleaver&) = default;
     De_Interleaver (De_Interleaver&&) = default;
     De_Interleaver& operator= (De_Interleaver &&) = default;
-    De_Interleaver (const RaptorQ__v1::Impl::DenseMtx *symbols,
+    De_Interleaver (const RaptorQ__v1::Impl::Source_Symbols *symbols,
                                                     const Partition sub_blocks,
                                                     const uint16_t max_esi,
                                                     const uint8_t alignment)
@@ -45,18 +49,75 @@ public:
     {
         IS_FORWARD(Fwd_It, "RaptorQ__v1::Impl::De_Interleaver");
     }
+    // contiguous output: copy whole sub-symbols at a time.
+    template <typename F_It = Fwd_It, typename std::enable_if<
+            RaptorQ__v1::Impl::is_contiguous_le<F_It>::value, int>::type = 0>
+    size_t operator() (Fwd_It &start, const Fwd_It end, const size_t max_bytes,
+                            const uint8_t skip, const uint16_t from_esi = 0);
+    template <typename F_It = Fwd_It, typename std::enable_if<
+            !RaptorQ__v1::Impl::is_contiguous_le<F_It>::value, int>::type = 0>
     size_t operator() (Fwd_It &start, const Fwd_It end, const size_t max_bytes,
                             const uint8_t skip, const uint16_t from_esi = 0);
     std::vector<bool> symbols_to_bytes (const size_t block_bytes,
                                     const std::vector<bool> &real_syms) const;
 private:
-    const RaptorQ__v1::Impl::DenseMtx *_symbols;
+    const RaptorQ__v1::Impl::Source_Symbols *_symbols;
     const Partition _sub_blocks;
     const uint16_t _max_esi;
     const uint8_t _al;
 };
 
 template <typename Fwd_It>
+template <typename F_It, typename std::enable_if<
+                RaptorQ__v1::Impl::is_contiguous_le<F_It>::value, int>::type>
+size_t De_Interleaver<Fwd_It>::operator() (Fwd_It &start, const Fwd_It end,
+                                                    const size_t max_bytes,
+                                                    const uint8_t skip,
+                                                    const uint16_t from_esi)
+{
+    if (start == end)
+        return 0;
+    // return number of BYTES written
+    using T = typename std::iterator_traits<Fwd_It>::value_type;
+    assert (skip < sizeof(T) && "De_Interleaver: skip too big");
+    // "skip" bytes of the first element are kept as they are.
+    uint8_t *out = RaptorQ__v1::Impl::out_bytes (start) + skip;
+    const size_t max = std::min (max_bytes,
+                        static_cast<size_t> (end - start) * sizeof(T) - skip);
+    const size_t cols = static_cast<size_t> (_symbols->cols());
+    const uint16_t sub_blks = _sub_blocks.num (0) + _sub_blocks.num (1);
+    size_t written = 0;
+    uint16_t esi = from_esi;
+    uint16_t sub_blk = 0;
+    while (written < max && sub_blk < sub_blks) {
+        size_t sub_sym_size, byte;
+        if (sub_blk < _sub_blocks.num (0)) {
+            sub_sym_size = _sub_blocks.size (0) * _al;
+            byte = sub_sym_size * sub_blk;
+        } else {
+            sub_sym_size = _sub_blocks.size (1) * _al;
+            byte = _sub_blocks.tot (0) * _al +
+                                sub_sym_size * (sub_blk - _sub_blocks.num (0));
+        }
+        const size_t size = std::min (sub_sym_size, max - written);
+        std::memcpy (out + written, _symbols->data() + esi * cols + byte,
+                                                                        size);
+        written += size;
+        ++esi;
+        if (esi >= _max_esi) {
+            esi = 0;
+            ++sub_blk;
+        }
+    }
+    // a partially written element still counts as written.
+    start += static_cast<int64_t> (RaptorQ__v1::Impl::div_ceil<size_t> (
+                                                    skip + written, sizeof(T)));
+    return written;
+}
+
+template <typename Fwd_It>
+template <typename F_It, typename std::enable_if<
+                !RaptorQ__v1::Impl::is_contiguous_le<F_It>::value, int>::type>
 size_t De_Interleaver<Fwd_It>::operator() (Fwd_It &start, const Fwd_It end,
                                                     const size_t max_bytes,
                                                     const uint8_t skip,
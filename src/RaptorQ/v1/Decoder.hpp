@@ -25,10 +25,20 @@
 #include "RaptorQ/v1/Octet.hpp"
 #include "RaptorQ/v1/Parameters.hpp"
 #include "RaptorQ/v1/Precode_Matrix.hpp"
+#include "RaptorQ/v1/Progressive_Solver.hpp"
 #include "RaptorQ/v1/Shared_Computation/Decaying_LF.hpp"
 #include "RaptorQ/v1/Thread_Pool.hpp"
 #include "RaptorQ/v1/util/Bitmask.hpp"
+#include "RaptorQ/v1/util/contiguous.hpp"
+#include "RaptorQ/v1/util/div.hpp"
 #include "RaptorQ/v1/util/Graph.hpp"
+#include "RaptorQ/v1/util/Scratch_File.hpp"
+#include "RaptorQ/v1/util/Symbol_Store.hpp"
+#include <algorithm>
+#include <atomic>
+#include <chrono>
+#include <condition_variable>
+#include <cstring>
 #include <memory>
 #include <mutex>
 #include <random>
@@ -42,6 +52,9 @@ namespace RaptorQ__v1 {
 
 namespace Impl {
 
+// the source symbols of a decoder, in its own memory or in the caller's.
+using Source_Symbols = Eigen::Map<DenseMtx>;
+
 template <typename In_It>
 class RAPTORQ_LOCAL Raw_Decoder
 {
@@ -49,21 +62,37 @@ class RAPTORQ_LOCAL Raw_Decoder
     // But each time the list of source and repair symbols might
     // change.
     using Vect = Eigen::Matrix<Impl::Octet, 1, Eigen::Dynamic, Eigen::RowMajor>;
-    using T_in = typename std::iterator_traits<In_It>::value_type;
 public:
 
     bool end_of_input;
 
     Raw_Decoder (const Block_Size symbols, const size_t symbol_size)
+        :Raw_Decoder (symbols, symbol_size, nullptr)
+    {}
+    // decode in place: the source symbols are written directly in "output",
+    // which holds "symbols * symbol_size" octets and must outlive us.
+    // received symbols go straight to their offset, only the missing ones
+    // are reconstructed there. nullptr means "use our own memory".
+    Raw_Decoder (const Block_Size symbols, const size_t symbol_size,
+                                                                Octet *output)
         :keep_working (true), type (test_computation()),
-                    _symbols (static_cast<uint16_t> (symbols)), mask (_symbols)
+                    _symbols (static_cast<uint16_t> (symbols)), mask (_symbols),
+                    pending (_symbols), own_symbols (output == nullptr ?
+                                    DenseMtx (_symbols, symbol_size) :
+                                    DenseMtx()),
+                    source_symbols (output == nullptr ?
+                                                own_symbols.data() : output,
+                                    _symbols, static_cast<int64_t> (symbol_size)),
+                                            received_repair (symbol_size)
     {
         IS_INPUT(In_It, "RaptorQ__v1::Impl::Decoder");
         // symbol size is in octets, but we save it in "T" sizes.
         // so be aware that "symbol_size" != "_symbol_size" for now
-        source_symbols = DenseMtx (_symbols, symbol_size);
         concurrent = 0;
         can_retry = false;
+        deferred = false;
+        quiet_ms = 0;
+        last_arrival = 0;
         end_of_input = false;
     }
     Raw_Decoder (const Block_Size symbols, const size_t symbol_size,
@@ -85,10 +114,24 @@ public:
     Raw_Decoder (Raw_Decoder&&) = delete;
     Raw_Decoder& operator= (Raw_Decoder&&) = delete;
 
-    Error add_symbol (In_It &start, const In_It end, const uint32_t esi,
+    // any input iterator can be used, not only In_It:
+    // the API uses this for the (pointer, size) overloads.
+    template <typename It>
+    Error add_symbol (It &start, const It end, const uint32_t esi,
                                                                 bool padded);
+    // "count" symbols, one after the other in "data": symbol "idx" has
+    // id "esi[idx]". The lock is taken twice for the whole batch.
+    // "added[idx]" is true if that symbol was added.
+    // returns the number of symbols added.
+    size_t add_symbols (const uint8_t *data, const uint32_t *esi,
+                            const uint32_t count, std::vector<bool> &added);
     Decoder_Result decode (Work_State *thread_keep_working);
-    DenseMtx* get_symbols();
+    const Source_Symbols* get_symbols() const;
+    // bytes of the repair symbols received and not used yet
+    size_t repair_bytes();
+    // decoding in place: we have no copy of the source symbols.
+    bool in_place() const
+        { return own_symbols.size() == 0; }
     bool has_symbol (const uint16_t symbol) const;
 
     void stop();
@@ -104,20 +147,121 @@ public:
     bool add_concurrent (const uint16_t max_concurrent);
     uint16_t threads() const;
     void drop_concurrent();
+    // progressive mode: eliminate each symbol as soon as it arrives,
+    // so that decode() has (almost) nothing left to do.
+    void set_progressive (const bool enable);
+    // maximum number of repair symbols used in a decoding attempt,
+    // on top of the number of missing symbols. The others are kept
+    // and used only if the attempt fails.
+    void set_max_overhead (const uint16_t overhead);
+    // when to attempt a decoding. not used in progressive mode, where
+    // we can decode as soon as the solver is complete.
+    void set_decode_policy (const Decode_Policy &new_policy);
+    // milliseconds before a deferred attempt is allowed by the quiet
+    // period of the policy. -1 if there is nothing to wait for.
+    int64_t quiet_left() const;
+    static int64_t now_ms()     // steady clock
+    {
+        return std::chrono::duration_cast<std::chrono::milliseconds> (
+                std::chrono::steady_clock::now().time_since_epoch()).count();
+    }
+    // keep the source symbols and the next repair symbols in "file"
+    // instead of RAM. Not while decoding, nor when decoding in place.
+    // Copies in flight are drained first, new ones wait until it is done.
+    bool set_storage (const std::shared_ptr<Scratch_File> &file);
     // you know you will not receive additional data, and can not decode.
     // fill with zeros and return what you have
     // returns the bitmask of the SYMBOLS we had (true) or not (false)
     std::vector<bool> fill_with_zeros();
 
 private:
-    bool keep_working, can_retry;
+    bool keep_working;
+    // read without the lock by whoever wants to know if it should
+    // schedule a decoding.
+    std::atomic<bool> can_retry;
+    // enough symbols to try, but the policy asks for more.
+    // "end_of_input" or the quiet period make this decodable.
+    std::atomic<bool> deferred;
+    std::atomic<uint32_t> quiet_ms;
+    std::atomic<int64_t> last_arrival;  // steady clock, milliseconds
     const Save_Computation type;
     std::mutex lock;
     const uint16_t _symbols;
     uint16_t concurrent;    // currently running decoders retry
     Bitmask mask;
-    DenseMtx source_symbols;
-    std::vector<std::pair<uint32_t, Vect>> received_repair;
+    // symbols are copied without holding "lock": the destination is
+    // reserved, filled, and only then published in "mask".
+    // "pending" are the esi being copied. Whoever needs to change the
+    // symbols (save_missing, fill_with_zeros, clear_data, set_storage)
+    // first waits for the copies in flight, and new copies wait for it.
+    Bitmask pending;
+    uint32_t copies = 0;
+    uint16_t draining = 0;
+    std::condition_variable copies_done;
+    // empty when decoding in place or with a scratch file
+    DenseMtx own_symbols;
+    std::shared_ptr<Scratch_File> storage;
+    std::shared_ptr<Octet> stored_symbols;
+    bool written_back = false;
+    Source_Symbols source_symbols;
+    Symbol_Store received_repair;
+    // the source symbols are complete: send them to disk.
+    // call with the lock held
+    void write_back();
+    // bigger matrices only make the elimination slower.
+    // "overhead_bonus" grows after each failure that could not be resumed.
+    uint16_t max_overhead = 4;
+    uint16_t overhead_bonus = 0;
+    Decode_Policy policy {0, 0, 0};
+    // repair symbols we want on top of the missing ones before trying
+    uint16_t policy_overhead() const;
+    // call with the lock held. decide if the received symbols are worth
+    // an attempt. triggers are coalesced: however many symbols arrive
+    // while an attempt is running, only one more attempt follows.
+    void trigger();
+
+    // what is left of a failed decoding attempt.
+    // new symbols can be added to this instead of starting from scratch.
+    class RAPTORQ_LOCAL Partial_Solve {
+    public:
+        Partial_Solve (const Bitmask &used)
+            : mask (used) {}
+        std::unique_ptr<Precode_Matrix<Save_Computation::ON>> precode_on;
+        std::unique_ptr<Precode_Matrix<Save_Computation::OFF>> precode_off;
+        DenseMtx D;
+        Bitmask mask;   // symbols (source and repair) that are already in D
+    };
+    std::unique_ptr<Partial_Solve> partial;
+
+    // progressive mode. the solver has its own lock, since eliminating
+    // takes time and should not block the other producers' copies.
+    // lock order: "lock", then "progressive_lock".
+    bool use_progressive = false;
+    std::mutex progressive_lock;
+    std::unique_ptr<Progressive_Solver> progressive;
+    void init_progressive();
+    // copy up to "size" octets of a symbol. returns the octets copied.
+    template <typename It, typename std::enable_if<
+                                !is_contiguous<It>::value, int>::type = 0>
+    static size_t copy_symbol (It &start, const It end, Octet *out,
+                                                            const size_t size);
+    template <typename It, typename std::enable_if<
+                                is_contiguous<It>::value, int>::type = 0>
+    static size_t copy_symbol (It &start, const It end, Octet *out,
+                                                            const size_t size);
+    template <typename Row>
+    void progress (const uint32_t esi, const Row &row);
+
+    Decoder_Result decode_resume (std::unique_lock<std::mutex> &shared,
+                                        Work_State *thread_keep_working);
+    // call with the lock held
+    void wait_copies (std::unique_lock<std::mutex> &guard);
+    Decoder_Result save_missing (std::unique_lock<std::mutex> &guard,
+                                                    const DenseMtx &missing,
+                                                    const Bitmask &mask_safe);
+    // copy the received source symbols in "out", the others are zeroed
+    void copy_source (const Bitmask &mask_safe, DenseMtx &out,
+                                                    const uint16_t skip) const;
 
     // to help making things const
     static Save_Computation test_computation()
@@ -168,17 +312,150 @@ template <typename In_It>
 void Raw_Decoder<In_It>::clear_data()
 {
     std::unique_lock<std::mutex> lock_all (lock);
-    RQ_UNUSED (lock_all);
+    wait_copies (lock_all);
     stop();
     // not needed, we will need to reallocate it anyway,
     // and the bitmask already considers the symbols as unkowns
     //source_symbols = DenseMtx (_symbols, symbol_size);
     concurrent = 0;
     can_retry = false;
+    deferred = false;
     end_of_input = false;
     keep_working= true;
     mask = Bitmask (_symbols);
+    pending = Bitmask (_symbols);
     received_repair.clear();
+    written_back = false;
+    partial.reset();
+    overhead_bonus = 0;
+    if (use_progressive) {
+        std::lock_guard<std::mutex> prog_guard (progressive_lock);
+        RQ_UNUSED (prog_guard);
+        init_progressive();
+    }
+}
+
+template <typename In_It>
+void Raw_Decoder<In_It>::set_progressive (const bool enable)
+{
+    std::lock_guard<std::mutex> guard (lock);
+    RQ_UNUSED (guard);
+    std::lock_guard<std::mutex> prog_guard (progressive_lock);
+    RQ_UNUSED (prog_guard);
+    if (use_progressive == enable)
+        return;
+    use_progressive = enable;
+    if (!enable) {
+        progressive.reset();
+        // back to the normal decoding
+        if (mask.get_holes() != 0)
+            trigger();
+        return;
+    }
+    init_progressive();
+}
+
+template <typename In_It>
+void Raw_Decoder<In_It>::set_max_overhead (const uint16_t overhead)
+{
+    std::lock_guard<std::mutex> guard (lock);
+    RQ_UNUSED (guard);
+    max_overhead = overhead;
+}
+
+template <typename In_It>
+void Raw_Decoder<In_It>::set_decode_policy (const Decode_Policy &new_policy)
+{
+    std::lock_guard<std::mutex> guard (lock);
+    RQ_UNUSED (guard);
+    policy = new_policy;
+    quiet_ms = new_policy.quiet_ms;
+    last_arrival = now_ms();
+    if (!use_progressive && mask.get_holes() != 0) {
+        deferred = false;
+        trigger();
+    }
+}
+
+template <typename In_It>
+uint16_t Raw_Decoder<In_It>::policy_overhead() const
+{
+    uint16_t overhead = policy.overhead;
+    if (policy.max_failure > 0) {
+        // rfc 6330: each additional symbol makes a failure
+        // about 100 times less likely.
+        float failure = 0.01f;
+        uint16_t needed = 0;
+        while (failure > policy.max_failure) {
+            failure /= 100;
+            ++needed;
+        }
+        overhead = std::max (overhead, needed);
+    }
+    return overhead;
+}
+
+template <typename In_It>
+void Raw_Decoder<In_It>::trigger()
+{
+    const size_t holes = mask.get_holes();
+    if (received_repair.size() < holes)
+        return;
+    if (received_repair.size() >= holes + policy_overhead())
+        can_retry = true;
+    else
+        deferred = true;
+}
+
+template <typename In_It>
+int64_t Raw_Decoder<In_It>::quiet_left() const
+{
+    const uint32_t quiet = quiet_ms;
+    if (!deferred || quiet == 0)
+        return -1;
+    return std::max<int64_t> (0, last_arrival + quiet - now_ms());
+}
+
+template <typename In_It>
+void Raw_Decoder<In_It>::init_progressive()
+{
+    // both locks must be held.
+    progressive.reset();
+    if (mask.get_holes() == 0)
+        return;
+    progressive = std::unique_ptr<Progressive_Solver> (new Progressive_Solver (
+                            Parameters (_symbols),
+                            static_cast<int32_t> (source_symbols.cols())));
+    // catch up with what we already have
+    for (uint16_t esi = 0; esi < _symbols; ++esi) {
+        if (mask.exists (esi))
+            progressive->add (esi, source_symbols.row (esi));
+    }
+    for (const auto &rep : received_repair)
+        progressive->add (rep.first, received_repair.row (rep));
+    can_retry = progressive->solved();
+}
+
+template <typename In_It>
+template <typename Row>
+void Raw_Decoder<In_It>::progress (const uint32_t esi, const Row &row)
+{
+    // called without the main lock held
+    std::unique_lock<std::mutex> prog_lock (progressive_lock);
+    if (progressive == nullptr)
+        return;
+    progressive->add (esi, row);
+    if (progressive->solved())
+        can_retry = true;
+}
+
+template <typename In_It>
+size_t Raw_Decoder<In_It>::repair_bytes()
+{
+    std::lock_guard<std::mutex> guard (lock);
+    RQ_UNUSED (guard);
+    return received_repair.size() * static_cast<size_t> (
+                                                        source_symbols.cols());
 }
 
 template <typename In_It>
@@ -191,14 +468,20 @@ bool Raw_Decoder<In_It>::ready() const
 
 template <typename In_It>
 bool Raw_Decoder<In_It>::can_decode() const
-    { return can_retry; }
+{
+    if (can_retry)
+        return true;
+    return deferred && (end_of_input || quiet_left() == 0);
+}
 
 template <typename In_It>
 uint16_t Raw_Decoder<In_It>::needed_symbols() const
 {
-    if (can_retry)
+    if (can_decode())
         return 0;
-    int32_t needed = static_cast<int32_t> (mask.get_holes()) -
+    // deferred: the policy wants some overhead before trying
+    int32_t needed = static_cast<int32_t> (mask.get_holes()) +
+                        (deferred ? policy_overhead() : 0) -
                         static_cast<int32_t> (received_repair.size());
     if (needed < 0)
         needed = 0;
@@ -234,7 +517,7 @@ void Raw_Decoder<In_It>::drop_concurrent()
 }
 
 template <typename In_It>
-DenseMtx* Raw_Decoder<In_It>::get_symbols()
+const Source_Symbols* Raw_Decoder<In_It>::get_symbols() const
     { return &source_symbols; }
 
 template <typename In_It>
@@ -242,9 +525,46 @@ bool Raw_Decoder<In_It>::has_symbol (const uint16_t symbol) const
     { return mask.get_holes() == 0 || mask.exists (symbol); }
 
 template <typename In_It>
-Error Raw_Decoder<In_It>::add_symbol (In_It &start, const In_It end,
+template <typename It, typename std::enable_if<
+                                        !is_contiguous<It>::value, int>::type>
+size_t Raw_Decoder<In_It>::copy_symbol (It &start, const It end, Octet *out,
+                                                            const size_t size)
+{
+    using T = typename std::iterator_traits<It>::value_type;
+    size_t col = 0;
+    for (; start != end && col != size; ++start) {
+        T al = *start;
+        for (uint8_t *p = reinterpret_cast<uint8_t *> (&al);
+                                p != reinterpret_cast<uint8_t *> (&al) +
+                                            sizeof(T) && col != size; ++p) {
+            out[col++] = *p;
+        }
+    }
+    return col;
+}
+
+template <typename In_It>
+template <typename It, typename std::enable_if<
+                                        is_contiguous<It>::value, int>::type>
+size_t Raw_Decoder<In_It>::copy_symbol (It &start, const It end, Octet *out,
+                                                            const size_t size)
+{
+    using T = typename std::iterator_traits<It>::value_type;
+    if (start == end)
+        return 0;
+    const size_t bytes = std::min (size,
+                                static_cast<size_t> (end - start) * sizeof(T));
+    std::memcpy (out, in_bytes (start), bytes);
+    start += static_cast<int64_t> (div_ceil<size_t> (bytes, sizeof(T)));
+    return bytes;
+}
+
+template <typename In_It>
+template <typename It>
+Error Raw_Decoder<In_It>::add_symbol (It &start, const It end,
                                             const uint32_t esi, bool padded)
 {
+    using T_in = typename std::iterator_traits<It>::value_type;
     // true if added succesfully
 
     // only the last symbol from the RFC interface should be padded,
@@ -253,7 +573,8 @@ Error Raw_Decoder<In_It>::add_symbol (In_It &start, const In_It end,
 
     // if we were lucky to get a random access iterator, quickly check that
     // the we have enough data for the symbol.
-    if (std::is_same<typename std::iterator_traits<In_It>::iterator_category,
+    if (!padded && std::is_same<
+                        typename std::iterator_traits<It>::iterator_category,
                                     std::random_access_iterator_tag>::value) {
         if (static_cast<size_t>(end - start) * sizeof(T_in) <
                                 static_cast<size_t> (source_symbols.cols()))
@@ -265,80 +586,174 @@ Error Raw_Decoder<In_It>::add_symbol (In_It &start, const In_It end,
     if (esi >= std::pow (2, 20))
         return Error::WRONG_INPUT;
 
-    std::lock_guard<std::mutex> guard (lock);
-    RQ_UNUSED(guard);
-
-    if (mask.get_holes() == 0 || mask.exists (esi))
+    // reserve the destination. the copy itself does not hold the lock,
+    // so multiple producers can copy at the same time.
+    std::unique_lock<std::mutex> guard (lock);
+    // the symbols are being changed: we can tell if this one is needed
+    // only after that.
+    copies_done.wait (guard, [this] () { return draining == 0; });
+    if (mask.get_holes() == 0 || mask.exists (esi) || pending.exists (esi))
         return Error::NOT_NEEDED;   // not even needed.
-
-    uint16_t col = 0;
+    const size_t size = static_cast<size_t> (source_symbols.cols());
+    uint32_t slot = 0;
+    Octet *dest;
     if (esi < _symbols) {
-        for (; start != end && col != source_symbols.cols(); ++start) {
-            T_in al = *start;
-            for (uint8_t *p = reinterpret_cast<uint8_t *> (&al);
-                        p != reinterpret_cast<uint8_t *> (&al) + sizeof(T_in)
-                                        && col != source_symbols.cols(); ++p) {
-                source_symbols (static_cast<int32_t>(esi), col++) = *p;
-            }
-        }
-        // input iterator might reach end before we get enough data
-        // for the symbol.
-        if (col != source_symbols.cols()) {
-            if (padded) {
-                while (col != source_symbols.cols())
-                    source_symbols (static_cast<int32_t>(esi), col++) = 0;
-            } else {
-                return Error::WRONG_INPUT;
-            }
-        }
+        dest = source_symbols.data() + esi * size;
     } else {
-        Vect v = Vect (source_symbols.cols());
-        for (; start != end && col != source_symbols.cols(); ++start) {
-            T_in al = *start;
-            for (uint8_t *p = reinterpret_cast<uint8_t *> (&al);
-                        p != reinterpret_cast<uint8_t *> (&al) + sizeof(T_in)
-                                        && col != source_symbols.cols(); ++p) {
-                v (col++) = *p;
-            }
-        }
-        // input iterator might reach end before we get enough data
-        // for the symbol.
-        if (col != v.cols())
-            return Error::WRONG_INPUT;
-        received_repair.emplace_back (esi, std::move(v));
-        // reorder the received_repair:
+        slot = received_repair.reserve();
+        dest = received_repair.slot (slot);
+    }
+    pending.add (esi);
+    ++copies;
+    guard.unlock();
+
+    const size_t col = copy_symbol (start, end, dest, size);
+    // input iterator might reach end before we get enough data
+    // for the symbol.
+    bool complete = col == size;
+    if (!complete && padded && esi < _symbols) {
+        std::fill (dest + col, dest + size, Octet (0));
+        complete = true;
+    }
+
+    // publish
+    guard.lock();
+    pending.drop (esi);
+    if (--copies == 0 && draining != 0)
+        copies_done.notify_all();
+    if (!complete) {
+        if (esi >= _symbols)
+            received_repair.release (slot);
+        return Error::WRONG_INPUT;
+    }
+    if (esi >= _symbols) {
+        // the store keeps the repair symbols ordered by esi:
         // ordering the repair packets lets us have more deterministic
         // matrices, that we can use for precomputation.
-        // this *should* not be a big performance hit as the repair symbols
-        // should already be *almost* in order.
-        // TODO: b-tree? map?
-        int32_t idx = static_cast<int32_t> (received_repair.size()) - 1;
-        while (idx >= 1) {
-            const uint32_t idx_u = static_cast<uint32_t> (idx);
-            const uint32_t prev = idx_u - 1;
-            if (received_repair[idx_u].first < received_repair[prev].first) {
-                std::swap (received_repair[idx_u], received_repair[prev]);
-                --idx;
-            } else {
-                break;
-            }
-        }
+        received_repair.commit (esi, slot);
     }
     mask.add (esi);
+    if (mask.get_holes() == 0)
+        write_back();
+    if (quiet_ms != 0)
+        last_arrival = now_ms();
 
-    if (mask.get_holes() <= received_repair.size())
+    if (use_progressive) {
+        // decode() becomes possible only when the solver is complete
+        // (or when we do not need it anymore)
+        if (mask.get_holes() == 0) {
+            can_retry = true;
+            return Error::NONE;
+        }
+        const Vect prog_row = Symbol_Store::Row (dest,
+                                                static_cast<int64_t> (size));
+        guard.unlock();
+        progress (esi, prog_row);
+        return Error::NONE;
+    }
+    if (mask.get_holes() == 0)
         can_retry = true;
+    else
+        trigger();
     return Error::NONE;
 }
 
+template <typename In_It>
+size_t Raw_Decoder<In_It>::add_symbols (const uint8_t *data,
+                                    const uint32_t *esi, const uint32_t count,
+                                                    std::vector<bool> &added)
+{
+    added.assign (count, false);
+    if (data == nullptr || esi == nullptr || count == 0)
+        return 0;
+    const size_t size = static_cast<size_t> (source_symbols.cols());
+
+    struct Reserved
+    {
+        uint32_t idx;
+        uint32_t slot;
+        Octet *dest;
+    };
+    std::vector<Reserved> todo;
+    todo.reserve (count);
+
+    // reserve all the destinations at once
+    std::unique_lock<std::mutex> guard (lock);
+    copies_done.wait (guard, [this] () { return draining == 0; });
+    if (use_progressive) {
+        // every symbol goes through the solver anyway
+        guard.unlock();
+        size_t ret = 0;
+        for (uint32_t idx = 0; idx < count; ++idx) {
+            const uint8_t *start = data + idx * size;
+            if (add_symbol (start, start + size, esi[idx], false) ==
+                                                                Error::NONE) {
+                added[idx] = true;
+                ++ret;
+            }
+        }
+        return ret;
+    }
+    for (uint32_t idx = 0; idx < count; ++idx) {
+        const uint32_t id = esi[idx];
+        if (id >= (1u << 20) || mask.get_holes() == 0 ||
+                                        mask.exists (id) || pending.exists (id)) {
+            continue;
+        }
+        Reserved res {idx, 0, nullptr};
+        if (id < _symbols) {
+            res.dest = source_symbols.data() + id * size;
+        } else {
+            res.slot = received_repair.reserve();
+            res.dest = received_repair.slot (res.slot);
+        }
+        pending.add (id);
+        ++copies;
+        todo.push_back (res);
+    }
+    if (todo.empty())
+        return 0;
+    guard.unlock();
+
+    for (const auto &res : todo)
+        std::memcpy (res.dest, data + res.idx * size, size);
+
+    // publish them all
+    guard.lock();
+    for (const auto &res : todo) {
+        const uint32_t id = esi[res.idx];
+        pending.drop (id);
+        if (id >= _symbols)
+            received_repair.commit (id, res.slot);
+        mask.add (id);
+        added[res.idx] = true;
+    }
+    copies -= static_cast<uint32_t> (todo.size());
+    if (copies == 0 && draining != 0)
+        copies_done.notify_all();
+    if (quiet_ms != 0)
+        last_arrival = now_ms();
+    if (mask.get_holes() == 0) {
+        write_back();
+        can_retry = true;
+    } else {
+        trigger();
+    }
+    return todo.size();
+}
+
 template <typename In_It>
 std::vector<bool> Raw_Decoder<In_It>::fill_with_zeros()
 {
-    std::lock_guard<std::mutex> dec_lock (lock);
-    RQ_UNUSED(dec_lock);
+    std::unique_lock<std::mutex> dec_lock (lock);
+    wait_copies (dec_lock);
     stop();
     // free mem;
-    received_repair = std::vector<std::pair<uint32_t, Vect>>();
+    received_repair.clear();
+    partial.reset();
+    std::unique_lock<std::mutex> prog_lock (progressive_lock);
+    progressive.reset();
+    prog_lock.unlock();
 
     std::vector<bool> ret (_symbols, false);
 
@@ -349,6 +764,7 @@ std::vector<bool> Raw_Decoder<In_It>::fill_with_zeros()
         source_symbols.block(idx, 0, 1, source_symbols.cols()).setZero();
         mask.add (idx);
     }
+    write_back();
     end_of_input = true;
     return ret;
 }
@@ -357,8 +773,9 @@ template <typename In_It>
 Decoder_Result Raw_Decoder<In_It>::decode (Work_State *thread_keep_working)
 {
     // this method can be launched concurrently multiple times.
-    // TODO:  do not build matrices with more than 4 overhead elements,
-    // but don't lose received elements either
+    // we do not build matrices with more than "max_overhead" overhead rows,
+    // but we don't lose the other received symbols either: they are used
+    // only if this attempt fails.
 
     // rfc 6330: can decode when received >= K_padded
     // actually: (K_padded - K) are padding and thus constant and NOT
@@ -369,19 +786,63 @@ Decoder_Result Raw_Decoder<In_It>::decode (Work_State *thread_keep_working)
     if (received_repair.size() < mask.get_holes())
         return Decoder_Result::NEED_DATA;
 
-    const std::unique_ptr<Precode_Matrix< Save_Computation::ON>> precode_on (
-                                                init_precode_on (_symbols));
-    const std::unique_ptr<Precode_Matrix<Save_Computation::OFF>> precode_off (
-                                                init_precode_off (_symbols));
     std::unique_lock<std::mutex> shared (lock);
-    if (!can_retry)
+    if (!can_decode())
         return Decoder_Result::NEED_DATA;
     can_retry = false;
-    const uint32_t overhead = static_cast<uint32_t> (
-                                    received_repair.size() - mask.get_holes());
+    deferred = false;
+    if (use_progressive) {
+        // everything has already been eliminated, just read the result.
+        Bitmask mask_safe = mask;
+        shared.unlock();
+        std::unique_lock<std::mutex> prog_lock (progressive_lock);
+        if (progressive == nullptr || !progressive->solved())
+            return Decoder_Result::NEED_DATA;
+        const Precode_Matrix<Save_Computation::OFF> precode (
+                                                    progressive->_params);
+        const DenseMtx C = progressive->intermediate();
+        prog_lock.unlock();
+        const DenseMtx missing = precode.get_missing (C, mask_safe);
+        shared.lock();
+        return save_missing (shared, missing, mask_safe);
+    }
+    if (partial != nullptr)
+        return decode_resume (shared, thread_keep_working);
+    shared.unlock();
+    std::unique_ptr<Precode_Matrix< Save_Computation::ON>> precode_on (
+                                                init_precode_on (_symbols));
+    std::unique_ptr<Precode_Matrix<Save_Computation::OFF>> precode_off (
+                                                init_precode_off (_symbols));
+    // if the encoder already solved the systematic system for this block
+    // size, we only need a small correction for the holes.
+    DenseMtx inverse;
+    if (type == Save_Computation::ON) {
+        const auto tmp_bool = std::vector<bool>();
+        const Cache_Key enc_key (precode_on->_params.L, 0, 0, tmp_bool,
+                                                                    tmp_bool);
+        auto compressed = DLF<std::vector<uint8_t>, Cache_Key>::
+                                                        get()->get (enc_key);
+        if (compressed.second.size() != 0) {
+            auto decompressed = decompress (compressed.first,
+                                                        compressed.second);
+            inverse = raw_to_Mtx (decompressed, enc_key.out_size());
+        }
+    }
+    shared.lock();
+    if (mask.get_holes() == 0) {
+        // other thread completed its work before us?
+        return Decoder_Result::DECODED;
+    }
+    const uint32_t used_repair = static_cast<uint32_t> (std::min<size_t> (
+                            received_repair.size(), static_cast<size_t> (
+                                mask.get_holes()) + std::max (max_overhead,
+                                policy_overhead()) + overhead_bonus));
+    const uint32_t overhead = used_repair - mask.get_holes();
+    const auto used_end = received_repair.begin() + used_repair;
 
     if (type == Save_Computation::ON) {
-        precode_on->gen (static_cast<uint32_t> (overhead));
+        if (inverse.rows() == 0)
+            precode_on->gen (static_cast<uint32_t> (overhead));
     } else {
         precode_off->gen (static_cast<uint32_t> (overhead));
     }
@@ -392,12 +853,11 @@ Decoder_Result Raw_Decoder<In_It>::decode (Work_State *thread_keep_working)
     if (type == Save_Computation::ON) {
         L_rows = precode_on->_params.L;
         S_H = precode_on->_params.S + precode_on->_params.H;
-        // repair.rbegin() is the highest repair symbol
-        const auto it = received_repair.crbegin();
-        bitmask_repair.reserve ((it->first - _symbols));
+        // (used_end - 1) is the highest repair symbol we use
+        bitmask_repair.reserve (((used_end - 1)->first - _symbols));
         uint32_t idx = _symbols;
-        for (auto rep = received_repair.begin();
-                                rep != received_repair.end(); ++rep, ++idx) {
+        for (auto rep = received_repair.begin(); rep != used_end;
+                                                                ++rep, ++idx) {
             for (;idx < rep->first; ++idx)
                 bitmask_repair.push_back (false);
             bitmask_repair.push_back (true);
@@ -406,48 +866,61 @@ Decoder_Result Raw_Decoder<In_It>::decode (Work_State *thread_keep_working)
         L_rows = precode_off->_params.L;
         S_H = precode_off->_params.S + precode_off->_params.H;
     }
-    const Cache_Key key (L_rows, mask.get_holes(),
-                                static_cast<uint32_t> (received_repair.size()),
-                                            mask.get_bitmask(), bitmask_repair);
-
-    DenseMtx D = DenseMtx (L_rows + overhead, source_symbols.cols());
-
-    // initialize D: first S_H rows == 0
-    D.block(0, 0, S_H, D.cols()).setZero();
-    // put non-repair symbols (source symbols) in place
-    if (mask.get_holes() == 0) {
-        // other thread completed its work before us?
-        return Decoder_Result::DECODED;
-    }
-    D.block (S_H, 0, source_symbols.rows(), D.cols()) = source_symbols;
+    // the repair symbols are tracked separately, only keep the source ones
+    const std::vector<bool> lost_bitmask (mask.get_bitmask().begin(),
+                                        mask.get_bitmask().begin() + _symbols);
+    const Cache_Key key (L_rows, mask.get_holes(), used_repair, lost_bitmask,
+                                                                bitmask_repair);
 
     // mask must be copied to avoid threading problems, same with tracking
-    // the repair esi.
-    const Bitmask mask_safe = mask;
+    // the repair esi. The mask only tracks the repair symbols we use.
+    Bitmask mask_safe = mask;
     std::vector<uint32_t> repair_esi;
-    repair_esi.reserve (received_repair.size());
-    for (auto rep : received_repair)
-        repair_esi.push_back (rep.first);
-
-    // fill holes with the first repair symbols available
-    auto symbol = received_repair.begin();
-    uint16_t hole = 0;
-    while (hole < _symbols && symbol != received_repair.end()) {
-        if (mask_safe.exists (static_cast<size_t> (hole))) {
+    repair_esi.reserve (used_repair);
+    for (auto rep = received_repair.begin(); rep != used_end; ++rep)
+        repair_esi.push_back (rep->first);
+    for (auto rep = used_end; rep != received_repair.end(); ++rep)
+        mask_safe.drop (rep->first);
+
+    const bool use_inverse = type == Save_Computation::ON &&
+                                                        inverse.rows() != 0;
+    DenseMtx D, source;
+    Symbol_Store::Rows repairs;
+    if (use_inverse) {
+        // nothing is solved in place: only copy the source symbols,
+        // the repair symbols are read directly from the store.
+        source = DenseMtx (_symbols, source_symbols.cols());
+        copy_source (mask_safe, source, 0);
+        repairs = received_repair.rows (used_repair);
+    } else {
+        D = DenseMtx (L_rows + overhead, source_symbols.cols());
+
+        // initialize D: first S_H rows == 0
+        D.block(0, 0, S_H, D.cols()).setZero();
+        // put non-repair symbols (source symbols) in place
+        copy_source (mask_safe, D, S_H);
+
+        // fill holes with the first repair symbols available
+        auto symbol = received_repair.begin();
+        uint16_t hole = 0;
+        while (hole < _symbols && symbol != used_end) {
+            if (mask_safe.exists (static_cast<size_t> (hole))) {
+                ++hole;
+                continue;
+            }
+            const uint16_t row = S_H + hole;
+            D.row (row) = received_repair.row (*symbol);
+            ++symbol;
             ++hole;
-            continue;
         }
-        const uint16_t row = S_H + hole;
-        D.row (row) = symbol->second;
-        ++symbol;
-        ++hole;
-    }
-    // fill the padding symbols (always zero)
-    D.block (S_H + _symbols, 0, (L_rows - S_H) - _symbols, D.cols()).setZero();
-    // fill the remaining (redundant) repair symbols
-    for (uint16_t row = L_rows; symbol != received_repair.end(); ++symbol) {
-        D.row (row) = symbol->second;
-        ++row;
+        // fill the padding symbols (always zero)
+        D.block (S_H + _symbols, 0, (L_rows - S_H) - _symbols,
+                                                            D.cols()).setZero();
+        // fill the remaining (redundant) repair symbols
+        for (uint16_t row = L_rows; symbol != used_end; ++symbol) {
+            D.row (row) = received_repair.row (*symbol);
+            ++row;
+        }
     }
 
     // do not lock this part, as it's the expensive part
@@ -457,7 +930,11 @@ Decoder_Result Raw_Decoder<In_It>::decode (Work_State *thread_keep_working)
 
     Precode_Result precode_res = Precode_Result::DONE;
     DenseMtx missing;
-    if (type == Save_Computation::ON) {
+    if (use_inverse) {
+        DO_NOT_SAVE = true;
+        std::tie (precode_res, missing) = precode_on->low_rank (inverse,
+                                        source, mask_safe, repair_esi, repairs);
+    } else if (type == Save_Computation::ON) {
         auto compressed = DLF<std::vector<uint8_t>, Cache_Key>::
                                                             get()->get (key);
         auto decompressed = decompress (compressed.first, compressed.second);
@@ -485,6 +962,34 @@ Decoder_Result Raw_Decoder<In_It>::decode (Work_State *thread_keep_working)
         return Decoder_Result::STOPPED;
     }
 
+    if (precode_res == Precode_Result::FAILED) {
+        std::lock_guard<std::mutex> dec_lock (lock);
+        RQ_UNUSED(dec_lock);
+        // keep the partially solved system, so that the next attempt only
+        // has to eliminate the new symbols.
+        if (partial == nullptr && mask.get_holes() != 0 &&
+                ((precode_on != nullptr && precode_on->can_resume()) ||
+                 (precode_off != nullptr && precode_off->can_resume()))) {
+            partial = std::unique_ptr<Partial_Solve> (
+                                                new Partial_Solve (mask_safe));
+            partial->precode_on = std::move (precode_on);
+            partial->precode_off = std::move (precode_off);
+            partial->D = std::move (D);
+        } else if (partial == nullptr) {
+            // next time, start with a bigger matrix
+            overhead_bonus = static_cast<uint16_t> (overhead_bonus +
+                                        std::max<uint16_t> (1, max_overhead));
+        }
+        if (mask.get_holes() == 0)
+            return Decoder_Result::DECODED;
+        // we still have unused repair symbols
+        if (received_repair.size() > used_repair)
+            can_retry = true;
+        if (can_retry)
+            return Decoder_Result::CAN_RETRY;
+        return Decoder_Result::NEED_DATA;
+    }
+
     D = DenseMtx(); // free some memory;
     if (type == Save_Computation::ON && !DO_NOT_SAVE &&
                                         precode_res == Precode_Result::DONE) {
@@ -502,14 +1007,168 @@ Decoder_Result Raw_Decoder<In_It>::decode (Work_State *thread_keep_working)
         }
     }
 
-    std::lock_guard<std::mutex> dec_lock (lock);
-    RQ_UNUSED(dec_lock);
+    std::unique_lock<std::mutex> dec_lock (lock);
+    return save_missing (dec_lock, missing, mask_safe);
+}
+
+template <typename In_It>
+Decoder_Result Raw_Decoder<In_It>::decode_resume (
+                                        std::unique_lock<std::mutex> &shared,
+                                        Work_State *thread_keep_working)
+{
+    // the lock is held. a previous attempt failed, and we kept its state.
+    // Only feed it the symbols received since then.
+    std::unique_ptr<Partial_Solve> state = std::move (partial);
+    Bitmask mask_safe = mask;
+    const uint32_t padding = static_cast<uint32_t> (
+                            (state->precode_on != nullptr ?
+                                    state->precode_on->_params.K_padded :
+                                    state->precode_off->_params.K_padded) -
+                                                                    _symbols);
+    std::vector<uint32_t> isis;
+    for (uint16_t esi = 0; esi < _symbols; ++esi) {
+        if (mask_safe.exists (esi) && !state->mask.exists (esi))
+            isis.push_back (esi);
+    }
+    const size_t new_sources = isis.size();
+    // bring in the new (or unused) repair symbols a few at a time
+    size_t new_repairs = 0;
+    bool reserve = false;
+    for (const auto &rep : received_repair) {
+        if (state->mask.exists (rep.first))
+            continue;
+        if (new_repairs >= std::max<uint16_t> (1, max_overhead)) {
+            reserve = true;
+            break;
+        }
+        isis.push_back (rep.first);
+        ++new_repairs;
+    }
+    DenseMtx rows (isis.size(), source_symbols.cols());
+    auto rep = received_repair.begin();
+    for (size_t idx = 0; idx < isis.size(); ++idx) {
+        const int32_t row = static_cast<int32_t> (idx);
+        state->mask.add (isis[idx]);
+        if (idx < new_sources) {
+            rows.row (row) = source_symbols.row (
+                                            static_cast<int32_t> (isis[idx]));
+            continue;
+        }
+        while (rep->first != isis[idx])
+            ++rep;
+        rows.row (row) = received_repair.row (*rep);
+        isis[idx] += padding;
+    }
+    shared.unlock();
 
+    std::deque<Operation> ops;
+    Precode_Result precode_res;
+    DenseMtx missing;
+    if (state->precode_on != nullptr) {
+        std::tie (precode_res, missing) = state->precode_on->
+                                    intermediate_resume (state->D, isis, rows,
+                                    ops, keep_working, thread_keep_working);
+        missing = state->precode_on->get_missing (std::move(missing),
+                                                                    mask_safe);
+    } else {
+        std::tie (precode_res, missing) = state->precode_off->
+                                    intermediate_resume (state->D, isis, rows,
+                                    ops, keep_working, thread_keep_working);
+        missing = state->precode_off->get_missing (std::move(missing),
+                                                                    mask_safe);
+    }
+    std::unique_lock<std::mutex> dec_lock (lock);
+    if (precode_res == Precode_Result::STOPPED) {
+        if (mask.get_holes() == 0)
+            return Decoder_Result::DECODED;
+        return Decoder_Result::STOPPED;
+    }
     if (precode_res == Precode_Result::FAILED) {
+        if (partial == nullptr && mask.get_holes() != 0)
+            partial = std::move (state);
+        if (mask.get_holes() == 0)
+            return Decoder_Result::DECODED;
+        if (reserve)
+            can_retry = true;
         if (can_retry)
             return Decoder_Result::CAN_RETRY;
         return Decoder_Result::NEED_DATA;
     }
+    return save_missing (dec_lock, missing, mask_safe);
+}
+
+template <typename In_It>
+bool Raw_Decoder<In_It>::set_storage (const std::shared_ptr<Scratch_File> &file)
+{
+    std::unique_lock<std::mutex> guard (lock);
+    if (file == nullptr || !*file || own_symbols.size() == 0)
+        return false;
+    wait_copies (guard);
+    if (concurrent != 0)
+        return false;
+    auto region = file->alloc (static_cast<size_t> (own_symbols.size()));
+    if (region == nullptr)
+        return false;
+    // keep what we already have (padding, received symbols)
+    std::copy (own_symbols.data(), own_symbols.data() + own_symbols.size(),
+                                                                region.get());
+    // Eigen::Map can not be re-pointed by assignment:
+    // end the old one, and build the new one in its place.
+    source_symbols.~Source_Symbols();
+    new (&source_symbols) Source_Symbols (region.get(), _symbols,
+                                                        own_symbols.cols());
+    own_symbols = DenseMtx();
+    stored_symbols = std::move (region);
+    storage = file;
+    received_repair.set_storage (file);
+    if (mask.get_holes() == 0)
+        write_back();
+    return true;
+}
+
+template <typename In_It>
+void Raw_Decoder<In_It>::write_back()
+{
+    if (storage == nullptr || written_back)
+        return;
+    written_back = true;
+    storage->write_back (source_symbols.data(),
+                    static_cast<size_t> (source_symbols.size()));
+}
+
+template <typename In_It>
+void Raw_Decoder<In_It>::wait_copies (std::unique_lock<std::mutex> &guard)
+{
+    // new copies wait for us, so this can not starve. They start again
+    // when the caller releases the lock.
+    ++draining;
+    copies_done.wait (guard, [this] () { return copies == 0; });
+    if (--draining == 0)
+        copies_done.notify_all();
+}
+
+template <typename In_It>
+void Raw_Decoder<In_It>::copy_source (const Bitmask &mask_safe, DenseMtx &out,
+                                                    const uint16_t skip) const
+{
+    // only the published rows: the others might be being written.
+    for (uint16_t row = 0; row < _symbols; ++row) {
+        if (mask_safe.exists (row)) {
+            out.row (skip + row) = source_symbols.row (row);
+        } else {
+            out.row (skip + row).setZero();
+        }
+    }
+}
+
+template <typename In_It>
+Decoder_Result Raw_Decoder<In_It>::save_missing (
+                                            std::unique_lock<std::mutex> &guard,
+                                            const DenseMtx &missing,
+                                            const Bitmask &mask_safe)
+{
+    // the missing symbols might be being copied right now.
+    wait_copies (guard);
     if (mask.get_holes() == 0)
         return Decoder_Result::DECODED;
 
@@ -526,10 +1185,15 @@ Decoder_Result Raw_Decoder<In_It>::decode (Work_State *thread_keep_working)
         source_symbols.row (row) = missing.row (miss_row - 1);
         mask.add (row);
     }
+    write_back();
 
     keep_working = false;   // tell eventual threads to stop crunching,
     // free some memory, we don't need recover symbols anymore
-    received_repair = std::vector<std::pair<uint32_t, Vect>>();
+    received_repair.clear();
+    partial.reset();
+    std::unique_lock<std::mutex> prog_lock (progressive_lock);
+    progressive.reset();
+    prog_lock.unlock();
     mask.free();
 
 
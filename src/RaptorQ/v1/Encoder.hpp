@@ -29,10 +29,19 @@
 #include "RaptorQ/v1/Rand.hpp"
 #include "RaptorQ/v1/Shared_Computation/Decaying_LF.hpp"
 #include "RaptorQ/v1/Thread_Pool.hpp"
+#include "RaptorQ/v1/util/contiguous.hpp"
+#include "RaptorQ/v1/util/div.hpp"
 #include <Eigen/Dense>
+#include <algorithm>
+#include <atomic>
+#include <condition_variable>
+#include <cstring>
+#include <limits>
 #include <memory>
+#include <mutex>
 #include <type_traits>
 #include <utility>
+#include <vector>
 
 namespace RaptorQ__v1 {
 namespace Impl {
@@ -40,6 +49,86 @@ namespace Impl {
 using with_interleaver    = std::true_type;
 using without_interleaver = std::false_type;
 
+// Generate many symbols at once, one after the other in a contiguous buffer.
+// The tuples of all the symbols are computed once, before starting.
+// The batch is split in chunks. The caller and the pool threads take
+// chunks until there are none left, so a busy pool never makes us wait
+// for more than the chunks that are already being worked on.
+template <typename Precode>
+class RAPTORQ_LOCAL Symbol_Batch
+{
+public:
+    // one tuple per symbol to generate
+    Symbol_Batch (const Precode &precode, const DenseMtx &C,
+                                std::vector<Tuple> &&tuples, Octet *output,
+                                                        const uint32_t chunk)
+        : _precode (precode), _C (C), _tuples (std::move (tuples)),
+          _output (output),
+          _count (static_cast<uint32_t> (_tuples.size())), _chunk (chunk),
+          _chunks ((_count + chunk - 1) / chunk), _next (0), _done (0)
+    {}
+    Symbol_Batch() = delete;
+    Symbol_Batch (const Symbol_Batch&) = delete;
+    Symbol_Batch& operator= (const Symbol_Batch&) = delete;
+    Symbol_Batch (Symbol_Batch&&) = delete;
+    Symbol_Batch& operator= (Symbol_Batch&&) = delete;
+    ~Symbol_Batch() = default;
+
+    // false if there was nothing left to do
+    bool run_chunk()
+    {
+        const uint32_t chunk = _next++;
+        if (chunk >= _chunks)
+            return false;
+        const size_t size = static_cast<size_t> (_C.cols());
+        const uint32_t end = std::min (_count, (chunk + 1) * _chunk);
+        for (uint32_t idx = chunk * _chunk; idx < end; ++idx)
+            _precode.encode (_C, _tuples[idx], _output + idx * size);
+        std::lock_guard<std::mutex> guard (_mtx);
+        RQ_UNUSED (guard);
+        if (++_done == _chunks)
+            _cond.notify_all();
+        return true;
+    }
+    void wait()
+    {
+        std::unique_lock<std::mutex> lock (_mtx);
+        while (_done != _chunks)
+            _cond.wait (lock);
+    }
+
+private:
+    // only valid while the caller is waiting. Once all the chunks
+    // are taken, late pool threads do not touch them anymore.
+    const Precode &_precode;
+    const DenseMtx &_C;
+    const std::vector<Tuple> _tuples;
+    Octet *_output;
+    const uint32_t _count, _chunk, _chunks;
+    std::atomic<uint32_t> _next;
+    uint32_t _done;
+    std::mutex _mtx;
+    std::condition_variable _cond;
+};
+
+template <typename Precode>
+class RAPTORQ_LOCAL Symbol_Batch_Work final :
+                                        public RFC6330__v1::Impl::Pool_Work
+{
+public:
+    std::shared_ptr<Symbol_Batch<Precode>> batch;
+
+    RFC6330__v1::Work_Exit_Status do_work (RaptorQ__v1::Work_State *state)
+                                                                    override
+    {
+        RQ_UNUSED (state);
+        while (batch->run_chunk())
+            {}
+        return RFC6330__v1::Work_Exit_Status::DONE;
+    }
+    ~Symbol_Batch_Work() override {}
+};
+
 
 // NOTE: enabled_if methods
 // instead of having 3-4 really similar methods, we use enable_if
@@ -75,14 +164,24 @@ public:
 
     // "Enc" will have two implementations, depending os whether the
     // interleaver was used or not.
+    // "output" is usually a Fwd_It, but any forward iterator will do.
     template <typename R_It = Rnd_It,
         typename F_It = Fwd_It, typename I = Interleaved,
         typename std::enable_if<I::value, int>::type = 0>
-    size_t Enc (const uint32_t ESI, Fwd_It &output, const Fwd_It end) const;
+    size_t Enc (const uint32_t ESI, F_It &output, const F_It end) const;
     template <typename R_It = Rnd_It,
         typename F_It = Fwd_It, typename I = Interleaved,
         typename std::enable_if<!I::value, int>::type = 0>
-    size_t Enc (const uint32_t ESI, Fwd_It &output, const Fwd_It end) const;
+    size_t Enc (const uint32_t ESI, F_It &output, const F_It end) const;
+
+    // generate "count" symbols (source or repair) directly in "output",
+    // one after the other. If ids == nullptr the symbols are
+    // "first", "first + 1"... Big batches are split on the thread pool.
+    // returns the number of symbols written, only whole symbols are written.
+    // We stop at the first id past the last repair symbol.
+    size_t Enc_batch (const uint32_t first, const uint32_t *ids,
+                                const uint32_t count, uint8_t *output,
+                                                    const size_t size) const;
 
 
     // for both interleaved and non-interleaved
@@ -98,6 +197,15 @@ public:
         typename F_It = Fwd_It, typename I = Interleaved,
         typename std::enable_if<I::value, int>::type = 0>
     bool generate_symbols (RaptorQ__v1::Work_State *thread_keep_working);
+    // interleaver-only, non precomputed, together with "others".
+    // blocks with the same K' have the same matrix: their symbols are put
+    // side by side and solved with a single elimination.
+    // "others" with a different K' or already computed are ignored.
+    template <typename R_It = Rnd_It,
+        typename F_It = Fwd_It, typename I = Interleaved,
+        typename std::enable_if<I::value, int>::type = 0>
+    bool generate_symbols (const std::vector<Raw_Encoder*> &others,
+                                RaptorQ__v1::Work_State *thread_keep_working);
 
 
     // NOTE: these two automatically add padding if needed.
@@ -142,14 +250,56 @@ private:
         typename F_It = Fwd_It, typename I = Interleaved,
         typename std::enable_if<I::value, int>::type = 0>
     DenseMtx get_raw_symbols (const uint16_t K_S_H, const uint16_t S_H) const;
+    // the precomputed matrix of our L, only if it is already in the cache
+    DenseMtx cached_precomputed() const;
+    // contiguous input (pointers, vector iterators): multiply "precomputed"
+    // with a read-only view of the caller's data, the source symbols are
+    // never copied.
+    // Only used with the precomputed matrix already in the cache: the
+    // solver works in place, so without it the block is still copied in D.
+    static constexpr bool contiguous_input = is_contiguous<Rnd_It>::value;
+    template <typename R_It = Rnd_It,
+        typename F_It = Fwd_It, typename I = Interleaved,
+        typename std::enable_if<!I::value, int>::type = 0>
+    void generate_mapped (const DenseMtx &precomputed, const uint16_t S_H);
 
 
     std::pair<uint16_t, uint16_t> init_ksh() const;
     bool compute_intermediate (DenseMtx &D,
                                 RaptorQ__v1::Work_State *thread_keep_working);
 
-    size_t Enc_repair (const uint32_t ESI, Fwd_It &output,
-                                                        const Fwd_It end) const;
+    template <typename F_It = Fwd_It>
+    size_t Enc_repair (const uint32_t ESI, F_It &output,
+                                                        const F_It end) const;
+    // non-interleaved source symbols: a single memcpy if both
+    // the input and the output are contiguous.
+    template <typename R_It = Rnd_It,
+        typename F_It = Fwd_It, typename I = Interleaved,
+        typename std::enable_if<!I::value && is_contiguous<R_It>::value &&
+                                    is_contiguous<F_It>::value, int>::type = 0>
+    size_t Enc_source (const uint32_t ESI, F_It &output,
+                                                        const F_It end) const;
+    template <typename R_It = Rnd_It,
+        typename F_It = Fwd_It, typename I = Interleaved,
+        typename std::enable_if<!I::value && !(is_contiguous<R_It>::value &&
+                                    is_contiguous<F_It>::value), int>::type = 0>
+    size_t Enc_source (const uint32_t ESI, F_It &output,
+                                                        const F_It end) const;
+    // copy a symbol in the output, zero-padding the last element.
+    // returns the number of iterators written.
+    template <typename F_It = Fwd_It,
+        typename std::enable_if<is_contiguous<F_It>::value, int>::type = 0>
+    static size_t write_symbol (const Octet *symbol, const size_t size,
+                                        F_It &output, const F_It end);
+    template <typename F_It = Fwd_It,
+        typename std::enable_if<!is_contiguous<F_It>::value, int>::type = 0>
+    static size_t write_symbol (const Octet *symbol, const size_t size,
+                                        F_It &output, const F_It end);
+    template <typename Precode>
+    static uint32_t Enc_batch (const Precode &precode, const DenseMtx &C,
+                                const uint16_t symbols, const uint32_t first,
+                                const uint32_t *ids, const uint32_t count,
+                                Octet *output);
     std::pair<uint16_t, uint16_t> init_ksh();
     static Save_Computation test_computation()
     {
@@ -229,6 +379,19 @@ template <typename Rnd_It, typename Fwd_It, typename Interleaved>
 bool Raw_Encoder<Rnd_It, Fwd_It, Interleaved>::ready() const
     { return encoded_symbols.cols() != 0; }
 
+template <typename Rnd_It, typename Fwd_It, typename Interleaved>
+DenseMtx Raw_Encoder<Rnd_It, Fwd_It, Interleaved>::cached_precomputed() const
+{
+    const uint16_t size = Parameters (_symbols).L;
+    const auto tmp_bool = std::vector<bool>();
+    const Cache_Key key (size, 0, 0, tmp_bool, tmp_bool);
+    auto compressed = DLF<std::vector<uint8_t>, Cache_Key>::get()->get (key);
+    if (compressed.second.size() == 0)
+        return DenseMtx();
+    auto uncompressed = decompress (compressed.first, compressed.second);
+    return raw_to_Mtx (uncompressed, key.out_size());
+}
+
 template <typename Rnd_It, typename Fwd_It, typename Interleaved>
 DenseMtx Raw_Encoder<Rnd_It, Fwd_It, Interleaved>::get_precomputed (
                                 RaptorQ__v1::Work_State *thread_keep_working)
@@ -240,22 +403,13 @@ DenseMtx Raw_Encoder<Rnd_It, Fwd_It, Interleaved>::get_precomputed (
                 new Precode_Matrix<Save_Computation::ON>(Parameters(_symbols)));
     }
     if (_type == Save_Computation::ON) {
-        const uint16_t size = precode_on->_params.L;
-        const auto tmp_bool = std::vector<bool>();
-        const Cache_Key key (size, 0, 0, tmp_bool, tmp_bool);
-        auto compressed = DLF<std::vector<uint8_t>, Cache_Key>::
-                                                            get()->get (key);
-        if (compressed.second.size() != 0) {
-            auto uncompressed = decompress (compressed.first,compressed.second);
-            DenseMtx precomputed = raw_to_Mtx (uncompressed, key.out_size());
-            if (precomputed.rows() != 0) {
-                return precomputed;
-            }
-            return DenseMtx();
-        }
+        DenseMtx precomputed = cached_precomputed();
+        if (precomputed.rows() != 0)
+            return precomputed;
         // else not found, generate one.
     }
-    precode_on->gen(0);    
+    if (!precode_on->generated())
+        precode_on->gen(0);
 
     uint16_t S_H;
     uint16_t K_S_H;
@@ -365,14 +519,8 @@ DenseMtx Raw_Encoder<Rnd_It, Fwd_It, Interleaved>::get_raw_symbols(
     uint16_t row = S_H;
     // now the C[0...K] symbols follow
     for (; row < S_H + _interleaver->source_symbols (_SBN); ++row) {
-        auto symbol = C[row - S_H];
-        uint16_t col = 0;
-        for (uint16_t i = 0; i < _interleaver->symbol_size(); ++i) {
-            T val = symbol[i];
-            uint8_t *octet = reinterpret_cast<uint8_t *> (&val);
-            for (uint8_t byte = 0; byte < sizeof(T); ++byte)
-                D (row, col++) = *(octet++);
-        }
+        C[row - S_H].copy_to (reinterpret_cast<uint8_t *> (D.data() +
+                                                            row * D.cols()));
     }
 
     // finally fill with eventual padding symbols (K...K_padded)
@@ -416,6 +564,69 @@ bool Raw_Encoder<Rnd_It, Fwd_It, Interleaved>::generate_symbols (
     return compute_intermediate (D, thread_keep_working);
 }
 
+// GENERATE - interleaved, NON precomputed, multiple blocks
+template <typename Rnd_It, typename Fwd_It, typename Interleaved>
+template <typename R_It, typename F_It, typename I,
+                                typename std::enable_if<I::value, int>::type>
+bool Raw_Encoder<Rnd_It, Fwd_It, Interleaved>::generate_symbols (
+                                const std::vector<Raw_Encoder*> &others,
+                                RaptorQ__v1::Work_State *thread_keep_working)
+{
+    std::vector<Raw_Encoder*> group;
+    if (encoded_symbols.cols() == 0)
+        group.push_back (this);
+    for (auto enc : others) {
+        if (enc != this && enc->_symbols == _symbols &&
+                                                enc->encoded_symbols.cols() == 0)
+            group.push_back (enc);
+    }
+    if (group.size() == 0)
+        return true;
+    Raw_Encoder *lead = group[0];
+
+    // D of each block is a column slice of the big D
+    auto ksh = lead->init_ksh();
+    DenseMtx D;
+    int64_t cols = 0;
+    for (size_t idx = 0; idx < group.size(); ++idx) {
+        // reading many blocks takes a while. The interleaver might be gone.
+        if (group[idx]->is_stopped())
+            return false;
+        const DenseMtx block = group[idx]->get_raw_symbols (ksh.first,
+                                                                ksh.second);
+        if (idx == 0) {
+            cols = block.cols();
+            D = DenseMtx (block.rows(),
+                                cols * static_cast<int64_t> (group.size()));
+        }
+        D.middleCols (static_cast<int64_t> (idx) * cols, cols) = block;
+    }
+    if (!lead->compute_intermediate (D, thread_keep_working))
+        return false;
+    D = DenseMtx(); // free some memory
+    if (group.size() == 1)
+        return true;
+    const DenseMtx wide = std::move (lead->encoded_symbols);
+    for (size_t idx = 0; idx < group.size(); ++idx) {
+        Raw_Encoder *enc = group[idx];
+        // repair symbols only need the parameters: no gen() needed.
+        if (enc != lead) {
+            if (enc->_type == Save_Computation::ON) {
+                enc->precode_on = std::unique_ptr<Precode_Matrix<
+                            Save_Computation::ON>> (new Precode_Matrix<
+                            Save_Computation::ON> (Parameters (_symbols)));
+            } else {
+                enc->precode_off = std::unique_ptr<Precode_Matrix<
+                            Save_Computation::OFF>> (new Precode_Matrix<
+                            Save_Computation::OFF> (Parameters (_symbols)));
+            }
+        }
+        enc->encoded_symbols = wide.middleCols (static_cast<int64_t> (idx) *
+                                                                cols, cols);
+    }
+    return true;
+}
+
 // GENERATE - NON interleaved, precomputed
 template <typename Rnd_It, typename Fwd_It, typename Interleaved>
 template <typename R_It, typename F_It, typename I,
@@ -433,11 +644,52 @@ bool Raw_Encoder<Rnd_It, Fwd_It, Interleaved>::generate_symbols (
     const uint16_t S_H = precode_on->_params.S + precode_on->_params.H;
     const uint16_t K_S_H = precode_on->_params.K_padded + S_H;
 
+    if (contiguous_input) {
+        generate_mapped (precomputed, S_H);
+        return true;
+    }
     const DenseMtx D = get_raw_symbols (K_S_H, S_H);
     encoded_symbols = precomputed * D;
     return true;
 }
 
+template <typename Rnd_It, typename Fwd_It, typename Interleaved>
+template <typename R_It, typename F_It, typename I,
+                                typename std::enable_if<!I::value, int>::type>
+void Raw_Encoder<Rnd_It, Fwd_It, Interleaved>::generate_mapped (
+                        const DenseMtx &precomputed, const uint16_t S_H)
+{
+    using T = typename std::iterator_traits<Rnd_It>::value_type;
+    using Const_Map = Eigen::Map<const DenseMtx>;
+    // the first S + H rows of D and the padding rows are zero, so they
+    // do not contribute to the product: only the K source rows are used.
+    const size_t bytes = static_cast<size_t> (*_to - *_from) * sizeof(T);
+    const uint16_t full = static_cast<uint16_t> (std::min<size_t> (_symbols,
+                                                        bytes / _symbol_size));
+    const int32_t size = static_cast<int32_t> (_symbol_size);
+    if (full > 0) {
+        const Const_Map source (reinterpret_cast<const Octet*> (&**_from),
+                                                                full, size);
+        encoded_symbols = precomputed.middleCols (S_H, full) * source;
+    } else {
+        encoded_symbols.setZero (precomputed.rows(), size);
+    }
+    if (full == _symbols)
+        return;
+    // last symbol is not complete, or there is less data than symbols:
+    // only these are copied, and padded with zeros.
+    DenseMtx tail (_symbols - full, size);
+    tail.setZero();
+    const uint8_t *p = reinterpret_cast<const uint8_t*> (&**_from) +
+                                                        full * _symbol_size;
+    for (size_t byte = full * _symbol_size; byte < bytes; ++byte, ++p) {
+        const size_t offset = byte - full * _symbol_size;
+        tail (static_cast<int32_t> (offset / _symbol_size),
+                        static_cast<int32_t> (offset % _symbol_size)) = *p;
+    }
+    encoded_symbols += precomputed.middleCols (S_H + full, tail.rows()) * tail;
+}
+
 // GENERATE - NON interleaved, NON precomputed
 template <typename Rnd_It, typename Fwd_It, typename Interleaved>
 template <typename R_It, typename F_It, typename I,
@@ -457,6 +709,24 @@ bool Raw_Encoder<Rnd_It, Fwd_It, Interleaved>::generate_symbols (
     _to = const_cast<Rnd_It*> (to);
     keep_working = true;
 
+    // With contiguous input we can avoid copying all the source symbols in D,
+    // but we need the precomputed matrix (L x L) instead.
+    // Building that is more work than solving with D, so we only use it
+    // when the cache already has it. Otherwise the solve below adds it.
+    if (contiguous_input && _type == Save_Computation::ON) {
+        const DenseMtx precomputed = cached_precomputed();
+        if (precomputed.rows() != 0) {
+            // repair symbols only need the parameters: no gen() needed.
+            if (precode_on == nullptr) {
+                precode_on = std::unique_ptr<Precode_Matrix<
+                            Save_Computation::ON>> (new Precode_Matrix<
+                            Save_Computation::ON> (Parameters (_symbols)));
+            }
+            generate_mapped (precomputed, precode_on->_params.S +
+                                                    precode_on->_params.H);
+            return true;
+        }
+    }
     auto ksh = init_ksh();
     DenseMtx D = get_raw_symbols (ksh.first, ksh.second);
     return compute_intermediate (D, thread_keep_working);
@@ -476,8 +746,9 @@ std::pair<uint16_t, uint16_t> Raw_Encoder<Rnd_It, Fwd_It, Interleaved>::
             precode_on = std::unique_ptr<Precode_Matrix<Save_Computation::ON>> (
                                     new Precode_Matrix<Save_Computation::ON> (
                                                         Parameters(_symbols)));
-            precode_on->gen(0);
         }
+        if (!precode_on->generated())
+            precode_on->gen(0);
         S_H = precode_on->_params.S + precode_on->_params.H;
         K_S_H = precode_on->_params.K_padded + S_H;
     } else {
@@ -486,7 +757,8 @@ std::pair<uint16_t, uint16_t> Raw_Encoder<Rnd_It, Fwd_It, Interleaved>::
                                     new Precode_Matrix<Save_Computation::OFF> (
                                                         Parameters(_symbols)));
         }
-        precode_off->gen(0);        
+        if (!precode_off->generated())
+            precode_off->gen(0);
         S_H = precode_off->_params.S + precode_off->_params.H;
         K_S_H = precode_off->_params.K_padded + S_H;
     }
@@ -500,20 +772,12 @@ bool Raw_Encoder<Rnd_It, Fwd_It, Interleaved>::compute_intermediate (
     Precode_Result precode_res;
     std::deque<Operation> ops;
     if (_type == Save_Computation::ON) {
-        const uint16_t size = precode_on->_params.L;
-        const auto tmp_bool = std::vector<bool>();
-        const Cache_Key key (size, 0, 0, tmp_bool, tmp_bool);
-        auto compressed = DLF<std::vector<uint8_t>, Cache_Key>::
-                                                            get()->get (key);
-        if (compressed.second.size() != 0) {
-            auto decompressed = decompress (compressed.first,compressed.second);
-            DenseMtx precomputed = raw_to_Mtx (decompressed, key.out_size());
-            if (precomputed.rows() != 0) {
-                // we have a precomputed matrix! let's use that!
-                encoded_symbols = precomputed * D;
-                // result is granted. we only save matrices that work
-                return true;
-            }
+        const DenseMtx precomputed = cached_precomputed();
+        if (precomputed.rows() != 0) {
+            // we have a precomputed matrix! let's use that!
+            encoded_symbols = precomputed * D;
+            // result is granted. we only save matrices that work
+            return true;
         }
         std::tie (precode_res, encoded_symbols) = precode_on->intermediate (D,
                                                         ops, keep_working,
@@ -526,11 +790,14 @@ bool Raw_Encoder<Rnd_It, Fwd_It, Interleaved>::compute_intermediate (
         // build the precomputed matrix.
         DenseMtx res;
         if (encoded_symbols.cols() != 0) {
+            const uint16_t size = precode_on->_params.L;
+            const auto tmp_bool = std::vector<bool>();
+            const Cache_Key key (size, 0, 0, tmp_bool, tmp_bool);
             res.setIdentity (size, size);
             for (const auto &op : ops)
                 op.build_mtx (res);
             auto raw_mtx = Mtx_to_raw (res);
-            compressed = compress (raw_mtx);
+            auto compressed = compress (raw_mtx);
             DLF<std::vector<uint8_t>, Cache_Key>::get()->add (compressed.first,
                                                         compressed.second, key);
         }
@@ -547,8 +814,8 @@ template <typename Rnd_It, typename Fwd_It, typename Interleaved>
 template <typename R_It, typename F_It, typename I,
                                 typename std::enable_if<I::value, int>::type>
 size_t Raw_Encoder<Rnd_It, Fwd_It, Interleaved>::Enc (const uint32_t ESI,
-                                                        Fwd_It &output,
-                                                        const Fwd_It end) const
+                                                        F_It &output,
+                                                        const F_It end) const
 {
     // returns iterators written
     // ESI means that the first _symbols.source_symbols() are the
@@ -566,7 +833,7 @@ size_t Raw_Encoder<Rnd_It, Fwd_It, Interleaved>::Enc (const uint32_t ESI,
         auto block = (*_interleaver)[_SBN];
         auto requested_symbol = block[static_cast<uint16_t> (ESI)];
 
-        typedef typename std::iterator_traits<Fwd_It>::value_type out_al;
+        typedef typename std::iterator_traits<F_It>::value_type out_al;
         size_t byte = 0;
         out_al tmp_out = 0;
         for (auto al : requested_symbol) {
@@ -601,73 +868,180 @@ template <typename Rnd_It, typename Fwd_It, typename Interleaved>
 template <typename R_It, typename F_It, typename I,
                                 typename std::enable_if<!I::value, int>::type>
 size_t Raw_Encoder<Rnd_It, Fwd_It, Interleaved>::Enc (const uint32_t ESI,
-                                                        Fwd_It &output,
-                                                        const Fwd_It end) const
+                                                        F_It &output,
+                                                        const F_It end) const
 {
     // returns iterators written
     // ESI means that the first _symbols.source_symbols() are the
     // original symbols, and the next ones are repair symbols.
+    if (_from == nullptr || _to == nullptr)
+        return 0;
 
-    // The alignment of "Fwd_It" might *NOT* be the alignment of "Rnd_It"
+    if (ESI < _symbols)
+        return Enc_source (ESI, output, end);
+    return Enc_repair (ESI, output, end);
+}
 
-    size_t written = 0;
-    if (_from == nullptr || _to == nullptr)
-        return written;
+template <typename Rnd_It, typename Fwd_It, typename Interleaved>
+template <typename R_It, typename F_It, typename I, typename std::enable_if<
+                                !I::value && is_contiguous<R_It>::value &&
+                                    is_contiguous<F_It>::value, int>::type>
+size_t Raw_Encoder<Rnd_It, Fwd_It, Interleaved>::Enc_source (
+                                                        const uint32_t ESI,
+                                                        F_It &output,
+                                                        const F_It end) const
+{
+    using in_T = typename std::iterator_traits<Rnd_It>::value_type;
+    using out_T = typename std::iterator_traits<F_It>::value_type;
+    if (output == end)
+        return 0;
+    const size_t out_size = std::min (static_cast<size_t> (end - output),
+                                    div_ceil<size_t> (_symbol_size,
+                                                            sizeof(out_T)));
+    const size_t bytes = std::min (_symbol_size, out_size * sizeof(out_T));
+    const size_t offset = ESI * _symbol_size;
+    const size_t in_size = static_cast<size_t> (*_to - *_from) * sizeof(in_T);
+    // past the end of the input there is only padding
+    const size_t from_input = offset >= in_size ? 0 :
+                                            std::min (bytes, in_size - offset);
+    uint8_t *out = out_bytes (output);
+    if (from_input > 0)
+        std::memcpy (out, in_bytes (*_from) + offset, from_input);
+    std::memset (out + from_input, 0, out_size * sizeof(out_T) - from_input);
+    output += static_cast<int64_t> (out_size);
+    return out_size;
+}
 
-    if (ESI < _symbols) {
-        // just return the source symbol.
-        typedef typename std::iterator_traits<Rnd_It>::value_type in_T;
-        typedef typename std::iterator_traits<Fwd_It>::value_type out_T;
-        const in_T padding = static_cast<in_T> (0);
-        const size_t skip_it = (ESI * _symbol_size) / sizeof(in_T);
-              size_t in_al   = (ESI * _symbol_size) % sizeof(in_T);
-        Rnd_It it = *_from + static_cast<int64_t> (skip_it);
-        uint8_t *p_in = reinterpret_cast<uint8_t*> (&*it);
-        if (it >= *_to)
-            p_in = reinterpret_cast<uint8_t*> (const_cast<in_T*> (&padding));
-        p_in += in_al;
-        size_t out_al = 0;
-        out_T tmp_out = static_cast<out_T> (0);
-        uint8_t *p_out = reinterpret_cast<uint8_t*> (&tmp_out);
-        size_t byte = 0;
-        while (output != end && byte != _symbol_size) {
-            *(p_out++) = *(p_in++);
-            ++out_al;
-            ++in_al;
-            ++byte;
-            if (in_al == sizeof(in_T)) {
-                in_al = 0;
-                ++it;
-                if (it < *_to) {
-                    p_in = reinterpret_cast<uint8_t*> (&*it);
-                } else {
-                    p_in = reinterpret_cast<uint8_t*> (const_cast<in_T*> (
-                                                                    &padding));
-                }
-            }
-            if (out_al == sizeof(out_T)) {
-                out_al = 0;
-                ++written;
-                *(output++) = tmp_out;
-                tmp_out = static_cast<out_T> (0);
-                p_out = reinterpret_cast<uint8_t*> (&tmp_out);
+template <typename Rnd_It, typename Fwd_It, typename Interleaved>
+template <typename R_It, typename F_It, typename I, typename std::enable_if<
+                                !I::value && !(is_contiguous<R_It>::value &&
+                                    is_contiguous<F_It>::value), int>::type>
+size_t Raw_Encoder<Rnd_It, Fwd_It, Interleaved>::Enc_source (
+                                                        const uint32_t ESI,
+                                                        F_It &output,
+                                                        const F_It end) const
+{
+    // The alignment of "Fwd_It" might *NOT* be the alignment of "Rnd_It"
+    size_t written = 0;
+    typedef typename std::iterator_traits<Rnd_It>::value_type in_T;
+    typedef typename std::iterator_traits<F_It>::value_type out_T;
+    const in_T padding = static_cast<in_T> (0);
+    const size_t skip_it = (ESI * _symbol_size) / sizeof(in_T);
+          size_t in_al   = (ESI * _symbol_size) % sizeof(in_T);
+    Rnd_It it = *_from + static_cast<int64_t> (skip_it);
+    uint8_t *p_in = reinterpret_cast<uint8_t*> (&*it);
+    if (it >= *_to)
+        p_in = reinterpret_cast<uint8_t*> (const_cast<in_T*> (&padding));
+    p_in += in_al;
+    size_t out_al = 0;
+    out_T tmp_out = static_cast<out_T> (0);
+    uint8_t *p_out = reinterpret_cast<uint8_t*> (&tmp_out);
+    size_t byte = 0;
+    while (output != end && byte != _symbol_size) {
+        *(p_out++) = *(p_in++);
+        ++out_al;
+        ++in_al;
+        ++byte;
+        if (in_al == sizeof(in_T)) {
+            in_al = 0;
+            ++it;
+            if (it < *_to) {
+                p_in = reinterpret_cast<uint8_t*> (&*it);
+            } else {
+                p_in = reinterpret_cast<uint8_t*> (const_cast<in_T*> (
+                                                                &padding));
             }
         }
-        if (out_al != 0) {
-            *(output++) = tmp_out;
+        if (out_al == sizeof(out_T)) {
+            out_al = 0;
             ++written;
+            *(output++) = tmp_out;
+            tmp_out = static_cast<out_T> (0);
+            p_out = reinterpret_cast<uint8_t*> (&tmp_out);
         }
-        return written;
-    } else {
-        return Enc_repair (ESI, output, end);
     }
+    if (out_al != 0) {
+        *(output++) = tmp_out;
+        ++written;
+    }
+    return written;
+}
+
+template <typename Rnd_It, typename Fwd_It, typename Interleaved>
+size_t Raw_Encoder<Rnd_It, Fwd_It, Interleaved>::Enc_batch (
+                                const uint32_t first, const uint32_t *ids,
+                                const uint32_t count, uint8_t *output,
+                                                    const size_t size) const
+{
+    if (!ready() || output == nullptr)
+        return 0;
+    const size_t symbol_size = static_cast<size_t> (encoded_symbols.cols());
+    const uint32_t fit = static_cast<uint32_t> (std::min<size_t> (count,
+                                                        size / symbol_size));
+    if (fit == 0)
+        return 0;
+    Octet *out = reinterpret_cast<Octet *> (output);
+    // same as Enc_repair: we might have been forced to use "precode_on"
+    if (_type == Save_Computation::ON || precode_off == nullptr) {
+        if (precode_on == nullptr)
+            return 0;
+        return Enc_batch (*precode_on, encoded_symbols, _symbols, first, ids,
+                                                                    fit, out);
+    }
+    return Enc_batch (*precode_off, encoded_symbols, _symbols, first, ids,
+                                                                    fit, out);
+}
+
+template <typename Rnd_It, typename Fwd_It, typename Interleaved>
+template <typename Precode>
+uint32_t Raw_Encoder<Rnd_It, Fwd_It, Interleaved>::Enc_batch (
+                                const Precode &precode, const DenseMtx &C,
+                                const uint16_t symbols, const uint32_t first,
+                                const uint32_t *ids, const uint32_t count,
+                                Octet *output)
+{
+    // same limit as Encoder::max_repair(): the ISI must not overflow.
+    const uint32_t last = std::numeric_limits<uint32_t>::max() -
+                                                            precode._params.L;
+    const uint32_t padding = precode._params.K_padded - symbols;
+    std::vector<Tuple> tuples;
+    tuples.reserve (count);
+    for (uint32_t idx = 0; idx < count; ++idx) {
+        const uint32_t esi = ids == nullptr ? first + idx : ids[idx];
+        if (esi > last)
+            break;
+        tuples.push_back (precode.tuple (esi < symbols ? esi : esi + padding));
+    }
+    const uint32_t todo = static_cast<uint32_t> (tuples.size());
+    if (todo == 0)
+        return 0;
+    // a few chunks per thread, so that the faster ones can steal work.
+    // small batches are not worth waking up the pool.
+    const uint32_t min_chunk = 32;
+    auto &pool = RFC6330__v1::Impl::Thread_Pool::get();
+    const uint32_t threads = static_cast<uint32_t> (pool.size());
+    const uint32_t chunk = std::max (min_chunk, todo / (4 * (threads + 1)));
+    auto batch = std::make_shared<Symbol_Batch<Precode>> (precode, C,
+                                            std::move (tuples), output, chunk);
+    const uint32_t chunks = (todo + chunk - 1) / chunk;
+    for (uint32_t idx = 1; idx < chunks && idx <= threads; ++idx) {
+        std::unique_ptr<Symbol_Batch_Work<Precode>> work (
+                                            new Symbol_Batch_Work<Precode>());
+        work->batch = batch;
+        pool.add_work (std::move (work));
+    }
+    while (batch->run_chunk())
+        {}
+    batch->wait();
+    return todo;
 }
 
 // repair symbol only - no need to diffenretiate between (non)interleaved
 template <typename Rnd_It, typename Fwd_It, typename Interleaved>
+template <typename F_It>
 size_t Raw_Encoder<Rnd_It, Fwd_It, Interleaved>::Enc_repair (const uint32_t ESI,
-                                                        Fwd_It &output,
-                                                        const Fwd_It end) const
+                                                        F_It &output,
+                                                        const F_It end) const
 {
     size_t written = 0;
     // repair symbol requested.
@@ -702,12 +1076,44 @@ size_t Raw_Encoder<Rnd_It, Fwd_It, Interleaved>::Enc_repair (const uint32_t ESI,
     }
 
     // put "tmp" in output, but the alignment is different
+    return write_symbol (tmp.data(), static_cast<size_t> (tmp.cols()),
+                                                                output, end);
+}
+
+template <typename Rnd_It, typename Fwd_It, typename Interleaved>
+template <typename F_It,
+            typename std::enable_if<is_contiguous<F_It>::value, int>::type>
+size_t Raw_Encoder<Rnd_It, Fwd_It, Interleaved>::write_symbol (
+                                        const Octet *symbol, const size_t size,
+                                        F_It &output, const F_It end)
+{
+    using T = typename std::iterator_traits<F_It>::value_type;
+    if (output == end)
+        return 0;
+    const size_t out_size = std::min (static_cast<size_t> (end - output),
+                                            div_ceil<size_t> (size, sizeof(T)));
+    const size_t bytes = std::min (size, out_size * sizeof(T));
+    uint8_t *out = out_bytes (output);
+    std::memcpy (out, symbol, bytes);
+    // symbol size is not aligned with Fwd_It type
+    std::memset (out + bytes, 0, out_size * sizeof(T) - bytes);
+    output += static_cast<int64_t> (out_size);
+    return out_size;
+}
 
-    using T = typename std::iterator_traits<Fwd_It>::value_type;
+template <typename Rnd_It, typename Fwd_It, typename Interleaved>
+template <typename F_It,
+            typename std::enable_if<!is_contiguous<F_It>::value, int>::type>
+size_t Raw_Encoder<Rnd_It, Fwd_It, Interleaved>::write_symbol (
+                                        const Octet *symbol, const size_t size,
+                                        F_It &output, const F_It end)
+{
+    using T = typename std::iterator_traits<F_It>::value_type;
+    size_t written = 0;
     T al = static_cast<T> (0);
     uint8_t *p = reinterpret_cast<uint8_t *>  (&al);
-    for (int32_t i = 0; i < tmp.cols(); ++i) {
-        *p = static_cast<uint8_t> (tmp (0, i));
+    for (size_t i = 0; i < size; ++i) {
+        *p = static_cast<uint8_t> (symbol[i]);
         ++p;
         if (p == reinterpret_cast<uint8_t *>  (&al) + sizeof(T)) {
             *output = al;
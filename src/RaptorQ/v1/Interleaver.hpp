@@ -23,8 +23,11 @@
 #include "RaptorQ/v1/common.hpp"
 #include "RaptorQ/v1/multiplication.hpp"
 #include "RaptorQ/v1/table2.hpp"
+#include "RaptorQ/v1/util/contiguous.hpp"
 #include "RaptorQ/v1/util/div.hpp"
+#include <algorithm>
 #include <cmath>
+#include <cstring>
 #include <limits>
 #include <memory>
 #include <tuple>
@@ -224,6 +227,30 @@ public:
         }
         return *data;
     }
+    // write the whole symbol (with padding) in "out", as
+    // (_sub_blocks.tot (0) + _sub_blocks.tot (1)) * sizeof(T) bytes.
+    // Each sub-symbol is a contiguous run of the input, so we copy
+    // one run at a time instead of computing each element's position.
+    void copy_to (uint8_t *out) const
+    {
+        const size_t data_size = static_cast<size_t> (_data_to - _data_from);
+        size_t part_start = _start;
+        for (uint8_t part = 0; part < 2; ++part) {
+            const size_t run = _sub_blocks.size (part);
+            for (uint16_t sub_blk = 0; sub_blk < _sub_blocks.num (part);
+                                                                    ++sub_blk) {
+                const size_t from = part_start + sub_blk * _k * run +
+                                                            _symbol_id * run;
+                const size_t real = from >= data_size ? 0 :
+                                        std::min (run, data_size - from);
+                copy_run (out, from, real);
+                std::memset (out + real * sizeof(T), 0,
+                                                    (run - real) * sizeof(T));
+                out += run * sizeof(T);
+            }
+            part_start += static_cast<size_t> (_sub_blocks.tot (part)) * _k;
+        }
+    }
     T operator* () const
         { return (*this)[_idx]; }
     Symbol_it<Rnd_It> operator++ (int i) const
@@ -250,6 +277,29 @@ private:
     size_t _idx;
     const Partition _sub_blocks;
     const uint16_t _symbol_id, _k;
+
+    template <typename R_It = Rnd_It, typename std::enable_if<
+            RaptorQ__v1::Impl::is_contiguous<R_It>::value, int>::type = 0>
+    void copy_run (uint8_t *out, const size_t from, const size_t elements)
+                                                                        const
+    {
+        if (elements != 0) {
+            std::memcpy (out, RaptorQ__v1::Impl::in_bytes (_data_from +
+                                            static_cast<int64_t> (from)),
+                                                    elements * sizeof(T));
+        }
+    }
+    template <typename R_It = Rnd_It, typename std::enable_if<
+            !RaptorQ__v1::Impl::is_contiguous<R_It>::value, int>::type = 0>
+    void copy_run (uint8_t *out, const size_t from, const size_t elements)
+                                                                        const
+    {
+        auto data = _data_from + static_cast<int64_t> (from);
+        for (size_t idx = 0; idx < elements; ++idx, ++data) {
+            const T val = *data;
+            std::memcpy (out + idx * sizeof(T), &val, sizeof(T));
+        }
+    }
 };
 
 //
@@ -334,6 +384,11 @@ public:
                                             const uint16_t min_subsymbol_size,
                                             const size_t max_block_decodable,
                                             const uint16_t symbol_syze);
+    // only the partitioning of an object of "size" bytes, without its data.
+    // use "block()" to read the source blocks.
+    Interleaver (const uint64_t size, const uint16_t min_subsymbol_size,
+                                            const size_t max_block_decodable,
+                                            const uint16_t symbol_syze);
     Interleaver() = delete;
     Interleaver (const Interleaver&) = default;
     Interleaver& operator= (const Interleaver&) = default;
@@ -345,6 +400,9 @@ public:
     Interleaver<Rnd_It>& operator++();
     Source_Block<Rnd_It> operator*() const;
     Source_Block<Rnd_It> operator[] (uint8_t source_block_id) const;
+    // source block "source_block_id", when only its data is in [from, to)
+    Source_Block<Rnd_It> block (const uint8_t source_block_id,
+                                const Rnd_It from, const Rnd_It to) const;
     Partition get_partition() const;
     uint16_t source_symbols (const uint8_t SBN) const;
     Block_Size extended_symbols (const uint8_t SBN) const;
@@ -365,6 +423,12 @@ private:
     // Same names are kept to better track the rfc
     // (SIZE, SIZE, BLOCKNUM, BLOCKNUM) for:
     Partition _source_part, _sub_part;
+
+    void init (const uint64_t input_size, const uint16_t min_subsymbol_size,
+                                                    const size_t max_sub_block);
+    // start and end (in alignments) of a source block in the object
+    std::pair<size_t, size_t> block_range (const uint8_t source_block_id)
+                                                                        const;
 };
 
 ///////////////////////////////////
@@ -383,6 +447,32 @@ Interleaver<Rnd_It>::Interleaver (const Rnd_It data_from,
         _alignment (sizeof(typename std::iterator_traits<Rnd_It>::value_type))
 {
     IS_RANDOM(Rnd_It, "RaptorQ__v1::Impl::Interleaver");
+    init (static_cast<uint64_t> (_data_to - _data_from) * _alignment,
+                                            min_subsymbol_size, max_sub_block);
+}
+
+template <typename Rnd_It>
+Interleaver<Rnd_It>::Interleaver (const uint64_t size,
+                                            const uint16_t min_subsymbol_size,
+                                            const size_t max_sub_block,
+                                            const uint16_t symbol_size)
+    :_data_from(), _data_to(), _symbol_size (symbol_size),
+        _alignment (sizeof(typename std::iterator_traits<Rnd_It>::value_type))
+{
+    IS_RANDOM(Rnd_It, "RaptorQ__v1::Impl::Interleaver");
+    if (size % _alignment != 0) {
+        _alignment = 0;
+        return;
+    }
+    init (size, min_subsymbol_size, max_sub_block);
+}
+
+template <typename Rnd_It>
+void Interleaver<Rnd_It>::init (const uint64_t input_size,
+                                            const uint16_t min_subsymbol_size,
+                                            const size_t max_sub_block)
+{
+    const uint16_t symbol_size = _symbol_size;
     // all parameters are in octets
     assert(_symbol_size >= _alignment &&
                     "RaptorQ: symbol_size must be >= alignment");
@@ -456,9 +546,6 @@ Interleaver<Rnd_It>::Interleaver (const Rnd_It data_from,
     //
 
     std::vector<uint16_t> sizes;
-    size_t iter_size =sizeof(typename std::iterator_traits<Rnd_It>::value_type);
-    const uint64_t input_size =
-                    static_cast<uint64_t> (_data_to - _data_from) * iter_size;
     const uint64_t Kt = div_ceil<uint64_t> (input_size, symbol_size);
     const size_t N_max = static_cast<size_t> (div_floor (_symbol_size,
                                                         min_subsymbol_size));
@@ -530,8 +617,8 @@ Interleaver<Rnd_It>::operator bool() const
 }
 
 template <typename Rnd_It>
-Source_Block<Rnd_It> Interleaver<Rnd_It>::operator[] (
-                                                uint8_t source_block_id) const
+std::pair<size_t, size_t> Interleaver<Rnd_It>::block_range (
+                                        const uint8_t source_block_id) const
 {
     // now we start working with multiples of T.
     // identify the start and end of the requested block.
@@ -543,9 +630,7 @@ Source_Block<Rnd_It> Interleaver<Rnd_It>::operator[] (
                                                                 al_symbol_size;
         size_t sb_end = (source_block_id + 1) * _source_part.size(0) *
                                                                 al_symbol_size;
-
-        return Source_Block<Rnd_It> (_data_from, _data_to, sb_start, sb_end, 0,
-                                                    _sub_part, al_symbol_size);
+        return {sb_start, sb_end};
     } else if (source_block_id - _source_part.num(0) < _source_part.num(1)) {
         // start == all the previous partition
         size_t sb_start = _source_part.tot(0) * al_symbol_size +
@@ -553,14 +638,31 @@ Source_Block<Rnd_It> Interleaver<Rnd_It>::operator[] (
                                     (source_block_id - _source_part.num(0)) *
                                         _source_part.size(1) * al_symbol_size;
         size_t sb_end =  sb_start + _source_part.size(1) * al_symbol_size;
-
-        return Source_Block<Rnd_It> (_data_from, _data_to, sb_start, sb_end, 0,
-                                                    _sub_part, al_symbol_size);
-    } else  {
-        assert(false && "RaptorQ: source_block_id out of range");
-        return Source_Block<Rnd_It> (_data_from, _data_to, 0, 0, 0, _sub_part,
-                                                                al_symbol_size);
+        return {sb_start, sb_end};
     }
+    assert(false && "RaptorQ: source_block_id out of range");
+    return {0, 0};
+}
+
+template <typename Rnd_It>
+Source_Block<Rnd_It> Interleaver<Rnd_It>::operator[] (
+                                                uint8_t source_block_id) const
+{
+    const auto range = block_range (source_block_id);
+    return Source_Block<Rnd_It> (_data_from, _data_to, range.first,
+                                        range.second, 0, _sub_part,
+                                        symbol_size());
+}
+
+template <typename Rnd_It>
+Source_Block<Rnd_It> Interleaver<Rnd_It>::block (
+                                                const uint8_t source_block_id,
+                                                const Rnd_It from,
+                                                const Rnd_It to) const
+{
+    const auto range = block_range (source_block_id);
+    return Source_Block<Rnd_It> (from, to, 0, range.second - range.first, 0,
+                                                    _sub_part, symbol_size());
 }
 
 template <typename Rnd_It>
@@ -23,6 +23,7 @@
 #include "RaptorQ/v1/common.hpp"
 #include "RaptorQ/v1/multiplication.hpp"
 #include <cmath>
+#include <cstring>
 #include <Eigen/Core>
 #include <vector>
 
@@ -128,6 +129,27 @@ private:
 
 inline uint8_t abs (Octet x) { return static_cast<uint8_t> (x); }
 
+static_assert (sizeof(Octet) == 1, "RaptorQ: Octet must be a single byte");
+
+// dst += src, on a whole row of octets.
+// Eigen does not vectorize our Octet, but adding is just a xor, so we can
+// work on whole words and let the compiler use the vector registers.
+inline void add_octets (Octet *dst, const Octet *src, const size_t octets)
+{
+    uint8_t *out = reinterpret_cast<uint8_t *> (dst);
+    const uint8_t *in = reinterpret_cast<const uint8_t *> (src);
+    size_t idx = 0;
+    for (; idx + sizeof(uint64_t) <= octets; idx += sizeof(uint64_t)) {
+        uint64_t a, b;
+        std::memcpy (&a, out + idx, sizeof(uint64_t));
+        std::memcpy (&b, in + idx, sizeof(uint64_t));
+        a ^= b;
+        std::memcpy (out + idx, &a, sizeof(uint64_t));
+    }
+    for (; idx < octets; ++idx)
+        out[idx] ^= in[idx];
+}
+
 }   // namespace Impl
 }   // namespace RaptorQ
 
@@ -24,7 +24,8 @@
 #include "RaptorQ/v1/degree.hpp"
 #include "RaptorQ/v1/Rand.hpp"
 #include "RaptorQ/v1/table2.hpp"
-#include <cmath>
+#include <algorithm>
+#include <array>
 #include <Eigen/Core>
 #include <vector>
 
@@ -50,6 +51,27 @@ public:
     uint16_t d, a, b, d1, a1, b1;   // great names. thanks rfc6330!
 };
 
+// the indexes of the intermediate symbols that make up an encoded symbol.
+// at most 30 LT + 3 PI symbols: fixed size, so we never allocate.
+class RAPTORQ_LOCAL Idxs
+{
+public:
+    Idxs() : _size (0) {}
+    void push_back (const uint16_t idx)
+        { _idx[_size++] = idx; }
+    const uint16_t* begin() const
+        { return _idx.data(); }
+    const uint16_t* end() const
+        { return _idx.data() + _size; }
+    size_t size() const
+        { return _size; }
+    uint16_t operator[] (const size_t pos) const
+        { return _idx[pos]; }
+private:
+    std::array<uint16_t, 33> _idx;
+    uint8_t _size;
+};
+
 class RAPTORQ_API Parameters
 {
 public:
@@ -64,6 +86,10 @@ public:
     uint16_t Deg (const uint32_t v) const;
     Tuple tuple (const uint32_t ISI) const;
     std::vector<uint16_t> get_idxs (const uint32_t ISI) const;
+    std::vector<uint16_t> get_idxs (Tuple t) const;
+    // same as get_idxs, without allocations
+    Idxs idxs (const uint32_t ISI) const;
+    Idxs idxs (Tuple t) const;
 
     uint16_t K_padded, S, H, W, L, P, P1, U, B; // RFC 6330, pg 22
     uint16_t J;
@@ -74,16 +100,21 @@ private:
 
 inline Parameters::Parameters (const uint16_t symbols)
 {
-    uint16_t idx;
-    for (idx = 0; idx < RaptorQ__v1::Impl::K_padded.size(); ++idx) {
-        if (RaptorQ__v1::Impl::K_padded[idx] >= symbols) {
-            K_padded = RaptorQ__v1::Impl::K_padded[idx];
-            break;
-        }
-    }
+    // no K' for more than K_max symbols: use the biggest one.
+    // callers never go past it, the RFC limits the block size.
+    assert (symbols <= RaptorQ__v1::Impl::K_max &&
+                                            "Parameters: too many symbols");
+    // the table is sorted
+    const auto it = std::lower_bound (RaptorQ__v1::Impl::K_padded.begin(),
+                            RaptorQ__v1::Impl::K_padded.end() - 1, symbols);
+    const auto idx = static_cast<size_t> (it -
+                                        RaptorQ__v1::Impl::K_padded.begin());
+    K_padded = *it;
 
     J = RaptorQ__v1::Impl::J_K_padded[idx];
-    std::tie (S, H, W) = RaptorQ__v1::Impl::S_H_W [idx];
+    S = RaptorQ__v1::Impl::S_H_W[idx][0];
+    H = RaptorQ__v1::Impl::S_H_W[idx][1];
+    W = RaptorQ__v1::Impl::S_H_W[idx][2];
 
     L = K_padded + S + H;
     P = L - W;
@@ -119,12 +150,15 @@ inline bool Parameters::is_prime (const uint16_t n)
 inline uint16_t Parameters::Deg (const uint32_t v) const
 {
     // rfc 6330, pg 27
-
-    for (uint16_t d = 0; d < RaptorQ__v1::Impl::degree_distribution.size();++d){
-        if (v < RaptorQ__v1::Impl::degree_distribution[d])
-            return (d < (W - 2)) ? d : (W - 2);
-    }
-    return 0;   // never get here, but don't make the compiler complain
+    // first d so that v < degree_distribution[d]. the table is sorted.
+    const auto it = std::upper_bound (
+                        RaptorQ__v1::Impl::degree_distribution.begin(),
+                        RaptorQ__v1::Impl::degree_distribution.end(), v);
+    if (it == RaptorQ__v1::Impl::degree_distribution.end())
+        return 0;   // never get here, but don't make the compiler complain
+    const auto d = static_cast<uint16_t> (it -
+                            RaptorQ__v1::Impl::degree_distribution.begin());
+    return (d < (W - 2)) ? d : (W - 2);
 }
 
 inline Tuple RaptorQ__v1::Impl::Parameters::tuple (const uint32_t ISI) const
@@ -142,7 +176,7 @@ inline Tuple RaptorQ__v1::Impl::Parameters::tuple (const uint32_t ISI) const
         ++A;
     size_t B1 = 10267 * (J + 1);
     uint32_t y = static_cast<uint32_t> (B1 + ISI * A);
-    uint32_t v = rnd_get (y, 0, static_cast<uint32_t> (std::pow(2, 20)));
+    uint32_t v = rnd_get (y, 0, 1 << 20);
     ret.d = Deg (v);
     ret.a = 1 + static_cast<uint16_t> (rnd_get (y, 1, W - 1));
     ret.b = static_cast<uint16_t> (rnd_get (y, 2, W));
@@ -158,16 +192,26 @@ inline Tuple RaptorQ__v1::Impl::Parameters::tuple (const uint32_t ISI) const
 }
 
 inline std::vector<uint16_t> Parameters::get_idxs (const uint32_t ISI) const
+    { return get_idxs (tuple (ISI)); }
+
+inline std::vector<uint16_t> Parameters::get_idxs (Tuple t) const
+{
+    const Idxs ret = idxs (t);
+    return std::vector<uint16_t> (ret.begin(), ret.end());
+}
+
+inline Idxs Parameters::idxs (const uint32_t ISI) const
+    { return idxs (tuple (ISI)); }
+
+inline Idxs Parameters::idxs (Tuple t) const
 {
     // Needed to generate G_ENC: We need the ids of the symbols we would
     // use on a "Enc" call. So this is the "enc algorithm, but returns the
     // indexes instead of computing the result.
     // rfc6330, pg29
 
-    std::vector<uint16_t> ret;
-    Tuple t = tuple (ISI);
+    Idxs ret;
 
-    ret.reserve (t.d + t.d1);
     ret.push_back (t.b);
 
     for (uint16_t j = 1; j < t.d; ++j) {
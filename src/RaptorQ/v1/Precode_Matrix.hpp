@@ -20,7 +20,9 @@
 
 #pragma once
 
+#include "RaptorQ/v1/Shared_Computation/Plan_Registry.hpp"
 #include "RaptorQ/v1/util/Bitmask.hpp"
+#include "RaptorQ/v1/util/Symbol_Store.hpp"
 #include "RaptorQ/v1/common.hpp"
 #include "RaptorQ/v1/multiplication.hpp"
 #include "RaptorQ/v1/Operation.hpp"
@@ -55,7 +57,7 @@ public:
     const Parameters _params;
 
     Precode_Matrix(const Parameters &params)
-        :_params (params)
+        :_params (params), _plan (Plan_Registry::get().find (params.K_padded))
     {}
     Precode_Matrix() = delete;
     Precode_Matrix (const Precode_Matrix&) = default;
@@ -65,6 +67,16 @@ public:
     ~Precode_Matrix() = default;
 
     void gen (const uint32_t repair_overhead);
+    // gen() was called, and no solve has touched the matrix since then
+    bool generated() const
+        { return _generated; }
+    // the shared plan of K', after gen().
+    // nullptr if K' is too big for the Plan_Registry.
+    std::shared_ptr<const Plan> plan() const
+        { return _plan; }
+    // LDPC and HDPC rows (S + H) of the matrix built by gen()
+    DenseMtx constraints() const
+        { return A.block (0, 0, _params.S + _params.H, A.cols()); }
 
 
     std::pair<Precode_Result, DenseMtx> intermediate (DenseMtx &D, Op_Vec &ops,
@@ -75,12 +87,45 @@ public:
                                         const std::vector<uint32_t> &repair_esi,
                                         Op_Vec &ops, bool &keep_working,
                                         const Work_State *thread_keep_working);
+    // after a FAILED intermediate(), the partially solved system is kept.
+    // new symbols (by ISI, data in "rows") can be eliminated against it
+    // and the solving resumes from where it stopped.
+    bool can_resume() const
+        { return _resumable; }
+    std::pair<Precode_Result, DenseMtx> intermediate_resume (DenseMtx &D,
+                                        const std::vector<uint32_t> &isis,
+                                        const DenseMtx &rows, Op_Vec &ops,
+                                        bool &keep_working,
+                                        const Work_State *thread_keep_working);
     DenseMtx get_missing (const DenseMtx &C, const Bitmask &mask) const;
+    // decode starting from the solution of the systematic (no loss) system,
+    // "inverse" is the cached encoder matrix. Work is proportional to the
+    // number of holes. "source" are the source symbols (holes are ignored),
+    // "repairs" the repair symbols in "repair_esi". no gen() needed.
+    // returns the missing symbols, not the intermediate ones.
+    std::pair<Precode_Result, DenseMtx> low_rank (const DenseMtx &inverse,
+                                const DenseMtx &source, const Bitmask &mask,
+                                const std::vector<uint32_t> &repair_esi,
+                                const Symbol_Store::Rows &repairs) const;
     DenseMtx encode (const DenseMtx &C, const uint32_t ISI) const;
+    // same, but write the C.cols() octets directly in "output"
+    void encode (const DenseMtx &C, const uint32_t ISI, Octet *output) const;
+    // same, from the tuple of the ISI
+    void encode (const DenseMtx &C, Tuple t, Octet *output) const;
+    // the plan has the tuples of the most used ISIs
+    Tuple tuple (const uint32_t ISI) const
+        { return _plan != nullptr ? _plan->tuple (ISI) : _params.tuple (ISI); }
 
 private:
+    std::shared_ptr<const Plan> _plan;
     DenseMtx A;
     uint32_t _repair_overhead = 0;
+    bool _generated = false;
+    // state of the last solve, used to resume it after a failure
+    DenseMtx _X;
+    std::vector<uint16_t> _c;
+    uint16_t _i = 0, _u = 0, _phase2_row = 0;
+    bool _resumable = false;
 
     // indenting here prepresent which function needs which other.
     // not standard, ask me if I care.
@@ -94,7 +139,9 @@ private:
     void init_HDPC (DenseMtx &_A) const;
         DenseMtx make_MT() const;       // rfc 6330, pgg 24, used for HDPC
         DenseMtx make_GAMMA() const;    // rfc 6330, pgg 24, used for HDPC
-    void add_G_ENC (DenseMtx &_A) const;
+    void add_G_ENC (DenseMtx &_A, const std::vector<Tuple> &tuples) const;
+    Idxs get_idxs (const uint32_t ISI) const
+        { return _params.idxs (tuple (ISI)); }
 
     //DenseMtx intermediate (DenseMtx &D, Op_Vec &ops, bool &keep_working);
     void decode_phase0 (const Bitmask &mask,
@@ -106,6 +153,11 @@ private:
     bool decode_phase2 (DenseMtx &D, const uint16_t i,const uint16_t u,
                                         Op_Vec &ops, bool &keep_working,
                                         const Work_State *thread_keep_working);
+    void decode_add_rows (DenseMtx &D, const std::vector<uint32_t> &isis,
+                                                        const DenseMtx &rows);
+    std::pair<Precode_Result, DenseMtx> solve_U (DenseMtx &D, Op_Vec &ops,
+                                        bool &keep_working,
+                                        const Work_State *thread_keep_working);
     void decode_phase3 (const DenseMtx &X, DenseMtx &D, const uint16_t i,
                                         Op_Vec &ops);
     void decode_phase4 (DenseMtx &D, const uint16_t i, const uint16_t u,
@@ -22,6 +22,7 @@
 
 #include "RaptorQ/v1/Precode_Matrix.hpp"
 #include "RaptorQ/v1/Rand.hpp"
+#include "RaptorQ/v1/Shared_Computation/Plan_Registry.hpp"
 #include <limits>
 
 ///////////////////
@@ -41,21 +42,35 @@ template<Save_Computation IS_OFFLINE>
 void Precode_Matrix<IS_OFFLINE>::gen (const uint32_t repair_overhead)
 {
     _repair_overhead = repair_overhead;
-    DenseMtx _A = DenseMtx (_params.L + repair_overhead, _params.L);
-
-    init_LDPC1 (_A, _params.S, _params.B);
-    add_identity (_A, _params.S, 0, _params.B);
-    init_LDPC2 (_A, _params.W, _params.S, _params.P);
-    init_HDPC (_A);
-    add_identity (_A, _params.H, _params.S, _params.L - _params.H);
-    add_G_ENC (_A);
+    // the first L rows only depend on K', and are shared.
+    if (_plan == nullptr)
+        _plan = Plan_Registry::get().find (_params.K_padded);
+    // the solver works in place, so we need our copy.
+    A = DenseMtx (_params.L + repair_overhead, _params.L);
+    if (_plan != nullptr) {
+        A.block (0, 0, _params.L, _params.L) = _plan->_A;
+    } else {
+        auto tuples = Plan::make_tuples (_params);
+
+        init_LDPC1 (A, _params.S, _params.B);
+        add_identity (A, _params.S, 0, _params.B);
+        init_LDPC2 (A, _params.W, _params.S, _params.P);
+        init_HDPC (A);
+        add_identity (A, _params.H, _params.S, _params.L - _params.H);
+        add_G_ENC (A, tuples);
+        // plans too big for the registry are not even built:
+        // it would be a second copy of A, only to be dropped.
+        if (Plan_Registry::get().fits (Plan::bytes (_params))) {
+            _plan = Plan_Registry::get().add (std::make_shared<const Plan> (
+                                _params, DenseMtx (A.block (0, 0, _params.L,
+                                                            _params.L)),
+                                                        std::move (tuples)));
+        }
+    }
     // G_ENC only fills up to L rows, but we might have overhead.
     // initialize it.
-    for (uint16_t row = _params.L; row < A.rows(); ++row) {
-        for (uint16_t col = 0; col < A.cols(); ++col)
-            _A (row, col) = 0;
-    }
-    A = std::move (_A);
+    A.block (_params.L, 0, repair_overhead, _params.L).setZero();
+    _generated = true;
 }
 
 template<Save_Computation IS_OFFLINE>
@@ -187,7 +202,8 @@ void Precode_Matrix<IS_OFFLINE>::init_HDPC (DenseMtx &_A) const
 }
 
 template<Save_Computation IS_OFFLINE>
-void Precode_Matrix<IS_OFFLINE>::add_G_ENC (DenseMtx &_A) const
+void Precode_Matrix<IS_OFFLINE>::add_G_ENC (DenseMtx &_A,
+                                        const std::vector<Tuple> &tuples) const
 {
     // rfc 6330, pg 26
     for (uint16_t row = _params.S + _params.H; row < _params.L; ++row) {
@@ -195,7 +211,7 @@ void Precode_Matrix<IS_OFFLINE>::add_G_ENC (DenseMtx &_A) const
         for (uint16_t col = 0; col < _params.L; ++col)
             _A (row, col) = 0;
         // only overwrite with ones the columns that need it
-        auto idxs = _params.get_idxs ((row - _params.S) - _params.H);
+        auto idxs = _params.idxs (tuples[(row - _params.S) - _params.H]);
         for (auto idx : idxs)
             _A (row, idx) = 1;
     }
@@ -49,49 +49,79 @@ std::pair<Precode_Result, DenseMtx> Precode_Matrix<IS_OFFLINE>::intermediate (
     // than actually having "d". so we're left only with "c",
     // which is needed 'cause D does not have _params.L columns.
 
-    std::vector<uint16_t> c;
-
-    c.clear();
-    c.reserve (_params.L);
-    DenseMtx C, X = A;
+    _c.clear();
+    _c.reserve (_params.L);
+    _X = A;
+    _resumable = false;
+    _generated = false;     // the solver works on A: gen() it again
 
     bool success;
     uint16_t i, u;
     for (i = 0; i < _params.L; ++i)
-        c.emplace_back (i);
+        _c.emplace_back (i);
 
     DenseMtx CP_D;
     if (debug)
         CP_D = D;
-    std::tie (success, i, u) = decode_phase1 (X, D, c , ops,
+    std::tie (success, i, u) = decode_phase1 (_X, D, _c, ops,
                                             keep_working, thread_keep_working);
     if (stop (keep_working, thread_keep_working))
         return std::make_pair (Precode_Result::STOPPED, DenseMtx());
     if (!success)
         return std::make_pair (Precode_Result::FAILED, DenseMtx());
+    _i = i;
+    _u = u;
+    _phase2_row = i;
 
-    success = decode_phase2 (D, i, u, ops, keep_working, thread_keep_working);
-    if (stop (keep_working, thread_keep_working))
+    auto res = solve_U (D, ops, keep_working, thread_keep_working);
+
+    if (debug && res.first == Precode_Result::DONE && ops.size() != 0) {
+        DenseMtx test_off (D.rows(), D.rows());
+        test_off.setIdentity (CP_D.rows(), CP_D.rows());
+        for (const auto &op : ops)
+            op.build_mtx (test_off);
+        DenseMtx test_res = test_off * CP_D;
+        assert (test_res == res.second && "RQ: I'm different!");
+    }
+    return res;
+}
+
+template <Save_Computation IS_OFFLINE>
+std::pair<Precode_Result, DenseMtx> Precode_Matrix<IS_OFFLINE>::solve_U (
+                                        DenseMtx &D, Op_Vec &ops,
+                                        bool &keep_working,
+                                        const Work_State *thread_keep_working)
+{
+    // phase 2 to 5. Phase 1 has been done, and phase 2 might have been
+    // partially done in a previous, failed, attempt.
+    const uint16_t i = _i, u = _u;
+    DenseMtx C;
+
+    bool success = decode_phase2 (D, i, u, ops, keep_working,
+                                                        thread_keep_working);
+    if (stop (keep_working, thread_keep_working)) {
+        _resumable = false;
         return std::make_pair (Precode_Result::STOPPED, DenseMtx());
-    if (!success)
+    }
+    if (!success) {
+        // keep A, _X, _c: we can add more rows later and resume.
+        _resumable = true;
         return std::make_pair (Precode_Result::FAILED, DenseMtx());
+    }
+    _resumable = false;
     // A now should be considered as being LxL from now
-    decode_phase3 (X, D, i, ops);
+    decode_phase3 (_X, D, i, ops);
     if (stop (keep_working, thread_keep_working))
         return std::make_pair (Precode_Result::STOPPED, DenseMtx());
 
-    X = DenseMtx ();    // free some memory, X is not needed anymore.
+    _X = DenseMtx ();    // free some memory, X is not needed anymore.
     decode_phase4 (D, i, u, ops, keep_working, thread_keep_working);
     if (stop (keep_working, thread_keep_working))
         return std::make_pair (Precode_Result::STOPPED, DenseMtx());
-    if (!success)
-        return std::make_pair (Precode_Result::FAILED, DenseMtx());
 
     decode_phase5 (D, i, ops, keep_working, thread_keep_working);
     if (stop (keep_working, thread_keep_working))
         return std::make_pair (Precode_Result::STOPPED, DenseMtx());
-    if (!success)
-        return std::make_pair (Precode_Result::FAILED, DenseMtx());
 
     // A now must be an LxL identity matrix: check it.
     // CHECK DISABLED: phase4  does not modify A, as it's never readed
@@ -106,23 +136,80 @@ std::pair<Precode_Result, DenseMtx> Precode_Matrix<IS_OFFLINE>::intermediate (
     A = DenseMtx(); // free A memory.
 
     if (IS_OFFLINE == Save_Computation::ON)
-        ops.emplace_back (Operation::_t::REORDER, c);
+        ops.emplace_back (Operation::_t::REORDER, _c);
 
     C = DenseMtx (_params.L, D.cols());
-    for (i = 0; i < _params.L; ++i)
-        C.row (c[i]) = D.row (i);
+    for (uint16_t row = 0; row < _params.L; ++row)
+        C.row (_c[row]) = D.row (row);
+    _c.clear();
 
-    if (debug && ops.size() != 0) {
-        DenseMtx test_off (D.rows(), D.rows());
-        test_off.setIdentity (CP_D.rows(), CP_D.rows());
-        for (const auto &op : ops)
-            op.build_mtx (test_off);
-        DenseMtx test_res = test_off * CP_D;
-        assert (test_res == C && "RQ: I'm different!");
-    }
     return std::make_pair (Precode_Result::DONE, C);
 }
 
+template <Save_Computation IS_OFFLINE>
+std::pair<Precode_Result, DenseMtx>
+                            Precode_Matrix<IS_OFFLINE>::intermediate_resume (
+                                        DenseMtx &D,
+                                        const std::vector<uint32_t> &isis,
+                                        const DenseMtx &rows, Op_Vec &ops,
+                                        bool &keep_working,
+                                        const Work_State *thread_keep_working)
+{
+    if (!_resumable)
+        return std::make_pair (Precode_Result::FAILED, DenseMtx());
+    decode_add_rows (D, isis, rows);
+    return solve_U (D, ops, keep_working, thread_keep_working);
+}
+
+template <Save_Computation IS_OFFLINE>
+void Precode_Matrix<IS_OFFLINE>::decode_add_rows (DenseMtx &D,
+                                        const std::vector<uint32_t> &isis,
+                                        const DenseMtx &rows)
+{
+    // After phase 1 A looks like:
+    //   | lower triangular (i x i) | U_upper |
+    //   |           0              | U_lower |
+    // and phase 2 has turned the first (_phase2_row - i) columns of U_lower
+    // into identity. A new row only needs to be reduced against those
+    // pivots, costing O(rows * L) instead of a full solve.
+    // The operations are not tracked: the result can not be cached
+    // anyway, as the row layout is not the one of a fresh decode.
+    const uint16_t first_new = static_cast<uint16_t> (A.rows());
+    const uint16_t col_start = static_cast<uint16_t> (A.cols() - _u);
+
+    // columns have been swapped: map the original column to its position
+    std::vector<uint16_t> col_pos (_c.size());
+    for (uint16_t col = 0; col < _c.size(); ++col)
+        col_pos[_c[col]] = col;
+
+    A.conservativeResize (A.rows() + rows.rows(), Eigen::NoChange);
+    D.conservativeResize (D.rows() + rows.rows(), Eigen::NoChange);
+    for (uint16_t idx = 0; idx < rows.rows(); ++idx) {
+        const uint16_t row = first_new + idx;
+        A.row (row).setZero();
+        for (const auto isi : get_idxs (isis[idx]))
+            A (row, col_pos[isi]) = 1;
+        D.row (row) = rows.row (idx);
+
+        for (int32_t j = static_cast<int32_t> (_i) - 1; j >= 0; --j) {
+            const uint16_t piv = static_cast<uint16_t> (j);
+            if (static_cast<uint8_t> (A (row, piv)) == 0)
+                continue;
+            const Octet multiple = A (row, piv) / A (piv, piv);
+            A.row (row) += A.row (piv) * multiple;
+            D.row (row) += D.row (piv) * multiple;
+        }
+        for (uint16_t piv = _i; piv < _phase2_row; ++piv) {
+            const uint16_t col = col_start + (piv - _i);
+            const Octet multiple = A (row, col);
+            if (static_cast<uint8_t> (multiple) == 0)
+                continue;
+            A.row (row) += A.row (piv) * multiple;
+            D.row (row) += D.row (piv) * multiple;
+        }
+    }
+}
+
 template <Save_Computation IS_OFFLINE>
 std::pair<Precode_Result, DenseMtx> Precode_Matrix<IS_OFFLINE>::intermediate (
                                         DenseMtx &D, const Bitmask &mask,
@@ -146,14 +233,89 @@ DenseMtx Precode_Matrix<IS_OFFLINE>::get_missing (const DenseMtx &C,
     for (uint16_t hole = 0; hole < mask._max_nonrepair && holes > 0; ++hole) {
         if (mask.exists (hole))
             continue;
-        DenseMtx ret = encode (C, hole);
-        missing.row (row) = ret.row (0);
+        encode (C, hole, missing.data() + row * missing.cols());
         ++row;
         --holes;
     }
     return missing;
 }
 
+template <Save_Computation IS_OFFLINE>
+std::pair<Precode_Result, DenseMtx> Precode_Matrix<IS_OFFLINE>::low_rank (
+                                const DenseMtx &inverse,
+                                const DenseMtx &source, const Bitmask &mask,
+                                const std::vector<uint32_t> &repair_esi,
+                                const Symbol_Store::Rows &repairs) const
+{
+    // the encoder solved the systematic system: C = inverse * D0,
+    // where D0 has all the source symbols in place.
+    // Each repair symbol is a sum of intermediate symbols, so:
+    //      repair = G * D0 = G * D_known + G_holes * missing
+    // where the rows of G are the sums of the rows of "inverse" selected by
+    // the repair tuple. We only need to solve a (repair x holes) system
+    // instead of an L x L one: everything is O(holes * L * T).
+    const uint16_t S_H = _params.S + _params.H;
+    const uint16_t holes = mask.get_holes();
+    const int32_t rows = static_cast<int32_t> (repair_esi.size());
+    const uint32_t padding = _params.K_padded - mask._max_nonrepair;
+    if (rows < holes || inverse.rows() != _params.L ||
+                                            repairs.size() != repair_esi.size())
+        return {Precode_Result::FAILED, DenseMtx()};
+
+    std::vector<uint16_t> hole_row;
+    hole_row.reserve (holes);
+    for (uint16_t esi = 0; esi < mask._max_nonrepair &&
+                                            hole_row.size() < holes; ++esi) {
+        if (!mask.exists (esi))
+            hole_row.push_back (S_H + esi);
+    }
+    DenseMtx rhs (rows, source.cols());
+    for (int32_t row = 0; row < rows; ++row)
+        rhs.row (row) = repairs.row (static_cast<size_t> (row));
+    DenseMtx G (rows, _params.L);
+    G.setZero();
+    for (int32_t row = 0; row < rows; ++row) {
+        for (const auto isi : get_idxs (
+                            repair_esi[static_cast<size_t> (row)] + padding))
+            G.row (row) += inverse.row (isi);
+    }
+    DenseMtx coeff (rows, holes);
+    for (uint16_t col = 0; col < holes; ++col) {
+        coeff.col (col) = G.col (hole_row[col]);
+        G.col (hole_row[col]).setZero();
+    }
+    // GF(256): subtracting is the same as adding.
+    // the S_H and padding symbols are zero: only the source ones count.
+    rhs += G.middleCols (S_H, mask._max_nonrepair) * source;
+    G = DenseMtx();
+
+    // gauss-jordan on the small system
+    for (uint16_t col = 0; col < holes; ++col) {
+        int32_t pivot = col;
+        while (pivot < rows && static_cast<uint8_t> (coeff (pivot, col)) == 0)
+            ++pivot;
+        if (pivot == rows)
+            return {Precode_Result::FAILED, DenseMtx()};
+        if (pivot != col) {
+            coeff.row (col).swap (coeff.row (pivot));
+            rhs.row (col).swap (rhs.row (pivot));
+        }
+        if (static_cast<uint8_t> (coeff (col, col)) != 1) {
+            const Octet divisor = coeff (col, col);
+            coeff.row (col) /= divisor;
+            rhs.row (col) /= divisor;
+        }
+        for (int32_t row = 0; row < rows; ++row) {
+            const Octet multiple = coeff (row, col);
+            if (row == col || static_cast<uint8_t> (multiple) == 0)
+                continue;
+            coeff.row (row) += coeff.row (col) * multiple;
+            rhs.row (row) += rhs.row (col) * multiple;
+        }
+    }
+    return {Precode_Result::DONE, rhs.block (0, 0, holes, rhs.cols())};
+}
+
 template <Save_Computation IS_OFFLINE>
 void Precode_Matrix<IS_OFFLINE>::decode_phase0 (const Bitmask &mask,
                                         const std::vector<uint32_t> &repair_esi)
@@ -181,7 +343,7 @@ void Precode_Matrix<IS_OFFLINE>::decode_phase0 (const Bitmask &mask,
             continue;
         // now hole_from is the esi hole, and hole_to is our repair sym.
         // put the repair dependancy in the hole row
-        auto depends = _params.get_idxs (static_cast<uint16_t> (
+        auto depends = get_idxs (static_cast<uint32_t> (
                                                             *r_esi + padding));
         ++r_esi;
         // erease the line, mark the dependencies of the repair symbol.
@@ -201,7 +363,7 @@ void Precode_Matrix<IS_OFFLINE>::decode_phase0 (const Bitmask &mask,
     for (uint16_t rep_row = static_cast<uint16_t> (
                             static_cast<uint32_t>(A.rows()) - _repair_overhead);
                                                 rep_row < A.rows(); ++rep_row) {
-        auto depends = _params.get_idxs (static_cast<uint16_t> (
+        auto depends = get_idxs (static_cast<uint32_t> (
                                                             *r_esi + padding));
         ++r_esi;
         // erease the line, mark the dependencies of the repair symbol.
@@ -320,8 +482,14 @@ std::tuple<bool, uint16_t, uint16_t>
                 }
             }
         }
-        if (non_zero == V.cols() + 1)
-            return std::tuple<bool,uint16_t,uint16_t> (false, 0, 0); // failure
+        if (non_zero == V.cols() + 1) {
+            // V is all zeros: we can not choose a row. Instead of failing,
+            // inactivate all the remaining V columns (they are already
+            // next to U) and let phase 2 check the rank.
+            // This way any failure happens in phase 2, and can be resumed.
+            u = _params.L - i;
+            break;
+        }
         // search for r.
         if (non_zero != 2) {
             // search for row with minimum original degree.
@@ -443,8 +611,9 @@ bool Precode_Matrix<IS_OFFLINE>::decode_phase2 (DenseMtx &D, const uint16_t i,
     const uint16_t col_start = static_cast<uint16_t> (A.cols() - u);
     // try to bring U_Lower to Identity with gaussian elimination.
     // remember that all row swaps affect A as well, not just U_Lower
+    // _phase2_row: we might be resuming a previously failed attempt.
 
-    for (uint16_t row = row_start; row < row_end; ++row) {
+    for (uint16_t row = _phase2_row; row < row_end; ++row) {
         if (stop (keep_working, thread_keep_working))
             return false; // stop
         // make sure the considered row has nonzero on the diagonal
@@ -459,6 +628,8 @@ bool Precode_Matrix<IS_OFFLINE>::decode_phase2 (DenseMtx &D, const uint16_t i,
         }
         if (row_nonzero == row_end) {
             // U_Lower is square, we can return early (rank < u, not solvable)
+            // everything up to "row" is done, though.
+            _phase2_row = row;
             return false;
         } else if (row != row_nonzero) {
             A.row (row).swap (A.row (row_nonzero));
@@ -607,32 +778,47 @@ template<Save_Computation IS_OFFLINE>
 DenseMtx Precode_Matrix<IS_OFFLINE>::encode (const DenseMtx &C,
                                                     const uint32_t ISI) const
 {
-    // Generate repair symbols. same algorithm as "get_idxs"
-    // rfc6330, pg29
+    DenseMtx ret = DenseMtx (1, C.cols());
+    encode (C, ISI, ret.data());
+    return ret;
+}
 
-    DenseMtx ret;
+template <Save_Computation IS_OFFLINE>
+void Precode_Matrix<IS_OFFLINE>::encode (const DenseMtx &C, const uint32_t ISI,
+                                                        Octet *output) const
+{
+    encode (C, tuple (ISI), output);
+}
 
-    ret = DenseMtx (1, C.cols());
-    Tuple t = _params.tuple (ISI);
+template <Save_Computation IS_OFFLINE>
+void Precode_Matrix<IS_OFFLINE>::encode (const DenseMtx &C, Tuple t,
+                                                        Octet *output) const
+{
+    // Generate repair symbols. same algorithm as "get_idxs"
+    // rfc6330, pg29
+    // C is row major, so each intermediate symbol is contiguous.
+    const size_t size = static_cast<size_t> (C.cols());
+    const auto row = [&] (const uint32_t idx)
+                                        { return C.data() + idx * size; };
 
-    ret.row (0) = C.row (t.b);
+    std::memcpy (output, row (t.b), size);
 
     for (uint16_t j = 1; j < t.d; ++j) {
         t.b = (t.b + t.a) % _params.W;
-        ret.row (0) += C.row (t.b);
+        add_octets (output, row (t.b), size);
     }
     while (t.b1 >= _params.P)
         t.b1 = (t.b1 + t.a1) % _params.P1;
 
-    ret.row (0) += C.row (_params.W + t.b1);
+    add_octets (output, row (static_cast<uint32_t> (_params.W + t.b1)),
+                                                                        size);
     for (uint16_t j = 1; j < t.d1; ++j) {
         t.b1 = (t.b1 + t.a1) % _params.P1;
         while (t.b1 >= _params.P)
             t.b1 = (t.b1 + t.a1) % _params.P1;
-        ret.row (0) += C.row (_params.W + t.b1);
+        add_octets (output, row (static_cast<uint32_t> (_params.W + t.b1)),
+                                                                        size);
     }
-
-    return ret;
 }
 
 }   // namespace RaptorQ
@@ -0,0 +1,153 @@
+/*
+ * Copyright (c) 2015-2018, Luca Fulchir<luca@fulchir.it>, All rights reserved.
+ *
+ * This file is part of "libRaptorQ".
+ *
+ * libRaptorQ is free software: you can redistribute it and/or modify
+ * it under the terms of the GNU Lesser General Public License as
+ * published by the Free Software Foundation, either version 3
+ * of the License, or (at your option) any later version.
+ *
+ * libRaptorQ is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ * GNU General Public License for more details.
+ *
+ * You should have received a copy of the GNU General Public License
+ * and a copy of the GNU Lesser General Public License
+ * along with libRaptorQ.  If not, see <http://www.gnu.org/licenses/>.
+ */
+
+#pragma once
+
+#include "RaptorQ/v1/common.hpp"
+#include "RaptorQ/v1/Octet.hpp"
+#include "RaptorQ/v1/Parameters.hpp"
+#include "RaptorQ/v1/Precode_Matrix.hpp"
+#include <Eigen/Dense>
+#include <vector>
+
+namespace RaptorQ__v1 {
+namespace Impl {
+
+// Progressive (on-arrival) solver.
+// Instead of waiting for enough symbols and then solving everything,
+// each symbol is eliminated against what we already have as soon as it
+// arrives. The matrix is kept in reduced row echelon form, so once we reach
+// rank L the intermediate symbols are already there: no final solve.
+//
+// Total work is comparable to a dense gaussian elimination, but it is
+// spread over the whole reception window, and out of the critical path.
+class RAPTORQ_LOCAL Progressive_Solver
+{
+public:
+    Progressive_Solver (const Parameters &params, const int32_t symbol_size)
+        : _params (params), _rank (0)
+    {
+        A = DenseMtx (_params.L, _params.L);
+        D = DenseMtx (_params.L, symbol_size);
+        _col_row = std::vector<int32_t> (_params.L, -1);
+        _pivot_col.reserve (_params.L);
+        // The LDPC and HDPC rows are known from the start, and are always
+        // equal to zero.
+        Precode_Matrix<Save_Computation::OFF> precode (_params);
+        precode.gen (0);
+        _plan = precode.plan();
+        const DenseMtx constraints = precode.constraints();
+        DenseMtx row_a, row_d = DenseMtx (1, symbol_size);
+        row_d.setZero();
+        for (int32_t row = 0; row < constraints.rows(); ++row) {
+            row_a = constraints.row (row);
+            add_row (row_a, row_d);
+        }
+    }
+    Progressive_Solver() = delete;
+    Progressive_Solver (const Progressive_Solver&) = delete;
+    Progressive_Solver& operator= (const Progressive_Solver&) = delete;
+    Progressive_Solver (Progressive_Solver&&) = default;
+    Progressive_Solver& operator= (Progressive_Solver&&) = default;
+    ~Progressive_Solver() = default;
+
+    // add a received symbol. false if it did not add any information.
+    template <typename Row>
+    bool add (const uint32_t isi, const Row &data)
+    {
+        if (solved())
+            return false;
+        DenseMtx row_a (1, _params.L);
+        row_a.setZero();
+        const auto idxs = _plan != nullptr ? _plan->get_idxs (isi) :
+                                                    _params.idxs (isi);
+        for (const auto col : idxs)
+            row_a (0, col) = 1;
+        DenseMtx row_d = data;
+        return add_row (row_a, row_d);
+    }
+
+    uint16_t rank() const
+        { return _rank; }
+    bool solved() const
+        { return _rank == _params.L; }
+
+    // the intermediate symbols. empty if not solved
+    DenseMtx intermediate() const
+    {
+        if (!solved())
+            return DenseMtx();
+        DenseMtx C (_params.L, D.cols());
+        for (uint16_t row = 0; row < _rank; ++row)
+            C.row (_pivot_col[row]) = D.row (row);
+        return C;
+    }
+
+    const Parameters _params;
+private:
+    std::shared_ptr<const Plan> _plan;
+    DenseMtx A, D;
+    // _col_row: row that has its pivot in the column. -1 => none
+    std::vector<int32_t> _col_row;
+    std::vector<uint16_t> _pivot_col;
+    uint16_t _rank;
+
+    bool add_row (DenseMtx &row_a, DenseMtx &row_d)
+    {
+        // every pivot row is zero on all the other pivot columns,
+        // so a single pass is enough to reduce the new row.
+        for (uint16_t col = 0; col < _params.L; ++col) {
+            const Octet multiple = row_a (0, col);
+            if (_col_row[col] < 0 || static_cast<uint8_t> (multiple) == 0)
+                continue;
+            row_a.row (0) += A.row (_col_row[col]) * multiple;
+            row_d.row (0) += D.row (_col_row[col]) * multiple;
+        }
+        uint16_t pivot = 0;
+        for (; pivot < _params.L; ++pivot) {
+            if (static_cast<uint8_t> (row_a (0, pivot)) != 0)
+                break;
+        }
+        if (pivot == _params.L)
+            return false;   // linearly dependent, nothing new
+        if (static_cast<uint8_t> (row_a (0, pivot)) != 1) {
+            const Octet divisor = row_a (0, pivot);
+            row_a.row (0) /= divisor;
+            row_d.row (0) /= divisor;
+        }
+        // keep the form reduced: clear the new pivot column everywhere
+        for (uint16_t row = 0; row < _rank; ++row) {
+            const Octet multiple = A (row, pivot);
+            if (static_cast<uint8_t> (multiple) == 0)
+                continue;
+            A.row (row) += row_a.row (0) * multiple;
+            D.row (row) += row_d.row (0) * multiple;
+        }
+        A.row (_rank) = row_a.row (0);
+        D.row (_rank) = row_d.row (0);
+        _col_row[pivot] = _rank;
+        _pivot_col.push_back (pivot);
+        ++_rank;
+        return true;
+    }
+};
+
+}   // namespace Impl
+}   // namespace RaptorQ__v1
@@ -37,14 +37,20 @@
 #include "RaptorQ/v1/RFC_Iterators.hpp"
 #include "RaptorQ/v1/Shared_Computation/Decaying_LF.hpp"
 #include "RaptorQ/v1/Thread_Pool.hpp"
+#include "RaptorQ/v1/util/contiguous.hpp"
 #include "RaptorQ/v1/util/endianess.hpp"
+#include "RaptorQ/v1/util/Notifier.hpp"
+#include "RaptorQ/v1/util/Scratch_File.hpp"
 #include <algorithm>
+#include <atomic>
 #include <cassert>
+#include <chrono>
 #include <future>
 #include <map>
 #include <memory>
 #include <mutex>
 #include <limits>
+#include <string>
 #include <thread>
 #include <tuple>
 #include <type_traits>
@@ -140,9 +146,33 @@ public:
     size_t precompute_max_memory ();
     size_t encode (Fwd_It &output, const Fwd_It end, const uint32_t esi,
                                                             const uint8_t sbn);
+    // same, on a plain buffer. returns the number of bytes written.
+    size_t encode (uint8_t *output, const size_t size, const uint32_t esi,
+                                                            const uint8_t sbn);
     // id: 8-bit sbn + 24 bit esi
     size_t encode (Fwd_It &output, const Fwd_It end, const uint32_t id);
     size_t encode_packet (Fwd_It &output, const Fwd_It end, const uint32_t id);
+    // "count" packets of block "sbn", one symbol_size() symbol each, from
+    // "esi" on. Source symbols point into the object when it is contiguous
+    // and there is a single sub-block. The other symbols, and the padded
+    // last one, are written in "buffer", one after the other.
+    // returns the packets filled: less than "count" if the buffer is
+    // full, the block is not computed or there are no more symbols.
+    size_t encode_packets (Packet_Desc *packets, const size_t count,
+                                    const uint32_t esi, const uint8_t sbn,
+                                    uint8_t *buffer, const size_t size);
+    // "count" symbols of block "sbn" from "esi" on, one symbol_size()
+    // after the other in "output". returns the symbols written.
+    size_t encode_range (uint8_t *output, const size_t size,
+                                    const uint32_t esi, const uint32_t count,
+                                                            const uint8_t sbn);
+
+    // completion events for event loops (see Notify_Callback): BLOCK when
+    // a block computed by the pool is ready, COMPUTE when the future of
+    // a compute() that went to the pool is.
+    void set_notify (const Notify_Callback &callback);
+    // eventfd counting the same events, -1 if not supported.
+    int notify_fd();
 
     void free (const uint8_t sbn);
     uint8_t blocks() const;
@@ -152,14 +182,27 @@ public:
     Block_Size extended_symbols (const uint8_t sbn) const;
     uint32_t max_repair (const uint8_t sbn) const;
 private:
+    using Raw_Enc = RaptorQ__v1::Impl::Raw_Encoder<Rnd_It, Fwd_It,
+                                        RaptorQ__v1::Impl::with_interleaver>;
 
     static void wait_threads (Encoder<Rnd_It, Fwd_It> *obj, const Compute flags,
                                     std::promise<std::pair<Error, uint8_t>> p);
+    // "output" is usually a Fwd_It, but any forward iterator will do.
+    template <typename It>
+    size_t encode_to (It &output, const It end, const uint32_t esi,
+                                                            const uint8_t sbn);
+    // encoder of block "sbn", nullptr if it can not encode yet.
+    // without the pool, the block is computed here.
+    std::shared_ptr<Raw_Enc> block_encoder (const uint8_t sbn);
+    // fire BLOCK for the blocks that became ready
+    void notify_blocks();
 
     class Block_Work final : public Impl::Pool_Work {
     public:
-        std::weak_ptr<RaptorQ__v1::Impl::Raw_Encoder<Rnd_It, Fwd_It,
-                                  RaptorQ__v1::Impl::with_interleaver>> work;
+        std::weak_ptr<Raw_Enc> work;
+        // Compute::WIDE: other blocks with the same size, solved together
+        // with "work".
+        std::vector<std::weak_ptr<Raw_Enc>> wide;
         std::weak_ptr<std::condition_variable> notify;
         std::weak_ptr<std::mutex> lock;
 
@@ -174,11 +217,14 @@ private:
             enc = std::make_shared<RaptorQ__v1::Impl::Raw_Encoder<Rnd_It,
                                 Fwd_It, RaptorQ__v1::Impl::with_interleaver>> (
                                                             interleaver, sbn);
+            node = std::make_shared<std::atomic<int32_t>> (-1);
             reported = false;
+            notified = false;
         }
         std::shared_ptr<RaptorQ__v1::Impl::Raw_Encoder<Rnd_It, Fwd_It,
                                     RaptorQ__v1::Impl::with_interleaver>> enc;
-        bool reported;
+        std::shared_ptr<std::atomic<int32_t>> node;
+        bool reported, notified;
     };
 
     std::pair<Error, uint8_t> get_report (const Compute flags);
@@ -188,6 +234,7 @@ private:
 
     std::map<uint8_t, Enc> encoders;
     std::mutex _mtx;
+    RaptorQ__v1::Impl::Notifier notifier;
 
     const size_t _max_sub_blk;
     const Rnd_It _data_from, _data_to;
@@ -322,6 +369,10 @@ public:
     size_t decode_block_bytes (Fwd_It &start, const Fwd_It end,
                                                             const uint8_t skip,
                                                             const uint8_t sbn);
+    // the blocks "sbns", one after the other. Stops at the first block
+    // that is not decoded or does not fit. result in BYTES.
+    uint64_t decode_blocks (Fwd_It &start, const Fwd_It end,
+                                const uint8_t *sbns, const uint16_t count);
     // result in ITERATORS
     // last *might* be half written depending on data alignments
     // NOTE: skip = uint8_t to avoid problems with _alignment
@@ -335,7 +386,55 @@ public:
     Error add_symbol (In_It &start, const In_It end, const uint32_t id);
     Error add_symbol (In_It &start, const In_It end, const uint32_t esi,
                                                             const uint8_t sbn);
+    // same, from a plain buffer of "size" bytes.
+    Error add_symbol (const uint8_t *data, const size_t size,
+                                        const uint32_t esi, const uint8_t sbn);
     Error add_packet (In_It &start, const In_It end);
+    // received packets, as from add_packet. Packets of the same block
+    // one after the other share the work of finding and queueing it.
+    // returns the number of packets used. If less than "count", the next
+    // packet was refused with "err" (Error::WORKING or Error::EXITING in
+    // sink mode): the packets from there on can be given again later.
+    // A packet can end with a short symbol only if it is the last one of
+    // the object, as in add_symbol. Otherwise it is refused with
+    // Error::WRONG_INPUT.
+    size_t add_packets (const Packet_Desc *packets, const size_t count,
+                                                                Error &err);
+    // "count" symbols of symbol_size() bytes, one after the other in
+    // "data": symbol "idx" has id "ids[idx]" (8-bit sbn + 24 bit esi, in
+    // network order as in the packets). Symbols of the same block one
+    // after the other are added together.
+    // returns the number of symbols added.
+    size_t add_symbols (const uint8_t *data, const size_t size,
+                                const uint32_t *ids, const uint32_t count);
+    // eliminate symbols as they arrive (see Raw_Decoder::set_progressive)
+    void set_progressive (const bool enable);
+    // when to attempt decoding a block (see Decode_Policy), for all blocks
+    void set_decode_policy (const Decode_Policy &new_policy);
+    // sink mode: each block is given to the sink as soon as it is decoded
+    // and all the previous blocks were given, then it is freed.
+    // The sink returns false to stop all the deliveries: from then on,
+    // adding symbols returns Error::EXITING.
+    // Do not call the decoder from the sink.
+    // "max_memory": bytes of the source symbols and of the repair symbols
+    // received of the blocks kept in memory.
+    // Symbols of a new block that would go over it are refused
+    // (Error::WORKING) unless the block is the next to be delivered.
+    // 0: no limit. Can only be set before adding symbols.
+    bool set_sink (const Decoder_Sink &new_sink, const size_t max_memory);
+    // keep the symbols of all blocks in a scratch file in "directory"
+    // instead of RAM. only the matrices of the blocks being decoded stay
+    // in memory. false if the file can not be created.
+    // Symbols added meanwhile wait for the move, they are not refused.
+    bool set_storage (const std::string &directory);
+    // blocks given to the sink
+    uint8_t blocks_delivered();
+    // completion events for event loops (see Notify_Callback): BLOCK when
+    // a block is decoded (after the sink got it, in sink mode), COMPUTE
+    // when the future of a compute() that went to the pool is.
+    void set_notify (const Notify_Callback &callback);
+    // eventfd counting the same events, -1 if not supported.
+    int notify_fd();
 
     uint8_t blocks_ready();
     bool is_ready();
@@ -362,20 +461,51 @@ private:
 
     class RAPTORQ_LOCAL Dec {
     public:
+        Dec() : reported (false), notified (false) {}
         Dec (const RaptorQ__v1::Block_Size symbols, const uint16_t symbol_size,
                                                 const uint16_t padding_symbols)
         {
             dec = std::make_shared<RaptorQ__v1::Impl::Raw_Decoder<In_It>> (
                                         symbols, symbol_size, padding_symbols);
+            node = std::make_shared<std::atomic<int32_t>> (-1);
             reported = false;
+            notified = false;
         }
         std::shared_ptr<RaptorQ__v1::Impl::Raw_Decoder<In_It>> dec;
-        bool reported;
+        // NUMA node the block prefers, shared by all retries
+        std::shared_ptr<std::atomic<int32_t>> node;
+        bool reported, notified;
     };
 
     static void wait_threads (Decoder<In_It, Fwd_It> *obj, const Compute flags,
                                     std::promise<std::pair<Error, uint8_t>> p);
     std::pair<Error, uint8_t> get_report (const Compute flags);
+    // call with the pool lock held. queue the decodable blocks that are not
+    // being worked on. returns the milliseconds before a deferred block
+    // can be tried, or -1.
+    int64_t queue_decodable (const std::vector<Dec> &decs);
+    // queue the deferred blocks whose quiet period ended.
+    void queue_quiet();
+    // "start" is usually an In_It, but any input iterator will do.
+    template <typename It>
+    Error add (It &start, const It end, const uint32_t esi, const uint8_t sbn);
+    // decoder of block "sbn", created if needed.
+    // NONE, or why symbols of that block can not be added now.
+    // "quiet": the policy has a quiet period
+    Error block_decoder (const uint8_t sbn, Dec &out, bool &pool,
+                                                                bool &quiet);
+    // symbols were added to block "sbn": queue it or decode it,
+    // and feed the sink.
+    void added (const Dec &dec, const uint8_t sbn, const bool pool,
+                                                            const bool quiet);
+    // give the decoded blocks to the sink, in order
+    void deliver();
+    // the next block for the sink is decoded. call with the pool lock held
+    bool deliverable();
+    // the sink stopped or got all the blocks
+    bool sink_done();
+    // fire BLOCK for the blocks that became ready
+    void notify_blocks();
     std::shared_ptr<std::condition_variable> _pool_notify;
     std::shared_ptr<std::mutex> _pool_mtx;
     std::deque<std::thread> pool_wait;
@@ -384,10 +514,21 @@ private:
     Impl::Partition part, _sub_blocks;
     std::map<uint8_t, Dec> decoders;
     std::mutex _mtx;
+    RaptorQ__v1::Impl::Notifier notifier;
     uint16_t _symbol_size;
     int16_t pool_last_reported;
     uint8_t _blocks, _alignment;
-    bool use_pool, exiting;
+    bool use_pool, exiting, progressive = false;
+    Decode_Policy policy {0, 0, 0};
+    // steady clock milliseconds: when the quiet period of a deferred
+    // block ends. -1 if no block is waiting for it.
+    std::atomic<int64_t> next_quiet {-1};
+    Decoder_Sink sink;
+    std::shared_ptr<RaptorQ__v1::Impl::Scratch_File> storage;
+    std::mutex _sink_mtx;
+    size_t sink_memory = 0;
+    uint8_t delivered = 0;
+    bool sink_ok = true;
 
     std::vector<bool> decoded_sbn;
 
@@ -491,6 +632,11 @@ Encoder<Rnd_It, Fwd_It>::Block_Work::~Block_Work()
     auto locked_enc = work.lock();
     auto locked_notify = notify.lock();
     auto locked_mtx = lock.lock();
+    for (auto &other : wide) {
+        auto locked_other = other.lock();
+        if (locked_other != nullptr)
+            locked_other->stop();
+    }
     if (locked_enc != nullptr && locked_notify != nullptr &&
                                                         locked_mtx != nullptr) {
         locked_enc->stop();
@@ -507,12 +653,29 @@ Work_Exit_Status Encoder<Rnd_It, Fwd_It>::Block_Work::do_work (
     auto locked_enc = work.lock();
     auto locked_notify = notify.lock();
     auto locked_mtx = lock.lock();
+    // WIDE: keep the blocks alive while we work on them. the first block
+    // that was not freed leads the group.
+    std::vector<std::shared_ptr<Raw_Enc>> locked_wide;
+    std::vector<Raw_Enc*> group;
+    for (auto &other : wide) {
+        auto locked_other = other.lock();
+        if (locked_other == nullptr)
+            continue;
+        group.push_back (locked_other.get());
+        locked_wide.push_back (std::move (locked_other));
+    }
+    if (locked_enc == nullptr && locked_wide.size() != 0)
+        locked_enc = locked_wide[0];
     if (locked_enc != nullptr && locked_notify != nullptr &&
                                                         locked_mtx != nullptr) {
         // encoding always works. It's one of the few constants of the universe.
-        if (!locked_enc->generate_symbols (state))
+        const bool done = group.size() == 0 ?
+                                    locked_enc->generate_symbols (state) :
+                                    locked_enc->generate_symbols (group, state);
+        if (!done)
             return Work_Exit_Status::STOPPED;   // or maybe not so constant
         work.reset();
+        wide.clear();
         std::unique_lock<std::mutex> p_lock (*locked_mtx);
         RQ_UNUSED(p_lock);
         locked_notify->notify_all();
@@ -569,6 +732,8 @@ std::future<std::pair<Error, uint8_t>> Encoder<Rnd_It, Fwd_It>::compute (
     }
 
     // flags are fine, add work to pool
+    const bool wide = Compute::NONE != (flags & Compute::WIDE);
+    std::map<Block_Size, std::vector<Enc>> same_size;
     std::unique_lock<std::mutex> lock (_mtx);
     for (uint8_t block = 0; block < blocks(); ++block) {
         auto enc = encoders.find (block);
@@ -579,15 +744,41 @@ std::future<std::pair<Error, uint8_t>> Encoder<Rnd_It, Fwd_It>::compute (
                                     std::forward_as_tuple (block),
                                     std::forward_as_tuple (&interleave, block));
             assert (success == true);
+            if (wide) {
+                same_size[extended_symbols (block)].push_back (enc->second);
+                continue;
+            }
             std::unique_ptr<Block_Work> work = std::unique_ptr<Block_Work>(
                                                             new Block_Work());
             work->work = enc->second.enc;
+            work->node = enc->second.node;
             work->notify = _pool_notify;
             work->lock = _pool_mtx;
             Thread_Pool::get().add_work (std::move(work));
         }
     }
     lock.unlock();
+    // the blocks with the same size are split in as many groups as
+    // there are threads, so that we still use them all. Each group
+    // needs a single elimination.
+    const size_t threads = std::max<size_t> (1, Thread_Pool::get().size());
+    for (const auto &size : same_size) {
+        const std::vector<Enc> &encs = size.second;
+        const size_t groups = std::min (threads, encs.size());
+        for (size_t group = 0; group < groups; ++group) {
+            const size_t from = group * encs.size() / groups;
+            const size_t to = (group + 1) * encs.size() / groups;
+            std::unique_ptr<Block_Work> work = std::unique_ptr<Block_Work>(
+                                                            new Block_Work());
+            work->work = encs[from].enc;
+            work->node = encs[from].node;
+            for (size_t idx = from + 1; idx < to; ++idx)
+                work->wide.push_back (encs[idx].enc);
+            work->notify = _pool_notify;
+            work->lock = _pool_mtx;
+            Thread_Pool::get().add_work (std::move(work));
+        }
+    }
 
     // spawn thread waiting for other thread exit.
     // this way we can set_value to the future when needed.
@@ -608,13 +799,17 @@ void Encoder<Rnd_It, Fwd_It>::wait_threads (Encoder<Rnd_It, Fwd_It> *obj,
                                     std::promise<std::pair<Error, uint8_t>> p)
 {
     auto _notify = obj->_pool_notify;
+    std::pair<Error, uint8_t> status;
     while (true) {
+        // the callback might call us: do not hold the pool lock.
+        obj->notify_blocks();
         std::unique_lock<std::mutex> lock (*obj->_pool_mtx);
         if (obj->exiting) {
-            p.set_value ({Error::EXITING, 0});
+            status = {Error::EXITING, 0};
+            p.set_value (status);
             break;
         }
-        auto status = obj->get_report (flags);
+        status = obj->get_report (flags);
         if (Error::WORKING != status.first) {
             p.set_value (status);
             break;
@@ -623,6 +818,8 @@ void Encoder<Rnd_It, Fwd_It>::wait_threads (Encoder<Rnd_It, Fwd_It> *obj,
         _notify->wait (lock);
         lock.unlock();
     }
+    obj->notify_blocks();
+    obj->notifier.fire (Notify_Event::COMPUTE, status.first, status.second);
 
     // delete ourselves from the waiting thread vector.
     std::unique_lock<std::mutex> lock (*obj->_pool_mtx);
@@ -637,6 +834,32 @@ void Encoder<Rnd_It, Fwd_It>::wait_threads (Encoder<Rnd_It, Fwd_It> *obj,
     _notify->notify_all();
 }
 
+template <typename Rnd_It, typename Fwd_It>
+void Encoder<Rnd_It, Fwd_It>::notify_blocks()
+{
+    if (!notifier)
+        return;
+    std::vector<uint8_t> ready;
+    std::unique_lock<std::mutex> lock (_mtx);
+    for (auto &it : encoders) {
+        if (!it.second.notified && it.second.enc->ready()) {
+            it.second.notified = true;
+            ready.push_back (it.first);
+        }
+    }
+    lock.unlock();
+    for (const uint8_t sbn : ready)
+        notifier.fire (Notify_Event::BLOCK, Error::NONE, sbn);
+}
+
+template <typename Rnd_It, typename Fwd_It>
+void Encoder<Rnd_It, Fwd_It>::set_notify (const Notify_Callback &callback)
+    { notifier.set (callback); }
+
+template <typename Rnd_It, typename Fwd_It>
+int Encoder<Rnd_It, Fwd_It>::notify_fd()
+    { return notifier.fd(); }
+
 template <typename Rnd_It, typename Fwd_It>
 std::pair<Error, uint8_t> Encoder<Rnd_It, Fwd_It>::get_report (
                                                             const Compute flags)
@@ -698,6 +921,24 @@ template <typename Rnd_It, typename Fwd_It>
 size_t Encoder<Rnd_It, Fwd_It>::encode (Fwd_It &output, const Fwd_It end,
                                                             const uint32_t esi,
                                                             const uint8_t sbn)
+    { return encode_to (output, end, esi, sbn); }
+
+template <typename Rnd_It, typename Fwd_It>
+size_t Encoder<Rnd_It, Fwd_It>::encode (uint8_t *output, const size_t size,
+                                                            const uint32_t esi,
+                                                            const uint8_t sbn)
+{
+    if (output == nullptr)
+        return 0;
+    uint8_t *start = output;
+    return encode_to (start, output + size, esi, sbn);
+}
+
+template <typename Rnd_It, typename Fwd_It>
+template <typename It>
+size_t Encoder<Rnd_It, Fwd_It>::encode_to (It &output, const It end,
+                                                            const uint32_t esi,
+                                                            const uint8_t sbn)
 {
     if (sbn >= interleave.blocks())
         return 0;
@@ -707,35 +948,142 @@ size_t Encoder<Rnd_It, Fwd_It>::encode (Fwd_It &output, const Fwd_It end,
                                                                         - syms;
     const uint32_t real_esi = esi < syms ? esi : esi + padding;
 
+    auto shared_enc = block_encoder (sbn);
+    if (shared_enc == nullptr)
+        return 0;
+    return shared_enc->Enc (real_esi, output, end);
+}
+
+template <typename Rnd_It, typename Fwd_It>
+std::shared_ptr<typename Encoder<Rnd_It, Fwd_It>::Raw_Enc>
+                    Encoder<Rnd_It, Fwd_It>::block_encoder (const uint8_t sbn)
+{
     std::unique_lock<std::mutex> lock (_mtx);
     auto it = encoders.find (sbn);
-    if (use_pool) {
-        if (it == encoders.end())
-            return 0;
+    if (it == encoders.end()) {
+        if (use_pool)
+            return nullptr;
+        bool success;
+        std::tie (it, success) = encoders.emplace (std::make_pair (sbn,
+                                                    Enc (&interleave, sbn)));
         auto shared_enc = it->second.enc;
-        if (!shared_enc->ready())
-            return 0;
         lock.unlock();
-        return shared_enc->Enc (real_esi, output, end);
-    } else {
-        if (it == encoders.end()) {
-            bool success;
-            std::tie (it, success) = encoders.emplace (std::make_pair (sbn,
-                                                    Enc (&interleave, sbn)));
-            auto shared_enc = it->second.enc;
-            lock.unlock();
-            RaptorQ__v1::Work_State state =
-                                        RaptorQ__v1::Work_State::KEEP_WORKING;
-            shared_enc->generate_symbols (&state);
-            return shared_enc->Enc (real_esi, output, end);
-        } else {
-            auto shared_enc = it->second.enc;
-            lock.unlock();
-            if (!shared_enc->ready())
-                return 0;
-            return shared_enc->Enc (real_esi, output, end);
+        RaptorQ__v1::Work_State state = RaptorQ__v1::Work_State::KEEP_WORKING;
+        shared_enc->generate_symbols (&state);
+        return shared_enc;
+    }
+    auto shared_enc = it->second.enc;
+    lock.unlock();
+    if (!shared_enc->ready())
+        return nullptr;
+    return shared_enc;
+}
+
+template <typename Rnd_It, typename Fwd_It>
+size_t Encoder<Rnd_It, Fwd_It>::encode_packets (Packet_Desc *packets,
+                                    const size_t count,
+                                    const uint32_t esi, const uint8_t sbn,
+                                    uint8_t *buffer, const size_t size)
+{
+    using T = typename std::iterator_traits<Rnd_It>::value_type;
+    if (packets == nullptr || sbn >= blocks())
+        return 0;
+    const uint32_t syms = symbols (sbn);
+    const uint32_t padding = static_cast<uint16_t> (extended_symbols (sbn)) -
+                                                                        syms;
+    const uint32_t last = static_cast<uint32_t> (std::min<uint64_t> (
+                                        static_cast<uint64_t> (esi) + count,
+                                                syms + max_repair (sbn)));
+    // with a single sub-block the source symbols are whole in the object,
+    // and the interleaver would only copy them.
+    const bool in_place = RaptorQ__v1::Impl::is_contiguous_le<Rnd_It>::value &&
+                                                interleave.sub_blocks() == 1;
+    const uint64_t obj_bytes = static_cast<uint64_t> (_data_to - _data_from) *
+                                                                    sizeof(T);
+    uint64_t block_start = 0;
+    for (uint8_t idx = 0; idx < sbn; ++idx)
+        block_start += static_cast<uint64_t> (symbols (idx)) * _symbol_size;
+
+    std::shared_ptr<Raw_Enc> shared_enc;
+    size_t done = 0, used = 0;
+    uint32_t id = esi;
+    for (; id < std::min (last, syms); ++id, ++done) {
+        Packet_Desc &pkt = packets[done];
+        pkt.header = RaptorQ__v1::Impl::Endian::h_to_b<uint32_t> (
+                                (static_cast<uint32_t> (sbn) << 24) | id);
+        // the last symbol of the object is padded by the interleaver.
+        const uint64_t offset = block_start +
+                                    static_cast<uint64_t> (id) * _symbol_size;
+        pkt.size = _symbol_size;
+        if (in_place && offset + _symbol_size <= obj_bytes) {
+            pkt.symbol = RaptorQ__v1::Impl::in_bytes (_data_from +
+                                    static_cast<int64_t> (offset / sizeof(T)));
+            continue;
+        }
+        if (buffer == nullptr || size - used < _symbol_size)
+            return done;
+        if (shared_enc == nullptr)
+            shared_enc = block_encoder (sbn);
+        uint8_t *out = buffer + used;
+        if (shared_enc == nullptr || shared_enc->Enc (id, out,
+                                        buffer + used + _symbol_size) == 0) {
+            return done;
         }
+        pkt.symbol = buffer + used;
+        used += _symbol_size;
     }
+    if (id >= last || buffer == nullptr)
+        return done;
+    // repair symbols: all in a single batch, split on the thread pool.
+    if (shared_enc == nullptr)
+        shared_enc = block_encoder (sbn);
+    if (shared_enc == nullptr)
+        return done;
+    const size_t repair = shared_enc->Enc_batch (id + padding, nullptr,
+                                                                last - id,
+                                                    buffer + used, size - used);
+    for (size_t idx = 0; idx < repair; ++idx, ++id, ++done) {
+        Packet_Desc &pkt = packets[done];
+        pkt.header = RaptorQ__v1::Impl::Endian::h_to_b<uint32_t> (
+                                (static_cast<uint32_t> (sbn) << 24) | id);
+        pkt.symbol = buffer + used;
+        pkt.size = _symbol_size;
+        used += _symbol_size;
+    }
+    return done;
+}
+
+template <typename Rnd_It, typename Fwd_It>
+size_t Encoder<Rnd_It, Fwd_It>::encode_range (uint8_t *output,
+                                    const size_t size, const uint32_t esi,
+                                    const uint32_t count, const uint8_t sbn)
+{
+    if (output == nullptr || sbn >= blocks())
+        return 0;
+    const uint32_t syms = symbols (sbn);
+    const uint32_t padding = static_cast<uint16_t> (extended_symbols (sbn)) -
+                                                                        syms;
+    const uint32_t last = static_cast<uint32_t> (std::min<uint64_t> (
+                                        static_cast<uint64_t> (esi) + count,
+                                                syms + max_repair (sbn)));
+    if (esi >= last)
+        return 0;
+    auto shared_enc = block_encoder (sbn);
+    if (shared_enc == nullptr)
+        return 0;
+    // the padding symbols sit between the source and the repair symbols
+    if (esi >= syms)
+        return shared_enc->Enc_batch (esi + padding, nullptr, last - esi,
+                                                                output, size);
+    if (padding == 0 || last <= syms)
+        return shared_enc->Enc_batch (esi, nullptr, last - esi, output, size);
+    const size_t source = shared_enc->Enc_batch (esi, nullptr, syms - esi,
+                                                                output, size);
+    if (source < syms - esi)
+        return source;
+    const size_t used = source * _symbol_size;
+    return source + shared_enc->Enc_batch (syms + padding, nullptr,
+                                    last - syms, output + used, size - used);
 }
 
 template <typename Rnd_It, typename Fwd_It>
@@ -954,6 +1302,23 @@ Error Decoder<In_It, Fwd_It>::add_symbol (In_It &start, const In_It end,
 template <typename In_It, typename Fwd_It>
 Error Decoder<In_It, Fwd_It>::add_symbol (In_It &start, const In_It end,
                                         const uint32_t esi, const uint8_t sbn)
+    { return add (start, end, esi, sbn); }
+
+template <typename In_It, typename Fwd_It>
+Error Decoder<In_It, Fwd_It>::add_symbol (const uint8_t *data,
+                                        const size_t size, const uint32_t esi,
+                                                            const uint8_t sbn)
+{
+    if (data == nullptr)
+        return Error::WRONG_INPUT;
+    const uint8_t *start = data;
+    return add (start, data + size, esi, sbn);
+}
+
+template <typename In_It, typename Fwd_It>
+template <typename It>
+Error Decoder<In_It, Fwd_It>::add (It &start, const It end, const uint32_t esi,
+                                                            const uint8_t sbn)
 {
     if (!operator bool())
         return Error::INITIALIZATION;
@@ -966,42 +1331,444 @@ Error Decoder<In_It, Fwd_It>::add_symbol (In_It &start, const In_It end,
     const uint16_t padding = static_cast<uint16_t> (b_size) - syms;
     const uint32_t real_esi = esi < syms ? esi : esi + padding;
 
-    bool added_decoder = false;
+    Dec dec;
+    bool pool, quiet;
+    auto err = block_decoder (sbn, dec, pool, quiet);
+    if (err != Error::NONE)
+        return err;
+
+    // the last symbol of the object can have less size than the symbol
+    // size, in which case we should add padding. With more sub-blocks
+    // the padding is interleaved, and only the whole symbol will do.
+    const bool add_padding = sbn == (_blocks - 1) && esi + 1 == syms &&
+                            (_sub_blocks.num (0) + _sub_blocks.num (1)) == 1;
+
+    err = dec.dec->add_symbol (start, end, real_esi, add_padding);
+    if (err != Error::NONE)
+        return err;
+    added (dec, sbn, pool, quiet);
+    return Error::NONE;
+}
+
+template <typename In_It, typename Fwd_It>
+Error Decoder<In_It, Fwd_It>::block_decoder (const uint8_t sbn, Dec &out,
+                                                    bool &pool, bool &quiet)
+{
+    const Block_Size b_size = this->extended_symbols (sbn);
+    const uint16_t padding = static_cast<uint16_t> (b_size) -
+                                                        this->symbols (sbn);
 
     std::unique_lock<std::mutex> lock (_mtx);
+    if (sink && !sink_ok)
+        return Error::EXITING;
+    if (sink && sbn < delivered)
+        return Error::NOT_NEEDED;
     auto it = decoders.find (sbn);
     if (it == decoders.end()) {
+        if (sink && sink_memory != 0 && sbn != delivered) {
+            // never refuse the next block: the sink would wait forever.
+            // the repair symbols of a block can be as big as its source ones.
+            size_t used = static_cast<size_t> (b_size) * _symbol_size;
+            for (const auto &d : decoders) {
+                used += static_cast<size_t> (extended_symbols (d.first)) *
+                                _symbol_size + d.second.dec->repair_bytes();
+            }
+            if (used > sink_memory)
+                return Error::WORKING;
+        }
         bool success;
         std::tie (it, success) = decoders.emplace (std::make_pair(sbn,
                                         Dec (b_size, _symbol_size, padding)));
         assert (success);
-        added_decoder = true;
+        if (progressive)
+            it->second.dec->set_progressive (true);
+        it->second.dec->set_decode_policy (policy);
+        if (storage != nullptr)
+            it->second.dec->set_storage (storage);
+    }
+    out = it->second;
+    pool = use_pool;
+    quiet = policy.quiet_ms != 0;
+    return Error::NONE;
+}
+
+template <typename In_It, typename Fwd_It>
+void Decoder<In_It, Fwd_It>::added (const Dec &dec, const uint8_t sbn,
+                                        const bool pool, const bool quiet)
+{
+    if (pool && quiet) {
+        // no symbol will arrive for a deferred block when its quiet
+        // period ends, so the other arrivals check it. The waiting thread
+        // of compute() does the same when nothing arrives at all.
+        const int64_t now = RaptorQ__v1::Impl::Raw_Decoder<In_It>::now_ms();
+        const int64_t left = dec.dec->quiet_left();
+        if (left >= 0) {
+            int64_t next = next_quiet;
+            while ((next < 0 || now + left < next) &&
+                    !next_quiet.compare_exchange_weak (next, now + left)) {
+                continue;
+            }
+        }
+        const int64_t next = next_quiet;
+        if (next >= 0 && next <= now)
+            queue_quiet();
+    }
+    // automatically add work to pool if we use it and have enough data.
+    // most symbols do not make the block decodable: check that before
+    // taking the pool lock.
+    if (pool && dec.dec->can_decode()) {
+        std::unique_lock<std::mutex> pool_lock (*_pool_mtx);
+        if (dec.dec->can_decode()) {
+            bool add_work = dec.dec->add_concurrent (
+                                                max_block_decoder_concurrency);
+            if (add_work) {
+                std::unique_ptr<Block_Work> work =
+                            std::unique_ptr<Block_Work>(new Block_Work());
+                work->work = dec.dec;
+                work->node = dec.node;
+                work->notify = _pool_notify;
+                work->lock = _pool_mtx;
+                Impl::Thread_Pool::get().add_work (std::move(work));
+            }
+        }
+        pool_lock.unlock();
+    }
+    // without the pool we decode here, and with the pool the block
+    // might have been decoded by the previous symbols.
+    if (sink && (!pool || sbn == blocks_delivered()))
+        deliver();
+}
+
+template <typename In_It, typename Fwd_It>
+size_t Decoder<In_It, Fwd_It>::add_packets (const Packet_Desc *packets,
+                                            const size_t count, Error &err)
+{
+    err = Error::NONE;
+    if (packets == nullptr || !operator bool()) {
+        err = Error::INITIALIZATION;
+        return 0;
+    }
+    constexpr uint32_t mask = ~(static_cast<uint32_t>(0xFF) << 24);
+    Dec dec;
+    bool pool = false, quiet = false, have_dec = false;
+    uint8_t dec_sbn = 0;
+    size_t idx = 0;
+    for (; idx < count; ++idx) {
+        const Packet_Desc &pkt = packets[idx];
+        const uint32_t id = RaptorQ__v1::Impl::Endian::b_to_h<uint32_t> (
+                                                                    pkt.header);
+        const uint8_t sbn = static_cast<uint8_t> (id >> 24);
+        uint32_t esi = id & mask;
+        if (pkt.symbol == nullptr || sbn >= _blocks)
+            continue;
+        if (!have_dec || sbn != dec_sbn) {
+            if (have_dec)
+                added (dec, dec_sbn, pool, quiet);
+            have_dec = false;
+            const auto dec_err = block_decoder (sbn, dec, pool, quiet);
+            if (dec_err == Error::WORKING || dec_err == Error::EXITING) {
+                err = dec_err;
+                break;
+            }
+            if (dec_err != Error::NONE)
+                continue;
+            have_dec = true;
+            dec_sbn = sbn;
+        }
+        const uint16_t syms = this->symbols (sbn);
+        const uint16_t padding = static_cast<uint16_t> (
+                                        this->extended_symbols (sbn)) - syms;
+        // a packet can carry more than one symbol. Only the last symbol
+        // of the object can be short, and is padded as in add().
+        const size_t whole = pkt.size / _symbol_size;
+        const size_t tail = pkt.size % _symbol_size;
+        const bool add_padding = tail != 0 && sbn == (_blocks - 1) &&
+                                    esi + whole + 1 == syms &&
+                            (_sub_blocks.num (0) + _sub_blocks.num (1)) == 1;
+        if (tail != 0 && !add_padding) {
+            err = Error::WRONG_INPUT;
+            break;
+        }
+        const uint8_t *data = pkt.symbol;
+        for (size_t left = pkt.size; left >= _symbol_size;
+                                            left -= _symbol_size, ++esi) {
+            const uint8_t *start = data;
+            const uint32_t real_esi = esi < syms ? esi : esi + padding;
+            dec.dec->add_symbol (start, data + _symbol_size, real_esi, false);
+            data += _symbol_size;
+        }
+        if (add_padding) {
+            const uint8_t *start = data;
+            dec.dec->add_symbol (start, data + tail, esi, true);
+        }
+    }
+    if (have_dec)
+        added (dec, dec_sbn, pool, quiet);
+    return idx;
+}
+
+template <typename In_It, typename Fwd_It>
+size_t Decoder<In_It, Fwd_It>::add_symbols (const uint8_t *data,
+                                    const size_t size, const uint32_t *ids,
+                                                        const uint32_t count)
+{
+    if (data == nullptr || ids == nullptr || !operator bool())
+        return 0;
+    constexpr uint32_t mask = ~(static_cast<uint32_t>(0xFF) << 24);
+    // only whole symbols: with more sub-blocks the padding of the last
+    // symbol of the object is not at its end.
+    const uint32_t whole = static_cast<uint32_t> (std::min<size_t> (count,
+                                                        size / _symbol_size));
+    size_t symbols_added = 0;
+    std::vector<uint32_t> esi;
+    std::vector<bool> done;
+    const auto sbn_of = [ids] (const uint32_t idx)
+        { return static_cast<uint8_t> (
+                    RaptorQ__v1::Impl::Endian::b_to_h (ids[idx]) >> 24); };
+    uint32_t from = 0;
+    while (from < whole) {
+        // a run of symbols of the same block
+        const uint8_t sbn = sbn_of (from);
+        uint32_t to = from + 1;
+        while (to < whole && sbn_of (to) == sbn)
+            ++to;
+        const uint32_t run = from;
+        from = to;
+        Dec dec;
+        bool pool, quiet;
+        if (sbn >= _blocks ||
+                        block_decoder (sbn, dec, pool, quiet) != Error::NONE) {
+            continue;
+        }
+        const uint16_t syms = this->symbols (sbn);
+        const uint16_t padding = static_cast<uint16_t> (
+                                        this->extended_symbols (sbn)) - syms;
+        esi.clear();
+        for (uint32_t idx = run; idx < to; ++idx) {
+            const uint32_t id = RaptorQ__v1::Impl::Endian::b_to_h (ids[idx]) &
+                                                                        mask;
+            esi.push_back (id < syms ? id : id + padding);
+        }
+        symbols_added += dec.dec->add_symbols (data + run * _symbol_size,
+                                                esi.data(), to - run, done);
+        added (dec, sbn, pool, quiet);
     }
-    auto dec = it->second.dec;
+    return symbols_added;
+}
+
+template <typename In_It, typename Fwd_It>
+void Decoder<In_It, Fwd_It>::set_progressive (const bool enable)
+{
+    std::unique_lock<std::mutex> lock (_mtx);
+    progressive = enable;
+    std::vector<Dec> decs;
+    for (auto &it : decoders)
+        decs.push_back (it.second);
     lock.unlock();
+    for (auto &it : decs)
+        it.dec->set_progressive (enable);
+    // some blocks might be decodable now
+    std::unique_lock<std::mutex> pool_lock (*_pool_mtx);
+    RQ_UNUSED(pool_lock);
+    queue_decodable (decs);
+}
 
-    // the last symbol in a block can have less size than the symbol size,
-    // in which case we should add padding
-    const bool add_padding = (esi == syms);
+template <typename In_It, typename Fwd_It>
+void Decoder<In_It, Fwd_It>::set_decode_policy (const Decode_Policy &new_policy)
+{
+    std::unique_lock<std::mutex> lock (_mtx);
+    policy = new_policy;
+    std::vector<Dec> decs;
+    for (auto &it : decoders)
+        decs.push_back (it.second);
+    lock.unlock();
+    for (auto &it : decs)
+        it.dec->set_decode_policy (new_policy);
+    std::unique_lock<std::mutex> pool_lock (*_pool_mtx);
+    queue_decodable (decs);
+    pool_lock.unlock();
+    // the waiting threads might need to change their timeouts
+    _pool_notify->notify_all();
+}
 
-    auto err = dec->add_symbol (start, end, real_esi, add_padding);
-    if (err != Error::NONE)
-        return err;
-    // automatically add work to pool if we use it and have enough data
+template <typename In_It, typename Fwd_It>
+void Decoder<In_It, Fwd_It>::queue_quiet()
+{
+    std::unique_lock<std::mutex> lock (_mtx);
+    std::vector<Dec> decs;
+    for (auto &it : decoders)
+        decs.push_back (it.second);
+    lock.unlock();
     std::unique_lock<std::mutex> pool_lock (*_pool_mtx);
     RQ_UNUSED(pool_lock);
-    if (use_pool && dec->can_decode()) {
-        bool add_work = dec->add_concurrent (max_block_decoder_concurrency);
-        if (add_work) {
-            std::unique_ptr<Block_Work> work = std::unique_ptr<Block_Work>(
-                                                            new Block_Work());
-            work->work = dec;
-            work->notify = _pool_notify;
-            work->lock = _pool_mtx;
-            Impl::Thread_Pool::get().add_work (std::move(work));
+    const int64_t wait = queue_decodable (decs);
+    if (wait < 0)
+        next_quiet = -1;
+    else
+        next_quiet = RaptorQ__v1::Impl::Raw_Decoder<In_It>::now_ms() + wait;
+}
+
+template <typename In_It, typename Fwd_It>
+bool Decoder<In_It, Fwd_It>::set_sink (const Decoder_Sink &new_sink,
+                                                    const size_t max_memory)
+{
+    std::unique_lock<std::mutex> lock (_mtx);
+    RQ_UNUSED(lock);
+    if (decoders.size() != 0 || delivered != 0)
+        return false;
+    sink = new_sink;
+    sink_memory = max_memory;
+    return true;
+}
+
+template <typename In_It, typename Fwd_It>
+bool Decoder<In_It, Fwd_It>::set_storage (const std::string &directory)
+{
+    auto file = std::make_shared<RaptorQ__v1::Impl::Scratch_File> (directory);
+    if (!*file)
+        return false;
+    std::unique_lock<std::mutex> lock (_mtx);
+    storage = file;
+    std::vector<Dec> decs;
+    for (auto &it : decoders)
+        decs.push_back (it.second);
+    lock.unlock();
+    // blocks being decoded right now stay in memory.
+    for (auto &it : decs)
+        it.dec->set_storage (file);
+    return true;
+}
+
+template <typename In_It, typename Fwd_It>
+uint8_t Decoder<In_It, Fwd_It>::blocks_delivered()
+{
+    std::unique_lock<std::mutex> lock (_mtx);
+    RQ_UNUSED(lock);
+    return delivered;
+}
+
+template <typename In_It, typename Fwd_It>
+void Decoder<In_It, Fwd_It>::deliver()
+{
+    // one delivery at a time, so the blocks are given in order.
+    std::unique_lock<std::mutex> sink_lock (_sink_mtx);
+    RQ_UNUSED(sink_lock);
+    std::unique_lock<std::mutex> lock (_mtx);
+    while (sink_ok) {
+        const uint8_t sbn = delivered;
+        auto it = decoders.find (sbn);
+        if (sbn >= _blocks || it == decoders.end())
+            return;
+        auto dec_ptr = it->second.dec;
+        lock.unlock();
+        if (!dec_ptr->ready()) {
+            if (use_pool || !dec_ptr->can_decode())
+                return;
+            RaptorQ__v1::Work_State keep_working =
+                                        RaptorQ__v1::Work_State::KEEP_WORKING;
+            dec_ptr->decode (&keep_working);
+            if (!dec_ptr->ready())
+                return;
+        }
+        std::vector<uint8_t> data (block_size (sbn));
+        Impl::De_Interleaver<uint8_t*> de_interleaving (dec_ptr->get_symbols(),
+                                                                _sub_blocks,
+                                                                symbols (sbn),
+                                                                _alignment);
+        uint8_t *out = data.data();
+        de_interleaving (out, data.data() + data.size(), data.size(), 0);
+        const bool keep_going = sink (sbn, data.data(), data.size());
+        bool notify = false;
+        lock.lock();
+        if (!keep_going) {
+            sink_ok = false;
+        } else {
+            // the block is gone: announce it now, or never.
+            it = decoders.find (sbn);
+            if (it != decoders.end())
+                notify = !it->second.notified;
+            decoders.erase (sbn);
+            ++delivered;
         }
+        lock.unlock();
+        if (notify && notifier)
+            notifier.fire (Notify_Event::BLOCK, Error::NONE, sbn);
+        _pool_notify->notify_all();
+        lock.lock();
     }
-    return Error::NONE;
+}
+
+template <typename In_It, typename Fwd_It>
+bool Decoder<In_It, Fwd_It>::deliverable()
+{
+    std::unique_lock<std::mutex> lock (_mtx);
+    RQ_UNUSED(lock);
+    if (!sink || !sink_ok)
+        return false;
+    auto it = decoders.find (delivered);
+    return it != decoders.end() && it->second.dec->ready();
+}
+
+template <typename In_It, typename Fwd_It>
+bool Decoder<In_It, Fwd_It>::sink_done()
+{
+    std::unique_lock<std::mutex> lock (_mtx);
+    RQ_UNUSED(lock);
+    return !sink_ok || delivered >= _blocks;
+}
+
+template <typename In_It, typename Fwd_It>
+void Decoder<In_It, Fwd_It>::notify_blocks()
+{
+    // in sink mode deliver() announces the blocks, in order.
+    if (!notifier || sink)
+        return;
+    std::vector<uint8_t> ready;
+    std::unique_lock<std::mutex> lock (_mtx);
+    for (auto &it : decoders) {
+        if (!it.second.notified && it.second.dec != nullptr &&
+                                                    it.second.dec->ready()) {
+            it.second.notified = true;
+            ready.push_back (it.first);
+        }
+    }
+    lock.unlock();
+    for (const uint8_t sbn : ready)
+        notifier.fire (Notify_Event::BLOCK, Error::NONE, sbn);
+}
+
+template <typename In_It, typename Fwd_It>
+void Decoder<In_It, Fwd_It>::set_notify (const Notify_Callback &callback)
+    { notifier.set (callback); }
+
+template <typename In_It, typename Fwd_It>
+int Decoder<In_It, Fwd_It>::notify_fd()
+    { return notifier.fd(); }
+
+template <typename In_It, typename Fwd_It>
+int64_t Decoder<In_It, Fwd_It>::queue_decodable (const std::vector<Dec> &decs)
+{
+    int64_t wait = -1;
+    if (!use_pool)
+        return wait;
+    for (auto &it : decs) {
+        if (!it.dec->can_decode()) {
+            const int64_t quiet = it.dec->quiet_left();
+            if (quiet >= 0 && (wait < 0 || quiet < wait))
+                wait = quiet;
+            continue;
+        }
+        if (!it.dec->add_concurrent (max_block_decoder_concurrency))
+            continue;   // whoever is working on it will requeue it
+        std::unique_ptr<Block_Work> work = std::unique_ptr<Block_Work>(
+                                                            new Block_Work());
+        work->work = it.dec;
+        work->node = it.node;
+        work->notify = _pool_notify;
+        work->lock = _pool_mtx;
+        Impl::Thread_Pool::get().add_work (std::move(work));
+    }
+    return wait;
 }
 
 template <typename In_It, typename Fwd_It>
@@ -1328,21 +2095,65 @@ void Decoder<In_It, Fwd_It>::wait_threads (Decoder<In_It, Fwd_It> *obj,
                                     std::promise<std::pair<Error, uint8_t>> p)
 {
     auto _notify = obj->_pool_notify;
+    bool reported = false, fired = false;
+    std::pair<Error, uint8_t> result {Error::EXITING, 0};
     while (true) {
+        // the sink and the callback might be slow: do not hold the pool lock.
+        if (obj->sink)
+            obj->deliver();
+        obj->notify_blocks();
+        if (reported && !fired) {
+            obj->notifier.fire (Notify_Event::COMPUTE, result.first,
+                                                                result.second);
+            fired = true;
+        }
         std::unique_lock<std::mutex> lock (*obj->_pool_mtx);
         if (obj->exiting) { // make sure we can exit
-            p.set_value ({Error::EXITING, 0});
+            if (!reported)
+                p.set_value (result);
+            reported = true;
             break;
         }
+        if (reported && obj->sink_done())
+            break;
+        if (obj->deliverable())
+            continue;   // decoded while we were delivering
+        // deferred blocks (see Decode_Policy) are not started by the
+        // arrival of new symbols: start them here, before reporting
+        // that they can not be decoded.
+        std::unique_lock<std::mutex> dec_lock (obj->_mtx);
+        std::vector<Dec> decs;
+        if (obj->policy.overhead != 0 || obj->policy.max_failure > 0) {
+            for (auto &it : obj->decoders)
+                decs.push_back (it.second);
+        }
+        dec_lock.unlock();
+        const int64_t quiet = obj->queue_decodable (decs);
         auto status = obj->get_report (flags);
         if (Error::WORKING != status.first) {
-            p.set_value (status);
-            break;
+            if (!reported) {
+                p.set_value (status);
+                result = status;
+            }
+            reported = true;
+            // partial reports come before the end: keep feeding the sink.
+            if (!obj->sink || Error::NONE != status.first ||
+                                                        obj->sink_done()) {
+                break;
+            }
         }
 
-        _notify->wait (lock);
+        if (quiet < 0) {
+            _notify->wait (lock);
+        } else {
+            _notify->wait_for (lock, std::chrono::milliseconds (
+                                                std::max<int64_t> (1, quiet)));
+        }
         lock.unlock();
     }
+    obj->notify_blocks();
+    if (!fired)
+        obj->notifier.fire (Notify_Event::COMPUTE, result.first, result.second);
 
     // delete ourselves from the waiting thread vector.
     std::unique_lock<std::mutex> lock (*obj->_pool_mtx);
@@ -1361,14 +2172,22 @@ template <typename In_It, typename Fwd_It>
 std::pair<Error, uint8_t> Decoder<In_It, Fwd_It>::get_report (
                                                             const Compute flags)
 {
-    if (decoders.size() == 0)
+    // the pool lock is held: take the decoder lock after it.
+    std::unique_lock<std::mutex> dec_lock (_mtx);
+    if (sink && !sink_ok)
+        return {Error::EXITING, 0};
+    if (decoders.size() == 0 && delivered == 0)
         return {Error::WORKING, 0};
     if (Compute::COMPLETE == (flags & Compute::COMPLETE) ||
             Compute::PARTIAL_FROM_BEGINNING ==
                                     (flags & Compute::PARTIAL_FROM_BEGINNING)) {
         uint16_t reportable = 0;
         uint16_t next_expected = static_cast<uint16_t> (pool_last_reported + 1);
-        std::unique_lock<std::mutex> dec_lock (_mtx);
+        // the blocks given to the sink are gone, but were decoded.
+        if (delivered > next_expected) {
+            reportable = delivered - next_expected;
+            next_expected = delivered;
+        }
         auto it = decoders.lower_bound (static_cast<uint8_t> (next_expected));
 
         // get last reportable block
@@ -1407,8 +2226,6 @@ std::pair<Error, uint8_t> Decoder<In_It, Fwd_It>::get_report (
     } else if (Compute::PARTIAL_ANY == (flags & Compute::PARTIAL_ANY)) {
         // invalidate other pointers.
         auto undecodable = decoders.end();
-        std::unique_lock<std::mutex> dec_lock (_mtx);
-        RQ_UNUSED(dec_lock);
         for (auto it = decoders.begin(); it != decoders.end(); ++it) {
             if (!it->second.reported) {
                 auto ptr = it->second.dec;
@@ -1607,6 +2424,35 @@ size_t Decoder<In_It, Fwd_It>::decode_block_bytes (Fwd_It &start,
     return de_interleaving (start, end, max_bytes, skip);
 }
 
+template <typename In_It, typename Fwd_It>
+uint64_t Decoder<In_It, Fwd_It>::decode_blocks (Fwd_It &start,
+                                    const Fwd_It end, const uint8_t *sbns,
+                                                        const uint16_t count)
+{
+    using T = typename std::iterator_traits<Fwd_It>::value_type;
+    if (sbns == nullptr)
+        return 0;
+    uint64_t written = 0;
+    uint8_t skip = 0;
+    for (uint16_t idx = 0; idx < count; ++idx) {
+        const uint8_t sbn = sbns[idx];
+        auto tmp_start = start;
+        const size_t bytes = decode_block_bytes (tmp_start, end, skip, sbn);
+        written += bytes;
+        // same as decode_bytes: do not skip a half-written Fwd_It
+        const uint64_t bytes_and_skip = skip + bytes;
+        skip = static_cast<uint8_t> (bytes_and_skip % sizeof(T));
+        if (skip == 0) {
+            start = tmp_start;
+        } else {
+            start += static_cast<int64_t> (bytes_and_skip / sizeof(T));
+        }
+        if (sbn >= _blocks || bytes < block_size (sbn))
+            return written;
+    }
+    return written;
+}
+
 template <typename In_It, typename Fwd_It>
 Decoder_written Decoder<In_It, Fwd_It>::decode_aligned (Fwd_It &start,
                                                             const Fwd_It end,
@@ -1656,6 +2502,8 @@ template <typename In_It, typename Fwd_It>
 bool Decoder<In_It, Fwd_It>::is_block_ready (const uint8_t block)
 {
     std::unique_lock<std::mutex> block_lock (_mtx);
+    if (block < delivered)
+        return true;
     auto it = decoders.find (block);
     if (it == decoders.end())
         return false;
@@ -0,0 +1,306 @@
+/*
+ * Copyright (c) 2015-2018, Luca Fulchir<luca@fulchir.it>, All rights reserved.
+ *
+ * This file is part of "libRaptorQ".
+ *
+ * libRaptorQ is free software: you can redistribute it and/or modify
+ * it under the terms of the GNU Lesser General Public License as
+ * published by the Free Software Foundation, either version 3
+ * of the License, or (at your option) any later version.
+ *
+ * libRaptorQ is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ * GNU General Public License for more details.
+ *
+ * You should have received a copy of the GNU General Public License
+ * and a copy of the GNU Lesser General Public License
+ * along with libRaptorQ.  If not, see <http://www.gnu.org/licenses/>.
+ */
+
+#pragma once
+
+#include "RaptorQ/v1/common.hpp"
+#include "RaptorQ/v1/block_sizes.hpp"
+#include "RaptorQ/v1/Interleaver.hpp"
+#include "RaptorQ/v1/Parameters.hpp"
+#include <algorithm>
+#include <cmath>
+#include <limits>
+#include <vector>
+
+/////////////////////
+//
+//  Planner: choose the OTI parameters (symbol_size, min_subsymbol_size,
+//  max_sub_block) of an RFC6330 Encoder for an object.
+//
+//  The cost of a block grows much faster than its number of symbols (K'),
+//  so the same object can take seconds or hours depending on how the
+//  Interleaver splits it. The planner tries every K' the RFC allows for
+//  the object, and keeps the one with the lowest predicted time given
+//  the cores, the memory and the expected packet loss.
+//
+/////////////////////
+
+namespace RFC6330__v1 {
+
+namespace Impl {
+class RAPTORQ_LOCAL Planner;
+struct RAPTORQ_LOCAL Transfer_Plan;
+} // namespace Impl
+#ifdef RQ_HEADER_ONLY
+    using Planner = Impl::Planner;
+    using Transfer_Plan = Impl::Transfer_Plan;
+#endif
+
+namespace Impl {
+
+struct RAPTORQ_LOCAL Transfer_Plan
+{
+    // NONE: use the parameters below.
+    // WRONG_INPUT: bad arguments, or no block fits in the memory limit.
+    Error error = Error::WRONG_INPUT;
+
+    // for the Encoder
+    uint16_t symbol_size = 0;
+    uint16_t min_subsymbol_size = 0;
+    size_t max_sub_block = 0;
+
+    // what the Interleaver makes of them
+    uint8_t blocks = 0;
+    uint16_t symbols = 0;           // K' of the biggest block
+    uint16_t threads = 0;           // blocks worked on at the same time
+    uint32_t repair_symbols = 0;    // to send for each block at that loss,
+                                    // on top of its K source symbols
+    size_t memory = 0;              // bytes used by "threads" blocks
+
+    // predicted wall-clock time for the whole object
+    double encode_seconds = 0;
+    double decode_seconds = 0;
+};
+
+class RAPTORQ_LOCAL Planner
+{
+public:
+    // time to encode or decode one block of "symbols" (K') symbols:
+    //      matrix + per_byte * symbol_size     seconds
+    struct Cost
+    {
+        uint16_t symbols;
+        double matrix, per_byte;
+    };
+
+    // the built-in table was measured up to K' = 2737: bigger blocks,
+    // up to K' = 56403, are extrapolated with the power law of the last
+    // two points, so their seconds are only a rough guess.
+    Planner();
+    // your own measures, at least two points. "symbol_byte" is the time
+    // to generate one byte of a repair symbol.
+    Planner (std::vector<Cost> costs, const double symbol_byte);
+    Planner (const Planner&) = default;
+    Planner& operator= (const Planner&) = default;
+    Planner (Planner&&) = default;
+    Planner& operator= (Planner&&) = default;
+    ~Planner() = default;
+
+    explicit operator bool() const
+        { return _costs.size() >= 2; }
+
+    // "size": bytes of the object, multiple of sizeof(T).
+    // "packet_size": maximum symbol size.
+    // "memory": bytes for the blocks being worked on. 0: no limit.
+    // "loss": expected fraction of lost packets, in [0, 1).
+    template <typename Rnd_It = uint8_t*>
+    Transfer_Plan plan (const uint64_t size, const uint16_t packet_size,
+                                    const size_t memory, const uint16_t cores,
+                                                    const double loss) const;
+
+    // predicted seconds to encode or decode a single block
+    double block_seconds (const uint16_t symbols,
+                                            const uint16_t symbol_size) const;
+    // working memory of a single block
+    static size_t block_memory (const uint16_t symbols,
+                                            const uint16_t symbol_size);
+    // symbols to send for a block of K source symbols so that it can
+    // almost always be decoded with the given loss. The padding symbols
+    // (K' - K) are never sent.
+    static uint32_t sent_symbols (const uint16_t symbols, const double loss);
+
+private:
+    std::vector<Cost> _costs;
+    double _symbol_byte;
+
+    static double interpolate (const double x, const double x0,
+                                            const double y0, const double x1,
+                                                            const double y1);
+};
+
+///////////////////////////////////
+//
+// IMPLEMENTATION OF ABOVE CLASS
+//
+///////////////////////////////////
+
+inline Planner::Planner()
+{
+    // RAW Encoder and Decoder (5% loss), single core of a small x86-64 box,
+    // from 16 and 1024 bytes symbols. per_byte over 1000 symbols is
+    // smoothed, the measures were too noisy.
+    // Faster CPUs just scale everything: the choice does not change,
+    // only the predicted seconds. Give your own table for real figures.
+    _costs = {
+        {   10, 1.30e-4, 1.76e-6 },
+        {   20, 2.78e-4, 2.54e-6 },
+        {   42, 6.89e-4, 6.60e-6 },
+        {   84, 2.45e-3, 1.88e-5 },
+        {  168, 1.25e-2, 6.68e-5 },
+        {  337, 6.96e-2, 2.16e-4 },
+        {  675, 4.79e-1, 7.56e-4 },
+        { 1361, 3.78,    2.2e-3  },
+        { 2737, 22.4,    6.3e-3  }
+    };
+    // nothing measured past K' = 2737: block_seconds() extends the
+    // last segment.
+    _symbol_byte = 1e-9;
+}
+
+inline Planner::Planner (std::vector<Cost> costs, const double symbol_byte)
+    : _costs (std::move (costs)), _symbol_byte (symbol_byte)
+{
+    std::sort (_costs.begin(), _costs.end(), [] (const Cost &a, const Cost &b)
+                                            { return a.symbols < b.symbols; });
+    // we work in log-log space: only positive, distinct points
+    bool ok = _symbol_byte >= 0;
+    for (size_t idx = 0; ok && idx < _costs.size(); ++idx) {
+        if (_costs[idx].symbols == 0 || !(_costs[idx].matrix > 0) ||
+                                                !(_costs[idx].per_byte > 0) ||
+                    (idx > 0 && _costs[idx].symbols == _costs[idx - 1].symbols))
+            ok = false;
+    }
+    if (!ok)
+        _costs.clear();
+}
+
+inline double Planner::interpolate (const double x, const double x0,
+                                            const double y0, const double x1,
+                                                            const double y1)
+{
+    // straight line in log-log: power law between (and past) the points
+    const double slope = (std::log (y1) - std::log (y0)) /
+                                            (std::log (x1) - std::log (x0));
+    return y0 * std::pow (x / x0, slope);
+}
+
+inline double Planner::block_seconds (const uint16_t symbols,
+                                            const uint16_t symbol_size) const
+{
+    if (_costs.size() < 2)
+        return 0;
+    size_t idx = 1;
+    while (idx < _costs.size() - 1 && _costs[idx].symbols < symbols)
+        ++idx;
+    const Cost &a = _costs[idx - 1], &b = _costs[idx];
+    const double x = symbols;
+    return interpolate (x, a.symbols, a.matrix, b.symbols, b.matrix) +
+                        interpolate (x, a.symbols, a.per_byte,
+                                                    b.symbols, b.per_byte) *
+                                                                    symbol_size;
+}
+
+inline size_t Planner::block_memory (const uint16_t symbols,
+                                                    const uint16_t symbol_size)
+{
+    // L x L precode matrix, plus the intermediate and received symbols.
+    const RaptorQ__v1::Impl::Parameters params (symbols);
+    const size_t L = params.L;
+    return L * L + 2 * L * symbol_size;
+}
+
+inline uint32_t Planner::sent_symbols (const uint16_t symbols,
+                                                            const double loss)
+{
+    // K + 2 received symbols fail about once in a million: the decoder
+    // already knows the K' - K padding symbols, so it gets K' + 2.
+    // The received ones are binomial: ask for 3 sigmas more than that.
+    const double need = static_cast<double> (symbols) + 2;
+    if (!(loss > 0))
+        return static_cast<uint32_t> (need);
+    const double ok = 1 - loss;
+    const double sigma = 3 * std::sqrt (loss * ok);
+    const double root = (sigma + std::sqrt (sigma * sigma + 4 * ok * need)) /
+                                                                    (2 * ok);
+    return static_cast<uint32_t> (std::ceil (root * root));
+}
+
+template <typename Rnd_It>
+Transfer_Plan Planner::plan (const uint64_t size, const uint16_t packet_size,
+                                    const size_t memory, const uint16_t cores,
+                                                    const double loss) const
+{
+    using T = typename std::iterator_traits<Rnd_It>::value_type;
+    Transfer_Plan best;
+    const uint16_t symbol_size = static_cast<uint16_t> (packet_size -
+                                                    (packet_size % sizeof(T)));
+    if (_costs.size() < 2 || size == 0 || size > RFC6330_max_data ||
+                                (size % sizeof(T)) != 0 || symbol_size == 0 ||
+                                                !(loss >= 0) || !(loss < 1)) {
+        return best;
+    }
+    // sub-blocks only shrink the working set of in-place decoders.
+    // Ours keep the whole block anyway: one sub-block, K' <= WS / T.
+    double best_time = std::numeric_limits<double>::infinity();
+    uint8_t last_blocks = 0;
+    for (const uint16_t K_padded : RaptorQ__v1::Impl::K_padded) {
+        const size_t max_sub_block = static_cast<size_t> (K_padded) *
+                                                                symbol_size;
+        const Interleaver<Rnd_It> interleaver (size, symbol_size,
+                                                max_sub_block, symbol_size);
+        if (!interleaver)
+            continue;   // too many blocks
+        const uint8_t blocks = interleaver.blocks();
+        if (blocks == last_blocks)
+            continue;   // same layout as the previous K'
+        last_blocks = blocks;
+        const uint16_t symbols = static_cast<uint16_t> (
+                                            interleaver.extended_symbols (0));
+        const uint16_t source = interleaver.source_symbols (0);
+        const size_t block_mem = block_memory (symbols, symbol_size);
+        if (memory != 0 && block_mem > memory)
+            break;      // bigger blocks will not fit either
+        size_t threads = std::min<size_t> (std::max<uint16_t> (cores, 1),
+                                                                        blocks);
+        if (memory != 0)
+            threads = std::min<size_t> (threads, memory / block_mem);
+        const double waves = std::ceil (static_cast<double> (blocks) /
+                                                static_cast<double> (threads));
+
+        // encoding: always solve, then generate what we send.
+        // decoding: solve only if some source symbol is lost.
+        const uint32_t sent = sent_symbols (source, loss);
+        const double solve = block_seconds (symbols, symbol_size);
+        const double encode = waves * (solve + static_cast<double> (sent) *
+                                                    symbol_size * _symbol_byte);
+        const double decode = waves * solve *
+                                    (1 - std::pow (1 - loss, source));
+        if (encode + decode < best_time) {
+            best_time = encode + decode;
+            best.error = Error::NONE;
+            best.symbol_size = symbol_size;
+            best.min_subsymbol_size = symbol_size;
+            best.max_sub_block = max_sub_block;
+            best.blocks = blocks;
+            best.symbols = symbols;
+            best.threads = static_cast<uint16_t> (threads);
+            best.repair_symbols = sent - source;
+            best.memory = threads * block_mem;
+            best.encode_seconds = encode;
+            best.decode_seconds = decode;
+        }
+        if (blocks == 1)
+            break;
+    }
+    return best;
+}
+
+}   // namespace Impl
+}   // namespace RFC6330__v1
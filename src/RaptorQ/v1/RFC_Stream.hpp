@@ -0,0 +1,498 @@
+/*
+ * Copyright (c) 2015-2018, Luca Fulchir<luca@fulchir.it>, All rights reserved.
+ *
+ * This file is part of "libRaptorQ".
+ *
+ * libRaptorQ is free software: you can redistribute it and/or modify
+ * it under the terms of the GNU Lesser General Public License as
+ * published by the Free Software Foundation, either version 3
+ * of the License, or (at your option) any later version.
+ *
+ * libRaptorQ is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ * GNU General Public License for more details.
+ *
+ * You should have received a copy of the GNU General Public License
+ * and a copy of the GNU Lesser General Public License
+ * along with libRaptorQ.  If not, see <http://www.gnu.org/licenses/>.
+ */
+
+#pragma once
+
+#include "RaptorQ/v1/common.hpp"
+#include "RaptorQ/v1/block_sizes.hpp"
+#include "RaptorQ/v1/Encoder.hpp"
+#include "RaptorQ/v1/Interleaver.hpp"
+#include "RaptorQ/v1/Thread_Pool.hpp"
+#include "RaptorQ/v1/util/endianess.hpp"
+#include <algorithm>
+#include <atomic>
+#include <cmath>
+#include <condition_variable>
+#include <iterator>
+#include <map>
+#include <memory>
+#include <mutex>
+#include <type_traits>
+#include <utility>
+#include <vector>
+
+/////////////////////
+//
+//  Stream_Encoder: RFC6330 encoder for objects that do not fit in memory.
+//  The object is given in order, a piece at a time. Each source block
+//  is computed on the thread pool as soon as all its data arrived,
+//  and lives until "free()". At most "window" blocks are kept in memory.
+//
+//  Same symbols and OTI as RFC6330__v1::Encoder on the same object.
+//
+/////////////////////
+
+namespace RFC6330__v1 {
+
+namespace Impl {
+template <typename In_It, typename Fwd_It>
+class RAPTORQ_LOCAL Stream_Encoder;
+} // namespace Impl
+#ifdef RQ_HEADER_ONLY
+    template <typename In_It, typename Fwd_It>
+    using Stream_Encoder = Impl::Stream_Encoder<In_It, Fwd_It>;
+#endif
+
+namespace Impl {
+
+template <typename In_It, typename Fwd_It>
+class RAPTORQ_LOCAL Stream_Encoder
+{
+    using T = typename std::iterator_traits<In_It>::value_type;
+public:
+    Stream_Encoder() = delete;
+    Stream_Encoder (const Stream_Encoder&) = delete;
+    Stream_Encoder& operator= (const Stream_Encoder&) = delete;
+    Stream_Encoder (Stream_Encoder&&) = delete;
+    Stream_Encoder& operator= (Stream_Encoder&&) = delete;
+    ~Stream_Encoder();
+    // "size": bytes of the whole object, multiple of sizeof(T).
+    // "window": maximum number of source blocks in memory.
+    Stream_Encoder (const uint64_t size, const uint16_t min_subsymbol_size,
+                                            const uint16_t symbol_size,
+                                            const size_t max_sub_block,
+                                            const uint8_t window)
+        : _size (size), _symbol_size (symbol_size),
+                    _window (std::max<uint8_t> (1, window)),
+                    interleave (size, min_subsymbol_size, max_sub_block,
+                                                                symbol_size)
+    {
+        IS_INPUT(In_It, "RFC6330__v1::Stream_Encoder");
+        IS_FORWARD(Fwd_It, "RFC6330__v1::Stream_Encoder");
+        _pool_notify = std::make_shared<std::condition_variable>();
+        _pool_mtx = std::make_shared<std::mutex>();
+        _next = 0;
+    }
+
+    operator bool() const
+        { return interleave && _size <= RFC6330_max_data; }
+    RFC6330_OTI_Common_Data OTI_Common() const;
+    RFC6330_OTI_Scheme_Specific_Data OTI_Scheme_Specific() const;
+
+    // the next part of the object. Returns the number of elements used:
+    // less than (to - from) if "window" blocks are in memory and the next
+    // block can not be started. free() some blocks and retry.
+    // The block still being filled counts as one of the "window".
+    // Only one thread at a time can call this.
+    size_t feed (In_It from, const In_It to);
+    // first block that did not get all its data yet. blocks() when done.
+    uint8_t next_block() const;
+    // wait until block "sbn" can be encoded.
+    // NEED_DATA: the block did not get all its data.
+    // WRONG_INPUT: no such block, or already freed.
+    Error wait (const uint8_t sbn);
+    bool ready (const uint8_t sbn) const;
+
+    size_t encode (Fwd_It &output, const Fwd_It end, const uint32_t esi,
+                                                            const uint8_t sbn);
+    // same, on a plain buffer. returns the number of bytes written.
+    size_t encode (uint8_t *output, const size_t size, const uint32_t esi,
+                                                            const uint8_t sbn);
+    void free (const uint8_t sbn);
+
+    uint8_t blocks() const;
+    uint32_t block_size (const uint8_t sbn) const;
+    uint16_t symbol_size() const;
+    uint16_t symbols (const uint8_t sbn) const;
+    Block_Size extended_symbols (const uint8_t sbn) const;
+    uint32_t max_repair (const uint8_t sbn) const;
+private:
+    using Raw_Enc = RaptorQ__v1::Impl::Raw_Encoder<T*, Fwd_It,
+                                        RaptorQ__v1::Impl::without_interleaver>;
+    // a source block with all its data, already interleaved:
+    // one symbol after the other.
+    class Block {
+    public:
+        Block (const Block_Size extended, const size_t symbol_bytes,
+                                                const size_t elements)
+            : data (elements, static_cast<T> (0)),
+                enc (std::make_shared<Raw_Enc> (extended, symbol_bytes)),
+                node (std::make_shared<std::atomic<int32_t>> (-1))
+        {
+            from = data.data();
+            to = data.data() + data.size();
+        }
+        std::vector<T> data;
+        T *from, *to;
+        std::shared_ptr<Raw_Enc> enc;
+        std::shared_ptr<std::atomic<int32_t>> node;
+    };
+
+    class Block_Work final : public Impl::Pool_Work {
+    public:
+        std::weak_ptr<Block> work;
+        std::weak_ptr<std::condition_variable> notify;
+        std::weak_ptr<std::mutex> lock;
+
+        Work_Exit_Status do_work (RaptorQ__v1::Work_State *state) override;
+        ~Block_Work() override;
+    };
+
+    const uint64_t _size;
+    const uint16_t _symbol_size;
+    const uint8_t _window;
+    const Interleaver<T*> interleave;
+    // data of the block "_next", in object order.
+    // Only feed() changes these, "_next" under the pool lock.
+    std::vector<T> _filling;
+    uint8_t _next;
+    std::map<uint8_t, std::shared_ptr<Block>> _blocks;
+    std::shared_ptr<std::condition_variable> _pool_notify;
+    std::shared_ptr<std::mutex> _pool_mtx;
+
+    size_t block_elements (const uint8_t sbn) const;
+    // append up to "count" elements to "_filling". returns how many.
+    // a single copy with random access iterators.
+    template <typename It = In_It, typename std::enable_if<std::is_same<
+                        typename std::iterator_traits<It>::iterator_category,
+                        std::random_access_iterator_tag>::value, int>::type = 0>
+    size_t fill (It &from, const It to, const size_t count);
+    template <typename It = In_It, typename std::enable_if<!std::is_same<
+                        typename std::iterator_traits<It>::iterator_category,
+                        std::random_access_iterator_tag>::value, int>::type = 0>
+    size_t fill (It &from, const It to, const size_t count);
+    // call with the pool lock held. the block being filled counts
+    // against the window, too.
+    size_t in_memory() const
+        { return _blocks.size() + (_filling.size() == 0 ? 0 : 1); }
+    void start_block();
+};
+
+///////////////////////////////////
+//
+// IMPLEMENTATION OF ABOVE TEMPLATE
+//
+///////////////////////////////////
+
+template <typename In_It, typename Fwd_It>
+Stream_Encoder<In_It, Fwd_It>::~Stream_Encoder()
+{
+    // running works keep their block alive, we just tell them to stop.
+    std::unique_lock<std::mutex> lock (*_pool_mtx);
+    for (auto &blk : _blocks)
+        blk.second->enc->stop();
+    lock.unlock();
+    _pool_notify->notify_all();
+}
+
+template <typename In_It, typename Fwd_It>
+Work_Exit_Status Stream_Encoder<In_It, Fwd_It>::Block_Work::do_work (
+                                                RaptorQ__v1::Work_State *state)
+{
+    auto locked_blk = work.lock();
+    auto locked_notify = notify.lock();
+    auto locked_mtx = lock.lock();
+    if (locked_blk != nullptr && locked_notify != nullptr &&
+                                                        locked_mtx != nullptr) {
+        if (!locked_blk->enc->generate_symbols (state, &locked_blk->from,
+                                                            &locked_blk->to)) {
+            return Work_Exit_Status::STOPPED;
+        }
+        work.reset();
+        std::unique_lock<std::mutex> p_lock (*locked_mtx);
+        RQ_UNUSED(p_lock);
+        locked_notify->notify_all();
+    }
+    return Work_Exit_Status::DONE;
+}
+
+template <typename In_It, typename Fwd_It>
+Stream_Encoder<In_It, Fwd_It>::Block_Work::~Block_Work()
+{
+    // have we been called before the computation finished?
+    auto locked_blk = work.lock();
+    auto locked_notify = notify.lock();
+    auto locked_mtx = lock.lock();
+    if (locked_blk != nullptr && locked_notify != nullptr &&
+                                                        locked_mtx != nullptr) {
+        locked_blk->enc->stop();
+        std::unique_lock<std::mutex> p_lock (*locked_mtx);
+        RQ_UNUSED(p_lock);
+        locked_notify->notify_all();
+    }
+}
+
+template <typename In_It, typename Fwd_It>
+RFC6330_OTI_Common_Data Stream_Encoder<In_It, Fwd_It>::OTI_Common() const
+{
+    if (!*this)
+        return 0;
+    // first 40 bits: data length. 8 bits: reserved. 16 bits: symbol size
+    const RFC6330_OTI_Common_Data ret = (_size << 24) + _symbol_size;
+    return RaptorQ__v1::Impl::Endian::h_to_b<RFC6330_OTI_Common_Data> (ret);
+}
+
+template <typename In_It, typename Fwd_It>
+RFC6330_OTI_Scheme_Specific_Data
+                        Stream_Encoder<In_It, Fwd_It>::OTI_Scheme_Specific() const
+{
+    if (!*this)
+        return 0;
+    // 8 bit: source blocks. 16 bit: sub-blocks number (N). 8 bit: alignment
+    RFC6330_OTI_Scheme_Specific_Data ret;
+    ret = static_cast<uint32_t> (interleave.blocks()) << 24;
+    ret += static_cast<uint32_t> (interleave.sub_blocks()) << 8;
+    ret += sizeof(T);
+    return RaptorQ__v1::Impl::Endian::h_to_b<RFC6330_OTI_Scheme_Specific_Data> (
+                                                                        ret);
+}
+
+template <typename In_It, typename Fwd_It>
+size_t Stream_Encoder<In_It, Fwd_It>::block_elements (const uint8_t sbn) const
+{
+    // the last block ends with the object, not with its symbols.
+    uint64_t before = 0;
+    for (uint8_t blk = 0; blk < sbn; ++blk)
+        before += interleave.source_symbols (blk);
+    const uint64_t al_symbol = _symbol_size / sizeof(T);
+    const uint64_t elements = _size / sizeof(T);
+    const uint64_t start = before * al_symbol;
+    return static_cast<size_t> (std::min<uint64_t> (elements - start,
+                                interleave.source_symbols (sbn) * al_symbol));
+}
+
+template <typename In_It, typename Fwd_It>
+void Stream_Encoder<In_It, Fwd_It>::start_block()
+{
+    // "_filling" has all the data of block "_next".
+    const uint8_t sbn = _next;
+    const uint16_t syms = interleave.source_symbols (sbn);
+    const size_t al_symbol = _symbol_size / sizeof(T);
+    auto blk = std::make_shared<Block> (interleave.extended_symbols (sbn),
+                                            _symbol_size, syms * al_symbol);
+    auto source = interleave.block (sbn, _filling.data(),
+                                            _filling.data() + _filling.size());
+    uint8_t *out = reinterpret_cast<uint8_t*> (blk->data.data());
+    for (uint16_t esi = 0; esi < syms; ++esi)
+        source[esi].copy_to (out + esi * _symbol_size);
+    _filling = std::vector<T>();
+
+    std::unique_lock<std::mutex> lock (*_pool_mtx);
+    _blocks.emplace (sbn, blk);
+    ++_next;
+    lock.unlock();
+    std::unique_ptr<Block_Work> work = std::unique_ptr<Block_Work> (
+                                                            new Block_Work());
+    work->work = blk;
+    work->node = blk->node;
+    work->notify = _pool_notify;
+    work->lock = _pool_mtx;
+    Thread_Pool::get().add_work (std::move (work));
+}
+
+template <typename In_It, typename Fwd_It>
+size_t Stream_Encoder<In_It, Fwd_It>::feed (In_It from, const In_It to)
+{
+    if (!*this)
+        return 0;
+    size_t used = 0;
+    while (from != to && _next < interleave.blocks()) {
+        const size_t needed = block_elements (_next);
+        if (_filling.size() == 0) {
+            std::unique_lock<std::mutex> lock (*_pool_mtx);
+            if (in_memory() >= _window)
+                break;
+            lock.unlock();
+            _filling.reserve (needed);
+        }
+        used += fill (from, to, needed - _filling.size());
+        if (_filling.size() == needed)
+            start_block();
+    }
+    return used;
+}
+
+template <typename In_It, typename Fwd_It>
+template <typename It, typename std::enable_if<std::is_same<
+                        typename std::iterator_traits<It>::iterator_category,
+                        std::random_access_iterator_tag>::value, int>::type>
+size_t Stream_Encoder<In_It, Fwd_It>::fill (It &from, const It to,
+                                                        const size_t count)
+{
+    using Diff = typename std::iterator_traits<It>::difference_type;
+    const size_t elements = std::min (count, static_cast<size_t> (to - from));
+    const It last = from + static_cast<Diff> (elements);
+    _filling.insert (_filling.end(), from, last);
+    from = last;
+    return elements;
+}
+
+template <typename In_It, typename Fwd_It>
+template <typename It, typename std::enable_if<!std::is_same<
+                        typename std::iterator_traits<It>::iterator_category,
+                        std::random_access_iterator_tag>::value, int>::type>
+size_t Stream_Encoder<In_It, Fwd_It>::fill (It &from, const It to,
+                                                        const size_t count)
+{
+    size_t elements = 0;
+    for (; from != to && elements < count; ++from, ++elements)
+        _filling.push_back (*from);
+    return elements;
+}
+
+template <typename In_It, typename Fwd_It>
+uint8_t Stream_Encoder<In_It, Fwd_It>::next_block() const
+{
+    std::unique_lock<std::mutex> lock (*_pool_mtx);
+    RQ_UNUSED(lock);
+    return std::min (_next, blocks());
+}
+
+template <typename In_It, typename Fwd_It>
+Error Stream_Encoder<In_It, Fwd_It>::wait (const uint8_t sbn)
+{
+    if (sbn >= blocks())
+        return Error::WRONG_INPUT;
+    std::unique_lock<std::mutex> lock (*_pool_mtx);
+    auto it = _blocks.find (sbn);
+    if (it == _blocks.end())
+        return sbn < _next ? Error::WRONG_INPUT : Error::NEED_DATA;
+    auto blk = it->second;
+    while (!blk->enc->ready()) {
+        if (blk->enc->is_stopped())
+            return Error::EXITING;
+        _pool_notify->wait (lock);
+    }
+    return Error::NONE;
+}
+
+template <typename In_It, typename Fwd_It>
+bool Stream_Encoder<In_It, Fwd_It>::ready (const uint8_t sbn) const
+{
+    std::unique_lock<std::mutex> lock (*_pool_mtx);
+    RQ_UNUSED(lock);
+    auto it = _blocks.find (sbn);
+    return it != _blocks.end() && it->second->enc->ready();
+}
+
+template <typename In_It, typename Fwd_It>
+size_t Stream_Encoder<In_It, Fwd_It>::encode (Fwd_It &output, const Fwd_It end,
+                                                            const uint32_t esi,
+                                                            const uint8_t sbn)
+{
+    std::unique_lock<std::mutex> lock (*_pool_mtx);
+    auto it = _blocks.find (sbn);
+    if (it == _blocks.end() || !it->second->enc->ready())
+        return 0;
+    auto blk = it->second;
+    lock.unlock();
+    const uint32_t syms = symbols (sbn);
+    const uint32_t padding = static_cast<uint16_t> (extended_symbols (sbn))
+                                                                        - syms;
+    const uint32_t real_esi = esi < syms ? esi : esi + padding;
+    return blk->enc->Enc (real_esi, output, end);
+}
+
+template <typename In_It, typename Fwd_It>
+size_t Stream_Encoder<In_It, Fwd_It>::encode (uint8_t *output,
+                                                            const size_t size,
+                                                            const uint32_t esi,
+                                                            const uint8_t sbn)
+{
+    if (output == nullptr)
+        return 0;
+    std::unique_lock<std::mutex> lock (*_pool_mtx);
+    auto it = _blocks.find (sbn);
+    if (it == _blocks.end() || !it->second->enc->ready())
+        return 0;
+    auto blk = it->second;
+    lock.unlock();
+    const uint32_t syms = symbols (sbn);
+    const uint32_t padding = static_cast<uint16_t> (extended_symbols (sbn))
+                                                                        - syms;
+    const uint32_t real_esi = esi < syms ? esi : esi + padding;
+    uint8_t *start = output;
+    return blk->enc->Enc (real_esi, start, output + size);
+}
+
+template <typename In_It, typename Fwd_It>
+void Stream_Encoder<In_It, Fwd_It>::free (const uint8_t sbn)
+{
+    std::unique_lock<std::mutex> lock (*_pool_mtx);
+    RQ_UNUSED(lock);
+    auto it = _blocks.find (sbn);
+    if (it != _blocks.end()) {
+        it->second->enc->stop();
+        _blocks.erase (it);
+    }
+}
+
+template <typename In_It, typename Fwd_It>
+uint8_t Stream_Encoder<In_It, Fwd_It>::blocks() const
+{
+    if (!*this)
+        return 0;
+    return interleave.blocks();
+}
+
+template <typename In_It, typename Fwd_It>
+uint32_t Stream_Encoder<In_It, Fwd_It>::block_size (const uint8_t sbn) const
+{
+    if (!*this)
+        return 0;
+    return interleave.source_symbols (sbn) * interleave.symbol_size();
+}
+
+template <typename In_It, typename Fwd_It>
+uint16_t Stream_Encoder<In_It, Fwd_It>::symbol_size() const
+{
+    if (!*this)
+        return 0;
+    return interleave.symbol_size();
+}
+
+template <typename In_It, typename Fwd_It>
+uint16_t Stream_Encoder<In_It, Fwd_It>::symbols (const uint8_t sbn) const
+{
+    if (!*this)
+        return 0;
+    return interleave.source_symbols (sbn);
+}
+
+template <typename In_It, typename Fwd_It>
+Block_Size Stream_Encoder<In_It, Fwd_It>::extended_symbols (const uint8_t sbn)
+                                                                        const
+{
+    if (!*this)
+        return static_cast<Block_Size> (0);
+    return interleave.extended_symbols (sbn);
+}
+
+template <typename In_It, typename Fwd_It>
+uint32_t Stream_Encoder<In_It, Fwd_It>::max_repair (const uint8_t sbn) const
+{
+    if (!*this)
+        return 0;
+    return static_cast<uint32_t> (std::pow (2, 20)) -
+                                                interleave.source_symbols (sbn);
+}
+
+}   // namespace Impl
+}   // namespace RFC6330__v1
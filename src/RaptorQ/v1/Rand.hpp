@@ -273,13 +273,11 @@ constexpr uint32_t pow (const uint32_t base, const uint32_t exponent)
 
 inline uint32_t rnd_get (const uint32_t y, const uint8_t i, const uint32_t m)
 {
-    const uint32_t mod = static_cast<uint32_t> (pow (2, 8));
-    const uint32_t x0 = (y + i) % mod;
-    const uint32_t x1 = (div_floor<uint32_t> (y, mod) + i) % mod;
-    const uint32_t x2 = (div_floor<uint32_t> (y,
-                            static_cast<uint32_t>(pow (2, 16))) + i) % mod;
-    const uint32_t x3 = (div_floor<uint32_t> (y,
-                            static_cast<uint32_t>(pow (2, 24))) + i) % mod;
+    // rfc 6330, pg 26: divisions and modulos by powers of 2
+    const uint32_t x0 = (y + i) & 0xFF;
+    const uint32_t x1 = ((y >> 8) + i) & 0xFF;
+    const uint32_t x2 = ((y >> 16) + i) & 0xFF;
+    const uint32_t x3 = ((y >> 24) + i) & 0xFF;
 
     return (Rand_V0[x0] ^ Rand_V1[x1] ^ Rand_V2[x2] ^ Rand_V3[x3]) % m;
 }
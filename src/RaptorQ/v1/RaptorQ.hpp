@@ -28,14 +28,19 @@
 #include "RaptorQ/v1/Encoder.hpp"
 #include "RaptorQ/v1/Decoder.hpp"
 #include "RaptorQ/v1/Parameters.hpp"
+#include "RaptorQ/v1/util/Atomic_Bitset.hpp"
+#include "RaptorQ/v1/util/contiguous.hpp"
+#include "RaptorQ/v1/util/Notifier.hpp"
 #include <algorithm>
 #include <atomic>
+#include <chrono>
 #include <cmath>
-#include <deque>
+#include <cstring>
 #include <future>
 #include <limits>
 #include <memory>
 #include <mutex>
+#include <string>
 #include <vector>
 #include <utility>
 
@@ -100,6 +105,21 @@ public:
     std::shared_future<Error> compute();
 
     size_t encode (Fwd_It &output, const Fwd_It end, const uint32_t id);
+    // same, on a plain buffer. returns the number of bytes written.
+    size_t encode (uint8_t *output, const size_t size, const uint32_t id);
+    // many symbols at once, one after the other in "output".
+    // return the number of symbols written: we stop at the first id
+    // after max_repair().
+    size_t encode_range (uint8_t *output, const size_t size,
+                                const uint32_t first, const uint32_t count);
+    size_t encode_list (uint8_t *output, const size_t size,
+                                const uint32_t *ids, const uint32_t count);
+
+    // completion events for event loops (see Notify_Callback):
+    // COMPUTE when the future of compute()/precompute() is ready.
+    void set_notify (const Notify_Callback &callback);
+    // eventfd counting the same events, -1 if not supported.
+    int notify_fd();
 
 private:
     enum class Enc_State : uint8_t {
@@ -119,10 +139,15 @@ private:
     std::mutex _mtx;
     std::shared_future<Error> _single_wait;
     std::thread _waiting;
+    Notifier notifier;
 
+    static Error compute_symbols (Encoder<Rnd_It, Fwd_It> *obj,
+                                                bool forced_precomputation);
     static void compute_thread (Encoder<Rnd_It, Fwd_It> *obj,
                                                     bool forced_precomputation,
                                                     std::promise<Error> p);
+    // wait for the intermediate symbols. false if we have no data.
+    bool wait_ready();
 };
 
 template <typename In_It, typename Fwd_It>
@@ -134,6 +159,11 @@ public:
     ~Decoder();
     Decoder (const Block_Size symbols, const size_t symbol_size,
                                                         const Dec_Report type);
+    // decode in place: the decoded block is built directly in "output",
+    // which must hold "symbols * symbol_size" bytes and outlive the decoder.
+    // no internal copy of the source symbols is kept.
+    Decoder (const Block_Size symbols, const size_t symbol_size,
+                                const Dec_Report type, uint8_t *output);
     Decoder (const Decoder&) = delete;
     Decoder& operator= (const Decoder&) = delete;
     Decoder (Decoder &&) = delete;
@@ -150,6 +180,14 @@ public:
 #endif
 
     Error add_symbol (In_It &from, const In_It to, const uint32_t esi);
+    // same, from a plain buffer of "size" bytes.
+    Error add_symbol (const uint8_t *data, const size_t size,
+                                                            const uint32_t esi);
+    // "count" symbols of symbol_size bytes, one after the other in "data":
+    // symbol "idx" has id "esi[idx]". Locks once for the whole batch.
+    // returns the number of symbols added.
+    size_t add_symbols (const uint8_t *data, const size_t size,
+                                const uint32_t *esi, const uint32_t count);
     std::vector<bool> end_of_input (const Fill_With_Zeros fill);
 
     bool can_decode() const;
@@ -159,17 +197,33 @@ public:
     uint16_t needed_symbols() const;
 
     void set_max_concurrency (const uint16_t max_threads);
+    void set_progressive (const bool enable);
+    void set_max_overhead (const uint16_t overhead);
+    void set_decode_policy (const Decode_Policy &policy);
+    // keep the symbols in a scratch file in "directory" instead of RAM.
+    // only the matrices of a decoding attempt stay in memory.
+    // Not with the in-place decoder. false on failure.
+    // Symbols added meanwhile wait for the move, they are not refused.
+    bool set_storage (const std::string &directory);
     Decoder_Result decode_once();
 
     struct Decoder_wait_res poll();
     struct Decoder_wait_res wait_sync();
     std::future<struct Decoder_wait_res> wait();
+    // completion events for event loops (see Notify_Callback):
+    // COMPUTE when the future of wait() is ready.
+    void set_notify (const Notify_Callback &callback);
+    // eventfd counting the same events, -1 if not supported.
+    int notify_fd();
 
 
     Error decode_symbol (Fwd_It &start, const Fwd_It end, const uint16_t esi);
     // return number of bytes written
     struct Decoder_written decode_bytes (Fwd_It &start, const Fwd_It end,
                                     const size_t from_byte, const size_t skip);
+    // same, on a plain buffer. returns the number of bytes written.
+    size_t decode_bytes (uint8_t *output, const size_t size,
+                                                    const size_t from_byte);
 private:
     uint16_t _max_threads;
     const uint16_t _symbols;
@@ -179,14 +233,32 @@ private:
     RaptorQ__v1::Work_State work;
     Raw_Decoder<In_It> dec;
     // 2* symbols. Actually tracks available and reported symbols.
-    // each symbol gets 2 bool: 1= available, 2=reported
-    std::deque<std::atomic<bool>> symbols_tracker;
+    // each symbol gets 2 bits: 1= available, 2=reported
+    Atomic_Bitset symbols_tracker;
     std::mutex _mtx;
     std::condition_variable _cond;
+    // new symbols only signal "_cond" when somebody is waiting on it.
+    // "arrivals" changes with each new symbol, so that waiting threads
+    // can check that they did not miss anything before sleeping.
+    std::atomic<uint32_t> arrivals;
+    std::atomic<uint32_t> sleepers;
     std::vector<std::thread> waiting;
+    Notifier notifier;
 
     static void waiting_thread (Decoder<In_It, Fwd_It> *obj,
                                     std::promise<struct Decoder_wait_res> p);
+    template <typename It>
+    Error add (It &from, const It to, const uint32_t esi);
+    // copy the decoded symbols, starting from "esi", "byte".
+    // "output" is usually a Fwd_It, but any forward iterator will do.
+    template <typename F_It = Fwd_It, typename std::enable_if<
+                                is_contiguous_le<F_It>::value, int>::type = 0>
+    struct Decoder_written copy_decoded (F_It &start, const F_It end,
+                            uint16_t esi, uint16_t byte, const size_t skip);
+    template <typename F_It = Fwd_It, typename std::enable_if<
+                                !is_contiguous_le<F_It>::value, int>::type = 0>
+    struct Decoder_written copy_decoded (F_It &start, const F_It end,
+                            uint16_t esi, uint16_t byte, const size_t skip);
 };
 
 
@@ -385,9 +457,8 @@ bool Encoder<Rnd_It, Fwd_It>::compute_sync()
 }
 
 template <typename Rnd_It, typename Fwd_It>
-void Encoder<Rnd_It, Fwd_It>::compute_thread (
-                        Encoder<Rnd_It, Fwd_It> *obj, bool force_precomputation,
-                                                        std::promise<Error> p)
+Error Encoder<Rnd_It, Fwd_It>::compute_symbols (
+                        Encoder<Rnd_It, Fwd_It> *obj, bool force_precomputation)
 {
     static RaptorQ__v1::Work_State work = RaptorQ__v1::Work_State::KEEP_WORKING;
 
@@ -396,36 +467,31 @@ void Encoder<Rnd_It, Fwd_It>::compute_thread (
             obj->precomputed = obj->encoder.get_precomputed (&work);
         if (obj->precomputed.rows() == 0) {
             // encoder always works. only possible reason:
-            p.set_value (Error::EXITING);
-            return;
+            return Error::EXITING;
         }
         // if we finished getting data by the time the computation
         // finished, update it all.
         if (obj->_state == Enc_State::FULL && !obj->encoder.ready())
             obj->encoder.generate_symbols (obj->precomputed,
                                                     &obj->_from, &obj->_to);
-        p.set_value (Error::NONE);
+        return Error::NONE;
     } else {
         if (obj->encoder.ready()) {
-            p.set_value (Error::NONE);
-            return;
+            return Error::NONE;
         }
         if (obj->_state == Enc_State::FULL) {
             if (obj->encoder.generate_symbols (&work, &obj->_from, &obj->_to)) {
-                p.set_value (Error::NONE);
-                return;
+                return Error::NONE;
             } else {
                 // only possible reason:
-                p.set_value (Error::EXITING);
-                return;
+                return Error::EXITING;
             }
         } else {
             if (obj->precomputed.rows() == 0) {
                 obj->precomputed = obj->encoder.get_precomputed (&work);
                 if (obj->precomputed.rows() == 0) {
                     // only possible reason:
-                    p.set_value (Error::EXITING);
-                    return;
+                    return Error::EXITING;
                 }
             }
             if (obj->_state == Enc_State::FULL) {
@@ -434,12 +500,29 @@ void Encoder<Rnd_It, Fwd_It>::compute_thread (
                 obj->encoder.generate_symbols (obj->precomputed,
                                                     &obj->_from, &obj->_to);
             }
-            p.set_value (Error::NONE);
-            return;
+            return Error::NONE;
         }
     }
 }
 
+template <typename Rnd_It, typename Fwd_It>
+void Encoder<Rnd_It, Fwd_It>::compute_thread (
+                        Encoder<Rnd_It, Fwd_It> *obj, bool force_precomputation,
+                                                        std::promise<Error> p)
+{
+    const Error res = compute_symbols (obj, force_precomputation);
+    p.set_value (res);
+    obj->notifier.fire (Notify_Event::COMPUTE, res, 0);
+}
+
+template <typename Rnd_It, typename Fwd_It>
+void Encoder<Rnd_It, Fwd_It>::set_notify (const Notify_Callback &callback)
+    { notifier.set (callback); }
+
+template <typename Rnd_It, typename Fwd_It>
+int Encoder<Rnd_It, Fwd_It>::notify_fd()
+    { return notifier.fd(); }
+
 template <typename Rnd_It, typename Fwd_It>
 std::shared_future<Error> Encoder<Rnd_It, Fwd_It>::precompute()
 {
@@ -490,17 +573,61 @@ size_t Encoder<Rnd_It, Fwd_It>::encode (Fwd_It &output, const Fwd_It end,
     // returns number of iterators written
     if (_state == Enc_State::FULL) {
         if (id >= _symbols) { // repair symbol
-            if (!encoder.ready()) {
-                if (!_single_wait.valid())
-                    _single_wait = compute();
-                _single_wait.wait();
-            }
+            if (!wait_ready())
+                return 0;
         }
         return encoder.Enc (id, output, end);
     }
     return 0;
 }
 
+template <typename Rnd_It, typename Fwd_It>
+size_t Encoder<Rnd_It, Fwd_It>::encode (uint8_t *output, const size_t size,
+                                                            const uint32_t id)
+{
+    if (output == nullptr || _state != Enc_State::FULL)
+        return 0;
+    if (id >= _symbols && !wait_ready())
+        return 0;
+    uint8_t *start = output;
+    return encoder.Enc (id, start, output + size);
+}
+
+template <typename Rnd_It, typename Fwd_It>
+bool Encoder<Rnd_It, Fwd_It>::wait_ready()
+{
+    if (_state != Enc_State::FULL)
+        return false;
+    if (!encoder.ready()) {
+        if (!_single_wait.valid())
+            _single_wait = compute();
+        _single_wait.wait();
+    }
+    return true;
+}
+
+template <typename Rnd_It, typename Fwd_It>
+size_t Encoder<Rnd_It, Fwd_It>::encode_range (uint8_t *output,
+                                const size_t size, const uint32_t first,
+                                                        const uint32_t count)
+{
+    // everything is generated from the intermediate symbols,
+    // source symbols included.
+    if (!wait_ready())
+        return 0;
+    return encoder.Enc_batch (first, nullptr, count, output, size);
+}
+
+template <typename Rnd_It, typename Fwd_It>
+size_t Encoder<Rnd_It, Fwd_It>::encode_list (uint8_t *output,
+                                const size_t size, const uint32_t *ids,
+                                                        const uint32_t count)
+{
+    if (ids == nullptr || !wait_ready())
+        return 0;
+    return encoder.Enc_batch (0, ids, count, output, size);
+}
+
 ///////////////////
 //// Decoder
 ///////////////////
@@ -527,8 +654,16 @@ Decoder<In_It, Fwd_It>::~Decoder ()
 template <typename In_It, typename Fwd_It>
 Decoder<In_It, Fwd_It>::Decoder (const Block_Size symbols,
                                 const size_t symbol_size, const Dec_Report type)
+    :Decoder (symbols, symbol_size, type, nullptr)
+{}
+
+template <typename In_It, typename Fwd_It>
+Decoder<In_It, Fwd_It>::Decoder (const Block_Size symbols,
+                                const size_t symbol_size, const Dec_Report type,
+                                                            uint8_t *output)
     :_symbols (static_cast<uint16_t> (symbols)), _symbol_size (symbol_size),
-                                    _type (type), dec (symbols, symbol_size)
+                                    _type (type), dec (symbols, symbol_size,
+                                            reinterpret_cast<Octet*> (output))
 {
     IS_INPUT(In_It, "RaptorQ__v1::Decoder");
     IS_FORWARD(Fwd_It, "RaptorQ__v1::Decoder");
@@ -551,9 +686,9 @@ Decoder<In_It, Fwd_It>::Decoder (const Block_Size symbols,
     }
 
     last_reported.store (0);
-    symbols_tracker = std::deque<std::atomic<bool>> (2 * _symbols);
-    for (idx = 0; idx < 2 * _symbols; ++idx)
-        symbols_tracker[idx] = false;
+    arrivals.store (0);
+    sleepers.store (0);
+    symbols_tracker = Atomic_Bitset (2 * static_cast<size_t> (_symbols));
     work = RaptorQ__v1::Work_State::KEEP_WORKING;
     _max_threads = 1;
 }
@@ -606,15 +741,61 @@ uint16_t Decoder<In_It, Fwd_It>::needed_symbols() const
 template <typename In_It, typename Fwd_It>
 Error Decoder<In_It, Fwd_It>::add_symbol (In_It &from, const In_It to,
                                                             const uint32_t esi)
+    { return add (from, to, esi); }
+
+template <typename In_It, typename Fwd_It>
+Error Decoder<In_It, Fwd_It>::add_symbol (const uint8_t *data,
+                                    const size_t size, const uint32_t esi)
+{
+    if (data == nullptr)
+        return Error::WRONG_INPUT;
+    const uint8_t *from = data;
+    return add (from, data + size, esi);
+}
+
+template <typename In_It, typename Fwd_It>
+size_t Decoder<In_It, Fwd_It>::add_symbols (const uint8_t *data,
+                                    const size_t size, const uint32_t *esi,
+                                                        const uint32_t count)
+{
+    if (symbols_tracker.size() == 0 || data == nullptr || esi == nullptr)
+        return 0;
+    // only whole symbols
+    const uint32_t whole = static_cast<uint32_t> (std::min<size_t> (count,
+                                                        size / _symbol_size));
+    std::vector<bool> added;
+    const size_t ret = dec.add_symbols (data, esi, whole, added);
+    if (ret == 0)
+        return 0;
+    for (uint32_t idx = 0; idx < whole; ++idx) {
+        if (added[idx] && esi[idx] < _symbols)
+            symbols_tracker.set (2 * esi[idx]);
+    }
+    arrivals += static_cast<uint32_t> (ret);
+    if (sleepers.load() != 0) {
+        std::unique_lock<std::mutex> lock (_mtx);
+        RQ_UNUSED (lock);
+        _cond.notify_all();
+    }
+    return ret;
+}
+
+template <typename In_It, typename Fwd_It>
+template <typename It>
+Error Decoder<In_It, Fwd_It>::add (It &from, const It to, const uint32_t esi)
 {
     if (symbols_tracker.size() == 0)
         return Error::INITIALIZATION;
     auto ret = dec.add_symbol (from, to, esi, false);
     if (ret == Error::NONE) {
         if (esi < _symbols)
-            symbols_tracker [2 * esi].store (true);
-        std::unique_lock<std::mutex> lock (_mtx);
-        _cond.notify_all();
+            symbols_tracker.set (2 * esi);
+        ++arrivals;
+        if (sleepers.load() != 0) {
+            std::unique_lock<std::mutex> lock (_mtx);
+            RQ_UNUSED (lock);
+            _cond.notify_all();
+        }
     }
     return ret;
 }
@@ -626,7 +807,6 @@ Decoder_wait_res Decoder<In_It, Fwd_It>::poll ()
         return {Error::INITIALIZATION, 0};
     uint32_t idx;
     uint32_t last;
-    bool expected = false;
     switch (_type) {
     case Dec_Report::PARTIAL_FROM_BEGINNING:
         // report the number of symbols that are known, starting from
@@ -634,11 +814,8 @@ Decoder_wait_res Decoder<In_It, Fwd_It>::poll ()
         last = last_reported.load();
         idx = last;
         for (; idx < symbols_tracker.size(); idx += 2) {
-            if (symbols_tracker[idx].load() == true) {
-                ++idx;
-                if (symbols_tracker[idx].load() == false)
-                    symbols_tracker[idx].store (true);
-                --idx;
+            if (symbols_tracker.test (idx)) {
+                symbols_tracker.set (idx + 1);
             } else {
                 break;
             }
@@ -677,17 +854,11 @@ Decoder_wait_res Decoder<In_It, Fwd_It>::poll ()
             return {Error::NONE, _symbols};
         for (idx = 0; idx < static_cast<uint32_t> (symbols_tracker.size());
                                                                     idx += 2) {
-            if (symbols_tracker[idx].load() == true) {
-                ++idx;
-                if (symbols_tracker[idx].load() == false) {
-                    expected = false;
-                    if (symbols_tracker[idx].
-                                    compare_exchange_strong (expected, true)) {
-                        return {Error::NONE, static_cast<uint16_t> (idx / 2)};
-                    }   // else some other thread raced us, keep trying other
-                        // symbols
-                }
-            }
+            if (symbols_tracker.test (idx) &&
+                                    !symbols_tracker.test_and_set (idx + 1)) {
+                return {Error::NONE, static_cast<uint16_t> (idx / 2)};
+            }   // else not available, or some other thread raced us:
+                // keep trying other symbols
         }
         if (dec.ready())
             return {Error::NONE, _symbols};
@@ -698,7 +869,7 @@ Decoder_wait_res Decoder<In_It, Fwd_It>::poll ()
         auto init = last_reported.load();
         idx = init * 2;
         for (; idx < symbols_tracker.size(); idx += 2) {
-            if (symbols_tracker[idx].load() == false) {
+            if (!symbols_tracker.test (idx)) {
                 idx /= 2;
                 while (!last_reported.compare_exchange_weak(init, idx))
                     idx = std::max(init, idx);
@@ -719,6 +890,7 @@ void Decoder<In_It, Fwd_It>::waiting_thread (Decoder<In_It, Fwd_It> *obj,
 {
     bool promise_set = false;
     while (obj->work == RaptorQ__v1::Work_State::KEEP_WORKING) {
+        const uint32_t seen = obj->arrivals.load();
         bool compute = obj->dec.add_concurrent (obj->_max_threads);
         if (compute) {
             obj->decode_once();
@@ -737,14 +909,32 @@ void Decoder<In_It, Fwd_It>::waiting_thread (Decoder<In_It, Fwd_It> *obj,
                                                 res.error == Error::NEED_DATA)){
             p.set_value (res);
             promise_set = true;
+            lock.unlock();
+            obj->notifier.fire (Notify_Event::COMPUTE, res.error, 0);
             break;
         }
-        obj->_cond.wait (lock);
+        // only sleep if no symbol arrived since we last checked.
+        // a deferred attempt (see Decode_Policy) has no symbol
+        // to wake us up: wait for its quiet period at most.
+        ++obj->sleepers;
+        if (obj->arrivals.load() == seen &&
+                        obj->work == RaptorQ__v1::Work_State::KEEP_WORKING) {
+            const int64_t quiet = obj->dec.quiet_left();
+            if (quiet < 0) {
+                obj->_cond.wait (lock);
+            } else {
+                obj->_cond.wait_for (lock, std::chrono::milliseconds (
+                                                std::max<int64_t> (1, quiet)));
+            }
+        }
+        --obj->sleepers;
         lock.unlock();
     }
 
-    if (obj->work != RaptorQ__v1::Work_State::KEEP_WORKING && !promise_set)
+    if (obj->work != RaptorQ__v1::Work_State::KEEP_WORKING && !promise_set) {
         p.set_value ({Error::EXITING, 0});
+        obj->notifier.fire (Notify_Event::COMPUTE, Error::EXITING, 0);
+    }
 
     std::unique_lock<std::mutex> lock (obj->_mtx);
     RQ_UNUSED (lock);
@@ -758,6 +948,14 @@ void Decoder<In_It, Fwd_It>::waiting_thread (Decoder<In_It, Fwd_It> *obj,
     obj->_cond.notify_all(); // notify exit to destructor
 }
 
+template <typename In_It, typename Fwd_It>
+void Decoder<In_It, Fwd_It>::set_notify (const Notify_Callback &callback)
+    { notifier.set (callback); }
+
+template <typename In_It, typename Fwd_It>
+int Decoder<In_It, Fwd_It>::notify_fd()
+    { return notifier.fd(); }
+
 template <typename In_It, typename Fwd_It>
 Decoder_wait_res Decoder<In_It, Fwd_It>::wait_sync ()
 {
@@ -791,9 +989,15 @@ std::vector<bool> Decoder<In_It, Fwd_It>::end_of_input (
                                                     const Fill_With_Zeros fill)
 {
     if (symbols_tracker.size() != 0) {
+        std::vector<bool> ret;
         if (fill == Fill_With_Zeros::YES)
-            return dec.fill_with_zeros();
+            ret = dec.fill_with_zeros();
         dec.end_of_input = true;
+        // a deferred attempt can start now, or we can report the failure.
+        std::unique_lock<std::mutex> lock (_mtx);
+        RQ_UNUSED (lock);
+        _cond.notify_all();
+        return ret;
     }
     return std::vector<bool>();
 }
@@ -813,6 +1017,45 @@ void Decoder<In_It, Fwd_It>::set_max_concurrency (const uint16_t max_threads)
         _max_threads = max_threads;
 }
 
+template <typename In_It, typename Fwd_It>
+void Decoder<In_It, Fwd_It>::set_progressive (const bool enable)
+{
+    if (symbols_tracker.size() == 0)
+        return;
+    dec.set_progressive (enable);
+    // we might be able to decode now.
+    std::unique_lock<std::mutex> lock (_mtx);
+    RQ_UNUSED (lock);
+    _cond.notify_all();
+}
+
+template <typename In_It, typename Fwd_It>
+void Decoder<In_It, Fwd_It>::set_max_overhead (const uint16_t overhead)
+{
+    if (symbols_tracker.size() != 0)
+        dec.set_max_overhead (overhead);
+}
+
+template <typename In_It, typename Fwd_It>
+void Decoder<In_It, Fwd_It>::set_decode_policy (const Decode_Policy &policy)
+{
+    if (symbols_tracker.size() == 0)
+        return;
+    dec.set_decode_policy (policy);
+    // the new policy might let us try now.
+    std::unique_lock<std::mutex> lock (_mtx);
+    RQ_UNUSED (lock);
+    _cond.notify_all();
+}
+
+template <typename In_It, typename Fwd_It>
+bool Decoder<In_It, Fwd_It>::set_storage (const std::string &directory)
+{
+    if (symbols_tracker.size() == 0)
+        return false;
+    return dec.set_storage (std::make_shared<Scratch_File> (directory));
+}
+
 template <typename In_It, typename Fwd_It>
 Decoder_Result Decoder<In_It, Fwd_It>::decode_once()
 {
@@ -825,7 +1068,7 @@ Decoder_Result Decoder<In_It, Fwd_It>::decode_once()
         if (_type != Dec_Report::COMPLETE) {
             uint32_t id = last_reported.load();
             for (; id < symbols_tracker.size(); id += 2)
-                symbols_tracker[id].store (true);
+                symbols_tracker.set (id);
         }
         last_reported.store(_symbols);
         lock.unlock();
@@ -861,8 +1104,7 @@ void Decoder<In_It, Fwd_It>::clear_data()
     RQ_UNUSED (lock);
     dec.clear_data();
     last_reported.store(0);
-    for (auto it = symbols_tracker.begin(); it != symbols_tracker.end(); ++it)
-        *it = false;
+    symbols_tracker.reset();
 }
 
 template <typename In_It, typename Fwd_It>
@@ -878,12 +1120,53 @@ Decoder_written Decoder<In_It, Fwd_It>::decode_bytes (Fwd_It &start,
         return {0, 0};
     }
 
-    auto decoded = dec.get_symbols();
-
-    uint16_t esi = static_cast<uint16_t> (from_byte /
+    const uint16_t esi = static_cast<uint16_t> (from_byte /
                                             static_cast<size_t> (_symbol_size));
-    uint16_t byte = static_cast<uint16_t> (from_byte %
+    const uint16_t byte = static_cast<uint16_t> (from_byte %
                                             static_cast<size_t> (_symbol_size));
+    return copy_decoded (start, end, esi, byte, skip);
+}
+
+template <typename In_It, typename Fwd_It>
+template <typename F_It, typename std::enable_if<
+                                    is_contiguous_le<F_It>::value, int>::type>
+Decoder_written Decoder<In_It, Fwd_It>::copy_decoded (F_It &start,
+                                                const F_It end, uint16_t esi,
+                                                uint16_t byte, const size_t skip)
+{
+    // same results as the generic version, but whole symbols are
+    // copied at once.
+    using T = typename std::iterator_traits<F_It>::value_type;
+    if (start == end)
+        return {0, skip};
+    const auto decoded = dec.get_symbols();
+    const size_t cols = static_cast<size_t> (decoded->cols());
+    // the first "skip" bytes of the first element are kept.
+    uint8_t *out = out_bytes (start) + skip;
+    const size_t max = static_cast<size_t> (end - start) * sizeof(T) - skip;
+    size_t written = 0;
+    while (written < max && esi < _symbols && dec.has_symbol (esi)) {
+        const size_t size = std::min (cols - byte, max - written);
+        std::memcpy (out + written, decoded->data() + esi * cols + byte, size);
+        written += size;
+        byte = 0;
+        ++esi;
+    }
+    // only complete elements are skipped, "written" counts "skip", too.
+    written += skip;
+    start += static_cast<int64_t> (written / sizeof(T));
+    return {written, written % sizeof(T)};
+}
+
+template <typename In_It, typename Fwd_It>
+template <typename F_It, typename std::enable_if<
+                                    !is_contiguous_le<F_It>::value, int>::type>
+Decoder_written Decoder<In_It, Fwd_It>::copy_decoded (F_It &start,
+                                                const F_It end, uint16_t esi,
+                                                uint16_t byte, const size_t skip)
+{
+    using T = typename std::iterator_traits<F_It>::value_type;
+    auto decoded = dec.get_symbols();
 
     size_t offset_al = skip;
     T element = static_cast<T> (0);
@@ -923,6 +1206,20 @@ Decoder_written Decoder<In_It, Fwd_It>::decode_bytes (Fwd_It &start,
     return {written, offset_al};
 }
 
+template <typename In_It, typename Fwd_It>
+size_t Decoder<In_It, Fwd_It>::decode_bytes (uint8_t *output,
+                                const size_t size, const size_t from_byte)
+{
+    if (output == nullptr || symbols_tracker.size() == 0 ||
+                                        from_byte >= _symbols * _symbol_size) {
+        return 0;
+    }
+    const uint16_t esi = static_cast<uint16_t> (from_byte / _symbol_size);
+    const uint16_t byte = static_cast<uint16_t> (from_byte % _symbol_size);
+    uint8_t *start = output;
+    return copy_decoded (start, output + size, esi, byte, 0).written;
+}
+
 template <typename In_It, typename Fwd_It>
 Error Decoder<In_It, Fwd_It>::decode_symbol (Fwd_It &start, const Fwd_It end,
                                                             const uint16_t esi)
@@ -364,22 +364,25 @@ bool DLF<User_Data, Key>::add (const Compress algorithm, User_Data &raw,
         }
     }
     // key not present.
-    if (max_size - actual_size > sizeof(DLF_Data) + raw.size()) {
+    // "raw" is moved in the cache, take its size now.
+    const size_t raw_size = sizeof(DLF_Data) + raw.size();
+    if (max_size - actual_size > raw_size) {
         // free space is the best
         auto g_tick = ++global_tick;
         test_and_reset_scores();
         data.emplace_back (key, g_tick + data.size(), g_tick, raw, algorithm);
         std::sort (data.begin(), data.end());
-        actual_size += sizeof(DLF_Data) + raw.size();
+        actual_size += raw_size;
         return true;
     } else {
         // need to delete some element?
         auto g_tick = ++global_tick;
         test_and_reset_scores();
-        size_t usable_bytes = max_size - actual_size;
+        const size_t free_bytes = max_size - actual_size;
+        size_t usable_bytes = free_bytes;
         size_t delete_from_end = 0;
         for (auto r_it = data.rbegin(); r_it != data.rend() &&
-                                usable_bytes < (sizeof(DLF_Data) + raw.size());
+                                                usable_bytes < raw_size;
                                                                     ++r_it) {
             // score is less than tick. check for overflows
             if ((g_tick - r_it->tick) > (r_it->score - r_it->tick)) {
@@ -389,7 +392,7 @@ bool DLF<User_Data, Key>::add (const Compress algorithm, User_Data &raw,
                 break;
             }
         }
-        if (usable_bytes < (sizeof(DLF_Data) + raw.size())) {
+        if (usable_bytes < raw_size) {
             // can't delete enough cached items, the new item requires
             // too much space, and fresher elements are present.
             return false;
@@ -400,8 +403,9 @@ bool DLF<User_Data, Key>::add (const Compress algorithm, User_Data &raw,
         }
         data.emplace_back (key, g_tick + data.size(), g_tick, raw, algorithm);
         std::sort (data.begin(), data.end());
-        actual_size -= usable_bytes;
-        actual_size += sizeof(DLF_Data) + raw.size();
+        // only the deleted elements, not the free space
+        actual_size -= usable_bytes - free_bytes;
+        actual_size += raw_size;
         return true;
     }
 }
@@ -0,0 +1,206 @@
+/*
+ * Copyright (c) 2015-2018, Luca Fulchir<luca@fulchir.it>, All rights reserved.
+ *
+ * This file is part of "libRaptorQ".
+ *
+ * libRaptorQ is free software: you can redistribute it and/or modify
+ * it under the terms of the GNU Lesser General Public License as
+ * published by the Free Software Foundation, either version 3
+ * of the License, or (at your option) any later version.
+ *
+ * libRaptorQ is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ * GNU General Public License for more details.
+ *
+ * You should have received a copy of the GNU General Public License
+ * and a copy of the GNU Lesser General Public License
+ * along with libRaptorQ.  If not, see <http://www.gnu.org/licenses/>.
+ */
+
+#pragma once
+
+#include "RaptorQ/v1/common.hpp"
+#include "RaptorQ/v1/Operation.hpp"
+#include "RaptorQ/v1/Parameters.hpp"
+#include <list>
+#include <memory>
+#include <mutex>
+#include <utility>
+#include <vector>
+
+namespace RaptorQ__v1 {
+namespace Impl {
+
+// Everything that only depends on the block size (K').
+// The LDPC, HDPC and G_ENC rows of the precode matrix never change, but they
+// are expensive to build (HDPC alone is a matrix product), and every
+// encoder and every decoding attempt needs them.
+// The tuples of the source symbols and of the first K' repair symbols are
+// kept too: every row of the matrix and every encoded symbol needs one.
+// Plans are immutable once built, so they can be shared between threads.
+class RAPTORQ_LOCAL Plan
+{
+public:
+    Plan (const Parameters &params, DenseMtx &&A, std::vector<Tuple> &&tuples)
+        : _params (params), _A (std::move (A)), _tuples (std::move (tuples))
+    {}
+    Plan() = delete;
+    Plan (const Plan&) = delete;
+    Plan& operator= (const Plan&) = delete;
+    Plan (Plan&&) = delete;
+    Plan& operator= (Plan&&) = delete;
+    ~Plan() = default;
+
+    const Parameters _params;
+    const DenseMtx _A;  // L x L, as built by Precode_Matrix::gen (0)
+
+    // the tuples we keep in a plan, by ISI
+    static std::vector<Tuple> make_tuples (const Parameters &params)
+    {
+        std::vector<Tuple> ret;
+        ret.reserve (2 * static_cast<size_t> (params.K_padded));
+        for (uint32_t isi = 0; isi < 2u * params.K_padded; ++isi)
+            ret.push_back (params.tuple (isi));
+        return ret;
+    }
+
+    Tuple tuple (const uint32_t ISI) const
+    {
+        if (ISI < _tuples.size())
+            return _tuples[ISI];
+        return _params.tuple (ISI);
+    }
+    Idxs get_idxs (const uint32_t ISI) const
+        { return _params.idxs (tuple (ISI)); }
+
+    size_t bytes() const
+        { return bytes (_params); }
+    // what a plan for these parameters takes, without building it
+    static size_t bytes (const Parameters &params)
+    {
+        return static_cast<size_t> (params.L) * params.L +
+                        2 * static_cast<size_t> (params.K_padded) * sizeof(Tuple);
+    }
+
+private:
+    const std::vector<Tuple> _tuples;
+};
+
+// process-wide registry of the plans, by K'.
+// Only the most recently used plans are kept, up to "max_bytes()",
+// set with RaptorQ__v1::plan_cache_size. 0 disables the registry.
+// Dropping a plan from here does not free it while someone still uses it.
+class RAPTORQ_LOCAL Plan_Registry
+{
+public:
+    Plan_Registry (const Plan_Registry&) = delete;
+    Plan_Registry& operator= (const Plan_Registry&) = delete;
+    Plan_Registry (Plan_Registry&&) = delete;
+    Plan_Registry& operator= (Plan_Registry&&) = delete;
+    ~Plan_Registry() = default;
+
+    inline static Plan_Registry& get()
+    {
+        #pragma clang diagnostic push
+        #pragma clang diagnostic ignored "-Wexit-time-destructors"
+        #pragma clang diagnostic ignored "-Wglobal-constructors"
+        static Plan_Registry _registry;
+        #pragma clang diagnostic pop
+        return _registry;
+    }
+
+    // nullptr if we do not have it yet.
+    std::shared_ptr<const Plan> find (const uint16_t K_prime)
+    {
+        std::lock_guard<std::mutex> guard (_mtx);
+        RQ_UNUSED (guard);
+        for (auto it = _plans.begin(); it != _plans.end(); ++it) {
+            if ((*it)->_params.K_padded != K_prime)
+                continue;
+            // most recently used in front
+            _plans.splice (_plans.begin(), _plans, it);
+            return _plans.front();
+        }
+        return nullptr;
+    }
+
+    // two threads might build the same plan at the same time,
+    // only the first is kept.
+    // returns the plan we keep for that K', nullptr if it is too big.
+    std::shared_ptr<const Plan> add (std::shared_ptr<const Plan> plan)
+    {
+        std::lock_guard<std::mutex> guard (_mtx);
+        RQ_UNUSED (guard);
+        if (plan == nullptr || plan->bytes() > _max_bytes)
+            return nullptr;
+        for (const auto &cached : _plans) {
+            if (cached->_params.K_padded == plan->_params.K_padded)
+                return cached;
+        }
+        _bytes += plan->bytes();
+        _plans.push_front (std::move (plan));
+        const auto ret = _plans.front();
+        shrink();
+        return ret;
+    }
+
+    // would a plan of "bytes" be kept?
+    bool fits (const size_t bytes)
+    {
+        std::lock_guard<std::mutex> guard (_mtx);
+        RQ_UNUSED (guard);
+        return bytes <= _max_bytes;
+    }
+
+    size_t max_bytes()
+    {
+        std::lock_guard<std::mutex> guard (_mtx);
+        RQ_UNUSED (guard);
+        return _max_bytes;
+    }
+
+    // returns the new size. Plans that do not fit anymore are dropped.
+    size_t resize (const size_t max_bytes)
+    {
+        std::lock_guard<std::mutex> guard (_mtx);
+        RQ_UNUSED (guard);
+        _max_bytes = max_bytes;
+        shrink();
+        return _max_bytes;
+    }
+
+    void clear()
+    {
+        std::lock_guard<std::mutex> guard (_mtx);
+        RQ_UNUSED (guard);
+        _plans.clear();
+        _bytes = 0;
+    }
+
+    // a plan takes a bit more than L^2 bytes: the default holds ~60 plans
+    // with K' around 1000, or a single one up to K' = 7935 (L = 8157).
+    // Plans bigger than the registry are never built: the precode matrix
+    // is generated in place every time.
+    static constexpr size_t default_bytes = 64 * 1024 * 1024;
+
+private:
+    Plan_Registry() = default;
+
+    // needs _mtx
+    void shrink()
+    {
+        while (_bytes > _max_bytes) {
+            _bytes -= _plans.back()->bytes();
+            _plans.pop_back();
+        }
+    }
+
+    std::mutex _mtx;
+    std::list<std::shared_ptr<const Plan>> _plans;
+    size_t _bytes = 0;
+    size_t _max_bytes = default_bytes;
+};
+
+}   // namespace Impl
+}   // namespace RaptorQ__v1
@@ -21,15 +21,23 @@
 #pragma once
 
 #include "RaptorQ/v1/common.hpp"
+#include <atomic>
 #include <condition_variable>
 #include <deque>
+#include <fstream>
 #include <functional>
 #include <list>
 #include <map>
 #include <memory>
 #include <mutex>
+#include <string>
 #include <thread>
 #include <utility>
+#include <vector>
+#if defined(__linux__)
+    #include <pthread.h>
+    #include <sched.h>
+#endif
 
 namespace RFC6330__v1 {
 
@@ -39,10 +47,28 @@ enum class RAPTORQ_API Work_Exit_Status : uint8_t {
     REQUEUE = 2
 };
 
+// How the pool threads are placed on the machine.
+// NONE: let the OS scheduler do its thing (default)
+// CPU:  pin each thread to a single cpu, round-robin.
+// NUMA: group the threads per NUMA node, and prefer to keep each block
+//       (and all its retries) on the node that first worked on it, so that
+//       the matrices of the solver are allocated and eliminated on the same
+//       memory node. Idle threads of other nodes still take the work of
+//       a node that is busy. The symbols received by the decoder are
+//       stored by the thread that calls add_symbol(), wherever that runs.
+// Pinning is only implemented on linux. Elsewhere this is a no-op.
+// tracks C_common.h/RFC6330_Pool_Affinity
+enum class RAPTORQ_API Pool_Affinity : uint8_t {
+    NONE = RQ_AFFINITY_NONE,
+    CPU = RQ_AFFINITY_CPU,
+    NUMA = RQ_AFFINITY_NUMA
+};
+
 // implemented at the end of the file
 bool RAPTORQ_API set_thread_pool (const size_t threads,
                                     const uint16_t max_block_concurrency,
                                     const RFC6330__v1::Work_State exit_type);
+bool RAPTORQ_API set_thread_pool_affinity (const Pool_Affinity affinity);
 
 
 namespace Impl {
@@ -67,6 +93,48 @@ enum class RAPTORQ_LOCAL Work_State_Overlay : uint8_t {
         WAITING = 100
         };
 
+// parse the linux cpu list format: "0-3,8,10-11". A trailing newline is
+// fine, anything else that does not follow the format gives an empty list.
+inline std::vector<uint16_t> parse_cpulist (const std::string &list)
+{
+    size_t end = list.size();
+    while (end > 0 && (list[end - 1] == '\n' || list[end - 1] == ' '))
+        --end;
+    size_t idx = 0;
+    const auto number = [&list, &idx, end] (uint32_t *out) {
+        const size_t start = idx;
+        uint32_t num = 0;
+        while (idx < end && list[idx] >= '0' && list[idx] <= '9') {
+            num = num * 10 + static_cast<uint32_t> (list[idx] - '0');
+            if (num > 0xFFFF)
+                return false;
+            ++idx;
+        }
+        *out = num;
+        return idx != start;
+    };
+    std::vector<uint16_t> ret;
+    while (idx < end) {
+        uint32_t from, to;
+        if (!number (&from))
+            return std::vector<uint16_t>();
+        to = from;
+        if (idx < end && list[idx] == '-') {
+            ++idx;
+            if (!number (&to) || to < from)
+                return std::vector<uint16_t>();
+        }
+        for (uint32_t cpu = from; cpu <= to; ++cpu)
+            ret.push_back (static_cast<uint16_t> (cpu));
+        if (idx < end) {
+            if (list[idx] != ',' || idx + 1 == end)
+                return std::vector<uint16_t>();
+            ++idx;
+        }
+    }
+    return ret;
+}
+
 #pragma clang diagnostic push
 #pragma clang diagnostic ignored "-Wweak-vtables"
 class RAPTORQ_LOCAL Pool_Work
@@ -74,6 +142,11 @@ class RAPTORQ_LOCAL Pool_Work
 public:
     Work_Exit_Status virtual do_work (RaptorQ__v1::Work_State *state) = 0;
     virtual ~Pool_Work() {}
+
+    // NUMA node this work is bound to, -1 if it can run anywhere.
+    // shared so that all the works on the same block (eg: decoder retries)
+    // prefer the same node. can be left null.
+    std::shared_ptr<std::atomic<int32_t>> node;
 };
 #pragma clang diagnostic pop
 
@@ -88,6 +161,7 @@ public:
     {
         std::unique_lock<std::mutex> _data_lock (_data_mtx);
         _queue.clear();
+        _node_queue.clear();
         _data_lock.unlock();
 
         resize_pool (0, RaptorQ__v1::Work_State::ABORT_COMPUTATION);
@@ -186,15 +260,65 @@ public:
         if (_pool.size() == 0)
             resize_pool (1, RaptorQ__v1::Work_State::KEEP_WORKING);
 
-        _queue.emplace_back (std::move(work));
+        queue_for (work.get()).emplace_back (std::move(work));
         _lock_data.unlock();
         _cond.notify_all();
 
         return true;
     }
 
+    void set_affinity (const Pool_Affinity affinity)
+    {
+        std::vector<std::vector<uint16_t>> groups;
+        switch (affinity) {
+        case Pool_Affinity::NONE:
+            break;
+        case Pool_Affinity::CPU:
+            for (const auto cpu : _all_cpus)
+                groups.emplace_back (1, cpu);
+            break;
+        case Pool_Affinity::NUMA:
+            groups = numa_nodes();
+            if (groups.size() == 0)
+                groups.emplace_back (_all_cpus);
+            break;
+        }
+        set_groups (std::move(groups), affinity == Pool_Affinity::NUMA);
+    }
+
+    // explicit placement: one group of threads for each cpu list.
+    // "sticky": the groups are NUMA nodes, with one work queue each.
+    void set_groups (std::vector<std::vector<uint16_t>> groups,
+                                                            const bool sticky)
+    {
+        std::unique_lock<std::mutex> _lock_data (_data_mtx);
+        _groups = std::move(groups);
+        _sticky = sticky && _groups.size() != 0;
+        // old node ids are meaningless now. requeue everything as unassigned
+        for (auto &q : _node_queue) {
+            for (auto &work : q)
+                _queue.emplace_back (std::move(work));
+        }
+        _node_queue.clear();
+        if (_sticky)
+            _node_queue.resize (_groups.size());
+        // threads will notice the new generation and re-pin themselves
+        _group_workers.assign (_groups.size() == 0 ? 1 : _groups.size(), 0);
+        _group_busy.assign (_group_workers.size(), 0);
+        ++_generation;
+        _lock_data.unlock();
+        _cond.notify_all();
+    }
+
+    // group of the pool thread calling this, SIZE_MAX outside the pool.
+    static size_t current_group()
+        { return thread_group(); }
+
 private:
-    Thread_Pool() {resize_pool (1, RaptorQ__v1::Work_State::ABORT_COMPUTATION);}
+    Thread_Pool()
+        : _all_cpus (online_cpus()), _group_workers (1, 0), _group_busy (1, 0),
+                                                _generation (0), _sticky (false)
+        { resize_pool (1, RaptorQ__v1::Work_State::ABORT_COMPUTATION); }
 
     std::mutex _data_mtx, _pool_mtx;
     std::condition_variable _cond;
@@ -202,18 +326,188 @@ private:
     // pair (thread, &keep_working)
     using th_state = std::pair<std::thread, std::weak_ptr<Work_State_Overlay>>;
     std::list<th_state> _pool, _exiting;
-    std::deque<std::unique_ptr<Pool_Work>> _queue;
+    using Work_Queue = std::deque<std::unique_ptr<Pool_Work>>;
+    // _queue: work that can run anywhere.
+    // _node_queue: one per NUMA node, only used in Pool_Affinity::NUMA
+    Work_Queue _queue;
+    std::deque<Work_Queue> _node_queue;
+    // cpus each group of threads is pinned to. empty => no pinning
+    std::vector<std::vector<uint16_t>> _groups;
+    const std::vector<uint16_t> _all_cpus;
+    // threads in each group, and how many of them are running some work
+    std::vector<size_t> _group_workers, _group_busy;
+    uint32_t _generation;
+    bool _sticky;
+
+    // all of these need the _data_mtx
+    Work_Queue& queue_for (const Pool_Work *work)
+    {
+        if (!_sticky || work == nullptr || work->node == nullptr)
+            return _queue;
+        const int32_t node = *work->node;
+        if (node < 0 || static_cast<size_t> (node) >= _node_queue.size())
+            return _queue;
+        return _node_queue[static_cast<size_t> (node)];
+    }
+
+    static size_t& thread_group()
+    {
+        static thread_local size_t group = SIZE_MAX;
+        return group;
+    }
+
+    // own node first, then the unassigned work,
+    // then work bound to nodes that have no thread left,
+    // then the longest queue of the nodes whose threads are all busy:
+    // running remotely is better than not running at all.
+    // A node with a free thread keeps its work.
+    std::unique_ptr<Pool_Work> get_work (const size_t group)
+    {
+        std::unique_ptr<Pool_Work> ret;
+        Work_Queue *q = nullptr;
+        bool orphan = false;
+        if (_sticky && group < _node_queue.size() &&
+                                            _node_queue[group].size() != 0) {
+            q = &_node_queue[group];
+        } else if (_queue.size() != 0) {
+            q = &_queue;
+        } else if (_sticky) {
+            for (size_t idx = 0; idx < _node_queue.size(); ++idx) {
+                if (_node_queue[idx].size() == 0)
+                    continue;
+                if (_group_workers[idx] == 0) {
+                    q = &_node_queue[idx];
+                    orphan = true;
+                    break;
+                }
+                if (_group_busy[idx] < _group_workers[idx])
+                    continue;
+                if (q == nullptr || _node_queue[idx].size() > q->size())
+                    q = &_node_queue[idx];
+            }
+        }
+        if (q == nullptr)
+            return ret;
+        ret.swap (q->front());
+        q->pop_front();
+        if (group < _group_busy.size())
+            ++_group_busy[group];
+        if (_sticky && ret != nullptr && ret->node != nullptr) {
+            // first touch: the block will allocate its matrices on the
+            // node that first works on it, so prefer it from now on.
+            // stolen work keeps its node, orphans move to ours.
+            int32_t expected = -1;
+            const int32_t us = static_cast<int32_t> (group);
+            if (!ret->node->compare_exchange_strong (expected, us) && orphan)
+                ret->node->store (us);
+        }
+        return ret;
+    }
+
+    size_t join_group()
+    {
+        size_t best = 0;
+        for (size_t idx = 1; idx < _group_workers.size(); ++idx) {
+            if (_group_workers[idx] < _group_workers[best])
+                best = idx;
+        }
+        ++_group_workers[best];
+        return best;
+    }
+
+    static std::string read_line (const std::string &path)
+    {
+        std::string line;
+        std::ifstream in (path);
+        if (in.is_open())
+            std::getline (in, line);
+        return line;
+    }
+
+    static std::vector<uint16_t> online_cpus()
+    {
+        std::vector<uint16_t> ret;
+        #if defined(__linux__)
+        ret = parse_cpulist (read_line ("/sys/devices/system/cpu/online"));
+        #endif
+        if (ret.size() == 0) {
+            const uint32_t cpus = std::thread::hardware_concurrency();
+            for (uint32_t cpu = 0; cpu < cpus; ++cpu)
+                ret.push_back (static_cast<uint16_t> (cpu));
+        }
+        return ret;
+    }
+
+    static std::vector<std::vector<uint16_t>> numa_nodes()
+    {
+        std::vector<std::vector<uint16_t>> ret;
+        #if defined(__linux__)
+        const std::string base ("/sys/devices/system/node/");
+        for (const auto node : parse_cpulist (read_line (base + "online"))) {
+            auto cpus = parse_cpulist (read_line (base + "node" +
+                                        std::to_string (node) + "/cpulist"));
+            if (cpus.size() != 0)   // memory-only nodes have no cpu
+                ret.emplace_back (std::move(cpus));
+        }
+        #endif
+        return ret;
+    }
+
+    static void pin_thread (const std::vector<uint16_t> &cpus)
+    {
+        #if defined(__linux__)
+        if (cpus.size() == 0)
+            return;
+        cpu_set_t set;
+        CPU_ZERO (&set);
+        for (const auto cpu : cpus) {
+            if (cpu < CPU_SETSIZE)
+                CPU_SET (cpu, &set);
+        }
+        // failing is not a problem, we just run unpinned
+        pthread_setaffinity_np (pthread_self(), sizeof(set), &set);
+        #else
+        RQ_UNUSED (cpus);
+        #endif
+    }
 
     static void working_thread (Thread_Pool *obj,
                                     std::shared_ptr<Work_State_Overlay> state)
     {
+        uint32_t generation = 0;
+        size_t group = 0;
+        {
+            std::lock_guard<std::mutex> lock_data (obj->_data_mtx);
+            RQ_UNUSED(lock_data);
+            if (obj->_generation == 0) {
+                ++obj->_group_workers[0];
+                thread_group() = 0;
+            } else {
+                // affinity was set: pin ourselves at the first iteration
+                generation = obj->_generation - 1;
+            }
+        }
         while (Work_State_Overlay::KEEP_WORKING == *state) {
             std::unique_lock<std::mutex> lock_data (obj->_data_mtx);
             if (Work_State_Overlay::KEEP_WORKING != *state) {
                 lock_data.unlock();
                 break;
             }
-            if (obj->_queue.size() == 0) {
+            if (generation != obj->_generation) {
+                // thread affinity changed. The group counters have been
+                // reset, so just join the least crowded one.
+                generation = obj->_generation;
+                group = obj->join_group();
+                thread_group() = group;
+                std::vector<uint16_t> cpus = obj->_all_cpus;
+                if (group < obj->_groups.size())
+                    cpus = obj->_groups[group];
+                lock_data.unlock();
+                pin_thread (cpus);
+                continue;
+            }
+            std::unique_ptr<Pool_Work> my_work = obj->get_work (group);
+            if (my_work == nullptr) {
                 *state = Work_State_Overlay::WAITING;
                 obj->_cond.wait (lock_data);
                 if (Work_State_Overlay::WAITING != *state) {    // => abort
@@ -224,24 +518,27 @@ private:
                 lock_data.unlock();
                 continue;
             }
-
-            std::unique_ptr<Pool_Work> my_work;
-            my_work.swap (obj->_queue.front());
-            obj->_queue.pop_front();
+            // we are busy now: the idle threads of the other nodes
+            // might have to take our queue.
+            const bool wake = obj->_sticky;
             lock_data.unlock();
-            if (my_work == nullptr) {
-                assert (false && "thread null work");
-                continue; // should never happen
-            }
+            if (wake)
+                obj->_cond.notify_all();
             auto exit_stat = my_work->do_work (
                     reinterpret_cast<RaptorQ__v1::Work_State *> (state.get()));
+            lock_data.lock();
+            if (generation == obj->_generation &&
+                                            group < obj->_group_busy.size()) {
+                --obj->_group_busy[group];
+            }
+            lock_data.unlock();
 
             switch (exit_stat) {
             case Work_Exit_Status::DONE:
                 break;
             case Work_Exit_Status::STOPPED:
                 lock_data.lock();
-                obj->_queue.push_front (std::move(my_work));
+                obj->queue_for (my_work.get()).push_front (std::move(my_work));
                 lock_data.unlock();
                 obj->_cond.notify_all();
                 break;
@@ -250,6 +547,12 @@ private:
                 break;
             }
         }
+        std::unique_lock<std::mutex> lock_data (obj->_data_mtx);
+        if (generation == obj->_generation &&
+                                        group < obj->_group_workers.size()) {
+            --obj->_group_workers[group];
+        }
+        lock_data.unlock();
         // delete ourselves from the thread queue.
         std::unique_lock<std::mutex> _lock_pool (obj->_pool_mtx);
 
@@ -290,4 +593,16 @@ inline bool RAPTORQ_API set_thread_pool (const size_t threads,
     Impl::Thread_Pool::get().resize_pool (threads, exit_type);
     return true;
 }
+
+inline bool RAPTORQ_API set_thread_pool_affinity (const Pool_Affinity affinity)
+{
+    switch (affinity) {
+    case Pool_Affinity::NONE:
+    case Pool_Affinity::CPU:
+    case Pool_Affinity::NUMA:
+        Impl::Thread_Pool::get().set_affinity (affinity);
+        return true;
+    }
+    return false;
+}
 } // namespave RFC6330__v1
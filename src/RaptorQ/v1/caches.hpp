@@ -33,6 +33,11 @@ RAPTORQ_API bool     set_compression (const Compress compression);
 RAPTORQ_API size_t local_cache_size (const size_t local_cache);
 RAPTORQ_API size_t get_local_cache_size();
 
+// shared per-K' precode matrices, see Plan_Registry. 0 disables them.
+RAPTORQ_API size_t plan_cache_size (const size_t bytes);
+RAPTORQ_API size_t get_plan_cache_size();
+RAPTORQ_API void   clear_plan_cache();
+
 namespace Impl {
 
 RAPTORQ_API std::pair<Compress, std::vector<uint8_t>> compress (
@@ -51,5 +56,8 @@ using RaptorQ__v1::get_compression;
 using RaptorQ__v1::set_compression;
 using RaptorQ__v1::local_cache_size;
 using RaptorQ__v1::get_local_cache_size;
+using RaptorQ__v1::plan_cache_size;
+using RaptorQ__v1::get_plan_cache_size;
+using RaptorQ__v1::clear_plan_cache;
 
 } // namespace RFC6330__v1
@@ -22,6 +22,7 @@
 
 #include "RaptorQ/v1/caches.hpp"
 #include "RaptorQ/v1/Shared_Computation/Decaying_LF.hpp"
+#include "RaptorQ/v1/Shared_Computation/Plan_Registry.hpp"
 #ifdef RQ_USE_LZ4
     #include "RaptorQ/v1/Shared_Computation/LZ4_Wrapper.hpp"
 #endif
@@ -74,6 +75,15 @@ RQ_HDR_INLINE size_t get_local_cache_size()
                                                             get()->get_size();
 }
 
+RQ_HDR_INLINE size_t plan_cache_size (const size_t bytes)
+    { return Impl::Plan_Registry::get().resize (bytes); }
+
+RQ_HDR_INLINE size_t get_plan_cache_size()
+    { return Impl::Plan_Registry::get().max_bytes(); }
+
+RQ_HDR_INLINE void clear_plan_cache()
+    { Impl::Plan_Registry::get().clear(); }
+
 namespace Impl {
 RQ_HDR_INLINE std::pair<Compress, std::vector<uint8_t>> compress (
                                             const std::vector<uint8_t> &data)
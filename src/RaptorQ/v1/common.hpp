@@ -106,6 +106,7 @@ typedef uint32_t RFC6330_OTI_Scheme_Specific_Data;
 
 #if defined(__cplusplus)&& ( __cplusplus >= 201103L || _MSC_VER > 1900 )
 // C++ version. keep the enum synced
+#include <functional>
 #include <memory>
 #include <utility>
 
@@ -179,6 +180,22 @@ enum class Dec_Report : uint8_t {
     COMPLETE = RQ_COMPUTE_COMPLETE
 };
 
+// when a decoder should attempt a decoding. {0, 0, 0} (the default) means
+// "as soon as we have as many repair symbols as missing symbols".
+// "end_of_input" always allows an attempt with what we have.
+struct RAPTORQ_API Decode_Policy {
+    // wait for "missing + overhead" repair symbols
+    uint16_t overhead;
+    // once we have at least "missing" repair symbols, do not wait for the
+    // overhead if no new symbol arrived for "quiet_ms" milliseconds.
+    // 0: wait for the overhead.
+    uint32_t quiet_ms;
+    // raise "overhead" until the expected failure probability is below
+    // this (rfc 6330: ~1e-2 with no overhead, 1e-4 with 1, 1e-6 with 2...)
+    // 0: not used.
+    float max_failure;
+};
+
 // tracks C_common.h/RFC6330_Compute
 enum class Compute : uint8_t {
     NONE = RQ_COMPUTE_NONE,
@@ -187,13 +204,24 @@ enum class Compute : uint8_t {
     COMPLETE = RQ_COMPUTE_COMPLETE,
     NO_BACKGROUND = RQ_COMPUTE_NO_BACKGROUND,
     NO_POOL = RQ_COMPUTE_NO_POOL,
-    NO_RETRY = RQ_COMPUTE_NO_RETRY
+    NO_RETRY = RQ_COMPUTE_NO_RETRY,
+    WIDE = RQ_COMPUTE_WIDE
 };
 
 // tracks C_common.h/RaptorQ_Fill_With_Zeros
 enum class Fill_With_Zeros : uint8_t { NO  = RQ_NO_FILL,
                                        YES = RQ_FILL_WITH_ZEROS };
 
+// tracks C_common.h/RaptorQ_Notify_Event
+enum class Notify_Event : uint8_t { BLOCK = RQ_NOTIFY_BLOCK,
+                                    COMPUTE = RQ_NOTIFY_COMPUTE };
+// completion notifications for event loops. Called from the library
+// threads: be quick, and do not call back into the same object.
+// "sbn": the block for BLOCK, the reported block for COMPUTE. 0 for RAW.
+using Notify_Callback = std::function<void (const Notify_Event event,
+                                                const Error error,
+                                                const uint8_t sbn)>;
+
 inline Compute operator| (const Compute a, const Compute b)
 {
     return static_cast<Compute> (static_cast<uint8_t> (a) |
@@ -219,8 +247,11 @@ namespace Impl {
 
 using Compute = RaptorQ__v1::Compute;
 using Compress = RaptorQ__v1::Compress;
+using Decode_Policy = RaptorQ__v1::Decode_Policy;
 using Error = RaptorQ__v1::Error;
 using Fill_With_Zeros = RaptorQ__v1::Fill_With_Zeros;
+using Notify_Callback = RaptorQ__v1::Notify_Callback;
+using Notify_Event = RaptorQ__v1::Notify_Event;
 using Work_State = RaptorQ__v1::Work_State;
 
 // dieffrent than RaptorQ_v1::Decoder_written
@@ -231,6 +262,20 @@ struct RAPTORQ_API Decoder_written
     uint64_t written;
     uint8_t offset;
 };
+
+// one packet, as two buffers for scatter/gather I/O (sendmmsg/recvmmsg):
+// the 4 bytes of "header" (the FEC Payload ID, as on the wire: big endian)
+// and the "size" bytes of the symbol at "symbol".
+struct RAPTORQ_API Packet_Desc
+{
+    uint32_t header;
+    const uint8_t *symbol;
+    size_t size;
+};
+
+// gets the decoded blocks, in order. return false to stop.
+using Decoder_Sink = std::function<bool (const uint8_t sbn, const uint8_t *data,
+                                                            const size_t size)>;
 } // namespace RFC6330__v1
 
 
@@ -30,7 +30,7 @@ namespace Impl {
 #pragma clang diagnostic ignored "-Wglobal-constructors"
 #pragma clang diagnostic ignored "-Wexit-time-destructors"
 
-static const std::array<uint32_t, 31> degree_distribution = {
+constexpr std::array<uint32_t, 31> degree_distribution = {
                               0,    5243,  529531,  704294,  791675,  844104,
                          879057,  904023,  922747,  937311,  948962,  958494,
                          966438,  973160,  978921,  983914,  988283,  992138,
@@ -22,7 +22,6 @@
 
 #include "RaptorQ/v1/common.hpp"
 #include "RaptorQ/v1/block_sizes.hpp"
-#include <tuple>
 #include <array>
 
 namespace RaptorQ__v1 {
@@ -37,11 +36,12 @@ constexpr uint16_t table_size = 477;
 #pragma clang diagnostic ignored "-Wexit-time-destructors"
 #endif  //using_clang
 
-using rq_tuple16 = std::tuple<uint16_t, uint16_t, uint16_t>;
+// S, H, W
+using rq_tuple16 = std::array<uint16_t, 3>;
 
 static const uint16_t K_max = K_padded[table_size - 1];
 
-static const std::array<uint16_t, table_size> J_K_padded = {
+constexpr std::array<uint16_t, table_size> J_K_padded = {
     254, 630, 682, 293,  80, 566, 860, 267, 822, 506, 589,  87, 520, 159, 235,
     157, 502, 334, 583,  66, 352, 365, 562,   5, 603, 721,  28, 660, 829, 900,
     930, 814, 661, 693, 780, 605, 551, 777, 491, 396, 764, 843, 646, 557, 608,
@@ -75,167 +75,167 @@ static const std::array<uint16_t, table_size> J_K_padded = {
     379,  73, 387, 457, 761, 855, 370, 261, 299, 920, 269, 862, 349, 103, 115,
      93, 982, 432, 340, 173, 421, 330, 624, 233, 362, 963, 471};
 
-static const std::array<rq_tuple16, table_size> S_H_W = {
-    rq_tuple16(7, 10, 17), rq_tuple16(7, 10, 19), rq_tuple16(11, 10, 29),
-    rq_tuple16(11, 10, 31), rq_tuple16(11, 10, 37), rq_tuple16(11, 10, 41),
-    rq_tuple16(11, 10, 43), rq_tuple16(11, 10, 47), rq_tuple16(11, 10, 53),
-    rq_tuple16(13, 10, 59), rq_tuple16(13, 10, 61), rq_tuple16(13, 10, 61),
-    rq_tuple16(13, 10, 67), rq_tuple16(13, 10, 71), rq_tuple16(13, 10, 73),
-    rq_tuple16(13, 10, 79), rq_tuple16(17, 10, 89), rq_tuple16(17, 10, 97),
-    rq_tuple16(17, 10, 101), rq_tuple16(17, 10, 103), rq_tuple16(17, 10, 107),
-    rq_tuple16(17, 10, 109), rq_tuple16(17, 10, 113), rq_tuple16(19, 10, 127),
-    rq_tuple16(19, 10, 131), rq_tuple16(19, 10, 137), rq_tuple16(19, 10, 139),
-    rq_tuple16(19, 10, 149), rq_tuple16(19, 10, 151), rq_tuple16(23, 10, 163),
-    rq_tuple16(23, 10, 167), rq_tuple16(23, 10, 173), rq_tuple16(23, 10, 179),
-    rq_tuple16(23, 10, 181), rq_tuple16(23, 10, 191), rq_tuple16(23, 10, 193),
-    rq_tuple16(23, 10, 197), rq_tuple16(23, 10, 199), rq_tuple16(23, 10, 211),
-    rq_tuple16(23, 10, 223), rq_tuple16(29, 10, 233), rq_tuple16(29, 10, 241),
-    rq_tuple16(29, 10, 251), rq_tuple16(29, 10, 257), rq_tuple16(29, 10, 263),
-    rq_tuple16(29, 10, 271), rq_tuple16(29, 10, 277), rq_tuple16(29, 10, 283),
-    rq_tuple16(29, 10, 293), rq_tuple16(29, 10, 307), rq_tuple16(29, 10, 313),
-    rq_tuple16(29, 10, 317), rq_tuple16(31, 10, 337), rq_tuple16(31, 10, 349),
-    rq_tuple16(31, 10, 353), rq_tuple16(31, 10, 359), rq_tuple16(31, 10, 367),
-    rq_tuple16(31, 10, 373), rq_tuple16(31, 10, 379), rq_tuple16(37, 10, 389),
-    rq_tuple16(37, 10, 397), rq_tuple16(37, 10, 401), rq_tuple16(37, 10, 409),
-    rq_tuple16(37, 10, 421), rq_tuple16(37, 10, 433), rq_tuple16(37, 10, 443),
-    rq_tuple16(37, 10, 449), rq_tuple16(37, 10, 461), rq_tuple16(37, 10, 467),
-    rq_tuple16(37, 10, 479), rq_tuple16(37, 10, 491), rq_tuple16(37, 10, 499),
-    rq_tuple16(37, 10, 503), rq_tuple16(37, 10, 509), rq_tuple16(37, 10, 523),
-    rq_tuple16(41, 10, 541), rq_tuple16(41, 10, 547), rq_tuple16(41, 10, 557),
-    rq_tuple16(41, 10, 563), rq_tuple16(41, 10, 571), rq_tuple16(41, 10, 577),
-    rq_tuple16(41, 10, 587), rq_tuple16(41, 10, 593), rq_tuple16(41, 10, 601),
-    rq_tuple16(41, 10, 607), rq_tuple16(41, 10, 613), rq_tuple16(41, 10, 619),
-    rq_tuple16(41, 10, 631), rq_tuple16(43, 10, 647), rq_tuple16(43, 10, 653),
-    rq_tuple16(43, 10, 661), rq_tuple16(47, 10, 683), rq_tuple16(47, 10, 691),
-    rq_tuple16(47, 10, 701), rq_tuple16(47, 10, 709), rq_tuple16(47, 10, 719),
-    rq_tuple16(47, 10, 733), rq_tuple16(47, 10, 743), rq_tuple16(47, 10, 751),
-    rq_tuple16(47, 10, 761), rq_tuple16(47, 10, 773), rq_tuple16(53, 10, 797),
-    rq_tuple16(53, 10, 811), rq_tuple16(53, 10, 821), rq_tuple16(53, 10, 829),
-    rq_tuple16(53, 10, 839), rq_tuple16(53, 10, 853), rq_tuple16(53, 10, 863),
-    rq_tuple16(53, 10, 877), rq_tuple16(53, 10, 887), rq_tuple16(53, 10, 907),
-    rq_tuple16(53, 10, 919), rq_tuple16(53, 10, 929), rq_tuple16(53, 10, 941),
-    rq_tuple16(53, 10, 953), rq_tuple16(59, 10, 971), rq_tuple16(59, 10, 983),
-    rq_tuple16(59, 10, 997), rq_tuple16(59, 10, 1009), rq_tuple16(59, 10, 1021),
-    rq_tuple16(59, 10, 1039), rq_tuple16(59, 10, 1051),rq_tuple16(59, 11, 1069),
-    rq_tuple16(59, 11, 1093), rq_tuple16(59, 11, 1103),rq_tuple16(59, 11, 1117),
-    rq_tuple16(59, 11, 1129), rq_tuple16(59, 11, 1153),rq_tuple16(61, 11, 1171),
-    rq_tuple16(61, 11, 1187), rq_tuple16(61, 11, 1201),rq_tuple16(61, 11, 1223),
-    rq_tuple16(61, 11, 1237), rq_tuple16(67, 11, 1259),rq_tuple16(67, 11, 1277),
-    rq_tuple16(67, 11, 1291), rq_tuple16(67, 11, 1307),rq_tuple16(67, 11, 1327),
-    rq_tuple16(67, 11, 1367), rq_tuple16(67, 11, 1381),rq_tuple16(67, 11, 1409),
-    rq_tuple16(67, 11, 1423), rq_tuple16(67, 11, 1439),rq_tuple16(71, 11, 1459),
-    rq_tuple16(71, 11, 1483), rq_tuple16(71, 11, 1499),rq_tuple16(71, 11, 1523),
-    rq_tuple16(71, 11, 1543), rq_tuple16(71, 11, 1559),rq_tuple16(73, 11, 1583),
-    rq_tuple16(73, 11, 1601), rq_tuple16(73, 11, 1621),rq_tuple16(73, 11, 1637),
-    rq_tuple16(73, 11, 1669), rq_tuple16(79, 11, 1699),rq_tuple16(79, 11, 1723),
-    rq_tuple16(79, 11, 1741), rq_tuple16(79, 11, 1759),rq_tuple16(79, 11, 1783),
-    rq_tuple16(79, 11, 1801), rq_tuple16(79, 11, 1823),rq_tuple16(79, 11, 1847),
-    rq_tuple16(79, 11, 1867), rq_tuple16(83, 11, 1889),rq_tuple16(83, 11, 1913),
-    rq_tuple16(83, 11, 1931), rq_tuple16(83, 11, 1951),rq_tuple16(83, 11, 1979),
-    rq_tuple16(83, 11, 2003), rq_tuple16(83, 11, 2029),rq_tuple16(89, 11, 2069),
-    rq_tuple16(89, 11, 2099), rq_tuple16(89, 11, 2131),rq_tuple16(89, 11, 2153),
-    rq_tuple16(89, 11, 2179), rq_tuple16(89, 11, 2221),rq_tuple16(89, 11, 2243),
-    rq_tuple16(89, 11, 2273), rq_tuple16(97, 11, 2311),rq_tuple16(97, 11, 2347),
-    rq_tuple16(97, 11, 2371), rq_tuple16(97, 11, 2399),rq_tuple16(97, 11, 2423),
-    rq_tuple16(97, 11, 2447), rq_tuple16(97, 11, 2477),rq_tuple16(97, 11, 2503),
-    rq_tuple16(97, 11, 2531), rq_tuple16(97, 11, 2557),rq_tuple16(97, 11, 2593),
-    rq_tuple16(101,11,2633), rq_tuple16(101,11,2671), rq_tuple16(101,11,2699),
-    rq_tuple16(101,11,2731), rq_tuple16(101,11,2767), rq_tuple16(101,11,2801),
-    rq_tuple16(103,11,2833), rq_tuple16(103,11,2861), rq_tuple16(107,11,2909),
-    rq_tuple16(107,11,2939), rq_tuple16(107,11,2971), rq_tuple16(107,11,3011),
-    rq_tuple16(109,11,3049), rq_tuple16(109,11,3089), rq_tuple16(113,11,3137),
-    rq_tuple16(113,11,3187), rq_tuple16(113,11,3221), rq_tuple16(113,11,3259),
-    rq_tuple16(113,11,3299), rq_tuple16(127,11,3347), rq_tuple16(127,11,3391),
-    rq_tuple16(127,11,3433), rq_tuple16(127,11,3469), rq_tuple16(127,11,3511),
-    rq_tuple16(127,11,3547), rq_tuple16(127,11,3583), rq_tuple16(127,11,3623),
-    rq_tuple16(127,11,3659), rq_tuple16(127,11,3701), rq_tuple16(127,11,3739),
-    rq_tuple16(127,11,3793), rq_tuple16(127,11,3833), rq_tuple16(127,11,3881),
-    rq_tuple16(127,11,3923), rq_tuple16(131,11,3967), rq_tuple16(131,11,4013),
-    rq_tuple16(131,11,4057), rq_tuple16(131,11,4111), rq_tuple16(137,11,4159),
-    rq_tuple16(137,11,4211), rq_tuple16(137,11,4253), rq_tuple16(137,11,4297),
-    rq_tuple16(137,11,4363), rq_tuple16(137,11,4409), rq_tuple16(139,11,4463),
-    rq_tuple16(139,11,4513), rq_tuple16(149,11,4567), rq_tuple16(149,11,4621),
-    rq_tuple16(149,11,4679), rq_tuple16(149,11,4733), rq_tuple16(149,11,4783),
-    rq_tuple16(149,11,4831), rq_tuple16(149,11,4889), rq_tuple16(149,11,4951),
-    rq_tuple16(149,11,5003), rq_tuple16(151,11,5059), rq_tuple16(151,11,5113),
-    rq_tuple16(157,11,5171), rq_tuple16(157,11,5227), rq_tuple16(157,11,5279),
-    rq_tuple16(157,11,5333), rq_tuple16(157,11,5387), rq_tuple16(157,11,5443),
-    rq_tuple16(163,11,5507), rq_tuple16(163,11,5563), rq_tuple16(163,11,5623),
-    rq_tuple16(163,11,5693), rq_tuple16(163,11,5749), rq_tuple16(167,11,5821),
-    rq_tuple16(167,11,5881), rq_tuple16(167,11,5953), rq_tuple16(173,11,6037),
-    rq_tuple16(173,11,6101), rq_tuple16(173,11,6163), rq_tuple16(173,11,6229),
-    rq_tuple16(179,11,6299), rq_tuple16(179,11,6361), rq_tuple16(179,11,6427),
-    rq_tuple16(179,11,6491), rq_tuple16(179,11,6581), rq_tuple16(181,11,6653),
-    rq_tuple16(181,11,6719), rq_tuple16(191,11,6803), rq_tuple16(191,11,6871),
-    rq_tuple16(191,11,6949), rq_tuple16(191,11,7027), rq_tuple16(191,11,7103),
-    rq_tuple16(191,11,7177), rq_tuple16(191,11,7253), rq_tuple16(193,11,7351),
-    rq_tuple16(197,11,7433), rq_tuple16(197,11,7517), rq_tuple16(197,11,7591),
-    rq_tuple16(199,11,7669), rq_tuple16(211,11,7759), rq_tuple16(211,11,7853),
-    rq_tuple16(211,11,7937), rq_tuple16(211,11,8017), rq_tuple16(211,11,8111),
-    rq_tuple16(211,11,8191), rq_tuple16(211,11,8273), rq_tuple16(211,11,8369),
-    rq_tuple16(223,11,8467), rq_tuple16(223,11,8563), rq_tuple16(223,11,8647),
-    rq_tuple16(223,11,8741), rq_tuple16(223,11,8831), rq_tuple16(223,11,8923),
-    rq_tuple16(223,11,9013), rq_tuple16(223,11,9103), rq_tuple16(227,11,9199),
-    rq_tuple16(227,11,9293), rq_tuple16(229,11,9391), rq_tuple16(233,11,9491),
-    rq_tuple16(233,11,9587), rq_tuple16(239,11,9697), rq_tuple16(239,11,9803),
-    rq_tuple16(239,11,9907), rq_tuple16(239,11,10009), rq_tuple16(241,11,10111),
-    rq_tuple16(251,11,10223), rq_tuple16(251,11,10343),rq_tuple16(251,11,10453),
-    rq_tuple16(251,11,10559), rq_tuple16(251,11,10667),rq_tuple16(257,11,10781),
-    rq_tuple16(257,11,10891), rq_tuple16(257,12,11003),rq_tuple16(257,12,11119),
-    rq_tuple16(263,12,11239), rq_tuple16(263,12,11353),rq_tuple16(269,12,11471),
-    rq_tuple16(269,12,11587), rq_tuple16(269,12,11701),rq_tuple16(269,12,11821),
-    rq_tuple16(271,12,11941), rq_tuple16(277,12,12073),rq_tuple16(277,12,12203),
-    rq_tuple16(277,12,12323), rq_tuple16(281,12,12451),rq_tuple16(281,12,12577),
-    rq_tuple16(293,12,12721), rq_tuple16(293,12,12853),rq_tuple16(293,12,12983),
-    rq_tuple16(293,12,13127), rq_tuple16(293,12,13267),rq_tuple16(307,12,13421),
-    rq_tuple16(307,12,13553), rq_tuple16(307,12,13693),rq_tuple16(307,12,13829),
-    rq_tuple16(307,12,13967), rq_tuple16(307,12,14107),rq_tuple16(311,12,14251),
-    rq_tuple16(311,12,14407), rq_tuple16(313,12,14551),rq_tuple16(317,12,14699),
-    rq_tuple16(317,12,14851), rq_tuple16(331,12,15013),rq_tuple16(331,12,15161),
-    rq_tuple16(331,12,15319), rq_tuple16(331,12,15473),rq_tuple16(331,12,15643),
-    rq_tuple16(337,12,15803), rq_tuple16(337,12,15959),rq_tuple16(337,12,16127),
-    rq_tuple16(347,12,16319), rq_tuple16(347,12,16493),rq_tuple16(347,12,16661),
-    rq_tuple16(349,12,16831), rq_tuple16(353,12,17011),rq_tuple16(353,12,17183),
-    rq_tuple16(359,12,17359), rq_tuple16(359,12,17539),rq_tuple16(367,12,17729),
-    rq_tuple16(367,12,17911), rq_tuple16(367,12,18097),rq_tuple16(373,12,18289),
-    rq_tuple16(373,12,18481), rq_tuple16(379,12,18679),rq_tuple16(379,12,18869),
-    rq_tuple16(383,12,19087), rq_tuple16(389,12,19309),rq_tuple16(389,12,19507),
-    rq_tuple16(397,12,19727), rq_tuple16(397,12,19927),rq_tuple16(401,12,20129),
-    rq_tuple16(401,12,20341), rq_tuple16(409,12,20551),rq_tuple16(409,12,20759),
-    rq_tuple16(419,13,20983), rq_tuple16(419,13,21191),rq_tuple16(419,13,21401),
-    rq_tuple16(419,13,21613), rq_tuple16(431,13,21841),rq_tuple16(431,13,22063),
-    rq_tuple16(431,13,22283), rq_tuple16(433,13,22511),rq_tuple16(439,13,22751),
-    rq_tuple16(439,13,22993), rq_tuple16(443,13,23227),rq_tuple16(449,13,23473),
-    rq_tuple16(457,13,23719), rq_tuple16(457,13,23957),rq_tuple16(457,13,24197),
-    rq_tuple16(461,13,24443), rq_tuple16(467,13,24709),rq_tuple16(467,13,24953),
-    rq_tuple16(479,13,25219), rq_tuple16(479,13,25471),rq_tuple16(479,13,25733),
-    rq_tuple16(487,13,26003), rq_tuple16(487,13,26267),rq_tuple16(491,13,26539),
-    rq_tuple16(499,13,26821), rq_tuple16(499,13,27091),rq_tuple16(503,13,27367),
-    rq_tuple16(509,13,27653), rq_tuple16(521,13,27953),rq_tuple16(521,13,28229),
-    rq_tuple16(521,13,28517), rq_tuple16(523,13,28817),rq_tuple16(541,13,29131),
-    rq_tuple16(541,13,29423), rq_tuple16(541,13,29717),rq_tuple16(541,13,30013),
-    rq_tuple16(547,13,30323), rq_tuple16(547,13,30631),rq_tuple16(557,14,30949),
-    rq_tuple16(557,14,31267), rq_tuple16(563,14,31583),rq_tuple16(569,14,31907),
-    rq_tuple16(571,14,32251), rq_tuple16(577,14,32579),rq_tuple16(587,14,32917),
-    rq_tuple16(587,14,33247), rq_tuple16(593,14,33601),rq_tuple16(593,14,33941),
-    rq_tuple16(599,14,34283), rq_tuple16(607,14,34631),rq_tuple16(607,14,34981),
-    rq_tuple16(613,14,35363), rq_tuple16(619,14,35731),rq_tuple16(631,14,36097),
-    rq_tuple16(631,14,36457), rq_tuple16(641,14,36833),rq_tuple16(641,14,37201),
-    rq_tuple16(643,14,37579), rq_tuple16(653,14,37967),rq_tuple16(653,14,38351),
-    rq_tuple16(659,14,38749), rq_tuple16(673,14,39163),rq_tuple16(673,14,39551),
-    rq_tuple16(677,14,39953), rq_tuple16(683,14,40361),rq_tuple16(691,15,40787),
-    rq_tuple16(701,15,41213), rq_tuple16(701,15,41621),rq_tuple16(709,15,42043),
-    rq_tuple16(709,15,42467), rq_tuple16(719,15,42899),rq_tuple16(727,15,43331),
-    rq_tuple16(727,15,43801), rq_tuple16(733,15,44257),rq_tuple16(739,15,44701),
-    rq_tuple16(751,15,45161), rq_tuple16(751,15,45613),rq_tuple16(757,15,46073),
-    rq_tuple16(769,15,46549), rq_tuple16(769,15,47017),rq_tuple16(787,15,47507),
-    rq_tuple16(787,15,47981), rq_tuple16(787,15,48463),rq_tuple16(797,15,48953),
-    rq_tuple16(809,15,49451), rq_tuple16(809,15,49943),rq_tuple16(821,15,50461),
-    rq_tuple16(821,16,50993), rq_tuple16(827,16,51503),rq_tuple16(839,16,52027),
-    rq_tuple16(853,16,52571), rq_tuple16(853,16,53093),rq_tuple16(857,16,53623),
-    rq_tuple16(863,16,54163), rq_tuple16(877,16,54713),rq_tuple16(877,16,55259),
-    rq_tuple16(883,16,55817), rq_tuple16(907,16,56393),rq_tuple16(907,16,56951)
-};
+constexpr std::array<rq_tuple16, table_size> S_H_W = {{
+    {{7, 10, 17}}, {{7, 10, 19}}, {{11, 10, 29}},
+    {{11, 10, 31}}, {{11, 10, 37}}, {{11, 10, 41}},
+    {{11, 10, 43}}, {{11, 10, 47}}, {{11, 10, 53}},
+    {{13, 10, 59}}, {{13, 10, 61}}, {{13, 10, 61}},
+    {{13, 10, 67}}, {{13, 10, 71}}, {{13, 10, 73}},
+    {{13, 10, 79}}, {{17, 10, 89}}, {{17, 10, 97}},
+    {{17, 10, 101}}, {{17, 10, 103}}, {{17, 10, 107}},
+    {{17, 10, 109}}, {{17, 10, 113}}, {{19, 10, 127}},
+    {{19, 10, 131}}, {{19, 10, 137}}, {{19, 10, 139}},
+    {{19, 10, 149}}, {{19, 10, 151}}, {{23, 10, 163}},
+    {{23, 10, 167}}, {{23, 10, 173}}, {{23, 10, 179}},
+    {{23, 10, 181}}, {{23, 10, 191}}, {{23, 10, 193}},
+    {{23, 10, 197}}, {{23, 10, 199}}, {{23, 10, 211}},
+    {{23, 10, 223}}, {{29, 10, 233}}, {{29, 10, 241}},
+    {{29, 10, 251}}, {{29, 10, 257}}, {{29, 10, 263}},
+    {{29, 10, 271}}, {{29, 10, 277}}, {{29, 10, 283}},
+    {{29, 10, 293}}, {{29, 10, 307}}, {{29, 10, 313}},
+    {{29, 10, 317}}, {{31, 10, 337}}, {{31, 10, 349}},
+    {{31, 10, 353}}, {{31, 10, 359}}, {{31, 10, 367}},
+    {{31, 10, 373}}, {{31, 10, 379}}, {{37, 10, 389}},
+    {{37, 10, 397}}, {{37, 10, 401}}, {{37, 10, 409}},
+    {{37, 10, 421}}, {{37, 10, 433}}, {{37, 10, 443}},
+    {{37, 10, 449}}, {{37, 10, 461}}, {{37, 10, 467}},
+    {{37, 10, 479}}, {{37, 10, 491}}, {{37, 10, 499}},
+    {{37, 10, 503}}, {{37, 10, 509}}, {{37, 10, 523}},
+    {{41, 10, 541}}, {{41, 10, 547}}, {{41, 10, 557}},
+    {{41, 10, 563}}, {{41, 10, 571}}, {{41, 10, 577}},
+    {{41, 10, 587}}, {{41, 10, 593}}, {{41, 10, 601}},
+    {{41, 10, 607}}, {{41, 10, 613}}, {{41, 10, 619}},
+    {{41, 10, 631}}, {{43, 10, 647}}, {{43, 10, 653}},
+    {{43, 10, 661}}, {{47, 10, 683}}, {{47, 10, 691}},
+    {{47, 10, 701}}, {{47, 10, 709}}, {{47, 10, 719}},
+    {{47, 10, 733}}, {{47, 10, 743}}, {{47, 10, 751}},
+    {{47, 10, 761}}, {{47, 10, 773}}, {{53, 10, 797}},
+    {{53, 10, 811}}, {{53, 10, 821}}, {{53, 10, 829}},
+    {{53, 10, 839}}, {{53, 10, 853}}, {{53, 10, 863}},
+    {{53, 10, 877}}, {{53, 10, 887}}, {{53, 10, 907}},
+    {{53, 10, 919}}, {{53, 10, 929}}, {{53, 10, 941}},
+    {{53, 10, 953}}, {{59, 10, 971}}, {{59, 10, 983}},
+    {{59, 10, 997}}, {{59, 10, 1009}}, {{59, 10, 1021}},
+    {{59, 10, 1039}}, {{59, 10, 1051}},{{59, 11, 1069}},
+    {{59, 11, 1093}}, {{59, 11, 1103}},{{59, 11, 1117}},
+    {{59, 11, 1129}}, {{59, 11, 1153}},{{61, 11, 1171}},
+    {{61, 11, 1187}}, {{61, 11, 1201}},{{61, 11, 1223}},
+    {{61, 11, 1237}}, {{67, 11, 1259}},{{67, 11, 1277}},
+    {{67, 11, 1291}}, {{67, 11, 1307}},{{67, 11, 1327}},
+    {{67, 11, 1367}}, {{67, 11, 1381}},{{67, 11, 1409}},
+    {{67, 11, 1423}}, {{67, 11, 1439}},{{71, 11, 1459}},
+    {{71, 11, 1483}}, {{71, 11, 1499}},{{71, 11, 1523}},
+    {{71, 11, 1543}}, {{71, 11, 1559}},{{73, 11, 1583}},
+    {{73, 11, 1601}}, {{73, 11, 1621}},{{73, 11, 1637}},
+    {{73, 11, 1669}}, {{79, 11, 1699}},{{79, 11, 1723}},
+    {{79, 11, 1741}}, {{79, 11, 1759}},{{79, 11, 1783}},
+    {{79, 11, 1801}}, {{79, 11, 1823}},{{79, 11, 1847}},
+    {{79, 11, 1867}}, {{83, 11, 1889}},{{83, 11, 1913}},
+    {{83, 11, 1931}}, {{83, 11, 1951}},{{83, 11, 1979}},
+    {{83, 11, 2003}}, {{83, 11, 2029}},{{89, 11, 2069}},
+    {{89, 11, 2099}}, {{89, 11, 2131}},{{89, 11, 2153}},
+    {{89, 11, 2179}}, {{89, 11, 2221}},{{89, 11, 2243}},
+    {{89, 11, 2273}}, {{97, 11, 2311}},{{97, 11, 2347}},
+    {{97, 11, 2371}}, {{97, 11, 2399}},{{97, 11, 2423}},
+    {{97, 11, 2447}}, {{97, 11, 2477}},{{97, 11, 2503}},
+    {{97, 11, 2531}}, {{97, 11, 2557}},{{97, 11, 2593}},
+    {{101,11,2633}}, {{101,11,2671}}, {{101,11,2699}},
+    {{101,11,2731}}, {{101,11,2767}}, {{101,11,2801}},
+    {{103,11,2833}}, {{103,11,2861}}, {{107,11,2909}},
+    {{107,11,2939}}, {{107,11,2971}}, {{107,11,3011}},
+    {{109,11,3049}}, {{109,11,3089}}, {{113,11,3137}},
+    {{113,11,3187}}, {{113,11,3221}}, {{113,11,3259}},
+    {{113,11,3299}}, {{127,11,3347}}, {{127,11,3391}},
+    {{127,11,3433}}, {{127,11,3469}}, {{127,11,3511}},
+    {{127,11,3547}}, {{127,11,3583}}, {{127,11,3623}},
+    {{127,11,3659}}, {{127,11,3701}}, {{127,11,3739}},
+    {{127,11,3793}}, {{127,11,3833}}, {{127,11,3881}},
+    {{127,11,3923}}, {{131,11,3967}}, {{131,11,4013}},
+    {{131,11,4057}}, {{131,11,4111}}, {{137,11,4159}},
+    {{137,11,4211}}, {{137,11,4253}}, {{137,11,4297}},
+    {{137,11,4363}}, {{137,11,4409}}, {{139,11,4463}},
+    {{139,11,4513}}, {{149,11,4567}}, {{149,11,4621}},
+    {{149,11,4679}}, {{149,11,4733}}, {{149,11,4783}},
+    {{149,11,4831}}, {{149,11,4889}}, {{149,11,4951}},
+    {{149,11,5003}}, {{151,11,5059}}, {{151,11,5113}},
+    {{157,11,5171}}, {{157,11,5227}}, {{157,11,5279}},
+    {{157,11,5333}}, {{157,11,5387}}, {{157,11,5443}},
+    {{163,11,5507}}, {{163,11,5563}}, {{163,11,5623}},
+    {{163,11,5693}}, {{163,11,5749}}, {{167,11,5821}},
+    {{167,11,5881}}, {{167,11,5953}}, {{173,11,6037}},
+    {{173,11,6101}}, {{173,11,6163}}, {{173,11,6229}},
+    {{179,11,6299}}, {{179,11,6361}}, {{179,11,6427}},
+    {{179,11,6491}}, {{179,11,6581}}, {{181,11,6653}},
+    {{181,11,6719}}, {{191,11,6803}}, {{191,11,6871}},
+    {{191,11,6949}}, {{191,11,7027}}, {{191,11,7103}},
+    {{191,11,7177}}, {{191,11,7253}}, {{193,11,7351}},
+    {{197,11,7433}}, {{197,11,7517}}, {{197,11,7591}},
+    {{199,11,7669}}, {{211,11,7759}}, {{211,11,7853}},
+    {{211,11,7937}}, {{211,11,8017}}, {{211,11,8111}},
+    {{211,11,8191}}, {{211,11,8273}}, {{211,11,8369}},
+    {{223,11,8467}}, {{223,11,8563}}, {{223,11,8647}},
+    {{223,11,8741}}, {{223,11,8831}}, {{223,11,8923}},
+    {{223,11,9013}}, {{223,11,9103}}, {{227,11,9199}},
+    {{227,11,9293}}, {{229,11,9391}}, {{233,11,9491}},
+    {{233,11,9587}}, {{239,11,9697}}, {{239,11,9803}},
+    {{239,11,9907}}, {{239,11,10009}}, {{241,11,10111}},
+    {{251,11,10223}}, {{251,11,10343}},{{251,11,10453}},
+    {{251,11,10559}}, {{251,11,10667}},{{257,11,10781}},
+    {{257,11,10891}}, {{257,12,11003}},{{257,12,11119}},
+    {{263,12,11239}}, {{263,12,11353}},{{269,12,11471}},
+    {{269,12,11587}}, {{269,12,11701}},{{269,12,11821}},
+    {{271,12,11941}}, {{277,12,12073}},{{277,12,12203}},
+    {{277,12,12323}}, {{281,12,12451}},{{281,12,12577}},
+    {{293,12,12721}}, {{293,12,12853}},{{293,12,12983}},
+    {{293,12,13127}}, {{293,12,13267}},{{307,12,13421}},
+    {{307,12,13553}}, {{307,12,13693}},{{307,12,13829}},
+    {{307,12,13967}}, {{307,12,14107}},{{311,12,14251}},
+    {{311,12,14407}}, {{313,12,14551}},{{317,12,14699}},
+    {{317,12,14851}}, {{331,12,15013}},{{331,12,15161}},
+    {{331,12,15319}}, {{331,12,15473}},{{331,12,15643}},
+    {{337,12,15803}}, {{337,12,15959}},{{337,12,16127}},
+    {{347,12,16319}}, {{347,12,16493}},{{347,12,16661}},
+    {{349,12,16831}}, {{353,12,17011}},{{353,12,17183}},
+    {{359,12,17359}}, {{359,12,17539}},{{367,12,17729}},
+    {{367,12,17911}}, {{367,12,18097}},{{373,12,18289}},
+    {{373,12,18481}}, {{379,12,18679}},{{379,12,18869}},
+    {{383,12,19087}}, {{389,12,19309}},{{389,12,19507}},
+    {{397,12,19727}}, {{397,12,19927}},{{401,12,20129}},
+    {{401,12,20341}}, {{409,12,20551}},{{409,12,20759}},
+    {{419,13,20983}}, {{419,13,21191}},{{419,13,21401}},
+    {{419,13,21613}}, {{431,13,21841}},{{431,13,22063}},
+    {{431,13,22283}}, {{433,13,22511}},{{439,13,22751}},
+    {{439,13,22993}}, {{443,13,23227}},{{449,13,23473}},
+    {{457,13,23719}}, {{457,13,23957}},{{457,13,24197}},
+    {{461,13,24443}}, {{467,13,24709}},{{467,13,24953}},
+    {{479,13,25219}}, {{479,13,25471}},{{479,13,25733}},
+    {{487,13,26003}}, {{487,13,26267}},{{491,13,26539}},
+    {{499,13,26821}}, {{499,13,27091}},{{503,13,27367}},
+    {{509,13,27653}}, {{521,13,27953}},{{521,13,28229}},
+    {{521,13,28517}}, {{523,13,28817}},{{541,13,29131}},
+    {{541,13,29423}}, {{541,13,29717}},{{541,13,30013}},
+    {{547,13,30323}}, {{547,13,30631}},{{557,14,30949}},
+    {{557,14,31267}}, {{563,14,31583}},{{569,14,31907}},
+    {{571,14,32251}}, {{577,14,32579}},{{587,14,32917}},
+    {{587,14,33247}}, {{593,14,33601}},{{593,14,33941}},
+    {{599,14,34283}}, {{607,14,34631}},{{607,14,34981}},
+    {{613,14,35363}}, {{619,14,35731}},{{631,14,36097}},
+    {{631,14,36457}}, {{641,14,36833}},{{641,14,37201}},
+    {{643,14,37579}}, {{653,14,37967}},{{653,14,38351}},
+    {{659,14,38749}}, {{673,14,39163}},{{673,14,39551}},
+    {{677,14,39953}}, {{683,14,40361}},{{691,15,40787}},
+    {{701,15,41213}}, {{701,15,41621}},{{709,15,42043}},
+    {{709,15,42467}}, {{719,15,42899}},{{727,15,43331}},
+    {{727,15,43801}}, {{733,15,44257}},{{739,15,44701}},
+    {{751,15,45161}}, {{751,15,45613}},{{757,15,46073}},
+    {{769,15,46549}}, {{769,15,47017}},{{787,15,47507}},
+    {{787,15,47981}}, {{787,15,48463}},{{797,15,48953}},
+    {{809,15,49451}}, {{809,15,49943}},{{821,15,50461}},
+    {{821,16,50993}}, {{827,16,51503}},{{839,16,52027}},
+    {{853,16,52571}}, {{853,16,53093}},{{857,16,53623}},
+    {{863,16,54163}}, {{877,16,54713}},{{877,16,55259}},
+    {{883,16,55817}}, {{907,16,56393}},{{907,16,56951}}
+}};
 
 #ifdef USING_CLANG
 #pragma clang diagnostic pop
@@ -0,0 +1,77 @@
+/*
+ * Copyright (c) 2015-2018, Luca Fulchir<luca@fulchir.it>, All rights reserved.
+ *
+ * This file is part of "libRaptorQ".
+ *
+ * libRaptorQ is free software: you can redistribute it and/or modify
+ * it under the terms of the GNU Lesser General Public License as
+ * published by the Free Software Foundation, either version 3
+ * of the License, or (at your option) any later version.
+ *
+ * libRaptorQ is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ * GNU General Public License for more details.
+ *
+ * You should have received a copy of the GNU General Public License
+ * and a copy of the GNU Lesser General Public License
+ * along with libRaptorQ.  If not, see <http://www.gnu.org/licenses/>.
+ */
+
+
+#pragma once
+
+#include "RaptorQ/v1/common.hpp"
+#include <atomic>
+#include <memory>
+
+namespace RaptorQ__v1 {
+namespace Impl {
+
+// fixed size bitset that can be read and written concurrently without locks.
+// 64 bits per word: one allocation, and much smaller than a container
+// of atomic<bool>.
+class RAPTORQ_LOCAL Atomic_Bitset
+{
+public:
+    Atomic_Bitset()
+        : _size (0)
+    {}
+    Atomic_Bitset (const size_t bits)
+        : _size (bits), _words (new std::atomic<uint64_t>[words (bits)])
+    {
+        reset();
+    }
+    Atomic_Bitset (const Atomic_Bitset&) = delete;
+    Atomic_Bitset& operator= (const Atomic_Bitset&) = delete;
+    Atomic_Bitset (Atomic_Bitset&&) = default;
+    Atomic_Bitset& operator= (Atomic_Bitset&&) = default;
+    ~Atomic_Bitset() = default;
+
+    size_t size() const
+        { return _size; }
+    bool test (const size_t bit) const
+        { return (_words[bit / 64].load() & mask (bit)) != 0; }
+    void set (const size_t bit)
+        { _words[bit / 64].fetch_or (mask (bit)); }
+    // set the bit, return its previous value
+    bool test_and_set (const size_t bit)
+        { return (_words[bit / 64].fetch_or (mask (bit)) & mask (bit)) != 0; }
+    void reset()
+    {
+        for (size_t idx = 0; idx < words (_size); ++idx)
+            _words[idx].store (0);
+    }
+
+private:
+    size_t _size;
+    std::unique_ptr<std::atomic<uint64_t>[]> _words;
+
+    static size_t words (const size_t bits)
+        { return (bits + 63) / 64; }
+    static uint64_t mask (const size_t bit)
+        { return uint64_t (1) << (bit % 64); }
+};
+
+}   // namespace Impl
+}   // namespace RaptorQ__v1
@@ -0,0 +1,115 @@
+/*
+ * Copyright (c) 2015-2018, Luca Fulchir<luca@fulchir.it>, All rights reserved.
+ *
+ * This file is part of "libRaptorQ".
+ *
+ * libRaptorQ is free software: you can redistribute it and/or modify
+ * it under the terms of the GNU Lesser General Public License as
+ * published by the Free Software Foundation, either version 3
+ * of the License, or (at your option) any later version.
+ *
+ * libRaptorQ is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ * GNU General Public License for more details.
+ *
+ * You should have received a copy of the GNU General Public License
+ * and a copy of the GNU Lesser General Public License
+ * along with libRaptorQ.  If not, see <http://www.gnu.org/licenses/>.
+ */
+
+#pragma once
+
+#include "RaptorQ/v1/common.hpp"
+#include <atomic>
+#include <mutex>
+#if defined(__linux__)
+    #define RQ_NOTIFY_EVENTFD
+    #include <sys/eventfd.h>
+    #include <unistd.h>
+#endif
+
+namespace RaptorQ__v1 {
+namespace Impl {
+
+// completion notifications, so that event loops do not have to block
+// on the futures or poll them.
+// Fired by the threads that already complete the futures: a registered
+// callback is called, and an eventfd (created on first request) is
+// incremented, so it can be added to poll/epoll with the sockets.
+// The eventfd is only available on Linux: elsewhere fd() is -1.
+class RAPTORQ_LOCAL Notifier
+{
+public:
+    Notifier() = default;
+    Notifier (const Notifier&) = delete;
+    Notifier& operator= (const Notifier&) = delete;
+    Notifier (Notifier&&) = delete;
+    Notifier& operator= (Notifier&&) = delete;
+    ~Notifier()
+    {
+        #ifdef RQ_NOTIFY_EVENTFD
+        if (_fd >= 0)
+            close (_fd);
+        #endif
+    }
+
+    // nobody is listening: callers can skip looking for events
+    explicit operator bool() const
+        { return _active; }
+
+    // empty callback: remove it
+    void set (Notify_Callback callback)
+    {
+        std::lock_guard<std::mutex> guard (_mtx);
+        RQ_UNUSED (guard);
+        _callback = std::move (callback);
+        _active = _callback || _fd >= 0;
+    }
+
+    // readable when events happened. reading it (8 bytes) returns
+    // how many, and resets it. -1 if not supported.
+    int fd()
+    {
+        std::lock_guard<std::mutex> guard (_mtx);
+        RQ_UNUSED (guard);
+        #ifdef RQ_NOTIFY_EVENTFD
+        if (_fd < 0)
+            _fd = eventfd (0, EFD_NONBLOCK | EFD_CLOEXEC);
+        #endif
+        _active = _callback || _fd >= 0;
+        return _fd;
+    }
+
+    void fire (const Notify_Event event, const Error error, const uint8_t sbn)
+    {
+        std::unique_lock<std::mutex> lock (_mtx);
+        if (!_active)
+            return;
+        // the callback runs unlocked, so it can change the callback.
+        const auto callback = _callback;
+        const int fd = _fd;
+        lock.unlock();
+        if (callback)
+            callback (event, error, sbn);
+        #ifdef RQ_NOTIFY_EVENTFD
+        if (fd >= 0) {
+            const uint64_t one = 1;
+            // only fails if the counter would overflow: still readable.
+            const ssize_t written = write (fd, &one, sizeof(one));
+            RQ_UNUSED (written);
+        }
+        #else
+        RQ_UNUSED (fd);
+        #endif
+    }
+
+private:
+    std::mutex _mtx;
+    Notify_Callback _callback;
+    int _fd = -1;
+    std::atomic<bool> _active {false};
+};
+
+}   // namespace Impl
+}   // namespace RaptorQ__v1
@@ -0,0 +1,214 @@
+/*
+ * Copyright (c) 2015-2018, Luca Fulchir<luca@fulchir.it>, All rights reserved.
+ *
+ * This file is part of "libRaptorQ".
+ *
+ * libRaptorQ is free software: you can redistribute it and/or modify
+ * it under the terms of the GNU Lesser General Public License as
+ * published by the Free Software Foundation, either version 3
+ * of the License, or (at your option) any later version.
+ *
+ * libRaptorQ is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ * GNU General Public License for more details.
+ *
+ * You should have received a copy of the GNU General Public License
+ * and a copy of the GNU Lesser General Public License
+ * along with libRaptorQ.  If not, see <http://www.gnu.org/licenses/>.
+ */
+
+#pragma once
+
+#include "RaptorQ/v1/common.hpp"
+#include "RaptorQ/v1/Octet.hpp"
+#include <algorithm>
+#include <memory>
+#include <mutex>
+#include <string>
+#include <vector>
+#if defined(__unix__) || defined(__APPLE__)
+    #define RQ_SCRATCH_MMAP
+    #include <fcntl.h>
+    #include <sys/mman.h>
+    #include <unistd.h>
+#endif
+
+namespace RaptorQ__v1 {
+namespace Impl {
+
+// out-of-core storage for the decoders.
+// Memory is taken from an unlinked file in the given directory, mapped
+// in chunks: the kernel can write the symbols back and drop them from
+// RAM whenever it needs to, so the objects we decode can be much bigger
+// than the available memory.
+// Regions are never moved. When the last reference to a region goes
+// away its pages (and, where supported, its disk blocks) are dropped.
+// Only available on unix-like systems: elsewhere "operator bool" is false.
+class RAPTORQ_LOCAL Scratch_File
+{
+public:
+    explicit Scratch_File (const std::string &directory)
+    {
+        #ifdef RQ_SCRATCH_MMAP
+        page = static_cast<size_t> (sysconf (_SC_PAGESIZE));
+        std::string name = directory + "/libRaptorQ-XXXXXX";
+        std::vector<char> tmp (name.begin(), name.end());
+        tmp.push_back ('\0');
+        fd = mkstemp (tmp.data());
+        if (fd >= 0)
+            unlink (tmp.data());    // gone as soon as we close it
+        #else
+        RQ_UNUSED (directory);
+        #endif
+    }
+    Scratch_File() = delete;
+    Scratch_File (const Scratch_File&) = delete;
+    Scratch_File& operator= (const Scratch_File&) = delete;
+    Scratch_File (Scratch_File&&) = delete;
+    Scratch_File& operator= (Scratch_File&&) = delete;
+    ~Scratch_File()
+    {
+        #ifdef RQ_SCRATCH_MMAP
+        // chunks still referenced keep their own mapping alive.
+        if (fd >= 0)
+            close (fd);
+        #endif
+    }
+
+    explicit operator bool() const
+        { return fd >= 0; }
+
+    // "bytes" of stable, zeroed memory, backed by real disk blocks.
+    // nullptr on failure (i.e.: no space left): keep the data in RAM.
+    std::shared_ptr<Octet> alloc (const size_t bytes)
+    {
+        #ifdef RQ_SCRATCH_MMAP
+        if (fd < 0 || bytes == 0)
+            return nullptr;
+        const size_t size = round_up (bytes);
+        std::lock_guard<std::mutex> guard (mtx);
+        RQ_UNUSED (guard);
+        if (last == nullptr || last->used + size > last->size) {
+            const size_t chunk_size = size > chunk_bytes ? size : chunk_bytes;
+            auto chunk = std::make_shared<Chunk> (fd, total, chunk_size);
+            if (chunk->data == nullptr)
+                return nullptr;
+            total += chunk->size;
+            last = std::move (chunk);
+        }
+        Octet *ret = last->data + last->used;
+        last->used += size;
+        auto chunk = last;
+        return std::shared_ptr<Octet> (ret, [chunk, size] (Octet *ptr)
+                                                { chunk->discard (ptr, size); });
+        #else
+        RQ_UNUSED (bytes);
+        return nullptr;
+        #endif
+    }
+
+    // the region will not change anymore: start writing it to disk,
+    // and let the kernel drop it from RAM. It is still readable.
+    void write_back (const Octet *data, const size_t bytes) const
+    {
+        #ifdef RQ_SCRATCH_MMAP
+        void *start = const_cast<Octet*> (data);
+        msync (start, round_up (bytes), MS_ASYNC);
+        madvise (start, round_up (bytes), MADV_DONTNEED);
+        #else
+        RQ_UNUSED (data);
+        RQ_UNUSED (bytes);
+        #endif
+    }
+
+private:
+    static constexpr size_t chunk_bytes = 64 * 1024 * 1024;
+    int fd = -1;
+    size_t page = 4096;
+    uint64_t total = 0;
+    std::mutex mtx;
+
+    class RAPTORQ_LOCAL Chunk
+    {
+    public:
+        Octet *data = nullptr;
+        size_t size, used = 0;
+
+        Chunk (const int fd, const uint64_t offset, const size_t bytes)
+            : size (bytes)
+        {
+            #ifdef RQ_SCRATCH_MMAP
+            // a sparse file would only fail once we write to the mapping,
+            // with a SIGBUS. Get the disk blocks now, or fail here.
+            if (!reserve (fd, offset, bytes))
+                return;
+            void *map = mmap (nullptr, size, PROT_READ | PROT_WRITE,
+                                MAP_SHARED, fd, static_cast<off_t> (offset));
+            if (map == MAP_FAILED)
+                return;
+            // symbols are mostly written in order, and read back in order
+            madvise (map, size, MADV_SEQUENTIAL);
+            data = static_cast<Octet*> (map);
+            #else
+            RQ_UNUSED (fd);
+            RQ_UNUSED (offset);
+            #endif
+        }
+        ~Chunk()
+        {
+            #ifdef RQ_SCRATCH_MMAP
+            if (data != nullptr)
+                munmap (data, size);
+            #endif
+        }
+        Chunk (const Chunk&) = delete;
+        Chunk& operator= (const Chunk&) = delete;
+
+        #ifdef RQ_SCRATCH_MMAP
+        static bool reserve (const int fd, const uint64_t offset,
+                                                            const size_t bytes)
+        {
+            #if defined(__APPLE__)
+            // no posix_fallocate: write the zeros ourselves.
+            const std::vector<char> zeros (64 * 1024, 0);
+            for (size_t done = 0; done < bytes;) {
+                const size_t len = std::min (zeros.size(), bytes - done);
+                const ssize_t ret = pwrite (fd, zeros.data(), len,
+                                            static_cast<off_t> (offset + done));
+                if (ret <= 0)
+                    return false;
+                done += static_cast<size_t> (ret);
+            }
+            return true;
+            #else
+            return posix_fallocate (fd, static_cast<off_t> (offset),
+                                            static_cast<off_t> (bytes)) == 0;
+            #endif
+        }
+        #endif
+
+        // nobody uses the region anymore: free the pages and the disk.
+        // the region is not reused, the file only grows.
+        void discard (Octet *ptr, const size_t bytes)
+        {
+            #ifdef RQ_SCRATCH_MMAP
+            #ifdef MADV_REMOVE
+            if (madvise (ptr, bytes, MADV_REMOVE) == 0)
+                return;
+            #endif
+            madvise (ptr, bytes, MADV_DONTNEED);
+            #else
+            RQ_UNUSED (ptr);
+            RQ_UNUSED (bytes);
+            #endif
+        }
+    };
+    std::shared_ptr<Chunk> last;
+
+    size_t round_up (const size_t bytes) const
+        { return ((bytes + page - 1) / page) * page; }
+};
+
+}   // namespace Impl
+}   // namespace RaptorQ__v1
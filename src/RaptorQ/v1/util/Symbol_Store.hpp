@@ -0,0 +1,217 @@
+/*
+ * Copyright (c) 2015-2018, Luca Fulchir<luca@fulchir.it>, All rights reserved.
+ *
+ * This file is part of "libRaptorQ".
+ *
+ * libRaptorQ is free software: you can redistribute it and/or modify
+ * it under the terms of the GNU Lesser General Public License as
+ * published by the Free Software Foundation, either version 3
+ * of the License, or (at your option) any later version.
+ *
+ * libRaptorQ is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ * GNU General Public License for more details.
+ *
+ * You should have received a copy of the GNU General Public License
+ * and a copy of the GNU Lesser General Public License
+ * along with libRaptorQ.  If not, see <http://www.gnu.org/licenses/>.
+ */
+
+
+#pragma once
+
+#include "RaptorQ/v1/common.hpp"
+#include "RaptorQ/v1/Octet.hpp"
+#include "RaptorQ/v1/util/Scratch_File.hpp"
+#include <Eigen/Core>
+#include <algorithm>
+#include <cassert>
+#include <cstdint>
+#include <memory>
+#include <utility>
+#include <vector>
+
+namespace RaptorQ__v1 {
+namespace Impl {
+
+// store for the received repair symbols.
+// Symbols are written in big, contiguous slabs instead of one allocation
+// per symbol. The (esi, slot) index only has the symbols we received:
+// symbols that arrive in order are appended to it, and after an
+// out-of-order arrival it is sorted again only when somebody reads it.
+// Slabs are never moved nor reused: a "Rows" snapshot keeps them alive,
+// so the solver can read the symbols in place without holding any lock,
+// even if more symbols arrive or the store is cleared in the meantime.
+// With a Scratch_File the slabs live on disk instead of in RAM.
+// Every slot starts on a "slot_align" boundary, so two producers never
+// write on the same cache line, and the rows are aligned for the solver.
+class RAPTORQ_LOCAL Symbol_Store
+{
+public:
+    using Entry = std::pair<uint32_t, uint32_t>;    // esi, slot
+    using Row = Eigen::Map<const Eigen::Matrix<Octet, 1, Eigen::Dynamic,
+                                                            Eigen::RowMajor>>;
+    using Slab = std::shared_ptr<Octet>;
+
+    // a fixed list of symbols, readable without locking the store.
+    class RAPTORQ_LOCAL Rows
+    {
+    public:
+        Rows() = default;
+        size_t size() const
+            { return _rows.size(); }
+        Row row (const size_t idx) const
+            { return Row (_rows[idx], _symbol_size); }
+    private:
+        friend class Symbol_Store;
+        std::vector<std::shared_ptr<const Octet>> _slabs;
+        std::vector<const Octet*> _rows;
+        int32_t _symbol_size = 0;
+    };
+
+    Symbol_Store (const size_t symbol_size)
+        : _symbol_size (static_cast<int32_t> (symbol_size)),
+          _stride (stride (symbol_size)),
+          _slab_rows (static_cast<uint32_t> (std::max<size_t> (16,
+                                                    slab_bytes / _stride))),
+          _used (0)
+    {}
+    Symbol_Store() = delete;
+    Symbol_Store (const Symbol_Store&) = delete;
+    Symbol_Store& operator= (const Symbol_Store&) = delete;
+    Symbol_Store (Symbol_Store&&) = default;
+    Symbol_Store& operator= (Symbol_Store&&) = default;
+    ~Symbol_Store() = default;
+
+    // reserve a slot for a new symbol. It is not part of the store until
+    // "commit" is called, so the (stable) slot memory can be written
+    // without holding any lock.
+    uint32_t reserve()
+    {
+        if (!_free.empty()) {
+            const uint32_t ret = _free.back();
+            _free.pop_back();
+            return ret;
+        }
+        if (_used == _slabs.size() * _slab_rows)
+            _slabs.emplace_back (new_slab());
+        return _used++;
+    }
+    // the symbol in the reserved slot could not be written: the next
+    // "reserve" gets the slot again. Never committed, so no snapshot has it.
+    void release (const uint32_t slot_idx)
+        { _free.push_back (slot_idx); }
+    Octet* slot (const uint32_t slot_idx)
+        { return slot_data (slot_idx); }
+    // the symbol in the reserved slot is complete, and has the given esi.
+    // each esi must be committed only once.
+    void commit (const uint32_t esi, const uint32_t slot_idx)
+    {
+        if (!_index.empty() && esi < _index.back().first)
+            _unordered = true;
+        _index.emplace_back (esi, slot_idx);
+    }
+
+    size_t size() const
+        { return _index.size(); }
+    // entries, ordered by esi
+    std::vector<Entry>::const_iterator begin()
+        { return ordered().begin(); }
+    std::vector<Entry>::const_iterator end()
+        { return ordered().end(); }
+    Row row (const Entry &entry) const
+        { return Row (slot_data (entry.second), _symbol_size); }
+
+    // snapshot of the first "count" symbols (by esi).
+    // there are only size() of them.
+    Rows rows (size_t count)
+    {
+        assert (count <= _index.size() && "Symbol_Store: too many rows");
+        count = std::min (count, _index.size());
+        ordered();
+        Rows ret;
+        ret._slabs.assign (_slabs.begin(), _slabs.end());
+        ret._symbol_size = _symbol_size;
+        ret._rows.reserve (count);
+        for (auto it = _index.begin(); it != _index.begin() + count; ++it)
+            ret._rows.push_back (slot_data (it->second));
+        return ret;
+    }
+
+    // the next slabs are taken from "file". call before "reserve"
+    void set_storage (const std::shared_ptr<Scratch_File> &file)
+        { _file = file; }
+
+    // free everything. eventual snapshots are still valid.
+    void clear()
+    {
+        _slabs = std::vector<Slab>();
+        _index = std::vector<Entry>();
+        _free = std::vector<uint32_t>();
+        _used = 0;
+        _unordered = false;
+    }
+
+    static constexpr size_t slot_align = 64;
+
+private:
+    static constexpr size_t slab_bytes = 64 * 1024;
+    const int32_t _symbol_size;
+    const size_t _stride;   // bytes between two slots
+    const uint32_t _slab_rows;
+    uint32_t _used;
+    bool _unordered = false;
+    std::vector<Slab> _slabs;
+    std::vector<Entry> _index;
+    std::vector<uint32_t> _free;    // reserved, but never committed
+    std::shared_ptr<Scratch_File> _file;
+
+    // symbols *should* arrive almost in order, so this is rarely needed.
+    const std::vector<Entry>& ordered()
+    {
+        if (_unordered) {
+            std::sort (_index.begin(), _index.end(),
+                                [] (const Entry &a, const Entry &b)
+                                                { return a.first < b.first; });
+            _unordered = false;
+        }
+        return _index;
+    }
+
+    static size_t stride (const size_t symbol_size)
+    {
+        const size_t size = std::max<size_t> (1, symbol_size);
+        return ((size + slot_align - 1) / slot_align) * slot_align;
+    }
+
+    Slab new_slab() const
+    {
+        const size_t bytes = static_cast<size_t> (_slab_rows) * _stride;
+        if (_file != nullptr) {
+            // file regions are page aligned
+            auto ret = _file->alloc (bytes);
+            if (ret != nullptr)
+                return ret;
+            // no space left for the file: keep going in RAM.
+        }
+        // no aligned new in C++11: allocate more, and share the ownership
+        // of the whole allocation with the aligned pointer.
+        const Slab raw (new Octet[bytes + slot_align - 1],
+                                            std::default_delete<Octet[]>());
+        const uintptr_t addr = reinterpret_cast<uintptr_t> (raw.get());
+        const size_t skip = (slot_align - addr % slot_align) % slot_align;
+        return Slab (raw, raw.get() + skip);
+    }
+
+    size_t slot_offset (const uint32_t slot) const
+        { return static_cast<size_t> (slot % _slab_rows) * _stride; }
+    // slots are only written before they are committed
+    Octet* slot_data (const uint32_t slot)
+        { return _slabs[slot / _slab_rows].get() + slot_offset (slot); }
+    const Octet* slot_data (const uint32_t slot) const
+        { return _slabs[slot / _slab_rows].get() + slot_offset (slot); }
+};
+
+}   // namespace Impl
+}   // namespace RaptorQ__v1
@@ -0,0 +1,75 @@
+/*
+ * Copyright (c) 2015-2018, Luca Fulchir<luca@fulchir.it>, All rights reserved.
+ *
+ * This file is part of "libRaptorQ".
+ *
+ * libRaptorQ is free software: you can redistribute it and/or modify
+ * it under the terms of the GNU Lesser General Public License as
+ * published by the Free Software Foundation, either version 3
+ * of the License, or (at your option) any later version.
+ *
+ * libRaptorQ is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ * GNU General Public License for more details.
+ *
+ * You should have received a copy of the GNU General Public License
+ * and a copy of the GNU Lesser General Public License
+ * along with libRaptorQ.  If not, see <http://www.gnu.org/licenses/>.
+ */
+
+#pragma once
+
+#include "RaptorQ/v1/common.hpp"
+#include "RaptorQ/v1/util/endianess.hpp"
+#include <iterator>
+#include <type_traits>
+#include <vector>
+
+// C++11 has no way to tell if an iterator points to contiguous memory.
+// We recognize the common ones: pointers and std::vector iterators.
+// For those, symbols can be copied with memcpy instead of one
+// element at a time.
+// Only for integer elements: their bytes are the data. Floating point
+// values are converted when assigned, so they are never memcpy'd.
+
+namespace RaptorQ__v1 {
+namespace Impl {
+
+template <typename It>
+class RAPTORQ_LOCAL is_contiguous
+{
+    using T = typename std::remove_cv<
+                        typename std::iterator_traits<It>::value_type>::type;
+public:
+    // std::vector<bool> is not contiguous.
+    static constexpr bool value = std::is_integral<T>::value &&
+                                    !std::is_same<T, bool>::value &&
+            (std::is_pointer<It>::value ||
+             std::is_same<It, typename std::vector<T>::iterator>::value ||
+             std::is_same<It, typename std::vector<T>::const_iterator>::value);
+};
+
+// contiguous, and an element built with shifts (little endian)
+// has the same bytes as a memcpy.
+template <typename It>
+class RAPTORQ_LOCAL is_contiguous_le
+{
+    using T = typename std::iterator_traits<It>::value_type;
+public:
+    static constexpr bool value = is_contiguous<It>::value &&
+                                (sizeof(T) == 1 || Endian::get_endianness() ==
+                                                Endian::Endianness::LITTLE);
+};
+
+// first byte pointed by a contiguous iterator.
+// "it" must be dereferenceable: never call this on an "end" iterator.
+template <typename It>
+inline RAPTORQ_LOCAL const uint8_t* in_bytes (const It it)
+    { return reinterpret_cast<const uint8_t*> (&*it); }
+template <typename It>
+inline RAPTORQ_LOCAL uint8_t* out_bytes (const It it)
+    { return reinterpret_cast<uint8_t*> (&*it); }
+
+}   // namespace Impl
+}   // namespace RaptorQ__v1
@@ -24,6 +24,7 @@
 #include "RaptorQ/v1/common.hpp"
 #include "RaptorQ/v1/wrapper/CPP_RAW_API_void.hpp"
 #include "RaptorQ/v1/RaptorQ_Iterators.hpp"
+#include <string>
 #include <vector>
 #if __cplusplus >= 201103L || _MSC_VER > 1900
     #include <future>
@@ -83,6 +84,19 @@ public:
     #endif
 
     size_t encode (Fwd_It &output, const Fwd_It end, const uint32_t id);
+    // same, on a plain buffer. returns the number of bytes written.
+    size_t encode (uint8_t *output, const size_t size, const uint32_t id);
+    // many symbols at once, one after the other in "output".
+    // return the number of symbols written: we stop at the first id
+    // after max_repair().
+    size_t encode_range (uint8_t *output, const size_t size,
+                                const uint32_t first, const uint32_t count);
+    size_t encode_list (uint8_t *output, const size_t size,
+                                const uint32_t *ids, const uint32_t count);
+    // called (and eventfd incremented) when the future of compute() or
+    // precompute() is ready. see RaptorQ__v1::Notify_Callback
+    void set_notify (const Notify_Callback &callback);
+    int notify_fd();
 
 private:
     Impl::Encoder_void _encoder;
@@ -97,6 +111,10 @@ public:
     ~Decoder();
     Decoder (const Block_Size symbols, const size_t symbol_size,
                                                             const Report type);
+    // decode in place, directly in "output".
+    // It must hold "symbols * symbol_size" bytes and outlive the decoder.
+    Decoder (const Block_Size symbols, const size_t symbol_size,
+                                        const Report type, uint8_t *output);
     Decoder (const Decoder&) = delete;
     Decoder& operator= (const Decoder&) = delete;
     Decoder (Decoder &&) = default;
@@ -111,6 +129,13 @@ public:
     RaptorQ__v1::It::Decoder::Symbol_Iterator<In_It, Fwd_It> end();
 
     Error add_symbol (In_It &from, const In_It to, const uint32_t esi);
+    // same, from a plain buffer of "size" bytes.
+    Error add_symbol (const uint8_t *data, const size_t size,
+                                                            const uint32_t esi);
+    // "count" symbols, one after the other in "data": symbol "idx" has
+    // id "esi[idx]". returns the number of symbols added.
+    size_t add_symbols (const uint8_t *data, const size_t size,
+                                const uint32_t *esi, const uint32_t count);
     std::vector<bool> end_of_input (const Fill_With_Zeros fill);
 
     bool can_decode() const;
@@ -120,6 +145,10 @@ public:
     uint16_t needed_symbols() const;
 
     void set_max_concurrency (const uint16_t max_threads);
+    void set_progressive (const bool enable);
+    void set_max_overhead (const uint16_t overhead);
+    void set_decode_policy (const Decode_Policy &policy);
+    bool set_storage (const std::string &directory);
     Decoder_Result decode_once();
 
     Decoder_wait_res poll();
@@ -127,11 +156,17 @@ public:
     #if __cplusplus >= 201103L || _MSC_VER > 1900
     std::future<Decoder_wait_res> wait();
     #endif
+    // called (and eventfd incremented) when the future of wait() is ready.
+    void set_notify (const Notify_Callback &callback);
+    int notify_fd();
 
     Error decode_symbol (Fwd_It &start, const Fwd_It end, const uint16_t esi);
     // returns numer of bytes written, offset of data in last iterator
     Decoder_written decode_bytes (Fwd_It &start, const Fwd_It end,
                                     const size_t from_byte, const size_t skip);
+    // same, on a plain buffer. returns the number of bytes written.
+    size_t decode_bytes (uint8_t *output, const size_t size,
+                                                    const size_t from_byte);
 private:
     Impl::Decoder_void _decoder;
 };
@@ -272,6 +307,31 @@ size_t Encoder<Rnd_It, Fwd_It>::encode (Fwd_It &output, const Fwd_It end,
     return ret;
 }
 
+template <typename Rnd_It, typename Fwd_It>
+size_t Encoder<Rnd_It, Fwd_It>::encode (uint8_t *output, const size_t size,
+                                                            const uint32_t id)
+    { return _encoder.encode (output, size, id); }
+
+template <typename Rnd_It, typename Fwd_It>
+size_t Encoder<Rnd_It, Fwd_It>::encode_range (uint8_t *output,
+                                const size_t size, const uint32_t first,
+                                                        const uint32_t count)
+    { return _encoder.encode_range (output, size, first, count); }
+
+template <typename Rnd_It, typename Fwd_It>
+size_t Encoder<Rnd_It, Fwd_It>::encode_list (uint8_t *output,
+                                const size_t size, const uint32_t *ids,
+                                                        const uint32_t count)
+    { return _encoder.encode_list (output, size, ids, count); }
+
+template <typename Rnd_It, typename Fwd_It>
+void Encoder<Rnd_It, Fwd_It>::set_notify (const Notify_Callback &callback)
+    { _encoder.set_notify (callback); }
+
+template <typename Rnd_It, typename Fwd_It>
+int Encoder<Rnd_It, Fwd_It>::notify_fd()
+    { return _encoder.notify_fd(); }
+
 ///////////////////
 //// Decoder
 ///////////////////
@@ -305,6 +365,38 @@ inline Decoder<uint64_t*, uint64_t*>::Decoder (const Block_Size symbols,
     :_decoder (RaptorQ_type::RQ_DEC_64, symbols, symbol_size, type)
     {}
 
+template <>
+inline Decoder<uint8_t*, uint8_t*>::Decoder (const Block_Size symbols,
+                                                    const size_t symbol_size,
+                                                    const Dec_Report type,
+                                                    uint8_t *output)
+    :_decoder (RaptorQ_type::RQ_DEC_8, symbols, symbol_size, type, output)
+    {}
+
+template <>
+inline Decoder<uint16_t*, uint16_t*>::Decoder (const Block_Size symbols,
+                                                    const size_t symbol_size,
+                                                    const Dec_Report type,
+                                                    uint8_t *output)
+    :_decoder (RaptorQ_type::RQ_DEC_16, symbols, symbol_size, type, output)
+    {}
+
+template <>
+inline Decoder<uint32_t*, uint32_t*>::Decoder (const Block_Size symbols,
+                                                    const size_t symbol_size,
+                                                    const Dec_Report type,
+                                                    uint8_t *output)
+    :_decoder (RaptorQ_type::RQ_DEC_32, symbols, symbol_size, type, output)
+    {}
+
+template <>
+inline Decoder<uint64_t*, uint64_t*>::Decoder (const Block_Size symbols,
+                                                    const size_t symbol_size,
+                                                    const Dec_Report type,
+                                                    uint8_t *output)
+    :_decoder (RaptorQ_type::RQ_DEC_64, symbols, symbol_size, type, output)
+    {}
+
 template <typename In_It, typename Fwd_It>
 Decoder<In_It, Fwd_It>::~Decoder()
     {}
@@ -354,6 +446,17 @@ Error Decoder<In_It, Fwd_It>::add_symbol (In_It &from, const In_It to,
     return ret;
 }
 
+template <typename In_It, typename Fwd_It>
+Error Decoder<In_It, Fwd_It>::add_symbol (const uint8_t *data,
+                                    const size_t size, const uint32_t esi)
+    { return _decoder.add_symbol (data, size, esi); }
+
+template <typename In_It, typename Fwd_It>
+size_t Decoder<In_It, Fwd_It>::add_symbols (const uint8_t *data,
+                                    const size_t size, const uint32_t *esi,
+                                                        const uint32_t count)
+    { return _decoder.add_symbols (data, size, esi, count); }
+
 template <typename In_It, typename Fwd_It>
 std::vector<bool> Decoder<In_It, Fwd_It>::end_of_input (
                                                     const Fill_With_Zeros fill)
@@ -363,6 +466,22 @@ template <typename In_It, typename Fwd_It>
 void Decoder<In_It, Fwd_It>::set_max_concurrency (const uint16_t max_threads)
     { return _decoder.set_max_concurrency (max_threads); }
 
+template <typename In_It, typename Fwd_It>
+void Decoder<In_It, Fwd_It>::set_progressive (const bool enable)
+    { return _decoder.set_progressive (enable); }
+
+template <typename In_It, typename Fwd_It>
+void Decoder<In_It, Fwd_It>::set_max_overhead (const uint16_t overhead)
+    { return _decoder.set_max_overhead (overhead); }
+
+template <typename In_It, typename Fwd_It>
+void Decoder<In_It, Fwd_It>::set_decode_policy (const Decode_Policy &policy)
+    { return _decoder.set_decode_policy (policy); }
+
+template <typename In_It, typename Fwd_It>
+bool Decoder<In_It, Fwd_It>::set_storage (const std::string &directory)
+    { return _decoder.set_storage (directory); }
+
 template <typename In_It, typename Fwd_It>
 Decoder_Result Decoder<In_It, Fwd_It>::decode_once()
     { return _decoder.decode_once(); }
@@ -381,6 +500,14 @@ std::future<struct Decoder_wait_res> Decoder<In_It, Fwd_It>::wait()
     { return _decoder.wait(); }
 #endif
 
+template <typename In_It, typename Fwd_It>
+void Decoder<In_It, Fwd_It>::set_notify (const Notify_Callback &callback)
+    { _decoder.set_notify (callback); }
+
+template <typename In_It, typename Fwd_It>
+int Decoder<In_It, Fwd_It>::notify_fd()
+    { return _decoder.notify_fd(); }
+
 template <typename In_It, typename Fwd_It>
 bool Decoder<In_It, Fwd_It>::can_decode() const
     { return _decoder.can_decode(); }
@@ -423,4 +550,9 @@ Decoder_written Decoder<In_It, Fwd_It>::decode_bytes (Fwd_It &start,
     return ret;
 }
 
+template <typename In_It, typename Fwd_It>
+size_t Decoder<In_It, Fwd_It>::decode_bytes (uint8_t *output,
+                                const size_t size, const size_t from_byte)
+    { return _decoder.decode_bytes (output, size, from_byte); }
+
 }   // namespace RaptorQ__v1
@@ -470,6 +470,122 @@ size_t Encoder_void::encode (void** output, const void* end, const uint32_t id)
     return ret;
 }
 
+size_t Encoder_void::encode (uint8_t *output, const size_t size,
+                                                            const uint32_t id)
+{
+    const cast_enc _enc (_encoder);
+    switch (_type) {
+    case RaptorQ_type::RQ_ENC_8:
+        return _enc._8->encode (output, size, id);
+    case RaptorQ_type::RQ_ENC_16:
+        return _enc._16->encode (output, size, id);
+    case RaptorQ_type::RQ_ENC_32:
+        return _enc._32->encode (output, size, id);
+    case RaptorQ_type::RQ_ENC_64:
+        return _enc._64->encode (output, size, id);
+    case RaptorQ_type::RQ_DEC_8:
+    case RaptorQ_type::RQ_DEC_16:
+    case RaptorQ_type::RQ_DEC_32:
+    case RaptorQ_type::RQ_DEC_64:
+    case RaptorQ_type::RQ_NONE:
+        break;
+    }
+    return 0;
+}
+
+size_t Encoder_void::encode_range (uint8_t *output, const size_t size,
+                                const uint32_t first, const uint32_t count)
+{
+    const cast_enc _enc (_encoder);
+    switch (_type) {
+    case RaptorQ_type::RQ_ENC_8:
+        return _enc._8->encode_range (output, size, first, count);
+    case RaptorQ_type::RQ_ENC_16:
+        return _enc._16->encode_range (output, size, first, count);
+    case RaptorQ_type::RQ_ENC_32:
+        return _enc._32->encode_range (output, size, first, count);
+    case RaptorQ_type::RQ_ENC_64:
+        return _enc._64->encode_range (output, size, first, count);
+    case RaptorQ_type::RQ_DEC_8:
+    case RaptorQ_type::RQ_DEC_16:
+    case RaptorQ_type::RQ_DEC_32:
+    case RaptorQ_type::RQ_DEC_64:
+    case RaptorQ_type::RQ_NONE:
+        break;
+    }
+    return 0;
+}
+
+size_t Encoder_void::encode_list (uint8_t *output, const size_t size,
+                                const uint32_t *ids, const uint32_t count)
+{
+    const cast_enc _enc (_encoder);
+    switch (_type) {
+    case RaptorQ_type::RQ_ENC_8:
+        return _enc._8->encode_list (output, size, ids, count);
+    case RaptorQ_type::RQ_ENC_16:
+        return _enc._16->encode_list (output, size, ids, count);
+    case RaptorQ_type::RQ_ENC_32:
+        return _enc._32->encode_list (output, size, ids, count);
+    case RaptorQ_type::RQ_ENC_64:
+        return _enc._64->encode_list (output, size, ids, count);
+    case RaptorQ_type::RQ_DEC_8:
+    case RaptorQ_type::RQ_DEC_16:
+    case RaptorQ_type::RQ_DEC_32:
+    case RaptorQ_type::RQ_DEC_64:
+    case RaptorQ_type::RQ_NONE:
+        break;
+    }
+    return 0;
+}
+
+void Encoder_void::set_notify (const Notify_Callback &callback)
+{
+    const cast_enc _enc (_encoder);
+    switch (_type) {
+    case RaptorQ_type::RQ_ENC_8:
+        _enc._8->set_notify (callback);
+        return;
+    case RaptorQ_type::RQ_ENC_16:
+        _enc._16->set_notify (callback);
+        return;
+    case RaptorQ_type::RQ_ENC_32:
+        _enc._32->set_notify (callback);
+        return;
+    case RaptorQ_type::RQ_ENC_64:
+        _enc._64->set_notify (callback);
+        return;
+    case RaptorQ_type::RQ_DEC_8:
+    case RaptorQ_type::RQ_DEC_16:
+    case RaptorQ_type::RQ_DEC_32:
+    case RaptorQ_type::RQ_DEC_64:
+    case RaptorQ_type::RQ_NONE:
+        break;
+    }
+}
+
+int Encoder_void::notify_fd()
+{
+    const cast_enc _enc (_encoder);
+    switch (_type) {
+    case RaptorQ_type::RQ_ENC_8:
+        return _enc._8->notify_fd();
+    case RaptorQ_type::RQ_ENC_16:
+        return _enc._16->notify_fd();
+    case RaptorQ_type::RQ_ENC_32:
+        return _enc._32->notify_fd();
+    case RaptorQ_type::RQ_ENC_64:
+        return _enc._64->notify_fd();
+    case RaptorQ_type::RQ_DEC_8:
+    case RaptorQ_type::RQ_DEC_16:
+    case RaptorQ_type::RQ_DEC_32:
+    case RaptorQ_type::RQ_DEC_64:
+    case RaptorQ_type::RQ_NONE:
+        break;
+    }
+    return -1;
+}
+
 
 ////////////////
 //// Decoder
@@ -479,6 +595,14 @@ Decoder_void::Decoder_void (const RaptorQ_type type,
                                                 const Block_Size symbols,
                                                 const size_t symbol_size,
                                                 const Dec_Report computation)
+    : Decoder_void (type, symbols, symbol_size, computation, nullptr)
+{}
+
+Decoder_void::Decoder_void (const RaptorQ_type type,
+                                                const Block_Size symbols,
+                                                const size_t symbol_size,
+                                                const Dec_Report computation,
+                                                uint8_t *output)
     : _type (init_t (type, false))
 {
     _decoder = nullptr;
@@ -486,19 +610,19 @@ Decoder_void::Decoder_void (const RaptorQ_type type,
     switch (_type) {
     case RaptorQ_type::RQ_DEC_8:
         _decoder = new Decoder<uint8_t*, uint8_t*> (symbols,
-                                                    symbol_size, computation);
+                                            symbol_size, computation, output);
         return;
     case RaptorQ_type::RQ_DEC_16:
         _decoder = new Decoder<uint16_t*, uint16_t*> (symbols,
-                                                    symbol_size, computation);
+                                            symbol_size, computation, output);
         return;
     case RaptorQ_type::RQ_DEC_32:
         _decoder = new Decoder<uint32_t*, uint32_t*> (symbols,
-                                                    symbol_size, computation);
+                                            symbol_size, computation, output);
         return;
     case RaptorQ_type::RQ_DEC_64:
         _decoder = new Decoder<uint64_t*, uint64_t*> (symbols,
-                                                    symbol_size, computation);
+                                            symbol_size, computation, output);
         return;
     case RaptorQ_type::RQ_ENC_8:
     case RaptorQ_type::RQ_ENC_16:
@@ -647,6 +771,52 @@ Error Decoder_void::add_symbol (void** from, const void* to, const uint32_t esi)
     return err;
 }
 
+Error Decoder_void::add_symbol (const uint8_t *data, const size_t size,
+                                                            const uint32_t esi)
+{
+    const cast_dec _dec (_decoder);
+    switch (_type) {
+    case RaptorQ_type::RQ_DEC_8:
+        return _dec._8->add_symbol (data, size, esi);
+    case RaptorQ_type::RQ_DEC_16:
+        return _dec._16->add_symbol (data, size, esi);
+    case RaptorQ_type::RQ_DEC_32:
+        return _dec._32->add_symbol (data, size, esi);
+    case RaptorQ_type::RQ_DEC_64:
+        return _dec._64->add_symbol (data, size, esi);
+    case RaptorQ_type::RQ_ENC_8:
+    case RaptorQ_type::RQ_ENC_16:
+    case RaptorQ_type::RQ_ENC_32:
+    case RaptorQ_type::RQ_ENC_64:
+    case RaptorQ_type::RQ_NONE:
+        break;
+    }
+    return Error::INITIALIZATION;
+}
+
+size_t Decoder_void::add_symbols (const uint8_t *data, const size_t size,
+                                const uint32_t *esi, const uint32_t count)
+{
+    const cast_dec _dec (_decoder);
+    switch (_type) {
+    case RaptorQ_type::RQ_DEC_8:
+        return _dec._8->add_symbols (data, size, esi, count);
+    case RaptorQ_type::RQ_DEC_16:
+        return _dec._16->add_symbols (data, size, esi, count);
+    case RaptorQ_type::RQ_DEC_32:
+        return _dec._32->add_symbols (data, size, esi, count);
+    case RaptorQ_type::RQ_DEC_64:
+        return _dec._64->add_symbols (data, size, esi, count);
+    case RaptorQ_type::RQ_ENC_8:
+    case RaptorQ_type::RQ_ENC_16:
+    case RaptorQ_type::RQ_ENC_32:
+    case RaptorQ_type::RQ_ENC_64:
+    case RaptorQ_type::RQ_NONE:
+        break;
+    }
+    return 0;
+}
+
 std::vector<bool> Decoder_void::end_of_input (const Fill_With_Zeros fill)
 {
     const cast_dec _dec (_decoder);
@@ -798,6 +968,91 @@ void Decoder_void::set_max_concurrency (const uint16_t max_threads)
     }
 }
 
+void Decoder_void::set_progressive (const bool enable)
+{
+    const cast_dec _dec (_decoder);
+    switch (_type) {
+    case RaptorQ_type::RQ_DEC_8:
+        return _dec._8->set_progressive (enable);
+    case RaptorQ_type::RQ_DEC_16:
+        return _dec._16->set_progressive (enable);
+    case RaptorQ_type::RQ_DEC_32:
+        return _dec._32->set_progressive (enable);
+    case RaptorQ_type::RQ_DEC_64:
+        return _dec._64->set_progressive (enable);
+    case RaptorQ_type::RQ_ENC_8:
+    case RaptorQ_type::RQ_ENC_16:
+    case RaptorQ_type::RQ_ENC_32:
+    case RaptorQ_type::RQ_ENC_64:
+    case RaptorQ_type::RQ_NONE:
+        break;
+    }
+}
+
+void Decoder_void::set_max_overhead (const uint16_t overhead)
+{
+    const cast_dec _dec (_decoder);
+    switch (_type) {
+    case RaptorQ_type::RQ_DEC_8:
+        return _dec._8->set_max_overhead (overhead);
+    case RaptorQ_type::RQ_DEC_16:
+        return _dec._16->set_max_overhead (overhead);
+    case RaptorQ_type::RQ_DEC_32:
+        return _dec._32->set_max_overhead (overhead);
+    case RaptorQ_type::RQ_DEC_64:
+        return _dec._64->set_max_overhead (overhead);
+    case RaptorQ_type::RQ_ENC_8:
+    case RaptorQ_type::RQ_ENC_16:
+    case RaptorQ_type::RQ_ENC_32:
+    case RaptorQ_type::RQ_ENC_64:
+    case RaptorQ_type::RQ_NONE:
+        break;
+    }
+}
+
+void Decoder_void::set_decode_policy (const Decode_Policy &policy)
+{
+    const cast_dec _dec (_decoder);
+    switch (_type) {
+    case RaptorQ_type::RQ_DEC_8:
+        return _dec._8->set_decode_policy (policy);
+    case RaptorQ_type::RQ_DEC_16:
+        return _dec._16->set_decode_policy (policy);
+    case RaptorQ_type::RQ_DEC_32:
+        return _dec._32->set_decode_policy (policy);
+    case RaptorQ_type::RQ_DEC_64:
+        return _dec._64->set_decode_policy (policy);
+    case RaptorQ_type::RQ_ENC_8:
+    case RaptorQ_type::RQ_ENC_16:
+    case RaptorQ_type::RQ_ENC_32:
+    case RaptorQ_type::RQ_ENC_64:
+    case RaptorQ_type::RQ_NONE:
+        break;
+    }
+}
+
+bool Decoder_void::set_storage (const std::string &directory)
+{
+    const cast_dec _dec (_decoder);
+    switch (_type) {
+    case RaptorQ_type::RQ_DEC_8:
+        return _dec._8->set_storage (directory);
+    case RaptorQ_type::RQ_DEC_16:
+        return _dec._16->set_storage (directory);
+    case RaptorQ_type::RQ_DEC_32:
+        return _dec._32->set_storage (directory);
+    case RaptorQ_type::RQ_DEC_64:
+        return _dec._64->set_storage (directory);
+    case RaptorQ_type::RQ_ENC_8:
+    case RaptorQ_type::RQ_ENC_16:
+    case RaptorQ_type::RQ_ENC_32:
+    case RaptorQ_type::RQ_ENC_64:
+    case RaptorQ_type::RQ_NONE:
+        break;
+    }
+    return false;
+}
+
 Decoder_Result Decoder_void::decode_once()
 {
     const cast_dec _dec (_decoder);
@@ -888,6 +1143,53 @@ std::future<struct Decoder_wait_res> Decoder_void::wait()
     return p.get_future();
 }
 
+void Decoder_void::set_notify (const Notify_Callback &callback)
+{
+    const cast_dec _dec (_decoder);
+    switch (_type) {
+    case RaptorQ_type::RQ_DEC_8:
+        _dec._8->set_notify (callback);
+        return;
+    case RaptorQ_type::RQ_DEC_16:
+        _dec._16->set_notify (callback);
+        return;
+    case RaptorQ_type::RQ_DEC_32:
+        _dec._32->set_notify (callback);
+        return;
+    case RaptorQ_type::RQ_DEC_64:
+        _dec._64->set_notify (callback);
+        return;
+    case RaptorQ_type::RQ_ENC_8:
+    case RaptorQ_type::RQ_ENC_16:
+    case RaptorQ_type::RQ_ENC_32:
+    case RaptorQ_type::RQ_ENC_64:
+    case RaptorQ_type::RQ_NONE:
+        break;
+    }
+}
+
+int Decoder_void::notify_fd()
+{
+    const cast_dec _dec (_decoder);
+    switch (_type) {
+    case RaptorQ_type::RQ_DEC_8:
+        return _dec._8->notify_fd();
+    case RaptorQ_type::RQ_DEC_16:
+        return _dec._16->notify_fd();
+    case RaptorQ_type::RQ_DEC_32:
+        return _dec._32->notify_fd();
+    case RaptorQ_type::RQ_DEC_64:
+        return _dec._64->notify_fd();
+    case RaptorQ_type::RQ_ENC_8:
+    case RaptorQ_type::RQ_ENC_16:
+    case RaptorQ_type::RQ_ENC_32:
+    case RaptorQ_type::RQ_ENC_64:
+    case RaptorQ_type::RQ_NONE:
+        break;
+    }
+    return -1;
+}
+
 Error Decoder_void::decode_symbol (void** start, const void* end,
                                                             const uint16_t esi)
 {
@@ -987,5 +1289,28 @@ struct Decoder_written Decoder_void::decode_bytes (void** start,
     return ret;
 }
 
+size_t Decoder_void::decode_bytes (uint8_t *output, const size_t size,
+                                                        const size_t from_byte)
+{
+    const cast_dec _dec (_decoder);
+    switch (_type) {
+    case RaptorQ_type::RQ_DEC_8:
+        return _dec._8->decode_bytes (output, size, from_byte);
+    case RaptorQ_type::RQ_DEC_16:
+        return _dec._16->decode_bytes (output, size, from_byte);
+    case RaptorQ_type::RQ_DEC_32:
+        return _dec._32->decode_bytes (output, size, from_byte);
+    case RaptorQ_type::RQ_DEC_64:
+        return _dec._64->decode_bytes (output, size, from_byte);
+    case RaptorQ_type::RQ_ENC_8:
+    case RaptorQ_type::RQ_ENC_16:
+    case RaptorQ_type::RQ_ENC_32:
+    case RaptorQ_type::RQ_ENC_64:
+    case RaptorQ_type::RQ_NONE:
+        break;
+    }
+    return 0;
+}
+
 } // namespace Impl
 } // namespace RaptorQ__v1
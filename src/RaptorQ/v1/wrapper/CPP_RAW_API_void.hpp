@@ -23,6 +23,7 @@
 #include "RaptorQ/v1/block_sizes.hpp"
 #include "RaptorQ/v1/common.hpp"
 #include "RaptorQ/v1/wrapper/C_common.h"
+#include <string>
 #include <vector>
 #if __cplusplus >= 201103L || _MSC_VER > 1900
 #include <future>
@@ -79,6 +80,13 @@ public:
 
     // void* will be casted to the right type depending on RaptorQ_type
     size_t encode (void** output, const void* end, const uint32_t id);
+    size_t encode (uint8_t *output, const size_t size, const uint32_t id);
+    size_t encode_range (uint8_t *output, const size_t size,
+                                const uint32_t first, const uint32_t count);
+    size_t encode_list (uint8_t *output, const size_t size,
+                                const uint32_t *ids, const uint32_t count);
+    void set_notify (const Notify_Callback &callback);
+    int notify_fd();
 
 private:
     RaptorQ_type _type;
@@ -91,6 +99,9 @@ public:
     using Report = Dec_Report;
     Decoder_void (const RaptorQ_type type, const Block_Size symbols,
                             const size_t symbol_size, const Report computation);
+    Decoder_void (const RaptorQ_type type, const Block_Size symbols,
+                            const size_t symbol_size, const Report computation,
+                                                            uint8_t *output);
     ~Decoder_void();
     Decoder_void() = delete;
     Decoder_void (const Decoder_void&) = delete;
@@ -103,6 +114,10 @@ public:
     size_t symbol_size() const;
 
     Error add_symbol (void** from, const void* to, const uint32_t esi);
+    Error add_symbol (const uint8_t *data, const size_t size,
+                                                            const uint32_t esi);
+    size_t add_symbols (const uint8_t *data, const size_t size,
+                                const uint32_t *esi, const uint32_t count);
     std::vector<bool> end_of_input (const Fill_With_Zeros fill);
 
     bool can_decode() const;
@@ -112,6 +127,10 @@ public:
     uint16_t needed_symbols() const;
 
     void set_max_concurrency (const uint16_t max_threads);
+    void set_progressive (const bool enable);
+    void set_max_overhead (const uint16_t overhead);
+    void set_decode_policy (const Decode_Policy &policy);
+    bool set_storage (const std::string &directory);
     Decoder_Result decode_once();
 
     struct Decoder_wait_res poll();
@@ -120,11 +139,15 @@ public:
     // not even going to try and make this C++98
     std::future<Decoder_wait_res> wait();
     #endif
+    void set_notify (const Notify_Callback &callback);
+    int notify_fd();
 
     Error decode_symbol (void** start, const void* end, const uint16_t esi);
     // returns number of bytes written, offset of data in last iterator
     Decoder_written decode_bytes (void** start, const void* end,
                                     const size_t from_byte, const size_t skip);
+    size_t decode_bytes (uint8_t *output, const size_t size,
+                                                    const size_t from_byte);
 private:
     RaptorQ_type _type;
     void *_decoder;
@@ -23,6 +23,7 @@
 #include "RaptorQ/v1/common.hpp"
 #include "RaptorQ/v1/wrapper/CPP_RFC_API_void.hpp"
 #include "RaptorQ/v1/RFC_Iterators.hpp"
+#include <string>
 #include <vector>
 #include <cmath>
 #if __cplusplus >= 201103L || _MSC_VER > 1900
@@ -73,7 +74,23 @@ public:
     size_t precompute_max_memory ();
     size_t encode (Fwd_It &output, const Fwd_It end, const uint32_t esi,
                                                             const uint8_t sbn);
+    // same, on a plain buffer. returns the number of bytes written.
+    size_t encode (uint8_t *output, const size_t size, const uint32_t esi,
+                                                            const uint8_t sbn);
     size_t encode (Fwd_It &output, const Fwd_It end, const uint32_t id);
+    // "count" packets for scatter/gather I/O. see RFC6330__v1::Impl::Encoder
+    size_t encode_packets (Packet_Desc *packets, const size_t count,
+                                    const uint32_t esi, const uint8_t sbn,
+                                    uint8_t *buffer, const size_t size);
+    // "count" symbols of block "sbn" from "esi" on, one after the other.
+    // returns the symbols written.
+    size_t encode_range (uint8_t *output, const size_t size,
+                                    const uint32_t esi, const uint32_t count,
+                                                            const uint8_t sbn);
+    // called (and eventfd incremented) when a block is ready and when the
+    // future of compute() is. see RFC6330__v1::Impl::Encoder
+    void set_notify (const Notify_Callback &callback);
+    int notify_fd();
     void free (const uint8_t sbn);
     uint8_t blocks() const;
     uint32_t block_size (const uint8_t sbn) const;
@@ -126,6 +143,10 @@ public:
     size_t decode_block_bytes (Fwd_It &start, const Fwd_It end,
                                                             const uint8_t skip,
                                                             const uint8_t sbn);
+    // the blocks "sbns", one after the other, up to the first one that is
+    // not decoded. result in BYTES.
+    uint64_t decode_blocks (Fwd_It &start, const Fwd_It end,
+                                const uint8_t *sbns, const uint16_t count);
     struct aligned_res
     {
         uint64_t written;
@@ -139,6 +160,30 @@ public:
     Error add_symbol (In_It &start, const In_It end, const uint32_t id);
     Error add_symbol (In_It &start, const In_It end, const uint32_t esi,
                                                             const uint8_t sbn);
+    // same, from a plain buffer of "size" bytes.
+    Error add_symbol (const uint8_t *data, const size_t size,
+                                    const uint32_t esi, const uint8_t sbn);
+    // received packets. returns the packets used: the ones from there on
+    // were refused with "err", and can be given again later.
+    size_t add_packets (const Packet_Desc *packets, const size_t count,
+                                                                Error &err);
+    // "count" symbols, one after the other in "data": symbol "idx" has
+    // id "ids[idx]", as for add_symbol. returns the symbols added.
+    size_t add_symbols (const uint8_t *data, const size_t size,
+                                const uint32_t *ids, const uint32_t count);
+    // give each block to "new_sink" as soon as it and the previous ones
+    // are decoded, then free it. see RFC6330__v1::Impl::Decoder
+    bool set_sink (const Decoder_Sink &new_sink, const size_t max_memory);
+    // keep the symbols in a scratch file in "directory", not in RAM.
+    bool set_storage (const std::string &directory);
+    // when to attempt decoding a block, for all blocks.
+    // see RaptorQ__v1::Decode_Policy
+    void set_decode_policy (const Decode_Policy &policy);
+    uint8_t blocks_delivered();
+    // called (and eventfd incremented) when a block is decoded and when the
+    // future of compute() is ready. see RFC6330__v1::Impl::Decoder
+    void set_notify (const Notify_Callback &callback);
+    int notify_fd();
     uint8_t blocks_ready();
     bool is_ready();
     bool is_block_ready (const uint8_t block);
@@ -250,6 +295,39 @@ inline size_t Encoder<Rnd_It, Fwd_It>::encode (Fwd_It &output, const Fwd_It end,
     return ret;
 }
 
+template <typename Rnd_It, typename Fwd_It>
+inline size_t Encoder<Rnd_It, Fwd_It>::encode (uint8_t *output,
+                                            const size_t size,
+                                            const uint32_t esi,
+                                            const uint8_t sbn)
+    { return _encoder.encode (output, size, esi, sbn); }
+
+template <typename Rnd_It, typename Fwd_It>
+inline size_t Encoder<Rnd_It, Fwd_It>::encode_packets (Packet_Desc *packets,
+                                            const size_t count,
+                                            const uint32_t esi,
+                                            const uint8_t sbn,
+                                            uint8_t *buffer,
+                                            const size_t size)
+    { return _encoder.encode_packets (packets, count, esi, sbn, buffer, size); }
+
+template <typename Rnd_It, typename Fwd_It>
+inline size_t Encoder<Rnd_It, Fwd_It>::encode_range (uint8_t *output,
+                                            const size_t size,
+                                            const uint32_t esi,
+                                            const uint32_t count,
+                                            const uint8_t sbn)
+    { return _encoder.encode_range (output, size, esi, count, sbn); }
+
+template <typename Rnd_It, typename Fwd_It>
+inline void Encoder<Rnd_It, Fwd_It>::set_notify (
+                                            const Notify_Callback &callback)
+    { _encoder.set_notify (callback); }
+
+template <typename Rnd_It, typename Fwd_It>
+inline int Encoder<Rnd_It, Fwd_It>::notify_fd()
+    { return _encoder.notify_fd(); }
+
 template <typename Rnd_It, typename Fwd_It>
 inline size_t Encoder<Rnd_It, Fwd_It>::encode (Fwd_It &output, const Fwd_It end,
                                                             const uint32_t id)
@@ -444,6 +522,20 @@ inline size_t Decoder<In_It, Fwd_It>::decode_block_bytes (Fwd_It &start,
     return ret;
 }
 
+template <typename In_It, typename Fwd_It>
+inline uint64_t Decoder<In_It, Fwd_It>::decode_blocks (Fwd_It &start,
+                                                        const Fwd_It end,
+                                                        const uint8_t *sbns,
+                                                        const uint16_t count)
+{
+    void **_from = reinterpret_cast<void**> (&start);
+    void *_to = reinterpret_cast<void*> (end);
+    auto ret = _decoder.decode_blocks (_from, _to, sbns, count);
+    Fwd_It *tmp = reinterpret_cast<Fwd_It*> (_from);
+    start = *tmp;
+    return ret;
+}
+
 template <typename In_It, typename Fwd_It>
 inline typename Decoder<In_It, Fwd_It>::aligned_res
                                         Decoder<In_It, Fwd_It>::decode_aligned (
@@ -500,6 +592,53 @@ inline Error Decoder<In_It, Fwd_It>::add_symbol (In_It &start, const In_It end,
     return ret;
 }
 
+template <typename In_It, typename Fwd_It>
+inline Error Decoder<In_It, Fwd_It>::add_symbol (const uint8_t *data,
+                                            const size_t size,
+                                            const uint32_t esi,
+                                            const uint8_t sbn)
+    { return _decoder.add_symbol (data, size, esi, sbn); }
+
+template <typename In_It, typename Fwd_It>
+inline size_t Decoder<In_It, Fwd_It>::add_packets (const Packet_Desc *packets,
+                                                            const size_t count,
+                                                            Error &err)
+    { return _decoder.add_packets (packets, count, err); }
+
+template <typename In_It, typename Fwd_It>
+inline size_t Decoder<In_It, Fwd_It>::add_symbols (const uint8_t *data,
+                                                        const size_t size,
+                                                        const uint32_t *ids,
+                                                        const uint32_t count)
+    { return _decoder.add_symbols (data, size, ids, count); }
+
+template <typename In_It, typename Fwd_It>
+inline bool Decoder<In_It, Fwd_It>::set_sink (const Decoder_Sink &new_sink,
+                                                    const size_t max_memory)
+    { return _decoder.set_sink (new_sink, max_memory); }
+
+template <typename In_It, typename Fwd_It>
+inline bool Decoder<In_It, Fwd_It>::set_storage (const std::string &directory)
+    { return _decoder.set_storage (directory); }
+
+template <typename In_It, typename Fwd_It>
+inline void Decoder<In_It, Fwd_It>::set_decode_policy (
+                                                const Decode_Policy &policy)
+    { _decoder.set_decode_policy (policy); }
+
+template <typename In_It, typename Fwd_It>
+inline uint8_t Decoder<In_It, Fwd_It>::blocks_delivered()
+    { return _decoder.blocks_delivered(); }
+
+template <typename In_It, typename Fwd_It>
+inline void Decoder<In_It, Fwd_It>::set_notify (
+                                            const Notify_Callback &callback)
+    { _decoder.set_notify (callback); }
+
+template <typename In_It, typename Fwd_It>
+inline int Decoder<In_It, Fwd_It>::notify_fd()
+    { return _decoder.notify_fd(); }
+
 template <typename In_It, typename Fwd_It>
 inline uint8_t Decoder<In_It, Fwd_It>::blocks_ready()
     { return _decoder.blocks_ready(); }
@@ -354,6 +354,128 @@ size_t Encoder_void::encode (void** output, const void* end, const uint32_t esi,
     return ret;
 }
 
+size_t Encoder_void::encode (uint8_t *output, const size_t size,
+                                    const uint32_t esi, const uint8_t sbn)
+{
+    const cast_enc _enc (_encoder);
+    switch (_type) {
+    case RaptorQ_type::RQ_ENC_8:
+        return _enc._8->encode (output, size, esi, sbn);
+    case RaptorQ_type::RQ_ENC_16:
+        return _enc._16->encode (output, size, esi, sbn);
+    case RaptorQ_type::RQ_ENC_32:
+        return _enc._32->encode (output, size, esi, sbn);
+    case RaptorQ_type::RQ_ENC_64:
+        return _enc._64->encode (output, size, esi, sbn);
+    case RaptorQ_type::RQ_DEC_8:
+    case RaptorQ_type::RQ_DEC_16:
+    case RaptorQ_type::RQ_DEC_32:
+    case RaptorQ_type::RQ_DEC_64:
+    case RaptorQ_type::RQ_NONE:
+        break;
+    }
+    return 0;
+}
+
+size_t Encoder_void::encode_packets (Packet_Desc *packets, const size_t count,
+                                    const uint32_t esi, const uint8_t sbn,
+                                    uint8_t *buffer, const size_t size)
+{
+    const cast_enc _enc (_encoder);
+    switch (_type) {
+    case RaptorQ_type::RQ_ENC_8:
+        return _enc._8->encode_packets (packets, count, esi, sbn,
+                                                                buffer, size);
+    case RaptorQ_type::RQ_ENC_16:
+        return _enc._16->encode_packets (packets, count, esi, sbn,
+                                                                buffer, size);
+    case RaptorQ_type::RQ_ENC_32:
+        return _enc._32->encode_packets (packets, count, esi, sbn,
+                                                                buffer, size);
+    case RaptorQ_type::RQ_ENC_64:
+        return _enc._64->encode_packets (packets, count, esi, sbn,
+                                                                buffer, size);
+    case RaptorQ_type::RQ_DEC_8:
+    case RaptorQ_type::RQ_DEC_16:
+    case RaptorQ_type::RQ_DEC_32:
+    case RaptorQ_type::RQ_DEC_64:
+    case RaptorQ_type::RQ_NONE:
+        break;
+    }
+    return 0;
+}
+
+size_t Encoder_void::encode_range (uint8_t *output, const size_t size,
+                                    const uint32_t esi, const uint32_t count,
+                                                            const uint8_t sbn)
+{
+    const cast_enc _enc (_encoder);
+    switch (_type) {
+    case RaptorQ_type::RQ_ENC_8:
+        return _enc._8->encode_range (output, size, esi, count, sbn);
+    case RaptorQ_type::RQ_ENC_16:
+        return _enc._16->encode_range (output, size, esi, count, sbn);
+    case RaptorQ_type::RQ_ENC_32:
+        return _enc._32->encode_range (output, size, esi, count, sbn);
+    case RaptorQ_type::RQ_ENC_64:
+        return _enc._64->encode_range (output, size, esi, count, sbn);
+    case RaptorQ_type::RQ_DEC_8:
+    case RaptorQ_type::RQ_DEC_16:
+    case RaptorQ_type::RQ_DEC_32:
+    case RaptorQ_type::RQ_DEC_64:
+    case RaptorQ_type::RQ_NONE:
+        break;
+    }
+    return 0;
+}
+
+void Encoder_void::set_notify (const Notify_Callback &callback)
+{
+    const cast_enc _enc (_encoder);
+    switch (_type) {
+    case RaptorQ_type::RQ_ENC_8:
+        _enc._8->set_notify (callback);
+        return;
+    case RaptorQ_type::RQ_ENC_16:
+        _enc._16->set_notify (callback);
+        return;
+    case RaptorQ_type::RQ_ENC_32:
+        _enc._32->set_notify (callback);
+        return;
+    case RaptorQ_type::RQ_ENC_64:
+        _enc._64->set_notify (callback);
+        return;
+    case RaptorQ_type::RQ_DEC_8:
+    case RaptorQ_type::RQ_DEC_16:
+    case RaptorQ_type::RQ_DEC_32:
+    case RaptorQ_type::RQ_DEC_64:
+    case RaptorQ_type::RQ_NONE:
+        break;
+    }
+}
+
+int Encoder_void::notify_fd()
+{
+    const cast_enc _enc (_encoder);
+    switch (_type) {
+    case RaptorQ_type::RQ_ENC_8:
+        return _enc._8->notify_fd();
+    case RaptorQ_type::RQ_ENC_16:
+        return _enc._16->notify_fd();
+    case RaptorQ_type::RQ_ENC_32:
+        return _enc._32->notify_fd();
+    case RaptorQ_type::RQ_ENC_64:
+        return _enc._64->notify_fd();
+    case RaptorQ_type::RQ_DEC_8:
+    case RaptorQ_type::RQ_DEC_16:
+    case RaptorQ_type::RQ_DEC_32:
+    case RaptorQ_type::RQ_DEC_64:
+    case RaptorQ_type::RQ_NONE:
+        break;
+    }
+    return -1;
+}
+
 size_t Encoder_void::encode (void** output, const void* end, const uint32_t id)
 {
     const cast_enc _enc (_encoder);
@@ -888,6 +1010,56 @@ size_t Decoder_void::decode_block_bytes (void** start, const void* end,
     return ret;
 }
 
+uint64_t Decoder_void::decode_blocks (void** start, const void* end,
+                                    const uint8_t *sbns, const uint16_t count)
+{
+    const cast_dec _dec (_decoder);
+    uint8_t *p_8;
+    uint16_t *p_16;
+    uint32_t *p_32;
+    uint64_t *p_64;
+    uint64_t ret = 0;
+    if (start == nullptr || *start == nullptr || end == nullptr)
+        return ret;
+    switch (_type) {
+    case RaptorQ_type::RQ_DEC_8:
+        p_8 = reinterpret_cast<uint8_t*> (*start);
+        ret = _dec._8->decode_blocks (p_8,
+                        reinterpret_cast<uint8_t*> (const_cast<void*> (end)),
+                                                                sbns, count);
+        *start = p_8;
+        break;
+    case RaptorQ_type::RQ_DEC_16:
+        p_16 = reinterpret_cast<uint16_t*> (*start);
+        ret = _dec._16->decode_blocks (p_16,
+                        reinterpret_cast<uint16_t*> (const_cast<void*>(end)),
+                                                                sbns, count);
+        *start = p_16;
+        break;
+    case RaptorQ_type::RQ_DEC_32:
+        p_32 = reinterpret_cast<uint32_t*> (*start);
+        ret = _dec._32->decode_blocks (p_32,
+                        reinterpret_cast<uint32_t*> (const_cast<void*>(end)),
+                                                                sbns, count);
+        *start = p_32;
+        break;
+    case RaptorQ_type::RQ_DEC_64:
+        p_64 = reinterpret_cast<uint64_t*> (*start);
+        ret = _dec._64->decode_blocks (p_64,
+                        reinterpret_cast<uint64_t*> (const_cast<void*>(end)),
+                                                                sbns, count);
+        *start = p_64;
+        break;
+    case RaptorQ_type::RQ_ENC_8:
+    case RaptorQ_type::RQ_ENC_16:
+    case RaptorQ_type::RQ_ENC_32:
+    case RaptorQ_type::RQ_ENC_64:
+    case RaptorQ_type::RQ_NONE:
+        break;
+    }
+    return ret;
+}
+
 Decoder_written Decoder_void::decode_aligned (void** start,
                                                             const void* end,
                                                             const uint8_t skip)
@@ -1087,6 +1259,215 @@ Error Decoder_void::add_symbol (void** start, const void* end,
     return err;
 }
 
+Error Decoder_void::add_symbol (const uint8_t *data, const size_t size,
+                                    const uint32_t esi, const uint8_t sbn)
+{
+    const cast_dec _dec (_decoder);
+    switch (_type) {
+    case RaptorQ_type::RQ_DEC_8:
+        return _dec._8->add_symbol (data, size, esi, sbn);
+    case RaptorQ_type::RQ_DEC_16:
+        return _dec._16->add_symbol (data, size, esi, sbn);
+    case RaptorQ_type::RQ_DEC_32:
+        return _dec._32->add_symbol (data, size, esi, sbn);
+    case RaptorQ_type::RQ_DEC_64:
+        return _dec._64->add_symbol (data, size, esi, sbn);
+    case RaptorQ_type::RQ_ENC_8:
+    case RaptorQ_type::RQ_ENC_16:
+    case RaptorQ_type::RQ_ENC_32:
+    case RaptorQ_type::RQ_ENC_64:
+    case RaptorQ_type::RQ_NONE:
+        break;
+    }
+    return Error::INITIALIZATION;
+}
+
+size_t Decoder_void::add_packets (const Packet_Desc *packets,
+                                            const size_t count, Error &err)
+{
+    const cast_dec _dec (_decoder);
+    switch (_type) {
+    case RaptorQ_type::RQ_DEC_8:
+        return _dec._8->add_packets (packets, count, err);
+    case RaptorQ_type::RQ_DEC_16:
+        return _dec._16->add_packets (packets, count, err);
+    case RaptorQ_type::RQ_DEC_32:
+        return _dec._32->add_packets (packets, count, err);
+    case RaptorQ_type::RQ_DEC_64:
+        return _dec._64->add_packets (packets, count, err);
+    case RaptorQ_type::RQ_ENC_8:
+    case RaptorQ_type::RQ_ENC_16:
+    case RaptorQ_type::RQ_ENC_32:
+    case RaptorQ_type::RQ_ENC_64:
+    case RaptorQ_type::RQ_NONE:
+        break;
+    }
+    err = Error::INITIALIZATION;
+    return 0;
+}
+
+size_t Decoder_void::add_symbols (const uint8_t *data, const size_t size,
+                                const uint32_t *ids, const uint32_t count)
+{
+    const cast_dec _dec (_decoder);
+    switch (_type) {
+    case RaptorQ_type::RQ_DEC_8:
+        return _dec._8->add_symbols (data, size, ids, count);
+    case RaptorQ_type::RQ_DEC_16:
+        return _dec._16->add_symbols (data, size, ids, count);
+    case RaptorQ_type::RQ_DEC_32:
+        return _dec._32->add_symbols (data, size, ids, count);
+    case RaptorQ_type::RQ_DEC_64:
+        return _dec._64->add_symbols (data, size, ids, count);
+    case RaptorQ_type::RQ_ENC_8:
+    case RaptorQ_type::RQ_ENC_16:
+    case RaptorQ_type::RQ_ENC_32:
+    case RaptorQ_type::RQ_ENC_64:
+    case RaptorQ_type::RQ_NONE:
+        break;
+    }
+    return 0;
+}
+
+bool Decoder_void::set_sink (const Decoder_Sink &new_sink,
+                                                    const size_t max_memory)
+{
+    const cast_dec _dec (_decoder);
+    switch (_type) {
+    case RaptorQ_type::RQ_DEC_8:
+        return _dec._8->set_sink (new_sink, max_memory);
+    case RaptorQ_type::RQ_DEC_16:
+        return _dec._16->set_sink (new_sink, max_memory);
+    case RaptorQ_type::RQ_DEC_32:
+        return _dec._32->set_sink (new_sink, max_memory);
+    case RaptorQ_type::RQ_DEC_64:
+        return _dec._64->set_sink (new_sink, max_memory);
+    case RaptorQ_type::RQ_ENC_8:
+    case RaptorQ_type::RQ_ENC_16:
+    case RaptorQ_type::RQ_ENC_32:
+    case RaptorQ_type::RQ_ENC_64:
+    case RaptorQ_type::RQ_NONE:
+        break;
+    }
+    return false;
+}
+
+bool Decoder_void::set_storage (const std::string &directory)
+{
+    const cast_dec _dec (_decoder);
+    switch (_type) {
+    case RaptorQ_type::RQ_DEC_8:
+        return _dec._8->set_storage (directory);
+    case RaptorQ_type::RQ_DEC_16:
+        return _dec._16->set_storage (directory);
+    case RaptorQ_type::RQ_DEC_32:
+        return _dec._32->set_storage (directory);
+    case RaptorQ_type::RQ_DEC_64:
+        return _dec._64->set_storage (directory);
+    case RaptorQ_type::RQ_ENC_8:
+    case RaptorQ_type::RQ_ENC_16:
+    case RaptorQ_type::RQ_ENC_32:
+    case RaptorQ_type::RQ_ENC_64:
+    case RaptorQ_type::RQ_NONE:
+        break;
+    }
+    return false;
+}
+
+void Decoder_void::set_decode_policy (const Decode_Policy &policy)
+{
+    const cast_dec _dec (_decoder);
+    switch (_type) {
+    case RaptorQ_type::RQ_DEC_8:
+        _dec._8->set_decode_policy (policy);
+        return;
+    case RaptorQ_type::RQ_DEC_16:
+        _dec._16->set_decode_policy (policy);
+        return;
+    case RaptorQ_type::RQ_DEC_32:
+        _dec._32->set_decode_policy (policy);
+        return;
+    case RaptorQ_type::RQ_DEC_64:
+        _dec._64->set_decode_policy (policy);
+        return;
+    case RaptorQ_type::RQ_ENC_8:
+    case RaptorQ_type::RQ_ENC_16:
+    case RaptorQ_type::RQ_ENC_32:
+    case RaptorQ_type::RQ_ENC_64:
+    case RaptorQ_type::RQ_NONE:
+        break;
+    }
+}
+
+uint8_t Decoder_void::blocks_delivered ()
+{
+    const cast_dec _dec (_decoder);
+    switch (_type) {
+    case RaptorQ_type::RQ_DEC_8:
+        return _dec._8->blocks_delivered();
+    case RaptorQ_type::RQ_DEC_16:
+        return _dec._16->blocks_delivered();
+    case RaptorQ_type::RQ_DEC_32:
+        return _dec._32->blocks_delivered();
+    case RaptorQ_type::RQ_DEC_64:
+        return _dec._64->blocks_delivered();
+    case RaptorQ_type::RQ_ENC_8:
+    case RaptorQ_type::RQ_ENC_16:
+    case RaptorQ_type::RQ_ENC_32:
+    case RaptorQ_type::RQ_ENC_64:
+    case RaptorQ_type::RQ_NONE:
+        break;
+    }
+    return 0;
+}
+
+void Decoder_void::set_notify (const Notify_Callback &callback)
+{
+    const cast_dec _dec (_decoder);
+    switch (_type) {
+    case RaptorQ_type::RQ_DEC_8:
+        _dec._8->set_notify (callback);
+        return;
+    case RaptorQ_type::RQ_DEC_16:
+        _dec._16->set_notify (callback);
+        return;
+    case RaptorQ_type::RQ_DEC_32:
+        _dec._32->set_notify (callback);
+        return;
+    case RaptorQ_type::RQ_DEC_64:
+        _dec._64->set_notify (callback);
+        return;
+    case RaptorQ_type::RQ_ENC_8:
+    case RaptorQ_type::RQ_ENC_16:
+    case RaptorQ_type::RQ_ENC_32:
+    case RaptorQ_type::RQ_ENC_64:
+    case RaptorQ_type::RQ_NONE:
+        break;
+    }
+}
+
+int Decoder_void::notify_fd()
+{
+    const cast_dec _dec (_decoder);
+    switch (_type) {
+    case RaptorQ_type::RQ_DEC_8:
+        return _dec._8->notify_fd();
+    case RaptorQ_type::RQ_DEC_16:
+        return _dec._16->notify_fd();
+    case RaptorQ_type::RQ_DEC_32:
+        return _dec._32->notify_fd();
+    case RaptorQ_type::RQ_DEC_64:
+        return _dec._64->notify_fd();
+    case RaptorQ_type::RQ_ENC_8:
+    case RaptorQ_type::RQ_ENC_16:
+    case RaptorQ_type::RQ_ENC_32:
+    case RaptorQ_type::RQ_ENC_64:
+    case RaptorQ_type::RQ_NONE:
+        break;
+    }
+    return -1;
+}
+
 uint8_t Decoder_void::blocks_ready ()
 {
     const cast_dec _dec (_decoder);
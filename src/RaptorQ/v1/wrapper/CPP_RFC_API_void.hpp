@@ -23,6 +23,7 @@
 #include "RaptorQ/v1/common.hpp"
 #include "RaptorQ/v1/wrapper/C_common.h"
 #include "RaptorQ/v1/block_sizes.hpp"
+#include <string>
 #include <vector>
 #if __cplusplus >= 201103L || _MSC_VER > 1900
 #include <future>
@@ -79,7 +80,17 @@ public:
     size_t precompute_max_memory ();
     size_t encode (void** output, const void* end, const uint32_t esi,
                                                             const uint8_t sbn);
+    size_t encode (uint8_t *output, const size_t size, const uint32_t esi,
+                                                            const uint8_t sbn);
     size_t encode (void** output, const void* end, const uint32_t id);
+    size_t encode_packets (Packet_Desc *packets, const size_t count,
+                                    const uint32_t esi, const uint8_t sbn,
+                                    uint8_t *buffer, const size_t size);
+    size_t encode_range (uint8_t *output, const size_t size,
+                                    const uint32_t esi, const uint32_t count,
+                                                            const uint8_t sbn);
+    void set_notify (const Notify_Callback &callback);
+    int notify_fd();
     void free (const uint8_t sbn);
     uint8_t blocks() const;
     uint32_t block_size (const uint8_t sbn) const;
@@ -130,6 +141,8 @@ public:
     size_t decode_block_bytes (void** start, const void* end,
                                                             const uint8_t skip,
                                                             const uint8_t sbn);
+    uint64_t decode_blocks (void** start, const void* end,
+                                const uint8_t *sbns, const uint16_t count);
     Decoder_written decode_aligned (void** start, const void* end,
                                                             const uint8_t skip);
     Decoder_written decode_block_aligned (void** start, const void* end,
@@ -138,6 +151,18 @@ public:
     Error add_symbol (void** start, const void* end, const uint32_t id);
     Error add_symbol (void** start, const void* end, const uint32_t esi,
                                                             const uint8_t sbn);
+    Error add_symbol (const uint8_t *data, const size_t size,
+                                    const uint32_t esi, const uint8_t sbn);
+    size_t add_packets (const Packet_Desc *packets, const size_t count,
+                                                                Error &err);
+    size_t add_symbols (const uint8_t *data, const size_t size,
+                                const uint32_t *ids, const uint32_t count);
+    bool set_sink (const Decoder_Sink &new_sink, const size_t max_memory);
+    bool set_storage (const std::string &directory);
+    void set_decode_policy (const Decode_Policy &policy);
+    uint8_t blocks_delivered();
+    void set_notify (const Notify_Callback &callback);
+    int notify_fd();
     uint8_t blocks_ready();
     bool is_ready();
     bool is_block_ready (const uint8_t block);
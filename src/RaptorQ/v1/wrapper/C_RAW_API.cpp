@@ -78,6 +78,9 @@ static RaptorQ_Compress v1_get_compression();
 static bool v1_set_compression (const RaptorQ_Compress compression);
 static size_t v1_local_cache_size (const size_t local_cache);
 static size_t v1_get_local_cache_size ();
+static size_t v1_plan_cache_size (const size_t bytes);
+static size_t v1_get_plan_cache_size ();
+static void v1_clear_plan_cache ();
 
 // constructors
 static struct RaptorQ_ptr* v1_Encoder (RaptorQ_type type,
@@ -137,6 +140,25 @@ static RaptorQ_Dec_Written v1_decode_bytes (struct RaptorQ_ptr *dec,
                                                         const size_t from_byte,
                                                         const size_t skip);
 
+// batch operations
+static size_t v1_encode_range (const RaptorQ_ptr *enc, void *output,
+                                                        const size_t size,
+                                                        const uint32_t first,
+                                                        const uint32_t count);
+static size_t v1_encode_list (const RaptorQ_ptr *enc, void *output,
+                                                        const size_t size,
+                                                        const uint32_t *ids,
+                                                        const uint32_t count);
+static size_t v1_add_symbols (const RaptorQ_ptr *dec, const void *data,
+                                                        const size_t size,
+                                                        const uint32_t *esi,
+                                                        const uint32_t count);
+
+// completion notifications
+static bool v1_set_notify (const RaptorQ_ptr *ptr, RaptorQ_Notify callback,
+                                                                void *user);
+static int v1_notify_fd (const RaptorQ_ptr *ptr);
+
 
 void RaptorQ_free_api (struct RaptorQ_base_api **api)
 {
@@ -204,7 +226,21 @@ RaptorQ_v1::RaptorQ_v1()
     end_of_input (&v1_end_of_input),
     decode_once (&v1_decode_once),
     decode_symbol (&v1_decode_symbol),
-    decode_bytes (&v1_decode_bytes)
+    decode_bytes (&v1_decode_bytes),
+
+    // batch operations
+    encode_range (&v1_encode_range),
+    encode_list (&v1_encode_list),
+    add_symbols (&v1_add_symbols),
+
+    // completion notifications
+    set_notify (&v1_set_notify),
+    notify_fd (&v1_notify_fd),
+
+    // shared precode matrices
+    plan_cache_size (&v1_plan_cache_size),
+    get_plan_cache_size (&v1_get_plan_cache_size),
+    clear_plan_cache (&v1_clear_plan_cache)
 {}
 
 ///////////////////////////
@@ -231,6 +267,15 @@ static size_t v1_local_cache_size (const size_t local_cache)
 static size_t v1_get_local_cache_size ()
     { return RFC6330__v1::get_local_cache_size(); }
 
+static size_t v1_plan_cache_size (const size_t bytes)
+    { return RaptorQ__v1::plan_cache_size (bytes); }
+
+static size_t v1_get_plan_cache_size ()
+    { return RaptorQ__v1::get_plan_cache_size(); }
+
+static void v1_clear_plan_cache ()
+    { RaptorQ__v1::clear_plan_cache(); }
+
 
 /////////////////////
 // Constructors
@@ -1536,3 +1581,230 @@ static RaptorQ_Dec_Written v1_decode_bytes (struct RaptorQ_ptr *dec,
     }
     return {out.written, out.offset};
 }
+
+
+//////////////////////
+// Batch operations
+//////////////////////
+
+static size_t v1_encode_range (const RaptorQ_ptr *enc, void *output,
+                                                        const size_t size,
+                                                        const uint32_t first,
+                                                        const uint32_t count)
+{
+    if (enc == nullptr || enc->ptr == nullptr || output == nullptr)
+        return 0;
+    uint8_t *out = reinterpret_cast<uint8_t*> (output);
+    switch (enc->type) {
+    case RaptorQ_type::RQ_ENC_8:
+        return reinterpret_cast<
+                        RaptorQ__v1::Impl::Encoder<uint8_t*, uint8_t*>*> (
+                                        enc->ptr)->encode_range (out, size,
+                                                               first, count);
+    case RaptorQ_type::RQ_ENC_16:
+        return reinterpret_cast<
+                        RaptorQ__v1::Impl::Encoder<uint16_t*, uint16_t*>*> (
+                                        enc->ptr)->encode_range (out, size,
+                                                               first, count);
+    case RaptorQ_type::RQ_ENC_32:
+        return reinterpret_cast<
+                        RaptorQ__v1::Impl::Encoder<uint32_t*, uint32_t*>*> (
+                                        enc->ptr)->encode_range (out, size,
+                                                               first, count);
+    case RaptorQ_type::RQ_ENC_64:
+        return reinterpret_cast<
+                        RaptorQ__v1::Impl::Encoder<uint64_t*, uint64_t*>*> (
+                                        enc->ptr)->encode_range (out, size,
+                                                               first, count);
+    case RaptorQ_type::RQ_DEC_8:
+    case RaptorQ_type::RQ_DEC_16:
+    case RaptorQ_type::RQ_DEC_32:
+    case RaptorQ_type::RQ_DEC_64:
+    case RaptorQ_type::RQ_NONE:
+        break;
+    }
+    return 0;
+}
+
+static size_t v1_encode_list (const RaptorQ_ptr *enc, void *output,
+                                                        const size_t size,
+                                                        const uint32_t *ids,
+                                                        const uint32_t count)
+{
+    if (enc == nullptr || enc->ptr == nullptr || output == nullptr)
+        return 0;
+    uint8_t *out = reinterpret_cast<uint8_t*> (output);
+    switch (enc->type) {
+    case RaptorQ_type::RQ_ENC_8:
+        return reinterpret_cast<
+                        RaptorQ__v1::Impl::Encoder<uint8_t*, uint8_t*>*> (
+                                        enc->ptr)->encode_list (out, size,
+                                                                 ids, count);
+    case RaptorQ_type::RQ_ENC_16:
+        return reinterpret_cast<
+                        RaptorQ__v1::Impl::Encoder<uint16_t*, uint16_t*>*> (
+                                        enc->ptr)->encode_list (out, size,
+                                                                 ids, count);
+    case RaptorQ_type::RQ_ENC_32:
+        return reinterpret_cast<
+                        RaptorQ__v1::Impl::Encoder<uint32_t*, uint32_t*>*> (
+                                        enc->ptr)->encode_list (out, size,
+                                                                 ids, count);
+    case RaptorQ_type::RQ_ENC_64:
+        return reinterpret_cast<
+                        RaptorQ__v1::Impl::Encoder<uint64_t*, uint64_t*>*> (
+                                        enc->ptr)->encode_list (out, size,
+                                                                 ids, count);
+    case RaptorQ_type::RQ_DEC_8:
+    case RaptorQ_type::RQ_DEC_16:
+    case RaptorQ_type::RQ_DEC_32:
+    case RaptorQ_type::RQ_DEC_64:
+    case RaptorQ_type::RQ_NONE:
+        break;
+    }
+    return 0;
+}
+
+static size_t v1_add_symbols (const RaptorQ_ptr *dec, const void *data,
+                                                        const size_t size,
+                                                        const uint32_t *esi,
+                                                        const uint32_t count)
+{
+    if (dec == nullptr || dec->ptr == nullptr || data == nullptr)
+        return 0;
+    const uint8_t *in = reinterpret_cast<const uint8_t*> (data);
+    switch (dec->type) {
+    case RaptorQ_type::RQ_DEC_8:
+        return reinterpret_cast<
+                        RaptorQ__v1::Impl::Decoder<uint8_t*, uint8_t*>*> (
+                                dec->ptr)->add_symbols (in, size, esi, count);
+    case RaptorQ_type::RQ_DEC_16:
+        return reinterpret_cast<
+                        RaptorQ__v1::Impl::Decoder<uint16_t*, uint16_t*>*> (
+                                dec->ptr)->add_symbols (in, size, esi, count);
+    case RaptorQ_type::RQ_DEC_32:
+        return reinterpret_cast<
+                        RaptorQ__v1::Impl::Decoder<uint32_t*, uint32_t*>*> (
+                                dec->ptr)->add_symbols (in, size, esi, count);
+    case RaptorQ_type::RQ_DEC_64:
+        return reinterpret_cast<
+                        RaptorQ__v1::Impl::Decoder<uint64_t*, uint64_t*>*> (
+                                dec->ptr)->add_symbols (in, size, esi, count);
+    case RaptorQ_type::RQ_ENC_8:
+    case RaptorQ_type::RQ_ENC_16:
+    case RaptorQ_type::RQ_ENC_32:
+    case RaptorQ_type::RQ_ENC_64:
+    case RaptorQ_type::RQ_NONE:
+        break;
+    }
+    return 0;
+}
+
+///////////////////////////
+// Completion notifications
+///////////////////////////
+
+static bool v1_set_notify (const RaptorQ_ptr *ptr, RaptorQ_Notify callback,
+                                                                void *user)
+{
+    if (ptr == nullptr || ptr->ptr == nullptr)
+        return false;
+    RaptorQ__v1::Notify_Callback cb;
+    if (callback != nullptr) {
+        cb = [callback, user] (const RaptorQ__v1::Notify_Event event,
+                                            const RaptorQ__v1::Error error,
+                                            const uint8_t sbn) {
+            RQ_UNUSED (sbn);
+            callback (user, static_cast<RaptorQ_Notify_Event> (event),
+                                        static_cast<RaptorQ_Error> (error));
+        };
+    }
+    switch (ptr->type) {
+    case RaptorQ_type::RQ_ENC_8:
+        reinterpret_cast<
+                    RaptorQ__v1::Impl::Encoder<uint8_t*, uint8_t*>*> (
+                                        ptr->ptr)->set_notify (cb);
+        return true;
+    case RaptorQ_type::RQ_ENC_16:
+        reinterpret_cast<
+                    RaptorQ__v1::Impl::Encoder<uint16_t*, uint16_t*>*> (
+                                        ptr->ptr)->set_notify (cb);
+        return true;
+    case RaptorQ_type::RQ_ENC_32:
+        reinterpret_cast<
+                    RaptorQ__v1::Impl::Encoder<uint32_t*, uint32_t*>*> (
+                                        ptr->ptr)->set_notify (cb);
+        return true;
+    case RaptorQ_type::RQ_ENC_64:
+        reinterpret_cast<
+                    RaptorQ__v1::Impl::Encoder<uint64_t*, uint64_t*>*> (
+                                        ptr->ptr)->set_notify (cb);
+        return true;
+    case RaptorQ_type::RQ_DEC_8:
+        reinterpret_cast<
+                    RaptorQ__v1::Impl::Decoder<uint8_t*, uint8_t*>*> (
+                                        ptr->ptr)->set_notify (cb);
+        return true;
+    case RaptorQ_type::RQ_DEC_16:
+        reinterpret_cast<
+                    RaptorQ__v1::Impl::Decoder<uint16_t*, uint16_t*>*> (
+                                        ptr->ptr)->set_notify (cb);
+        return true;
+    case RaptorQ_type::RQ_DEC_32:
+        reinterpret_cast<
+                    RaptorQ__v1::Impl::Decoder<uint32_t*, uint32_t*>*> (
+                                        ptr->ptr)->set_notify (cb);
+        return true;
+    case RaptorQ_type::RQ_DEC_64:
+        reinterpret_cast<
+                    RaptorQ__v1::Impl::Decoder<uint64_t*, uint64_t*>*> (
+                                        ptr->ptr)->set_notify (cb);
+        return true;
+    case RaptorQ_type::RQ_NONE:
+        break;
+    }
+    return false;
+}
+
+static int v1_notify_fd (const RaptorQ_ptr *ptr)
+{
+    if (ptr == nullptr || ptr->ptr == nullptr)
+        return -1;
+    switch (ptr->type) {
+    case RaptorQ_type::RQ_ENC_8:
+        return reinterpret_cast<
+                    RaptorQ__v1::Impl::Encoder<uint8_t*, uint8_t*>*> (
+                                        ptr->ptr)->notify_fd();
+    case RaptorQ_type::RQ_ENC_16:
+        return reinterpret_cast<
+                    RaptorQ__v1::Impl::Encoder<uint16_t*, uint16_t*>*> (
+                                        ptr->ptr)->notify_fd();
+    case RaptorQ_type::RQ_ENC_32:
+        return reinterpret_cast<
+                    RaptorQ__v1::Impl::Encoder<uint32_t*, uint32_t*>*> (
+                                        ptr->ptr)->notify_fd();
+    case RaptorQ_type::RQ_ENC_64:
+        return reinterpret_cast<
+                    RaptorQ__v1::Impl::Encoder<uint64_t*, uint64_t*>*> (
+                                        ptr->ptr)->notify_fd();
+    case RaptorQ_type::RQ_DEC_8:
+        return reinterpret_cast<
+                    RaptorQ__v1::Impl::Decoder<uint8_t*, uint8_t*>*> (
+                                        ptr->ptr)->notify_fd();
+    case RaptorQ_type::RQ_DEC_16:
+        return reinterpret_cast<
+                    RaptorQ__v1::Impl::Decoder<uint16_t*, uint16_t*>*> (
+                                        ptr->ptr)->notify_fd();
+    case RaptorQ_type::RQ_DEC_32:
+        return reinterpret_cast<
+                    RaptorQ__v1::Impl::Decoder<uint32_t*, uint32_t*>*> (
+                                        ptr->ptr)->notify_fd();
+    case RaptorQ_type::RQ_DEC_64:
+        return reinterpret_cast<
+                    RaptorQ__v1::Impl::Decoder<uint64_t*, uint64_t*>*> (
+                                        ptr->ptr)->notify_fd();
+    case RaptorQ_type::RQ_NONE:
+        break;
+    }
+    return -1;
+}
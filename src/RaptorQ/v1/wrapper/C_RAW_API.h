@@ -61,6 +61,10 @@ extern "C"
         RQ_PARTIAL_ANY = RQ_COMPUTE_PARTIAL_ANY,
         RQ_COMPLETE = RQ_COMPUTE_COMPLETE
     } RAPTORQ_API RQ_Dec_Report;
+    // completion notifications: see set_notify
+    typedef void (*RaptorQ_Notify) (void *user,
+                                        const RaptorQ_Notify_Event event,
+                                        const RaptorQ_Error error);
 
 
     RAPTORQ_API struct RaptorQ_base_api* RaptorQ_api (uint32_t version);
@@ -159,6 +163,37 @@ extern "C"
                                                         const size_t from_byte,
                                                         const size_t skip);
 
+        // batch operations: many symbols, one after the other, with a
+        // single call. sizes are in bytes.
+        size_t (*const encode_range) (const struct RaptorQ_ptr *enc,
+                                                        void *output,
+                                                        const size_t size,
+                                                        const uint32_t first,
+                                                        const uint32_t count);
+        size_t (*const encode_list) (const struct RaptorQ_ptr *enc,
+                                                        void *output,
+                                                        const size_t size,
+                                                        const uint32_t *ids,
+                                                        const uint32_t count);
+        size_t (*const add_symbols) (const struct RaptorQ_ptr *dec,
+                                                        const void *data,
+                                                        const size_t size,
+                                                        const uint32_t *esi,
+                                                        const uint32_t count);
+
+        // completion notifications, for event loops: "callback" is called
+        // from the library threads with "user" when the future of
+        // compute()/precompute()/wait() is ready. NULL removes it.
+        // notify_fd: eventfd counting the same events. -1 if unsupported.
+        bool (*const set_notify) (const struct RaptorQ_ptr *ptr,
+                                                    RaptorQ_Notify callback,
+                                                    void *user);
+        int (*const notify_fd) (const struct RaptorQ_ptr *ptr);
+
+        // shared per-K' precode matrices, see local_cache_size
+        size_t (*const plan_cache_size) (const size_t bytes);
+        size_t (*const get_plan_cache_size) (void);
+        void (*const clear_plan_cache) (void);
     };
 
 
@@ -56,6 +56,9 @@ static RFC6330_Compress v1_get_compression();
 static bool v1_set_compression (const RFC6330_Compress compression);
 static size_t v1_local_cache_size (const size_t local_cache);
 static size_t v1_get_local_cache_size ();
+static size_t v1_plan_cache_size (const size_t bytes);
+static size_t v1_get_plan_cache_size ();
+static void v1_clear_plan_cache ();
 // constructors
 static struct RFC6330_ptr* v1_Encoder (RFC6330_type type,
                                               const void *data_from,
@@ -91,6 +94,7 @@ static struct RFC6330_Result v1_future_get (struct RFC6330_future *future);
 static bool v1_set_thread_pool (const size_t threads,
                                 const uint16_t max_block_concurrency,
                                 const RFC6330_Work exit_type);
+static bool v1_set_thread_pool_affinity (const RFC6330_Pool_Affinity affinity);
 static struct RFC6330_future* v1_compute (const struct RFC6330_ptr *ptr,
                                                 const RFC6330_Compute flags);
 static void v1_free (struct RFC6330_ptr **ptr);
@@ -159,6 +163,26 @@ static size_t v1_decode_block_bytes (const struct RFC6330_ptr *dec, void **data,
                                                             const uint8_t skip,
                                                             const uint8_t sbn);
 
+// batch operations
+static size_t v1_encode_range (const struct RFC6330_ptr *enc, void *output,
+                                                        const size_t size,
+                                                        const uint32_t esi,
+                                                        const uint32_t count,
+                                                        const uint8_t sbn);
+static size_t v1_add_symbols (const struct RFC6330_ptr *dec, const void *data,
+                                                        const size_t size,
+                                                        const uint32_t *ids,
+                                                        const uint32_t count);
+static uint64_t v1_decode_blocks (const struct RFC6330_ptr *dec, void **data,
+                                                        const uint64_t size,
+                                                        const uint8_t *sbns,
+                                                        const uint16_t count);
+
+// completion notifications
+static bool v1_set_notify (const struct RFC6330_ptr *ptr,
+                                    RFC6330_Notify callback, void *user);
+static int v1_notify_fd (const struct RFC6330_ptr *ptr);
+
 
 
 void RFC6330_free_api (struct RFC6330_base_api **api)
@@ -230,7 +254,24 @@ RFC6330_v1::RFC6330_v1()
     decode_block_aligned (&v1_decode_block_aligned),
     decode_symbol (&v1_decode_symbol),
     decode_bytes (&v1_decode_bytes),
-    decode_block_bytes (&v1_decode_block_bytes)
+    decode_block_bytes (&v1_decode_block_bytes),
+
+    // batch operations
+    encode_range (&v1_encode_range),
+    add_symbols (&v1_add_symbols),
+    decode_blocks (&v1_decode_blocks),
+
+    // completion notifications
+    set_notify (&v1_set_notify),
+    notify_fd (&v1_notify_fd),
+
+    // thread pool placement
+    set_thread_pool_affinity (&v1_set_thread_pool_affinity),
+
+    // shared precode matrices
+    plan_cache_size (&v1_plan_cache_size),
+    get_plan_cache_size (&v1_get_plan_cache_size),
+    clear_plan_cache (&v1_clear_plan_cache)
 {}
 
 
@@ -258,6 +299,15 @@ static size_t v1_local_cache_size (const size_t local_cache)
 static size_t v1_get_local_cache_size ()
     { return RFC6330__v1::get_local_cache_size(); }
 
+static size_t v1_plan_cache_size (const size_t bytes)
+    { return RFC6330__v1::plan_cache_size (bytes); }
+
+static size_t v1_get_plan_cache_size ()
+    { return RFC6330__v1::get_plan_cache_size(); }
+
+static void v1_clear_plan_cache ()
+    { RFC6330__v1::clear_plan_cache(); }
+
 
 
 
@@ -718,6 +768,12 @@ static bool v1_set_thread_pool (const size_t threads,
                             static_cast<RaptorQ__v1::Work_State> (exit_type));
 }
 
+static bool v1_set_thread_pool_affinity (const RFC6330_Pool_Affinity affinity)
+{
+    return RFC6330__v1::set_thread_pool_affinity (
+                        static_cast<RFC6330__v1::Pool_Affinity> (affinity));
+}
+
 static struct RFC6330_future* v1_compute (const struct RFC6330_ptr *ptr,
                                                  const RFC6330_Compute flags)
 {
@@ -1799,3 +1855,256 @@ static RFC6330_Error v1_add_symbol (const struct RFC6330_ptr *dec, void **data,
     }
     return ret;
 }
+
+
+//////////////////////
+// Batch operations
+//////////////////////
+
+static size_t v1_encode_range (const struct RFC6330_ptr *enc, void *output,
+                                                        const size_t size,
+                                                        const uint32_t esi,
+                                                        const uint32_t count,
+                                                        const uint8_t sbn)
+{
+    if (enc == nullptr || enc->ptr == nullptr || output == nullptr)
+        return 0;
+    uint8_t *out = reinterpret_cast<uint8_t*> (output);
+    switch (enc->type) {
+    case RFC6330_type::RQ_ENC_8:
+        return (reinterpret_cast<
+                            RFC6330__v1::Impl::Encoder<uint8_t*, uint8_t*>*> (
+                                        enc->ptr))->encode_range (out, size,
+                                                            esi, count, sbn);
+    case RFC6330_type::RQ_ENC_16:
+        return (reinterpret_cast<
+                            RFC6330__v1::Impl::Encoder<uint16_t*, uint16_t*>*> (
+                                        enc->ptr))->encode_range (out, size,
+                                                            esi, count, sbn);
+    case RFC6330_type::RQ_ENC_32:
+        return (reinterpret_cast<
+                            RFC6330__v1::Impl::Encoder<uint32_t*, uint32_t*>*> (
+                                        enc->ptr))->encode_range (out, size,
+                                                            esi, count, sbn);
+    case RFC6330_type::RQ_ENC_64:
+        return (reinterpret_cast<
+                            RFC6330__v1::Impl::Encoder<uint64_t*, uint64_t*>*> (
+                                        enc->ptr))->encode_range (out, size,
+                                                            esi, count, sbn);
+    case RFC6330_type::RQ_DEC_8:
+    case RFC6330_type::RQ_DEC_16:
+    case RFC6330_type::RQ_DEC_32:
+    case RFC6330_type::RQ_DEC_64:
+    case RFC6330_type::RQ_NONE:
+        break;
+    }
+    return 0;
+}
+
+static size_t v1_add_symbols (const struct RFC6330_ptr *dec, const void *data,
+                                                        const size_t size,
+                                                        const uint32_t *ids,
+                                                        const uint32_t count)
+{
+    if (dec == nullptr || dec->ptr == nullptr || data == nullptr)
+        return 0;
+    const uint8_t *in = reinterpret_cast<const uint8_t*> (data);
+    switch (dec->type) {
+    case RFC6330_type::RQ_DEC_8:
+        return (reinterpret_cast<
+                            RFC6330__v1::Impl::Decoder<uint8_t*, uint8_t*>*> (
+                                        dec->ptr))->add_symbols (in, size,
+                                                                ids, count);
+    case RFC6330_type::RQ_DEC_16:
+        return (reinterpret_cast<
+                            RFC6330__v1::Impl::Decoder<uint16_t*, uint16_t*>*> (
+                                        dec->ptr))->add_symbols (in, size,
+                                                                ids, count);
+    case RFC6330_type::RQ_DEC_32:
+        return (reinterpret_cast<
+                            RFC6330__v1::Impl::Decoder<uint32_t*, uint32_t*>*> (
+                                        dec->ptr))->add_symbols (in, size,
+                                                                ids, count);
+    case RFC6330_type::RQ_DEC_64:
+        return (reinterpret_cast<
+                            RFC6330__v1::Impl::Decoder<uint64_t*, uint64_t*>*> (
+                                        dec->ptr))->add_symbols (in, size,
+                                                                ids, count);
+    case RFC6330_type::RQ_ENC_8:
+    case RFC6330_type::RQ_ENC_16:
+    case RFC6330_type::RQ_ENC_32:
+    case RFC6330_type::RQ_ENC_64:
+    case RFC6330_type::RQ_NONE:
+        break;
+    }
+    return 0;
+}
+
+static uint64_t v1_decode_blocks (const struct RFC6330_ptr *dec, void **data,
+                                                        const uint64_t size,
+                                                        const uint8_t *sbns,
+                                                        const uint16_t count)
+{
+    uint8_t *p_8;
+    uint16_t *p_16;
+    uint32_t *p_32;
+    uint64_t *p_64;
+    uint64_t ret = 0;
+    if (dec == nullptr || dec->ptr == nullptr ||
+                                            data == nullptr || *data == nullptr) {
+        return ret;
+    }
+    switch (dec->type) {
+    case RFC6330_type::RQ_DEC_8:
+        p_8 = reinterpret_cast<uint8_t*> (*data);
+        ret = (reinterpret_cast<
+                            RFC6330__v1::Impl::Decoder<uint8_t*, uint8_t*>*> (
+                                            dec->ptr))->decode_blocks (
+                                                            p_8, p_8 + size,
+                                                                sbns, count);
+        *data = p_8;
+        break;
+    case RFC6330_type::RQ_DEC_16:
+        p_16 = reinterpret_cast<uint16_t*> (*data);
+        ret = (reinterpret_cast<
+                            RFC6330__v1::Impl::Decoder<uint16_t*, uint16_t*>*> (
+                                            dec->ptr))->decode_blocks (
+                                                            p_16, p_16 + size,
+                                                                sbns, count);
+        *data = p_16;
+        break;
+    case RFC6330_type::RQ_DEC_32:
+        p_32 = reinterpret_cast<uint32_t*> (*data);
+        ret = (reinterpret_cast<
+                            RFC6330__v1::Impl::Decoder<uint32_t*, uint32_t*>*> (
+                                            dec->ptr))->decode_blocks (
+                                                            p_32, p_32 + size,
+                                                                sbns, count);
+        *data = p_32;
+        break;
+    case RFC6330_type::RQ_DEC_64:
+        p_64 = reinterpret_cast<uint64_t*> (*data);
+        ret = (reinterpret_cast<
+                            RFC6330__v1::Impl::Decoder<uint64_t*, uint64_t*>*> (
+                                            dec->ptr))->decode_blocks (
+                                                            p_64, p_64 + size,
+                                                                sbns, count);
+        *data = p_64;
+        break;
+    case RFC6330_type::RQ_ENC_8:
+    case RFC6330_type::RQ_ENC_16:
+    case RFC6330_type::RQ_ENC_32:
+    case RFC6330_type::RQ_ENC_64:
+    case RFC6330_type::RQ_NONE:
+        break;
+    }
+    return ret;
+}
+
+///////////////////////////
+// Completion notifications
+///////////////////////////
+
+static bool v1_set_notify (const struct RFC6330_ptr *ptr,
+                                        RFC6330_Notify callback, void *user)
+{
+    if (ptr == nullptr || ptr->ptr == nullptr)
+        return false;
+    RFC6330__v1::Notify_Callback cb;
+    if (callback != nullptr) {
+        cb = [callback, user] (const RFC6330__v1::Notify_Event event,
+                                            const RFC6330__v1::Error error,
+                                            const uint8_t sbn) {
+            callback (user, static_cast<RFC6330_Notify_Event> (event),
+                                    static_cast<RFC6330_Error> (error), sbn);
+        };
+    }
+    switch (ptr->type) {
+    case RFC6330_type::RQ_ENC_8:
+        reinterpret_cast<
+                    RFC6330__v1::Impl::Encoder<uint8_t*, uint8_t*>*> (
+                                        ptr->ptr)->set_notify (cb);
+        return true;
+    case RFC6330_type::RQ_ENC_16:
+        reinterpret_cast<
+                    RFC6330__v1::Impl::Encoder<uint16_t*, uint16_t*>*> (
+                                        ptr->ptr)->set_notify (cb);
+        return true;
+    case RFC6330_type::RQ_ENC_32:
+        reinterpret_cast<
+                    RFC6330__v1::Impl::Encoder<uint32_t*, uint32_t*>*> (
+                                        ptr->ptr)->set_notify (cb);
+        return true;
+    case RFC6330_type::RQ_ENC_64:
+        reinterpret_cast<
+                    RFC6330__v1::Impl::Encoder<uint64_t*, uint64_t*>*> (
+                                        ptr->ptr)->set_notify (cb);
+        return true;
+    case RFC6330_type::RQ_DEC_8:
+        reinterpret_cast<
+                    RFC6330__v1::Impl::Decoder<uint8_t*, uint8_t*>*> (
+                                        ptr->ptr)->set_notify (cb);
+        return true;
+    case RFC6330_type::RQ_DEC_16:
+        reinterpret_cast<
+                    RFC6330__v1::Impl::Decoder<uint16_t*, uint16_t*>*> (
+                                        ptr->ptr)->set_notify (cb);
+        return true;
+    case RFC6330_type::RQ_DEC_32:
+        reinterpret_cast<
+                    RFC6330__v1::Impl::Decoder<uint32_t*, uint32_t*>*> (
+                                        ptr->ptr)->set_notify (cb);
+        return true;
+    case RFC6330_type::RQ_DEC_64:
+        reinterpret_cast<
+                    RFC6330__v1::Impl::Decoder<uint64_t*, uint64_t*>*> (
+                                        ptr->ptr)->set_notify (cb);
+        return true;
+    case RFC6330_type::RQ_NONE:
+        break;
+    }
+    return false;
+}
+
+static int v1_notify_fd (const struct RFC6330_ptr *ptr)
+{
+    if (ptr == nullptr || ptr->ptr == nullptr)
+        return -1;
+    switch (ptr->type) {
+    case RFC6330_type::RQ_ENC_8:
+        return reinterpret_cast<
+                    RFC6330__v1::Impl::Encoder<uint8_t*, uint8_t*>*> (
+                                        ptr->ptr)->notify_fd();
+    case RFC6330_type::RQ_ENC_16:
+        return reinterpret_cast<
+                    RFC6330__v1::Impl::Encoder<uint16_t*, uint16_t*>*> (
+                                        ptr->ptr)->notify_fd();
+    case RFC6330_type::RQ_ENC_32:
+        return reinterpret_cast<
+                    RFC6330__v1::Impl::Encoder<uint32_t*, uint32_t*>*> (
+                                        ptr->ptr)->notify_fd();
+    case RFC6330_type::RQ_ENC_64:
+        return reinterpret_cast<
+                    RFC6330__v1::Impl::Encoder<uint64_t*, uint64_t*>*> (
+                                        ptr->ptr)->notify_fd();
+    case RFC6330_type::RQ_DEC_8:
+        return reinterpret_cast<
+                    RFC6330__v1::Impl::Decoder<uint8_t*, uint8_t*>*> (
+                                        ptr->ptr)->notify_fd();
+    case RFC6330_type::RQ_DEC_16:
+        return reinterpret_cast<
+                    RFC6330__v1::Impl::Decoder<uint16_t*, uint16_t*>*> (
+                                        ptr->ptr)->notify_fd();
+    case RFC6330_type::RQ_DEC_32:
+        return reinterpret_cast<
+                    RFC6330__v1::Impl::Decoder<uint32_t*, uint32_t*>*> (
+                                        ptr->ptr)->notify_fd();
+    case RFC6330_type::RQ_DEC_64:
+        return reinterpret_cast<
+                    RFC6330__v1::Impl::Decoder<uint64_t*, uint64_t*>*> (
+                                        ptr->ptr)->notify_fd();
+    case RFC6330_type::RQ_NONE:
+        break;
+    }
+    return -1;
+}
@@ -53,6 +53,11 @@ extern "C"
         uint64_t length;
         uint8_t *bitmask;
     };
+    // completion notifications: see set_notify
+    typedef void (*RFC6330_Notify) (void *user,
+                                        const RFC6330_Notify_Event event,
+                                        const RFC6330_Error error,
+                                        const uint8_t sbn);
 
 
     RAPTORQ_API struct RFC6330_base_api* RFC6330_api (uint32_t version);
@@ -192,6 +197,44 @@ extern "C"
                                                             const size_t size,
                                                             const uint8_t skip,
                                                             const uint8_t sbn);
+
+        // batch operations: many symbols or blocks with a single call.
+        // symbols are one after the other, symbol sizes are in bytes.
+        size_t (*const encode_range) (const struct RFC6330_ptr *enc,
+                                                        void *output,
+                                                        const size_t size,
+                                                        const uint32_t esi,
+                                                        const uint32_t count,
+                                                        const uint8_t sbn);
+        size_t (*const add_symbols) (const struct RFC6330_ptr *dec,
+                                                        const void *data,
+                                                        const size_t size,
+                                                        const uint32_t *ids,
+                                                        const uint32_t count);
+        uint64_t (*const decode_blocks) (const struct RFC6330_ptr *dec,
+                                                        void **data,
+                                                        const uint64_t size,
+                                                        const uint8_t *sbns,
+                                                        const uint16_t count);
+
+        // completion notifications, for event loops: "callback" is called
+        // from the library threads with "user" when a block is ready
+        // (RQ_NOTIFY_BLOCK) and when the future of compute() is
+        // (RQ_NOTIFY_COMPUTE). NULL removes it.
+        // notify_fd: eventfd counting the same events. -1 if unsupported.
+        bool (*const set_notify) (const struct RFC6330_ptr *ptr,
+                                                    RFC6330_Notify callback,
+                                                    void *user);
+        int (*const notify_fd) (const struct RFC6330_ptr *ptr);
+
+        // thread pool placement, see set_thread_pool
+        bool (*const set_thread_pool_affinity) (
+                                    const RFC6330_Pool_Affinity affinity);
+
+        // shared per-K' precode matrices, see local_cache_size
+        size_t (*const plan_cache_size) (const size_t bytes);
+        size_t (*const get_plan_cache_size) (void);
+        void (*const clear_plan_cache) (void);
     };
 
 
@@ -69,8 +69,10 @@ typedef enum {
     RQ_COMPUTE_COMPLETE = 0x04,             //  all blocks are decoded.
     RQ_COMPUTE_NO_BACKGROUND = 0x08,        // no background/async. RFC
     RQ_COMPUTE_NO_POOL = 0x10,              // do not use the thread pool. RFC
-    RQ_COMPUTE_NO_RETRY = 0x20              // do not try again with different
+    RQ_COMPUTE_NO_RETRY = 0x20,             // do not try again with different
                                             // repair symbol combination. RFC
+    RQ_COMPUTE_WIDE = 0x40                  // encode together the blocks
+                                            // with the same size. RFC
 } RFC6330_Compute;
 
 typedef enum {
@@ -100,6 +102,20 @@ typedef enum {
 } RaptorQ_Fill_With_Zeros;
 typedef RaptorQ_Fill_With_Zeros RFC6330_Fill_With_Zeros;
 
+// tracked by RaptorQ__v1::Notify_Event
+typedef enum {
+    RQ_NOTIFY_BLOCK   = 0,  // a block has been encoded or decoded. RFC
+    RQ_NOTIFY_COMPUTE = 1   // the future of compute()/wait() is ready
+} RaptorQ_Notify_Event;
+typedef RaptorQ_Notify_Event RFC6330_Notify_Event;
+
+// tracked by RFC6330__v1::Pool_Affinity
+typedef enum {
+    RQ_AFFINITY_NONE = 0,   // the OS decides
+    RQ_AFFINITY_CPU  = 1,   // one thread per cpu
+    RQ_AFFINITY_NUMA = 2    // threads and blocks grouped per NUMA node
+} RFC6330_Pool_Affinity;
+
 #ifdef __cplusplus
 }   // extern "C"
 #endif
@@ -37,13 +37,20 @@
 #include <algorithm>
 #include <cassert>
 #include <chrono>
+#include <condition_variable>
 #include <cstdlib>
 #include <cstring>
 #include <fstream>
+#include <functional>
 #include <future>
+#include <iomanip>
 #include <iostream>
 #include <map>
 #include <memory>
+#include <mutex>
+#include <numeric>
+#include <random>
+#include <thread>
 #include <utility>
 #include <vector>
 
@@ -78,10 +85,13 @@ static option::ArgStatus Numeric (const option::Option& option, bool msg)
 }
 };
 
-enum  optionIndex { UNKNOWN, HELP, FORMAT, SYMBOLS, SYMBOL_SIZE, REPAIR, BYTES};
+enum  optionIndex { UNKNOWN, HELP, FORMAT, SYMBOLS, SYMBOL_SIZE, REPAIR, BYTES,
+                                THREADS, ALL_BLOCKS, LOSS, OVERHEAD, CACHE,
+                                                            RUNS, CSV, JSON};
 const option::Descriptor usage[] =
 {
- {UNKNOWN, 0, "", "", Arg::Unknown, "USAGE: benchmark|blocks"},
+ {UNKNOWN, 0, "", "", Arg::Unknown, "USAGE: blocks"},
+ {UNKNOWN, 0, "", "", Arg::Unknown, "USAGE: benchmark [PARAMETERS]"},
  {UNKNOWN, 0, "", "", Arg::Unknown,
                     "USAGE: encode|decode PARAMETERS INPUT OUTPUT\n"
                                             "  use '-' for stdin/stdout\n\n"
@@ -94,25 +104,68 @@ const option::Descriptor usage[] =
                                                 "number of symbols per block"},
  {SYMBOL_SIZE, 0, "w", "symbol-size", Arg::Numeric, "  -w --symbol-size\t"
                                                         " bytes per symbol"},
+ {THREADS, 0, "t", "threads", Arg::Numeric, "  -t --threads\t"
+                        "blocks worked on at the same time (default: cpus)"},
  {UNKNOWN, 0, "", "", Arg::Unknown, "ENCODE only parameters:"},
  {REPAIR, 0, "r", "repair", Arg::Numeric, "  -r --repair\t"
                                         "number of repair symbols per block"},
  {UNKNOWN, 0, "", "", Arg::None, "DECODE only parameters:"},
  {BYTES, 0, "b", "bytes", Arg::Numeric, "  -b --bytes\t"
                                     "data size for each {en,de}coder block"},
+ {UNKNOWN, 0, "", "", Arg::None, "BENCHMARK parameters:"},
+ {UNKNOWN, 0, "", "", Arg::None, "  -s -w -t -l -o -c can be repeated, "
+                                        "every combination is measured."},
+ {UNKNOWN, 0, "", "", Arg::None, "  -t is the number of blocks computed "
+                                                        "at the same time."},
+ {UNKNOWN, 0, "", "", Arg::None, "  defaults: -s 10 -s 101 -s 1002 "
+                                                            "-w 1280 -t 1"},
+ {UNKNOWN, 0, "", "", Arg::None, "  encode and decode start without cache "
+                    "or shared plans, *_cached reuse them."},
+ {ALL_BLOCKS, 0, "a", "all-blocks", Arg::None, "  -a --all-blocks\t"
+                    "all block sizes, up to the first that takes a second"},
+ {LOSS, 0, "l", "loss", Arg::Numeric, "  -l --loss\t"
+                            "percent of lost source symbols (default: 10)"},
+ {OVERHEAD, 0, "o", "overhead", Arg::Numeric, "  -o --overhead\t"
+                "repair symbols received over the lost ones (default: 0)"},
+ {CACHE, 0, "c", "cache", Arg::Numeric, "  -c --cache\t"
+                                "cache size in MB, 0 = off (default: 0, 100)"},
+ {RUNS, 0, "n", "runs", Arg::Numeric, "  -n --runs\t"
+                                            "runs per test (default: 10)"},
+ {CSV, 0, "", "csv", Arg::None, "  --csv\tCSV output"},
+ {JSON, 0, "", "json", Arg::None, "  --json\tJSON output"},
  {0,0,nullptr,nullptr,nullptr,nullptr}
 };
 
-void bench (uint32_t seconds);
+enum class Bench_Format : uint8_t { TEXT, CSV, JSON };
+
+// what the benchmark sweeps over. Every combination is measured.
+struct Bench_Params
+{
+    std::vector<RaptorQ__v1::Block_Size> blocks;
+    bool all_blocks;    // stop at the first block slower than a second
+    std::vector<size_t> symbol_sizes;
+    std::vector<uint32_t> losses;       // percent of lost source symbols
+    std::vector<uint32_t> overheads;    // repair symbols over the lost ones
+    std::vector<size_t> threads;
+    std::vector<size_t> caches;         // MB. 0: no cache
+    uint32_t runs;
+    Bench_Format format;
+};
+
+static bool bench (const Bench_Params &params);
+static bool get_block_size (const int64_t syms,
+                                        RaptorQ__v1::Block_Size *symbols);
 static void info (const char *prog_name);
 static bool encode (const int64_t symbol_size,
                                         const RaptorQ__v1::Block_Size symbols,
                                         const uint32_t repair,
+                                        const size_t threads,
                                         std::istream *input,
                                         std::ostream *output);
 
 static bool decode (const size_t bytes, const RaptorQ__v1::Block_Size symbols,
                                                     const int64_t symbol_size,
+                                                    const size_t threads,
                                                     std::istream *input,
                                                     std::ostream *output);
 
@@ -134,11 +187,17 @@ static void info (const char *prog_name)
     std::cout << "\tsymbol:   data\n";
 }
 
-// argument passing and data between input7output thread for the
+// argument passing and data between input/output thread for the
 // decoder
 using iter_8 = std::vector<uint8_t>::iterator;
+using Enc = RaptorQ__v1::Encoder<iter_8, iter_8>;
 using Dec = RaptorQ__v1::Decoder<iter_8, iter_8>;
 
+// each packet: uint32_t block, uint32_t symbol, symbol data
+constexpr size_t packet_header = 2 * sizeof(uint32_t);
+// input is read in chunks of about this size
+constexpr size_t chunk_size = 1024 * 1024;
+
 enum class Out_Status : uint8_t {
     WORKING,
     GRACEFUL_STOP,
@@ -146,10 +205,32 @@ enum class Out_Status : uint8_t {
     EXITED,
 };
 
+// one block being decoded. The decoder works in place on "data".
+// "done" is only valid once the block is allowed to decode: until then
+// the decoder just keeps the symbols.
+struct Dec_Block
+{
+    size_t bytes;
+    std::vector<uint8_t> data;
+    std::unique_ptr<Dec> dec;
+    std::future<RaptorQ__v1::Decoder_wait_res> done;
+};
+
+// let the block decode as soon as it has enough symbols
+static void start_block (Dec_Block *blk, size_t *decoding)
+{
+    blk->done = blk->dec->wait();
+    ++*decoding;
+}
+
 struct write_out_args
 {
     size_t bytes;
-    std::map<size_t, std::unique_ptr<Dec>> *decoders;
+    size_t block_size;
+    size_t threads;
+    std::map<size_t, std::unique_ptr<Dec_Block>> *blocks;
+    size_t *written;
+    size_t *decoding;
     std::mutex *mtx;
     std::condition_variable *cond;
     std::ostream *output;
@@ -159,342 +240,373 @@ struct write_out_args
 
 static void print_output (struct write_out_args args);
 
-// thread function to wait for the decoders to finish decoding and
-// print output. Only used when decoding
+// thread function to wait for the blocks to be decoded and
+// print them in order, one write per block. Only used when decoding.
+// Every block written lets the first waiting one decode.
 static void print_output (struct write_out_args args)
 {
-    size_t bytes_left = args.bytes;
-    size_t current_block = 0;
-    uint16_t last_symbol = 0;
-    std::unique_lock<std::mutex> lock (*args.mtx, std::defer_lock);
-    while (*args.status == Out_Status::WORKING ||
-                                    *args.status == Out_Status::GRACEFUL_STOP) {
-        lock.lock();
-        auto dec_it = args.decoders->find (current_block);
-        if (dec_it == args.decoders->end()) {
-            if (*args.status == Out_Status::GRACEFUL_STOP) {
-                lock.unlock();
-                break;
-            }
+    const size_t total = (args.bytes + args.block_size - 1) / args.block_size;
+    std::unique_lock<std::mutex> lock (*args.mtx);
+    for (size_t current = 0; current < total; ++current) {
+        auto blk_it = args.blocks->find (current);
+        while (blk_it == args.blocks->end() &&
+                                        *args.status == Out_Status::WORKING) {
             args.cond->wait (lock);
-            lock.unlock();
-            continue;
-        }
-        auto dec = dec_it->second.get();
-        if (!dec->can_decode()) {
-            if (*args.status == Out_Status::GRACEFUL_STOP) {
-                *args.status = Out_Status::ERROR;
-                return;
-            }
-            args.cond->wait (lock);
-            lock.unlock();
-            continue;
+            blk_it = args.blocks->find (current);
         }
-        lock.unlock();
-        auto pair = dec->wait_sync();
-        if (pair.error == RaptorQ__v1::Error::NEED_DATA) {
-            if (*args.status == Out_Status::GRACEFUL_STOP) {
-                lock.lock();
-                if (dec->poll().error == RaptorQ__v1::Error::NONE)
-                    continue;
-                *args.status = Out_Status::ERROR;
-                return;
-            }
-            continue;
-        }
-        if (pair.error != RaptorQ__v1::Error::NONE) {
-            // internal error or interrupted computation
-            lock.lock();
+        if (blk_it == args.blocks->end()) {
+            // input ended without this block
             *args.status = Out_Status::ERROR;
+            args.cond->notify_all();
             return;
         }
-        size_t sym_size = dec->symbol_size();
-        std::vector<uint8_t> buffer (sym_size);;
-        for (; last_symbol < pair.symbol; ++last_symbol) {
-            buffer.clear();
-            buffer.insert (buffer.begin(), sym_size, 0);
-            auto buf_start = buffer.begin();
-            auto to_write = dec->decode_symbol (buf_start, buffer.end(),
-                                                                last_symbol);
-            if (to_write != RaptorQ__v1::Error::NONE) {
-                std::cerr << "ERR: partial or empty symbol from decoder\n";
-                lock.lock();
-                *args.status = Out_Status::ERROR;
-                return;
-            }
-            size_t writes_left = std::min (bytes_left,
-                                            static_cast<size_t> (sym_size));
+        // only we remove blocks, so this stays valid.
+        auto blk = blk_it->second.get();
+        // we need this one now, even if the others are all decoding
+        if (!blk->done.valid())
+            start_block (blk, args.decoding);
+        lock.unlock();
+        // the other blocks keep decoding in their own threads
+        auto res = blk->done.get();
+        if (res.error == RaptorQ__v1::Error::NONE) {
             #pragma clang diagnostic push
             #pragma clang diagnostic ignored "-Wshorten-64-to-32"
-            args.output->write (reinterpret_cast<char *> (buffer.data()),
-                                            static_cast<int64_t> (writes_left));
+            args.output->write (reinterpret_cast<char *> (blk->data.data()),
+                                            static_cast<int64_t> (blk->bytes));
             #pragma clang diagnostic pop
-            bytes_left -= writes_left;
-            if (bytes_left == 0) {
-                // early exit. we wrote everything.
-                last_symbol = dec->symbols();
-                break;
-            }
         }
-        if (last_symbol == dec->symbols()) {
-            lock.lock();
-            dec_it = args.decoders->find (current_block);
-            dec_it->second.reset (nullptr);
-            lock.unlock();
-            ++current_block;
-            last_symbol = 0;
+        lock.lock();
+        if (res.error != RaptorQ__v1::Error::NONE || args.output->fail()) {
+            // internal error, interrupted computation or not enough symbols
+            *args.status = Out_Status::ERROR;
+            args.cond->notify_all();
+            return;
+        }
+        args.blocks->erase (blk_it);
+        ++*args.written;
+        --*args.decoding;
+        for (auto &next : *args.blocks) {
+            if (*args.decoding >= args.threads)
+                break;
+            if (!next.second->done.valid())
+                start_block (next.second.get(), args.decoding);
         }
     }
-    lock.lock();
     *args.status = Out_Status::EXITED;
+    args.cond->notify_all();
 }
 
 static bool decode (const size_t bytes, const RaptorQ__v1::Block_Size symbols,
                                                     const int64_t symbol_size,
+                                                    const size_t threads,
                                                     std::istream *input,
                                                     std::ostream *output)
 {
     // false on error
-    std::vector<uint8_t> buf (static_cast<size_t> (symbol_size));
-    std::map<size_t, std::unique_ptr<Dec>> decoders;
-    size_t bytes_left = bytes;
-    size_t last_block_bytes = 0;
-    uint32_t block_number;
-    uint32_t symbol_number;
+    const size_t sym_size = static_cast<size_t> (symbol_size);
+    const size_t block_size = static_cast<size_t> (symbols) * sym_size;
+    const size_t total_blocks = (bytes + block_size - 1) / block_size;
+    const size_t packet = packet_header + sym_size;
+    // whole packets, so that only the last read leaves a partial one
+    std::vector<uint8_t> buf (std::max<size_t> (1, chunk_size / packet) *
+                                                                        packet);
+    const std::vector<uint8_t> zeros (sym_size, 0);
+    std::vector<uint8_t> last_sym;
+    std::map<size_t, std::unique_ptr<Dec_Block>> blocks;
+    size_t written = 0;
+    size_t decoding = 0;
     std::mutex mtx;
     std::condition_variable cond;
     Out_Status thread_status = Out_Status::WORKING;
     struct write_out_args args;
     args.bytes = bytes;
-    args.decoders = &decoders;
+    args.block_size = block_size;
+    args.threads = threads;
+    args.blocks = &blocks;
+    args.written = &written;
+    args.decoding = &decoding;
     args.mtx = &mtx;
     args.cond = &cond;
     args.output = output;
     args.status = &thread_status;
     std::thread write_out (print_output, args);
 
-    std::unique_lock<std::mutex> lock (mtx, std::defer_lock);
-    while (true) {
-        input->read (reinterpret_cast<char *> (&block_number),
-                                                    sizeof(block_number));
-        int64_t read = input->gcount();
-        if (read > 0 && read != sizeof(block_number)) {
-            std::cerr << "ERR: not enough data to fill block number\n";
-            thread_status = Out_Status::ERROR;
-            return false;
-        } else if (read == 0 || input->eof()) {
-            if (bytes_left == 0 && last_block_bytes !=
-                                static_cast<uint64_t> (
-                                static_cast<int64_t> (symbols) * symbol_size)) {
-                // the last block was not filled to the end.
-                // we need to pad it with additional symbols.
-                lock.lock();
-                auto dec_it = decoders.rbegin();
-                if (dec_it == decoders.rend()) {
-                    // no decoder found? we needed to pad it. err.
-                    thread_status = Out_Status::ERROR;
-                    lock.unlock();
-                    cond.notify_one();
-                    write_out.join();
-                    std::cerr << "ERR: could not pad the last block\n";
-                    return false;
-                }
-                auto dec = dec_it->second.get();
-                if (dec != nullptr) {
-                    buf.clear();
-                    buf.insert (buf.begin(),
-                                        static_cast<size_t> (symbol_size), 0);
-                    uint16_t last_symbol = static_cast<uint16_t> (
-                                        std::ceil (last_block_bytes /
-                                            static_cast<float> (symbol_size)));
-                    for (uint16_t idx = 0; idx < dec->needed_symbols(); ++idx) {
-                        auto buf_start = buf.begin();
-                        dec->add_symbol (buf_start, buf.end(),
-                                                            last_symbol + idx);
-                    }
-                }
-                lock.unlock();
-            } // else let the other thread stop, and report error
-            lock.lock();
-            if (thread_status == Out_Status::WORKING)
-                thread_status = Out_Status::GRACEFUL_STOP;
-            lock.unlock();
-            cond.notify_one();
-            // wait for all blocks to be decoded.
-            // if one can not be decoded exit with error
-            write_out.join();
-            if (thread_status == Out_Status::EXITED)
-                return true;
-            std::cerr << "ERR: not all blocks could be decoded\n";
-            return false;
+    // at most "threads" blocks decode at the same time. The others only
+    // collect their symbols, so out of order input is never refused.
+    // get the block, create the decoder if necessary.
+    // nullptr if the block has already been written.
+    auto get_block = [&] (const uint32_t block_number, bool *success) {
+        *success = true;
+        if (block_number < written)
+            return static_cast<Dec_Block *> (nullptr);
+        auto blk_it = blocks.find (block_number);
+        if (blk_it != blocks.end())
+            return blk_it->second.get();
+        if (block_number >= total_blocks) {
+            std::cerr << "ERR: additional blocks found.\n";
+            *success = false;
+            return static_cast<Dec_Block *> (nullptr);
         }
-        input->read (reinterpret_cast<char *> (&symbol_number),
-                                                    sizeof(symbol_number));
-        read = input->gcount();
-        if (read != sizeof(symbol_number)) {
-            std::cerr << "ERR: not enough data to fill symbol number\n";
-            thread_status = Out_Status::ERROR;
-            cond.notify_one();
-            write_out.join();
-            return false;
+        std::unique_ptr<Dec_Block> blk (new Dec_Block());
+        const size_t offset = static_cast<size_t> (block_number) * block_size;
+        blk->bytes = std::min (block_size, bytes - offset);
+        blk->data = std::vector<uint8_t> (block_size, 0);
+        blk->dec = std::unique_ptr<Dec> (new Dec (symbols, sym_size,
+                                            Dec::Report::COMPLETE,
+                                            blk->data.data()));
+        // the padding of the last block is all zeros
+        for (size_t id = (blk->bytes + sym_size - 1) / sym_size;
+                        id < static_cast<size_t> (symbols); ++id) {
+            blk->dec->add_symbol (zeros.data(), sym_size,
+                                                static_cast<uint32_t> (id));
         }
-        buf.clear();
-        buf.insert (buf.begin(), static_cast<size_t> (symbol_size), 0);
+        if (decoding < threads)
+            start_block (blk.get(), &decoding);
+        auto ret = blk.get();
+        blocks.emplace (block_number, std::move(blk));
+        cond.notify_all();
+        return ret;
+    };
+
+    bool success = true;
+    size_t have = 0;
+    std::unique_lock<std::mutex> lock (mtx, std::defer_lock);
+    while (success) {
         #pragma clang diagnostic push
         #pragma clang diagnostic ignored "-Wshorten-64-to-32"
-        input->read (reinterpret_cast<char *> (buf.data()), symbol_size);
+        input->read (reinterpret_cast<char *> (buf.data() + have),
+                                    static_cast<int64_t> (buf.size() - have));
         #pragma clang diagnostic pop
-        read = input->gcount();
-        if (read <= 0) {
-            std::cerr << "ERR: unexpected end";
-            thread_status = Out_Status::ERROR;
-            cond.notify_one();
-            write_out.join();
-            return false;
-        }
+        const int64_t read = input->gcount();
+        have += static_cast<size_t> (read);
+        const bool last = read <= 0 || input->eof();
+        size_t used = 0;
         lock.lock();
-        auto dec_it = decoders.find (block_number);
-        if (dec_it == decoders.end()) {
-            // add new decoder
-            bool success;
-            if (bytes_left == 0) {
-                std::cerr << "ERR: additional blocks found.\n";
-                thread_status = Out_Status::ERROR;
-                lock.unlock();
-                cond.notify_one();
-                write_out.join();
-                return false;
+        if (thread_status != Out_Status::WORKING) {
+            lock.unlock();
+            success = false;
+            break;
+        }
+        while (success && have - used >= packet_header) {
+            const uint8_t *pkt = buf.data() + used;
+            size_t sym_bytes = std::min (sym_size, have - used - packet_header);
+            if (sym_bytes != sym_size && !last)
+                break;  // wait for the rest of the packet
+            uint32_t block_number;
+            uint32_t symbol_number;
+            memcpy (&block_number, pkt, sizeof(block_number));
+            memcpy (&symbol_number, pkt + sizeof(block_number),
+                                                        sizeof(symbol_number));
+            const uint8_t *sym = pkt + packet_header;
+            if (sym_bytes == 0) {
+                std::cerr << "ERR: unexpected end\n";
+                success = false;
+                break;
+            }
+            if (sym_bytes != sym_size) {
+                // truncated input: pad the last symbol
+                last_sym = zeros;
+                std::copy (sym, sym + sym_bytes, last_sym.begin());
+                sym = last_sym.data();
+            }
+            used += packet_header + sym_bytes;
+            auto blk = get_block (block_number, &success);
+            if (blk == nullptr)
+                continue;   // already decoded (and written), or error.
+            auto err = blk->dec->add_symbol (sym, sym_size, symbol_number);
+            if (err != RaptorQ__v1::Error::NONE &&
+                                        err != RaptorQ__v1::Error::NOT_NEEDED) {
+                std::cerr << "ERR: error adding symbol\n";
+                success = false;
+            }
+        }
+        if (success && last && have != used) {
+            if (have - used < sizeof(uint32_t)) {
+                std::cerr << "ERR: not enough data to fill block number\n";
+            } else {
+                std::cerr << "ERR: not enough data to fill symbol number\n";
+            }
+            success = false;
+        }
+        if (!success || last) {
+            // wake up the decoders: either stop them or let them report
+            // that there is no more data.
+            for (auto &blk : blocks) {
+                if (success) {
+                    blk.second->dec->end_of_input (
+                                            RaptorQ__v1::Fill_With_Zeros::NO);
+                } else {
+                    blk.second->dec->stop();
+                }
             }
-            last_block_bytes = std::min (bytes_left,
-                                static_cast<size_t> (
-                                static_cast<int64_t>(symbols) * symbol_size));
-            bytes_left -= last_block_bytes;
-            std::tie (dec_it, success) = decoders.emplace (std::make_pair (
-                        block_number,
-                        std::unique_ptr<Dec> (
-                            new Dec (symbols, static_cast<size_t> (symbol_size),
-                                        Dec::Report::PARTIAL_FROM_BEGINNING))));
             if (!success) {
-                std::cerr << "ERR: Can not add decoder\n";
                 thread_status = Out_Status::ERROR;
-                lock.unlock();
-                cond.notify_one();
-                write_out.join();
-                return false;
+            } else if (thread_status == Out_Status::WORKING) {
+                thread_status = Out_Status::GRACEFUL_STOP;
             }
-        }
-        auto dec = dec_it->second.get();
-        if (dec == nullptr) { // received additional symbol for an
             lock.unlock();
-            continue;       // already decoded (and freed) block.
+            cond.notify_all();
+            break;
         }
-        auto symbol_start = buf.begin();
-        auto err = dec->add_symbol (symbol_start, buf.end(), symbol_number);
         lock.unlock();
-        if (err != RaptorQ__v1::Error::NONE &&
-                                        err != RaptorQ__v1::Error::NOT_NEEDED) {
-            std::cerr << "ERR: error adding symbol\n";
-            thread_status = Out_Status::ERROR;
-            cond.notify_one();
-            write_out.join();
+        // keep the partial packet for the next read
+        std::copy (buf.begin() + static_cast<int64_t> (used),
+                                buf.begin() + static_cast<int64_t> (have),
+                                                                buf.begin());
+        have -= used;
+    }
+    // wait for all blocks to be decoded.
+    // if one can not be decoded exit with error
+    write_out.join();
+    if (thread_status == Out_Status::EXITED)
+        return true;
+    if (success)
+        std::cerr << "ERR: not all blocks could be decoded\n";
+    return false;
+}
+
+// one block in flight in the encoder
+struct Enc_Slot
+{
+    std::unique_ptr<Enc> encoder;
+    std::vector<uint8_t> in;    // block data
+    std::vector<uint8_t> out;   // all the packets of the block
+    // last, so that it is destroyed (and waited) first.
+    std::shared_future<bool> done;
+};
+
+// encode one block in the slot, then write it after the previous one.
+static bool encode_block (Enc_Slot *slot, const uint32_t block_num,
+                                        const size_t read,
+                                        const size_t symbol_size,
+                                        const uint16_t symbols,
+                                        const uint32_t repair,
+                                        std::shared_future<bool> previous,
+                                        std::ostream *output)
+{
+    const size_t sources = (read + symbol_size - 1) / symbol_size;
+    const size_t data_size = sources * symbol_size;
+    std::fill (slot->in.begin() + static_cast<int64_t> (read),
+                        slot->in.begin() + static_cast<int64_t> (data_size), 0);
+    // Since we do not change the number of symbols for each block,
+    // we can reuse the encoder and its precomputation.
+    // just call clear_data() before feeding it the next block.
+    slot->encoder->clear_data();
+    // give the data to the encoder. It will pad it automatically.
+    size_t ret = slot->encoder->set_data (slot->in.begin(),
+                        slot->in.begin() + static_cast<int64_t> (data_size));
+    if (ret != data_size) {
+        std::cerr << "ERR: can not add block data to the encoder\n";
+        return false;
+    }
+    if (!slot->encoder->precompute_sync()) {
+        std::cerr << "ERR: encoder should never fail!\n";
+        return false;
+    }
+    const size_t packet = packet_header + symbol_size;
+    slot->out.resize ((sources + repair) * packet);
+    uint8_t *pkt = slot->out.data();
+    for (uint32_t id = 0; id < symbols + repair; ++id) {
+        if (id == sources)
+            id = symbols;   // skip the padding
+        memcpy (pkt, &block_num, sizeof(block_num));
+        memcpy (pkt + sizeof(block_num), &id, sizeof(id));
+        if (id < symbols) {
+            memcpy (pkt + packet_header, slot->in.data() + id * symbol_size,
+                                                                symbol_size);
+        } else if (slot->encoder->encode (pkt + packet_header, symbol_size,
+                                                        id) != symbol_size) {
+            std::cerr << "ERR: wrong repair symbol size\n";
             return false;
         }
-        cond.notify_one();
+        pkt += packet;
     }
+    // keep the output ordered
+    previous.wait();
+    if (!previous.get())
+        return false;
+    #pragma clang diagnostic push
+    #pragma clang diagnostic ignored "-Wshorten-64-to-32"
+    output->write (reinterpret_cast<char *> (slot->out.data()),
+                                        static_cast<int64_t> (slot->out.size()));
+    #pragma clang diagnostic pop
+    return !output->fail();
 }
 
 // encoding function. manages both input and output
+// "threads" blocks are read, encoded and written at the same time.
 static bool encode (const int64_t symbol_size,
                                         const RaptorQ__v1::Block_Size symbols,
                                         const uint32_t repair,
+                                        const size_t threads,
                                         std::istream *input,
                                         std::ostream *output)
 {
     // false on error
-    std::vector<uint8_t> buf (static_cast<size_t> (symbol_size), 0);
-    std::vector<uint8_t> block_buf;
-    block_buf.reserve (static_cast<size_t> (symbols) *
-                                            static_cast<size_t> (symbol_size));
-    // Since we do not change the number of symbols for each block,
-    // we can reuse the encoder, so that less works will be done.
-    // just call clear_data() before feeding it the next block.
-    RaptorQ__v1::Encoder<iter_8, iter_8> encoder (symbols,
-                                        static_cast<size_t> (symbol_size));
-    auto future = encoder.precompute();
-    RaptorQ__v1::Error enc_status = RaptorQ__v1::Error::INITIALIZATION;
-    uint32_t sym_num = 0;
+    const size_t sym_size = static_cast<size_t> (symbol_size);
+    const size_t block_size = static_cast<size_t> (symbols) * sym_size;
+    std::vector<Enc_Slot> slots (threads);
+    for (auto &slot : slots) {
+        slot.encoder = std::unique_ptr<Enc> (new Enc (symbols, sym_size));
+        slot.in = std::vector<uint8_t> (block_size, 0);
+    }
+    std::promise<bool> start;
+    start.set_value (true);
+    std::shared_future<bool> previous = start.get_future().share();
     uint32_t block_num = 0;
     while (true) {
-        buf.clear(); // with padding already set
-        buf.insert (buf.begin(), static_cast<size_t> (symbol_size), 0);
+        auto &slot = slots[block_num % slots.size()];
+        // wait for the slot to be written before reusing it
+        if (slot.done.valid() && !slot.done.get())
+            return false;
         #pragma clang diagnostic push
         #pragma clang diagnostic ignored "-Wshorten-64-to-32"
-        input->read (reinterpret_cast<char *> (buf.data()), symbol_size);
+        input->read (reinterpret_cast<char *> (slot.in.data()),
+                                            static_cast<int64_t> (block_size));
         #pragma clang diagnostic pop
         int64_t read = input->gcount();
-        if (read > 0) {
-            output->write (reinterpret_cast<char *> (&block_num),
-                                                            sizeof(block_num));
-            output->write (reinterpret_cast<char *> (&sym_num),sizeof(sym_num));
-            #pragma clang diagnostic push
-            #pragma clang diagnostic ignored "-Wshorten-64-to-32"
-            output->write (reinterpret_cast<char *> (buf.data()), symbol_size);
-            #pragma clang diagnostic pop
-            block_buf.insert (block_buf.end(), buf.begin(), buf.end());
-            ++sym_num;
-        }
-        if (input->eof() || read <= 0) {
-            // end of input.
-            sym_num = static_cast<uint16_t> (symbols);
-        }
+        if (read <= 0)
+            break;  // end of input.
+        slot.done = std::async (std::launch::async, encode_block, &slot,
+                                    block_num, static_cast<size_t> (read),
+                                    sym_size, static_cast<uint16_t> (symbols),
+                                    repair, previous, output).share();
+        previous = slot.done;
+        ++block_num;
+        if (input->eof())
+            break;
+    }
+    return previous.get();
+}
 
-        if (sym_num == static_cast<uint16_t> (symbols)) {
-            // give the data to the encoder. It will pad it automatically.
-            size_t ret = encoder.set_data (block_buf.begin(), block_buf.end());
-            if (ret != block_buf.size()) {
-                std::cout << "ERR: can not add block data to the decoder\n";
-                return false;
-            }
-            // we use the same future multiple times, but it has a shared state
-            // only the first time. Do not wait() the other times.
-            if (future.valid()) {
-                future.wait();
-                enc_status = future.get();
-            }
-            if (enc_status != RaptorQ__v1::Error::NONE) {
-                std::cerr << "ERR: encoder should never fail!\n";
+// check that "syms" is a usable block size. false (and a message) if not.
+static bool get_block_size (const int64_t syms,
+                                        RaptorQ__v1::Block_Size *symbols)
+{
+    if (syms < 1 || syms > 56403) {
+        std::cerr << "ERR: Symbols must be between 1 and 56403\n";
+        return false;
+    }
+    for (size_t idx = 0; idx < RaptorQ__v1::blocks->size(); ++idx) {
+        if (static_cast<uint16_t> ((*RaptorQ__v1::blocks)[idx]) >= syms) {
+            if (static_cast<uint16_t> ((*RaptorQ__v1::blocks)[idx]) > syms) {
+                size_t pre_idx = (idx == 0 ? 0 : idx - 1);
+                size_t post_idx = (idx == RaptorQ__v1::blocks->size() - 1 ?
+                                                                idx : idx + 1);
+                std::cerr << "ERR: wrong block size. Closest blocks: "
+                    << static_cast<uint32_t> ((*RaptorQ__v1::blocks)[pre_idx])
+                    << " - "
+                    << static_cast<uint32_t> ((*RaptorQ__v1::blocks)[idx])
+                    << " - "
+                    << static_cast<uint32_t> ((*RaptorQ__v1::blocks)[post_idx])
+                          << "\n";
                 return false;
             }
-            std::vector<uint8_t> rep (static_cast<size_t> (symbol_size), 0);
-            for (uint32_t rep_id = sym_num; rep_id <
-                           (static_cast<size_t> (symbols) + repair); ++rep_id) {
-                auto rep_start = rep.begin();
-                auto rep_length = encoder.encode (rep_start, rep.end(), rep_id);
-                // rep_length is actually the number of iterators written.
-                // but our iteerators are over uint8_t, so
-                // rep_length == bytes written
-                if (rep_length != static_cast<size_t> (symbol_size)) {
-                    std::cerr << "ERR: wrong repair symbol size\n";
-                    return false;
-                }
-                output->write (reinterpret_cast<char *> (&block_num),
-                                                            sizeof(block_num));
-                output->write (reinterpret_cast<char *> (&rep_id),
-                                                            sizeof(rep_id));
-                #pragma clang diagnostic push
-                #pragma clang diagnostic ignored "-Wshorten-64-to-32"
-                output->write (reinterpret_cast<char *> (rep.data()),
-                                                                symbol_size);
-                #pragma clang diagnostic pop
-            }
-            if (input->eof())
-                return true;
-            encoder.clear_data();
-            block_buf.clear();
-            ++block_num;
-            sym_num = 0;
+            *symbols = (*RaptorQ__v1::blocks)[idx];
+            return true;
         }
     }
+    return false;
 }
 
 int main (int argc, char **argv)
@@ -556,22 +668,86 @@ int main (int argc, char **argv)
     uint32_t repair = 0;
     size_t bytes = 0;
     const std::string command = std::string (argv[1]);
+    const bool bench_options = options[ALL_BLOCKS].count() != 0 ||
+                                            options[LOSS].count() != 0 ||
+                                            options[OVERHEAD].count() != 0 ||
+                                            options[CACHE].count() != 0 ||
+                                            options[RUNS].count() != 0 ||
+                                            options[CSV].count() != 0 ||
+                                            options[JSON].count() != 0;
     if (command.compare ("benchmark") == 0) {
-        if (options[SYMBOLS].count() != 0 || options[SYMBOL_SIZE].count() != 0
-                                        || options[REPAIR].count() != 0
-                                        || options[BYTES].count() != 0
-                                        || parse.nonOptionsCount() != 1) {
-            std::cerr << "ERR: \"benchmark\" does not use arguments\n";
+        // "benchmark" is a non-option only when there are no options.
+        if (options[REPAIR].count() != 0 || options[BYTES].count() != 0
+                || parse.nonOptionsCount() != (argc == 2 ? 1 : 0)) {
+            std::cerr << "ERR: \"benchmark\" does not use \"--repair\", "
+                                            "\"--bytes\" or other arguments\n";
             option::printUsage (std::cout, usage);
             return 1;
         }
-        // TODO: launch benchmark
-        // This should launch single-thread benchmark up to 1 second, then
-        // estimate the amount needed for the next blocks.
-        // Meaning we should do some interpolation?
-        // is just taking the last 3 points and getting the x^3 curve enough?
-        bench (1);
-        std::cout << "Extrapolate by yourself. cubic curve :p\n";
+        if (options[ALL_BLOCKS].count() != 0 && options[SYMBOLS].count() != 0){
+            std::cerr << "ERR: use either \"--all-blocks\" or \"--symbols\"\n";
+            return 1;
+        }
+        if (options[CSV].count() != 0 && options[JSON].count() != 0) {
+            std::cerr << "ERR: use either \"--csv\" or \"--json\"\n";
+            return 1;
+        }
+        auto values = [] (option::Option &opt,
+                                            const std::vector<size_t> &def) {
+            if (opt.count() == 0)
+                return def;
+            std::vector<size_t> res;
+            for (option::Option *it = &opt; it != nullptr;
+                                                            it = it->next()) {
+                res.push_back (static_cast<size_t> (strtol(it->arg, nullptr,
+                                                                        10)));
+            }
+            return res;
+        };
+        Bench_Params params;
+        params.all_blocks = options[ALL_BLOCKS].count() != 0;
+        if (params.all_blocks) {
+            params.blocks.assign (RaptorQ__v1::blocks->begin(),
+                                                RaptorQ__v1::blocks->end());
+        } else {
+            for (auto syms : values (options[SYMBOLS], {10, 101, 1002})) {
+                RaptorQ__v1::Block_Size blk;
+                if (!get_block_size (static_cast<int64_t> (syms), &blk))
+                    return 1;
+                params.blocks.push_back (blk);
+            }
+        }
+        params.symbol_sizes = values (options[SYMBOL_SIZE], {1280});
+        params.threads = values (options[THREADS], {1});
+        params.caches = values (options[CACHE], {0, 100});
+        for (auto loss : values (options[LOSS], {10}))
+            params.losses.push_back (static_cast<uint32_t> (loss));
+        for (auto overhead : values (options[OVERHEAD], {0}))
+            params.overheads.push_back (static_cast<uint32_t> (overhead));
+        params.runs = static_cast<uint32_t> (
+                                        values (options[RUNS], {10}).back());
+        params.format = Bench_Format::TEXT;
+        if (options[CSV].count() != 0)
+            params.format = Bench_Format::CSV;
+        if (options[JSON].count() != 0)
+            params.format = Bench_Format::JSON;
+        if (std::count (params.symbol_sizes.begin(),
+                                        params.symbol_sizes.end(), 0) != 0 ||
+                std::count (params.threads.begin(),
+                                        params.threads.end(), 0) != 0 ||
+                                                            params.runs == 0) {
+            std::cerr << "ERR: symbol size, threads and runs must be "
+                                                                "positive\n";
+            return 1;
+        }
+        for (auto loss : params.losses) {
+            if (loss >= 100) {
+                std::cerr << "ERR: \"--loss\" must be less than 100\n";
+                return 1;
+            }
+        }
+        if (!bench (params))
+            return 1;
         return 0;
     } else if (command.compare ("blocks") == 0) {
         std::cout << "Usable block sizes:\n";
@@ -583,6 +759,10 @@ int main (int argc, char **argv)
     } else if (command.compare ("encode") == 0) {
         bool err = false;
         // parameters that should NOT be here:
+        if (bench_options) {
+            std::cerr << "ERR: encoder does not use benchmark parameters\n";
+            err = true;
+        }
         if (options[BYTES].count() != 0) {
             std::cerr << "ERR: encoder does not need the \"--bytes\" "
                                                                 "parameter\n";
@@ -625,6 +805,10 @@ int main (int argc, char **argv)
     } else if (command.compare ("decode") == 0) {
         bool err = false;
         // parameters that should NOT be here:
+        if (bench_options) {
+            std::cerr << "ERR: decoder does not use benchmark parameters\n";
+            err = true;
+        }
         if (options[REPAIR].count() != 0) {
             std::cerr << "ERR: decoder does not need the \"--repair\" "
                                                                 "parameter\n";
@@ -668,34 +852,22 @@ int main (int argc, char **argv)
         return 1;
     }
 
-    const uint16_t syms = static_cast<uint16_t> (strtol(options[SYMBOLS].arg,
-                                                                nullptr, 10));
+    const int64_t syms = strtol(options[SYMBOLS].arg, nullptr, 10);
     const int64_t symbol_size =  static_cast<int64_t> (
                                 strtol(options[SYMBOL_SIZE].arg, nullptr, 10));
 
-
-    if (syms < 1 || syms > 56403) {
-        std::cerr << "ERR: Symbols must be between 1 and 56403\n";
+    RaptorQ__v1::Block_Size symbols;
+    if (!get_block_size (syms, &symbols))
         return 1;
-    }
-    RaptorQ__v1::Block_Size symbols = RaptorQ__v1::Block_Size::Block_10;
-    for (size_t idx = 0; idx < RaptorQ__v1::blocks->size(); ++idx) {
-        if (static_cast<uint16_t> ((*RaptorQ__v1::blocks)[idx]) >= syms) {
-            if (static_cast<uint16_t> ((*RaptorQ__v1::blocks)[idx]) > syms) {
-                size_t pre_idx = (idx == 0 ? 0 : idx - 1);
-                size_t post_idx = (idx == RaptorQ__v1::blocks->size() - 1 ?
-                                                                idx : idx + 1);
-                std::cerr << "ERR: wrong block size. Closest blocks: "
-                    << static_cast<uint32_t> ((*RaptorQ__v1::blocks)[pre_idx])
-                    << " - "
-                    << static_cast<uint32_t> ((*RaptorQ__v1::blocks)[idx])
-                    << " - "
-                    << static_cast<uint32_t> ((*RaptorQ__v1::blocks)[post_idx])
-                          << "\n";
-                return 1;
-            }
-            symbols = (*RaptorQ__v1::blocks)[idx];
-            break;
+
+    size_t threads = std::max<size_t> (1,
+                                        std::thread::hardware_concurrency());
+    if (options[THREADS].count() != 0) {
+        threads = static_cast<size_t> (strtol(options[THREADS].last()->arg,
+                                                                nullptr, 10));
+        if (threads == 0) {
+            std::cerr << "ERR: \"--threads\" must be positive\n";
+            return 1;
         }
     }
 
@@ -703,6 +875,8 @@ int main (int argc, char **argv)
     const std::string output_file = parse.nonOption (1);
 
 
+    // we only do big reads and writes
+    std::ios_base::sync_with_stdio (false);
     // try to open input/output files
     std::istream *input;
     std::ostream *output;
@@ -731,11 +905,11 @@ int main (int argc, char **argv)
     }
 
     if (command.compare ("encode") == 0) {
-        if (encode (symbol_size, symbols, repair, input, output))
+        if (encode (symbol_size, symbols, repair, threads, input, output))
             return 0;
         return 1;
     } else {
-        if (decode(bytes, symbols, symbol_size, input, output))
+        if (decode(bytes, symbols, symbol_size, threads, input, output))
             return 0;
         return 1;
     }
@@ -764,96 +938,291 @@ private:
 };
 
 
-void bench (uint32_t seconds)
+
+// one point of the benchmark sweep
+struct Bench_Config
 {
-    // max 100MB of cache
-    // up to block size 10120 (more or less)
-    RaptorQ__v1::local_cache_size (1024*1024*100);
-    std::cout << "S: block size.\n";
-    std::cout << "A: average microseconds\n";
-    std::cout << "EF: encoder microseconds without precomputation\n";
-    std::cout << "EP: encoder microseconds with    precomputation\n";
-    std::cout << "DF: decoder microseconds without precomputation\n";
-    std::cout << "DP: decoder microseconds with    precomputation\n";
-    // do benchmarks until we find a block that stays "seconds" secs to crunch.
-    // then extrapolate the rest.
-    for (auto blk : *RaptorQ__v1::blocks) {
-        constexpr size_t symbol_size = 1280;    // min supported ipv6 payload
-                                                // kinda arbitrary anyway.
-        using T = typename std::vector<uint8_t>;
-        T data (symbol_size * static_cast<uint16_t> (blk), 0);
-
-        RaptorQ__v1::Encoder<T::iterator, T::iterator> encoder (
-                                                            blk, symbol_size);
-        encoder.set_data (data.begin(), data.end());
-        Timer time;
-        time.start();
-        if (!encoder.compute_sync()) {
-            std::cerr << "Could not encode??\n";
-            return;
-        }
-        auto microsec_encode_full = time.stop();
-        // now test after precomputation:
-        encoder.clear_data();
-        encoder.precompute_sync();
-        encoder.set_data (data.begin(), data.end());
+    RaptorQ__v1::Block_Size block;
+    size_t symbol_size;
+    uint32_t loss;
+    uint32_t overhead;
+    size_t threads;
+    size_t cache;
+};
+
+// input of the encoders and decoders. The same for all the threads.
+struct Bench_Data
+{
+    std::vector<uint8_t> source;
+    uint32_t repair;                // repair symbols for the decoder
+    std::vector<uint8_t> received;  // what the decoder gets,
+    std::vector<uint32_t> esi;      // and the ids of the symbols
+};
+
+// timings of one operation, one per run
+struct Bench_Result
+{
+    const char *op;
+    size_t bytes;   // source bytes worked on in each run
+    uint32_t failures;
+    std::vector<int64_t> microsec;
+};
+
+static bool bench_prepare (const Bench_Config &conf, std::mt19937 *rnd,
+                                                            Bench_Data *data)
+{
+    const uint16_t symbols = static_cast<uint16_t> (conf.block);
+    data->source.resize (symbols * conf.symbol_size);
+    for (auto &byte : data->source)
+        byte = static_cast<uint8_t> ((*rnd)());
+    // lose random source symbols, and replace them with repair symbols
+    std::vector<uint32_t> ids (symbols);
+    std::iota (ids.begin(), ids.end(), 0);
+    std::shuffle (ids.begin(), ids.end(), *rnd);
+    const uint32_t lost = (symbols * conf.loss + 50) / 100;
+    ids.resize (symbols - lost);
+    std::sort (ids.begin(), ids.end());
+    data->repair = lost + conf.overhead;
+    Enc encoder (conf.block, conf.symbol_size);
+    encoder.set_data (data->source.begin(), data->source.end());
+    if (!encoder.compute_sync())
+        return false;
+    data->received.clear();
+    data->esi = ids;
+    for (auto id : ids) {
+        data->received.insert (data->received.end(),
+                    data->source.begin() + id * conf.symbol_size,
+                    data->source.begin() + (id + 1) * conf.symbol_size);
+    }
+    const size_t received = data->received.size();
+    data->received.resize (received + data->repair * conf.symbol_size);
+    if (encoder.encode_range (data->received.data() + received,
+                            data->repair * conf.symbol_size, symbols,
+                                                data->repair) != data->repair) {
+        return false;
+    }
+    for (uint32_t id = symbols; id < symbols + data->repair; ++id)
+        data->esi.push_back (id);
+    return true;
+}
+
+// empty the cache, but keep it enabled.
+// The shared plans would skip the precode matrix too: drop them.
+static void bench_flush_cache (const size_t cache_mb)
+{
+    RaptorQ__v1::local_cache_size (0);
+    RaptorQ__v1::local_cache_size (cache_mb * 1024 * 1024);
+    RaptorQ__v1::clear_plan_cache();
+}
+
+// run "job" on "threads" threads at the same time, "runs" times.
+// "prepare" is called before each run, and is not timed.
+static Bench_Result bench_op (const char *op, const Bench_Config &conf,
+                                    const uint32_t runs,
+                                    const std::function<void()> &prepare,
+                                    const std::function<bool (size_t)> &job)
+{
+    Bench_Result res;
+    res.op = op;
+    res.bytes = conf.threads * static_cast<uint16_t> (conf.block) *
+                                                            conf.symbol_size;
+    res.failures = 0;
+    Timer time;
+    for (uint32_t run = 0; run < runs; ++run) {
+        if (prepare)
+            prepare();
         time.start();
-        if (!encoder.compute_sync()) {
-            std::cerr << "Could not encode??\n";
-            return;
-        }
-        auto microsec_encode_pre = time.stop();
-        const uint32_t max_symbol = static_cast<uint16_t> (blk) + 5;
-        std::vector<T> encoded (max_symbol);
-        for (uint32_t id = 1; id <= max_symbol; ++id) {
-            // skip the first so the decoder can do its work
-            encoded[id - 1] = T (symbol_size, 0);
-            auto b_it = encoded[id - 1].begin();
-            encoder.encode (b_it, encoded[id - 1].end(), id);
+        std::vector<std::future<bool>> others;
+        for (size_t idx = 1; idx < conf.threads; ++idx)
+            others.push_back (std::async (std::launch::async, job, idx));
+        if (!job (0))
+            ++res.failures;
+        for (auto &other : others) {
+            if (!other.get())
+                ++res.failures;
         }
+        res.microsec.push_back (time.stop().count());
+    }
+    return res;
+}
 
-        using Dec_t = typename RaptorQ__v1::Decoder<T::iterator, T::iterator>;
-        Dec_t decoder (blk, symbol_size, Dec_t::Report::COMPLETE);
-        uint32_t id = 1;
-        for (auto &sym : encoded) {
-            auto b_it = sym.begin();
-            decoder.add_symbol (b_it, sym.end(), id++);
-        }
-        time.start();
-        auto dec_res = decoder.decode_once();
-        auto microsec_decode_full = time.stop();
-        if (dec_res != RaptorQ__v1::Decoder_Result::DECODED) {
-            std::cerr << "Could not decode size " << static_cast<uint32_t> (blk)
-                                                                        << "\n";
-            microsec_decode_full = std::chrono::microseconds (0);
-            // do not return. can happen :(
-        }
-        std::chrono::microseconds microsec_decode_pre (0);
-        if (microsec_decode_full.count() > 0) {
-            // try to decode again, so that precomputation is used.
-            Dec_t dec_pre (blk, symbol_size, Dec_t::Report::COMPLETE);
-            id = 1;
-            for (auto &sym : encoded) {
-                auto b_it = sym.begin();
-                dec_pre.add_symbol (b_it, sym.end(), id++);
+static void bench_print (const Bench_Format format, const Bench_Config &conf,
+                                        const Bench_Result &res, bool *first)
+{
+    auto sorted = res.microsec;
+    std::sort (sorted.begin(), sorted.end());
+    const size_t n = sorted.size();
+    const int64_t median = (n % 2 == 1 ? sorted[n / 2] :
+                                    (sorted[n / 2 - 1] + sorted[n / 2]) / 2);
+    // nearest rank
+    const int64_t p99 = sorted[(n * 99 + 99) / 100 - 1];
+    // bytes per microsecond == MB/s
+    const double mb_s = static_cast<double> (res.bytes) /
+                            static_cast<double> (std::max<int64_t> (1, median));
+
+    const uint32_t symbols = static_cast<uint16_t> (conf.block);
+    switch (format) {
+    case Bench_Format::TEXT:
+        std::cout << std::setw (6) << symbols << std::setw (6)
+                    << conf.symbol_size << std::setw (5) << conf.loss
+                    << std::setw (5) << conf.overhead << std::setw (4)
+                    << conf.threads << std::setw (6) << conf.cache << "  "
+                    << std::left << std::setw (19) << res.op << std::right
+                    << std::setw (5) << n << std::setw (5) << res.failures
+                    << std::setw (11) << median << std::setw (11) << p99
+                    << std::setw (10) << std::fixed << std::setprecision (2)
+                                                            << mb_s << "\n";
+        break;
+    case Bench_Format::CSV:
+        std::cout << symbols << "," << conf.symbol_size << "," << conf.loss
+                    << "," << conf.overhead << "," << conf.threads << ","
+                    << conf.cache << "," << res.op << "," << n << ","
+                    << res.failures << "," << median << "," << p99 << ","
+                    << std::fixed << std::setprecision (2) << mb_s << "\n";
+        break;
+    case Bench_Format::JSON:
+        std::cout << (*first ? "\n" : ",\n") << "  {\"symbols\": " << symbols
+                    << ", \"symbol_size\": " << conf.symbol_size
+                    << ", \"loss\": " << conf.loss
+                    << ", \"overhead\": " << conf.overhead
+                    << ", \"threads\": " << conf.threads
+                    << ", \"cache_mb\": " << conf.cache
+                    << ", \"op\": \"" << res.op << "\""
+                    << ", \"runs\": " << n
+                    << ", \"failures\": " << res.failures
+                    << ", \"median_us\": " << median
+                    << ", \"p99_us\": " << p99
+                    << ", \"mb_s\": " << std::fixed << std::setprecision (2)
+                                                            << mb_s << "}";
+        break;
+    }
+    *first = false;
+}
+
+// measure all the operations on a single point of the sweep.
+// "slowest" is updated with the slowest run.
+static bool bench_point (const Bench_Params &params, const Bench_Config &conf,
+                        std::mt19937 *rnd, bool *first, int64_t *slowest)
+{
+    const auto blk = conf.block;
+    const auto symbol_size = conf.symbol_size;
+    const auto threads = conf.threads;
+    const auto cache = conf.cache;
+    Bench_Data data;
+    if (!bench_prepare (conf, rnd, &data)) {
+        std::cerr << "ERR: could not encode " << static_cast<uint32_t> (blk)
+                                                                    << "\n";
+        return false;
+    }
+    const uint16_t symbols = static_cast<uint16_t> (blk);
+    std::vector<std::vector<uint8_t>> out (threads,
+                        std::vector<uint8_t> (data.repair * symbol_size, 0));
+    auto flush = [cache] () { bench_flush_cache (cache); };
+    auto encode = [&] (size_t idx) {
+        Enc encoder (blk, symbol_size);
+        encoder.set_data (data.source.begin(), data.source.end());
+        if (!encoder.compute_sync())
+            return false;
+        return encoder.encode_range (out[idx].data(), out[idx].size(),
+                                        symbols, data.repair) == data.repair;
+    };
+    std::vector<std::unique_ptr<Enc>> encoders;
+    for (size_t idx = 0; idx < threads; ++idx) {
+        encoders.emplace_back (new Enc (blk, symbol_size));
+        encoders.back()->precompute_sync();
+    }
+    auto encode_pre = [&] (size_t idx) {
+        auto encoder = encoders[idx].get();
+        encoder->clear_data();
+        encoder->set_data (data.source.begin(), data.source.end());
+        if (!encoder->precompute_sync())
+            return false;
+        return encoder->encode_range (out[idx].data(), out[idx].size(),
+                                        symbols, data.repair) == data.repair;
+    };
+    auto decode = [&] (size_t) {
+        Dec decoder (blk, symbol_size, Dec::Report::COMPLETE);
+        decoder.add_symbols (data.received.data(), data.received.size(),
+                data.esi.data(), static_cast<uint32_t> (data.esi.size()));
+        return decoder.decode_once() == RaptorQ__v1::Decoder_Result::DECODED;
+    };
+
+    std::vector<Bench_Result> results;
+    results.push_back (bench_op ("encode", conf, params.runs, flush, encode));
+    if (cache != 0) {
+        results.push_back (bench_op ("encode_cached", conf, params.runs,
+                                                            nullptr, encode));
+    }
+    results.push_back (bench_op ("encode_precomputed", conf, params.runs,
+                                                        nullptr, encode_pre));
+    results.push_back (bench_op ("decode", conf, params.runs, flush, decode));
+    if (cache != 0) {
+        results.push_back (bench_op ("decode_cached", conf, params.runs,
+                                                            nullptr, decode));
+    }
+    for (const auto &res : results) {
+        bench_print (params.format, conf, res, first);
+        *slowest = std::max (*slowest, *std::max_element (
+                                res.microsec.begin(), res.microsec.end()));
+    }
+    return true;
+}
+
+// measure all the combinations of "params".
+// timings are in microseconds, for all the threads together:
+//  encode:             new encoder, compute and generate the repair symbols,
+//                      with an empty cache and no shared plans.
+//  encode_cached:      same, with the cache and the plans already filled.
+//  encode_precomputed: encoder reused after clear_data().
+//  decode:             new decoder, add the symbols and decode,
+//                      with an empty cache and no shared plans.
+//  decode_cached:      same, with the cache and the plans already filled.
+static bool bench (const Bench_Params &params)
+{
+    // same data for every build, so that results can be compared.
+    std::mt19937 rnd (42);
+    switch (params.format) {
+    case Bench_Format::TEXT:
+        std::cout << "     K  size loss  ovh thr cache  op                 "
+                        "runs fail  median_us     p99_us      MB/s\n";
+        break;
+    case Bench_Format::CSV:
+        std::cout << "symbols,symbol_size,loss,overhead,threads,cache_mb,op,"
+                                    "runs,failures,median_us,p99_us,mb_s\n";
+        break;
+    case Bench_Format::JSON:
+        std::cout << "[";
+        break;
+    }
+    bool first = true;
+    Bench_Config conf;
+    for (const auto cache : params.caches) {
+        conf.cache = cache;
+        bench_flush_cache (cache);
+        for (const auto blk : params.blocks) {
+            conf.block = blk;
+            int64_t slowest = 0;
+            for (const auto symbol_size : params.symbol_sizes) {
+                conf.symbol_size = symbol_size;
+                for (const auto threads : params.threads) {
+                    conf.threads = threads;
+                    for (const auto loss : params.losses) {
+                        conf.loss = loss;
+                        for (const auto overhead : params.overheads) {
+                            conf.overhead = overhead;
+                            if (!bench_point (params, conf, &rnd, &first,
+                                                                &slowest)) {
+                                return false;
+                            }
+                        }
+                    }
+                }
             }
-            time.start();
-            dec_res = dec_pre.decode_once();
-            microsec_decode_pre = time.stop();
-        }
-
-        auto avg_microsec = (microsec_encode_full +
-                             microsec_encode_pre +
-                             microsec_decode_full +
-                             microsec_decode_pre) / 4;
-
-        std::cout << "  S: " << static_cast<uint32_t> (blk) <<
-                                " A: "  << avg_microsec.count() <<
-                                " EF: " << microsec_encode_full.count() <<
-                                " EP: " << microsec_encode_pre.count() <<
-                                " DF: "  << microsec_decode_full.count() <<
-                                " DP: "  << microsec_decode_pre.count() << "\n";
-        if (avg_microsec > std::chrono::seconds (seconds))
-            break;
+            if (params.all_blocks && slowest > 1000000)
+                break;
+        }
     }
+    if (params.format == Bench_Format::JSON)
+        std::cout << "\n]\n";
+    return true;
 }
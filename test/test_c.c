@@ -357,10 +357,17 @@ int main (void)
 #ifdef RQ_USE_LZ4
     rfc->set_compression (RQ_COMPRESS_LZ4);
 #else
-    RaptorQ_set_compression (RQ_COMPRESS_NONE);
+    rfc->set_compression (RQ_COMPRESS_NONE);
 #endif
     rfc->local_cache_size (100*1024*1024);
     rfc->set_thread_pool (2, 2, RQ_WORK_ABORT_COMPUTATION);
+    // known placements are accepted, anything else is refused
+    if (!rfc->set_thread_pool_affinity (RQ_AFFINITY_CPU) ||
+            rfc->set_thread_pool_affinity ((RFC6330_Pool_Affinity) 7)) {
+        fprintf(stderr, "ERR: wrong thread pool affinity result\n");
+        RFC6330_free_api ((struct RFC6330_base_api**)&rfc);
+        return 1;
+    }
     // encode and decode
     bool ret = decode (rfc, 501, 20.0, 4);
 
@@ -0,0 +1,241 @@
+/*
+ * Copyright (c) 2015-2018, Luca Fulchir<luker@fulchir.it>, All rights reserved.
+ *
+ * This file is part of "libRaptorQ".
+ *
+ * libRaptorQ is free software: you can redistribute it and/or modify
+ * it under the terms of the GNU Lesser General Public License as
+ * published by the Free Software Foundation, either version 3
+ * of the License, or (at your option) any later version.
+ *
+ * libRaptorQ is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ * GNU General Public License for more details.
+ *
+ * You should have received a copy of the GNU General Public License
+ * and a copy of the GNU Lesser General Public License
+ * along with libRaptorQ.  If not, see <http://www.gnu.org/licenses/>.
+ */
+
+#include "../src/RaptorQ/RaptorQ.h"
+#include "../src/RaptorQ/RFC6330.h"
+#include <stdbool.h>
+#include <stdint.h>
+#include <stdio.h>
+#include <stdlib.h>
+#include <string.h>
+#include <time.h>
+
+
+// The batch operations of the C interfaces:
+// RAW: encode_range, encode_list -> add_symbols
+// RFC: encode_range -> add_symbols -> decode_blocks, with more sub-blocks
+
+static uint8_t *random_input (const size_t size);
+static uint8_t *random_input (const size_t size)
+{
+    uint8_t *data = (uint8_t *) malloc (size);
+    for (size_t i = 0; i < size; ++i)
+        data[i] = (uint8_t) rand();
+    return data;
+}
+
+bool raw_batch (struct RaptorQ_v1 *raw);
+bool raw_batch (struct RaptorQ_v1 *raw)
+{
+    const size_t symbol_size = 64;
+    const uint32_t symbols = 101;
+    const size_t size = symbols * symbol_size;
+    uint8_t *input = random_input (size);
+    bool ret = false;
+
+    struct RaptorQ_ptr *enc = raw->Encoder (RQ_ENC_8, RQ_Block_101,
+                                                                symbol_size);
+    struct RaptorQ_ptr *dec = raw->Decoder (RQ_DEC_8, RQ_Block_101,
+                                                    symbol_size, RQ_COMPLETE);
+    // source symbols with encode_range, one in four lost.
+    // the same number of repair symbols with encode_list.
+    const uint32_t repairs = symbols / 4 + 1 + 4;
+    uint8_t *sent = (uint8_t *) malloc ((symbols + repairs) * symbol_size);
+    uint32_t *esi = (uint32_t *) malloc ((symbols + repairs) *
+                                                            sizeof(uint32_t));
+    uint8_t *received = (uint8_t *) calloc (size, 1);
+    void *from = input;
+    if (enc == NULL || dec == NULL || !raw->initialized (enc) ||
+                                            !raw->initialized (dec) ||
+                                            raw->set_data (enc, &from, size) !=
+                                                                        size ||
+                                            !raw->compute_sync (enc)) {
+        fprintf (stderr, "RAW: could not initialize\n");
+        goto end;
+    }
+    if (raw->encode_range (enc, sent, symbols * symbol_size, 0, symbols) !=
+                                                                    symbols ||
+                                memcmp (sent, input, symbols * symbol_size)) {
+        fprintf (stderr, "RAW: encode_range failed\n");
+        goto end;
+    }
+    uint32_t count = 0;
+    for (uint32_t id = 0; id < symbols; ++id) {
+        if (id % 4 == 0)
+            continue;
+        memmove (sent + count * symbol_size, sent + id * symbol_size,
+                                                                symbol_size);
+        esi[count++] = id;
+    }
+    for (uint32_t idx = 0; idx < repairs; ++idx)
+        esi[count + idx] = symbols + 2 * idx;
+    if (raw->encode_list (enc, sent + count * symbol_size,
+                                                    repairs * symbol_size,
+                                                    esi + count, repairs) !=
+                                                                    repairs) {
+        fprintf (stderr, "RAW: encode_list failed\n");
+        goto end;
+    }
+    count += repairs;
+    if (raw->add_symbols (dec, sent, count * symbol_size, esi, count) !=
+                                                                    count) {
+        fprintf (stderr, "RAW: add_symbols failed\n");
+        goto end;
+    }
+    raw->end_of_input (dec, RQ_NO_FILL);
+    struct RaptorQ_Dec_wait_res res = raw->wait_sync (dec);
+    if (res.error != RQ_ERR_NONE) {
+        fprintf (stderr, "RAW: could not decode\n");
+        goto end;
+    }
+    void *out = received;
+    struct RaptorQ_Dec_Written written = raw->decode_bytes (dec, &out, size,
+                                                                        0, 0);
+    if (written.written != size || memcmp (input, received, size)) {
+        fprintf (stderr, "RAW: wrong output\n");
+        goto end;
+    }
+    printf ("RAW batch: ok\n");
+    ret = true;
+end:
+    raw->free (&enc);
+    raw->free (&dec);
+    free (input);
+    free (sent);
+    free (esi);
+    free (received);
+    return ret;
+}
+
+bool rfc_batch (struct RFC6330_v1 *rfc, const size_t size,
+                                                const uint16_t min_subsymbol,
+                                                const size_t max_sub_block);
+bool rfc_batch (struct RFC6330_v1 *rfc, const size_t size,
+                                                const uint16_t min_subsymbol,
+                                                const size_t max_sub_block)
+{
+    const uint16_t symbol_size = 1024;
+    uint8_t *input = random_input (size);
+    uint8_t *sent = NULL, *received = NULL, *sbns = NULL;
+    uint32_t *ids = NULL;
+    struct RFC6330_ptr *dec = NULL;
+    bool ret = false;
+
+    struct RFC6330_ptr *enc = rfc->Encoder (RQ_ENC_8, input, size,
+                                                min_subsymbol, symbol_size,
+                                                max_sub_block);
+    if (enc == NULL || !rfc->initialized (enc)) {
+        fprintf (stderr, "RFC: could not initialize the encoder\n");
+        goto end;
+    }
+    struct RFC6330_future *async_enc = rfc->compute (enc, RQ_COMPUTE_COMPLETE);
+    rfc->future_wait (async_enc);
+    rfc->future_free (&async_enc);
+
+    // every third source symbol is lost, and replaced by a repair symbol
+    const uint8_t blocks = rfc->blocks (enc);
+    uint32_t total = 0;
+    for (uint8_t sbn = 0; sbn < blocks; ++sbn)
+        total += rfc->symbols (enc, sbn) * 2u + 4;
+    sent = (uint8_t *) malloc (total * symbol_size);
+    ids = (uint32_t *) malloc (total * sizeof(uint32_t));
+    uint32_t count = 0;
+    for (uint8_t sbn = 0; sbn < blocks; ++sbn) {
+        const uint32_t syms = rfc->symbols (enc, sbn);
+        const uint32_t block_count = syms + syms / 3 + 4;
+        uint8_t *block = sent + count * symbol_size;
+        if (rfc->encode_range (enc, block, block_count * symbol_size, 0,
+                                            block_count, sbn) != block_count) {
+            fprintf (stderr, "RFC: encode_range failed\n");
+            goto end;
+        }
+        uint32_t kept = 0;
+        for (uint32_t esi = 0; esi < block_count; ++esi) {
+            if (esi < syms && esi % 3 == 0)
+                continue;
+            memmove (block + kept * symbol_size, block + esi * symbol_size,
+                                                                symbol_size);
+            ids[count + kept++] = rfc->id (esi, sbn);
+        }
+        count += kept;
+    }
+
+    dec = rfc->Decoder (RQ_DEC_8, rfc->OTI_Common (enc),
+                                                rfc->OTI_Scheme_Specific (enc));
+    if (dec == NULL || !rfc->initialized (dec)) {
+        fprintf (stderr, "RFC: could not initialize the decoder\n");
+        goto end;
+    }
+    struct RFC6330_future *async_dec = rfc->compute (dec, RQ_COMPUTE_COMPLETE);
+    if (rfc->add_symbols (dec, sent, count * symbol_size, ids, count) !=
+                                                                    count) {
+        fprintf (stderr, "RFC: add_symbols failed\n");
+        rfc->future_free (&async_dec);
+        goto end;
+    }
+    rfc->end_of_input (dec, RQ_NO_FILL);
+    rfc->future_wait (async_dec);
+    struct RFC6330_Result res = rfc->future_get (async_dec);
+    rfc->future_free (&async_dec);
+    if (res.error != RQ_ERR_NONE) {
+        fprintf (stderr, "RFC: could not decode\n");
+        goto end;
+    }
+    sbns = (uint8_t *) malloc (blocks);
+    for (uint8_t sbn = 0; sbn < blocks; ++sbn)
+        sbns[sbn] = sbn;
+    received = (uint8_t *) calloc (size, 1);
+    void *out = received;
+    if (rfc->decode_blocks (dec, &out, size, sbns, blocks) != size ||
+                                                memcmp (input, received, size)) {
+        fprintf (stderr, "RFC: wrong output\n");
+        goto end;
+    }
+    printf ("RFC batch, %u blocks: ok\n", (uint32_t) blocks);
+    ret = true;
+end:
+    rfc->free (&enc);
+    rfc->free (&dec);
+    free (input);
+    free (sent);
+    free (ids);
+    free (sbns);
+    free (received);
+    return ret;
+}
+
+int main (void)
+{
+    srand ((uint32_t) time (NULL));
+    struct RaptorQ_v1 *raw = (struct RaptorQ_v1*) RaptorQ_api (1);
+    struct RFC6330_v1 *rfc = (struct RFC6330_v1*) RFC6330_api (1);
+    if (raw == NULL || rfc == NULL) {
+        fprintf (stderr, "ERR: could not get the APIs\n");
+        return 1;
+    }
+    // one sub-block, then more sub-blocks and blocks
+    bool ret = raw_batch (raw) && rfc_batch (rfc, 100000, 8, 1024 * 1024) &&
+                                    rfc_batch (rfc, 100000, 8, 40000) &&
+                                    rfc_batch (rfc, 512 * 1024, 256, 20000);
+
+    RaptorQ_free_api ((struct RaptorQ_base_api**)&raw);
+    RFC6330_free_api ((struct RFC6330_base_api**)&rfc);
+    return (ret == true ? 0 : -1);
+}
@@ -0,0 +1,190 @@
+/*
+ * Copyright (c) 2015-2018, Luca Fulchir<luker@fulchir.it>, All rights reserved.
+ *
+ * This file is part of "libRaptorQ".
+ *
+ * libRaptorQ is free software: you can redistribute it and/or modify
+ * it under the terms of the GNU Lesser General Public License as
+ * published by the Free Software Foundation, either version 3
+ * of the License, or (at your option) any later version.
+ *
+ * libRaptorQ is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ * GNU General Public License for more details.
+ *
+ * You should have received a copy of the GNU General Public License
+ * and a copy of the GNU Lesser General Public License
+ * along with libRaptorQ.  If not, see <http://www.gnu.org/licenses/>.
+ */
+
+#if defined (TEST_HDR_ONLY)
+    #include "../src/RaptorQ/RaptorQ_v1_hdr.hpp"
+#else
+    #include "../src/RaptorQ/RaptorQ_v1.hpp"
+#endif
+#include "test_common.hpp"
+#include <algorithm>
+#include <iostream>
+#include <random>
+#include <vector>
+
+// The encoder uses the cached matrix directly on contiguous input,
+// and the decoders use it to only solve for the lost symbols.
+// The size accounting of the matrix cache: however many matrices we add,
+// the cache never holds more than its size, and shrinking it
+// drops exactly what is there.
+
+namespace Impl = RaptorQ__v1::Impl;
+
+using Cache = Impl::DLF<std::vector<uint8_t>, Impl::Cache_Key>;
+
+static Impl::Cache_Key key (const uint16_t id)
+{
+    const std::vector<bool> empty;
+    return Impl::Cache_Key (id, 0, 0, empty, empty);
+}
+
+// how many of the first "added" keys are still cached
+static uint16_t cached (const uint16_t added)
+{
+    uint16_t ret = 0;
+    for (uint16_t id = 1; id <= added; ++id) {
+        if (Cache::get()->get (key (id)).second.size() != 0)
+            ++ret;
+    }
+    return ret;
+}
+
+// without the cache (the input is copied), adding the matrix to the cache,
+// using the cached one (the input is only mapped): always the same symbols.
+static bool mapped (std::mt19937_64 &rnd)
+{
+    std::cout << "Cached matrix\n";
+    const RaptorQ__v1::Block_Size block = RaptorQ__v1::Block_Size::Block_1002;
+    const size_t symbol_size = 64;
+    // the last symbol is not complete
+    const size_t size = static_cast<size_t> (block) * symbol_size - 10;
+    auto input = random_input (rnd, size);
+    const uint16_t L = Impl::Parameters (static_cast<uint16_t> (block)).L;
+
+    const size_t caches[] = { 0, 50 * 1024 * 1024, 50 * 1024 * 1024 };
+    std::vector<std::vector<uint8_t>> sent;
+    for (const size_t cache : caches) {
+        Cache::get()->resize (cache);
+        if (sent.size() == 2 &&
+                            Cache::get()->get (key (L)).second.size() == 0) {
+            std::cout << "Matrix not cached\n";
+            return false;
+        }
+        RaptorQ__v1::Encoder<uint8_t*, uint8_t*> enc (block, symbol_size);
+        if (!init_encoder (enc, input))
+            return false;
+        const uint32_t total = enc.symbols() + 20;
+        std::vector<uint8_t> out (total * symbol_size);
+        if (enc.encode_range (out.data(), out.size(), 0, total) != total) {
+            std::cout << "Could not encode.\n";
+            return false;
+        }
+        sent.push_back (std::move (out));
+    }
+    if (sent[1] != sent[0] || sent[2] != sent[0]) {
+        std::cout << "Different symbols with the cache\n";
+        return false;
+    }
+    Cache::get()->resize (0);
+    return true;
+}
+
+// the encoder matrix is cached: the decoders solve only for the holes.
+static bool low_rank (std::mt19937_64 &rnd)
+{
+    std::cout << "Low rank decoding\n";
+    const RaptorQ__v1::Block_Size block = RaptorQ__v1::Block_Size::Block_1002;
+    const size_t symbol_size = 32;
+    const uint16_t L = Impl::Parameters (static_cast<uint16_t> (block)).L;
+
+    Cache::get()->resize (50 * 1024 * 1024);
+    const uint32_t syms = static_cast<uint32_t> (block);
+    const uint32_t max_repair = 64;
+    std::vector<uint8_t> input, sent;
+    using Enc = RaptorQ__v1::Encoder<uint8_t*, uint8_t*>;
+    if (!encode_block<Enc> (rnd, block, symbol_size, syms + max_repair, input,
+                                                                        sent)) {
+        return false;
+    }
+    if (Cache::get()->get (key (L)).second.size() == 0) {
+        std::cout << "Matrix not cached\n";
+        return false;
+    }
+    std::vector<uint32_t> ids (syms);
+    for (uint32_t id = 0; id < syms; ++id)
+        ids[id] = id;
+    const uint32_t losses[] = { 0, 1, 10, 60 };
+    for (const uint32_t loss : losses) {
+        std::shuffle (ids.begin(), ids.end(), rnd);
+        RaptorQ__v1::Decoder<uint8_t*, uint8_t*> dec (block, symbol_size,
+                    RaptorQ__v1::Decoder<uint8_t*, uint8_t*>::Report::COMPLETE);
+        // the repair symbols first, in reverse, then the source ones.
+        for (uint32_t esi = syms + loss + 4; esi > syms; --esi) {
+            uint8_t *sym = sent.data() + (esi - 1) * symbol_size;
+            dec.add_symbol (sym, sym + symbol_size, esi - 1);
+        }
+        for (uint32_t idx = loss; idx < syms; ++idx) {
+            uint8_t *sym = sent.data() + ids[idx] * symbol_size;
+            dec.add_symbol (sym, sym + symbol_size, ids[idx]);
+        }
+        dec.end_of_input (RaptorQ__v1::Fill_With_Zeros::NO);
+        if (dec.wait_sync().error != RaptorQ__v1::Error::NONE) {
+            std::cout << "Couldn't decode " << loss << " holes\n";
+            return false;
+        }
+        if (!check_output (dec, input)) {
+            std::cout << "With " << loss << " holes\n";
+            return false;
+        }
+    }
+    Cache::get()->resize (0);
+    return true;
+}
+
+int main (void)
+{
+    std::random_device rd;
+    std::mt19937_64 rnd (rd());
+    if (!mapped (rnd) || !low_rank (rnd))
+        return -1;
+
+    std::cout << "Cache accounting\n";
+    // room for three matrices, and some free space left.
+    const size_t matrix = 100000;
+    const uint16_t fit = 3;
+    Cache::get()->resize (fit * matrix + matrix / 2);
+
+    for (uint16_t id = 1; id <= 20; ++id) {
+        std::vector<uint8_t> raw (matrix, static_cast<uint8_t> (id));
+        Cache::get()->add (RaptorQ__v1::Compress::NONE, raw, key (id));
+        const uint16_t count = cached (id);
+        if (count > fit) {
+            std::cout << "After " << id << " adds: " << count << " cached\n";
+            return -1;
+        }
+    }
+    if (cached (20) == 0) {
+        std::cout << "Nothing cached\n";
+        return -1;
+    }
+    // shrinking must free exactly what we have
+    Cache::get()->resize (matrix + matrix / 2);
+    if (cached (20) > 1) {
+        std::cout << "Shrinking left " << cached (20) << " matrices\n";
+        return -1;
+    }
+    Cache::get()->resize (0);
+    if (cached (20) != 0) {
+        std::cout << "Empty cache still has data\n";
+        return -1;
+    }
+    std::cout << "All tests passed\n";
+    return 0;
+}
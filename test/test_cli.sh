@@ -0,0 +1,115 @@
+#!/bin/sh
+#
+# Copyright (c) 2015-2018, Luca Fulchir<luker@fulchir.it>, All rights reserved.
+#
+# This file is part of "libRaptorQ".
+#
+# libRaptorQ is free software: you can redistribute it and/or modify
+# it under the terms of the GNU Lesser General Public License as
+# published by the Free Software Foundation, either version 3
+# of the License, or (at your option) any later version.
+#
+# libRaptorQ is distributed in the hope that it will be useful,
+# but WITHOUT ANY WARRANTY; without even the implied warranty of
+# MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+# GNU General Public License for more details.
+#
+# You should have received a copy of the GNU General Public License
+# and a copy of the GNU Lesser General Public License
+# along with libRaptorQ.  If not, see <http://www.gnu.org/licenses/>.
+
+# Round trip through the CLI tool: encode, drop the first source symbols
+# of every block, decode. The blocks are given in order, reversed and
+# with their packets interleaved. Out of order input must decode even
+# with a single thread, when far more blocks wait than decode.
+#
+# usage: test_cli.sh path/to/RaptorQ
+
+RQ="$1"
+if [ ! -x "$RQ" ]; then
+    echo "usage: $0 path/to/RaptorQ"
+    exit 1
+fi
+
+SYMBOLS=101
+SIZE=64
+REPAIR=20
+DROP=15
+BLOCKS=6
+BYTES=$((SYMBOLS * SIZE * BLOCKS))
+PACKET=$((SIZE + 8))
+PER_BLOCK=$((SYMBOLS + REPAIR))
+
+TMP=$(mktemp -d)
+trap 'rm -rf "$TMP"' EXIT
+
+# a stuck decoder fails the test instead of hanging it
+if command -v timeout > /dev/null 2>&1; then
+    RUN="timeout 60 $RQ"
+else
+    RUN="$RQ"
+fi
+
+head -c "$BYTES" /dev/urandom > "$TMP/input"
+if ! $RUN encode -s $SYMBOLS -w $SIZE -r $REPAIR "$TMP/input" \
+                                                    "$TMP/encoded"; then
+    echo "Could not encode"
+    exit 1
+fi
+
+# the packets of block $1 without the first $DROP
+block() {
+    dd if="$TMP/encoded" bs=$PACKET skip=$(($1 * PER_BLOCK + DROP)) \
+                            count=$((PER_BLOCK - DROP)) 2> /dev/null
+}
+
+: > "$TMP/ordered"
+: > "$TMP/reversed"
+b=0
+while [ $b -lt $BLOCKS ]; do
+    block $b >> "$TMP/ordered"
+    block $((BLOCKS - 1 - b)) >> "$TMP/reversed"
+    b=$((b + 1))
+done
+# one packet of every block at a time
+: > "$TMP/interleaved"
+p=$DROP
+while [ $p -lt $PER_BLOCK ]; do
+    b=0
+    while [ $b -lt $BLOCKS ]; do
+        dd if="$TMP/encoded" bs=$PACKET skip=$((b * PER_BLOCK + p)) count=1 \
+                                    >> "$TMP/interleaved" 2> /dev/null
+        b=$((b + 1))
+    done
+    p=$((p + 1))
+done
+
+# $1: input, $2: threads
+decode() {
+    rm -f "$TMP/output"
+    $RUN decode -s $SYMBOLS -w $SIZE -b $BYTES -t $2 "$1" "$TMP/output" &&
+                                        cmp -s "$TMP/input" "$TMP/output"
+}
+
+echo "Ordered"
+if ! decode "$TMP/ordered" 2; then
+    echo "Wrong output"
+    exit 1
+fi
+echo "Reversed"
+if ! decode "$TMP/reversed" 2; then
+    echo "Wrong output"
+    exit 1
+fi
+echo "Reversed, one thread"
+if ! decode "$TMP/reversed" 1; then
+    echo "Wrong output"
+    exit 1
+fi
+echo "Interleaved, one thread"
+if ! decode "$TMP/interleaved" 1; then
+    echo "Wrong output"
+    exit 1
+fi
+echo "All tests passed"
+exit 0
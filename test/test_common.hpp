@@ -0,0 +1,131 @@
+/*
+ * Copyright (c) 2015-2018, Luca Fulchir<luker@fulchir.it>, All rights reserved.
+ *
+ * This file is part of "libRaptorQ".
+ *
+ * libRaptorQ is free software: you can redistribute it and/or modify
+ * it under the terms of the GNU Lesser General Public License as
+ * published by the Free Software Foundation, either version 3
+ * of the License, or (at your option) any later version.
+ *
+ * libRaptorQ is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ * GNU General Public License for more details.
+ *
+ * You should have received a copy of the GNU General Public License
+ * and a copy of the GNU Lesser General Public License
+ * along with libRaptorQ.  If not, see <http://www.gnu.org/licenses/>.
+ */
+
+#pragma once
+
+#include <cstdint>
+#include <iostream>
+#include <random>
+#include <vector>
+
+// What the tests share: the random input, the encoders made ready,
+// and the check of what was decoded.
+// The helpers print what went wrong, the tests only return false.
+// Include it after the RaptorQ/RFC6330 header.
+
+// "size" random bytes
+inline std::vector<uint8_t> random_input (std::mt19937_64 &rnd,
+                                                            const size_t size)
+{
+    std::uniform_int_distribution<uint16_t> distr (0, 0xFF);
+    std::vector<uint8_t> data (size);
+    for (auto &byte : data)
+        byte = static_cast<uint8_t> (distr (rnd));
+    return data;
+}
+
+// RAW encoder: give it all of "input" and compute the precode.
+template <typename Enc>
+bool init_encoder (Enc &enc, std::vector<uint8_t> &input)
+{
+    if (enc.set_data (input.data(), input.data() + input.size()) !=
+                                        input.size() || !enc.compute_sync()) {
+        std::cout << "Could not initialize encoder.\n";
+        return false;
+    }
+    return true;
+}
+
+// RFC encoder: at least "min_blocks" blocks, all of them computed.
+template <typename Enc>
+bool init_rfc_encoder (Enc &enc, const uint8_t min_blocks = 1)
+{
+    if (!enc || enc.blocks() < min_blocks) {
+        std::cout << "Could not initialize encoder.\n";
+        return false;
+    }
+    enc.compute (RaptorQ__v1::Compute::COMPLETE |
+                                RaptorQ__v1::Compute::NO_BACKGROUND).get();
+    return true;
+}
+
+// RAW: random input for all the "block" source symbols, and the symbols
+// of "esi" from an "Enc" encoder, one after the other in "sent".
+template <typename Enc>
+bool encode_block (std::mt19937_64 &rnd, const RaptorQ__v1::Block_Size block,
+                                const size_t symbol_size,
+                                const std::vector<uint32_t> &esi,
+                                std::vector<uint8_t> &input,
+                                std::vector<uint8_t> &sent)
+{
+    input = random_input (rnd, static_cast<size_t> (block) * symbol_size);
+    Enc enc (block, symbol_size);
+    if (!init_encoder (enc, input))
+        return false;
+    sent.resize (esi.size() * symbol_size);
+    for (size_t idx = 0; idx < esi.size(); ++idx) {
+        uint8_t *out = sent.data() + idx * symbol_size;
+        if (enc.encode (out, out + symbol_size, esi[idx]) != symbol_size) {
+            std::cout << "Could not encode.\n";
+            return false;
+        }
+    }
+    return true;
+}
+
+// same, with the first "count" symbols, from esi 0.
+template <typename Enc>
+bool encode_block (std::mt19937_64 &rnd, const RaptorQ__v1::Block_Size block,
+                                const size_t symbol_size, const uint32_t count,
+                                std::vector<uint8_t> &input,
+                                std::vector<uint8_t> &sent)
+{
+    std::vector<uint32_t> esi (count);
+    for (uint32_t id = 0; id < count; ++id)
+        esi[id] = id;
+    return encode_block<Enc> (rnd, block, symbol_size, esi, input, sent);
+}
+
+// RAW decoder: everything it decoded is "input".
+template <typename Dec>
+bool check_output (Dec &dec, const std::vector<uint8_t> &input)
+{
+    std::vector<uint8_t> received (input.size(), 0);
+    if (dec.decode_bytes (received.data(), received.size(), 0) !=
+                                    input.size() || received != input) {
+        std::cout << "Wrong output\n";
+        return false;
+    }
+    return true;
+}
+
+// RFC decoder: same, for all its blocks.
+template <typename Dec>
+bool check_rfc_output (Dec &dec, const std::vector<uint8_t> &input)
+{
+    std::vector<uint8_t> received (input.size(), 0);
+    auto out = received.data();
+    if (dec.decode_bytes (out, received.data() + received.size(), 0) !=
+                                    input.size() || received != input) {
+        std::cout << "Wrong output\n";
+        return false;
+    }
+    return true;
+}
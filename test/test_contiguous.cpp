@@ -0,0 +1,292 @@
+/*
+ * Copyright (c) 2015-2018, Luca Fulchir<luker@fulchir.it>, All rights reserved.
+ *
+ * This file is part of "libRaptorQ".
+ *
+ * libRaptorQ is free software: you can redistribute it and/or modify
+ * it under the terms of the GNU Lesser General Public License as
+ * published by the Free Software Foundation, either version 3
+ * of the License, or (at your option) any later version.
+ *
+ * libRaptorQ is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ * GNU General Public License for more details.
+ *
+ * You should have received a copy of the GNU General Public License
+ * and a copy of the GNU Lesser General Public License
+ * along with libRaptorQ.  If not, see <http://www.gnu.org/licenses/>.
+ */
+
+#include "../src/RaptorQ/RaptorQ_v1_hdr.hpp"
+#include "../src/RaptorQ/RFC6330_v1_hdr.hpp"
+#include "test_common.hpp"
+#include <algorithm>
+#include <cstring>
+#include <deque>
+#include <iostream>
+#include <random>
+#include <vector>
+
+// The memcpy fast paths on contiguous iterators, and the plain buffer
+// overloads, give the same symbols as the element by element copies
+// (std::deque is never contiguous). The objects end with a short symbol.
+
+namespace RaptorQ = RaptorQ__v1;
+namespace RFC6330 = RFC6330__v1;
+namespace Impl = RaptorQ__v1::Impl;
+
+static bool traits()
+{
+    std::cout << "Traits\n";
+    if (!Impl::is_contiguous<uint8_t*>::value ||
+                !Impl::is_contiguous<const uint32_t*>::value ||
+                !Impl::is_contiguous<std::vector<uint16_t>::iterator>::value ||
+                !Impl::is_contiguous<
+                                std::vector<uint8_t>::const_iterator>::value ||
+                !Impl::is_contiguous_le<uint8_t*>::value) {
+        std::cout << "Contiguous iterator not recognized\n";
+        return false;
+    }
+    if (Impl::is_contiguous<std::deque<uint8_t>::iterator>::value ||
+                Impl::is_contiguous<std::vector<bool>::iterator>::value ||
+                Impl::is_contiguous<float*>::value ||
+                Impl::is_contiguous<std::vector<double>::iterator>::value) {
+        std::cout << "Wrong contiguous iterator\n";
+        return false;
+    }
+    return true;
+}
+
+// same elements, both as a vector and as a deque.
+// "bytes" is cut to a multiple of sizeof(T).
+template <typename T>
+static void split (const std::vector<uint8_t> &bytes, std::vector<T> &vec,
+                                                            std::deque<T> &deq)
+{
+    vec.resize (bytes.size() / sizeof(T));
+    std::memcpy (vec.data(), bytes.data(), vec.size() * sizeof(T));
+    deq.assign (vec.begin(), vec.end());
+}
+
+// RAW, on "T" elements: the vector encoder and decoder (memcpy) agree
+// with the deque ones (one element at a time).
+template <typename T>
+static bool raw (std::mt19937_64 &rnd)
+{
+    std::cout << "RAW, " << sizeof(T) << " byte elements\n";
+    using Vec_It = typename std::vector<T>::iterator;
+    using Deq_It = typename std::deque<T>::iterator;
+    const RaptorQ::Block_Size block = RaptorQ::Block_Size::Block_26;
+    const size_t symbol_size = 16;
+    const uint32_t syms = static_cast<uint32_t> (block);
+    // the last symbol is half empty
+    std::vector<T> input;
+    std::deque<T> deq_input;
+    split (random_input (rnd, syms * symbol_size - symbol_size / 2), input,
+                                                                    deq_input);
+
+    RaptorQ::Encoder<Vec_It, Vec_It> enc (block, symbol_size);
+    RaptorQ::Encoder<Deq_It, Deq_It> deq_enc (block, symbol_size);
+    const size_t bytes = input.size() * sizeof(T);
+    if (enc.set_data (input.begin(), input.end()) != bytes ||
+                !enc.compute_sync() || deq_enc.set_data (deq_input.begin(),
+                        deq_input.end()) != bytes || !deq_enc.compute_sync()) {
+        std::cout << "Could not initialize encoder.\n";
+        return false;
+    }
+    RaptorQ::Decoder<Vec_It, Vec_It> dec (block, symbol_size,
+                        RaptorQ::Decoder<Vec_It, Vec_It>::Report::COMPLETE);
+    RaptorQ::Decoder<Deq_It, Deq_It> deq_dec (block, symbol_size,
+                        RaptorQ::Decoder<Deq_It, Deq_It>::Report::COMPLETE);
+    const size_t elements = symbol_size / sizeof(T);
+    // one source symbol in three is lost
+    for (uint32_t esi = 0; esi < syms + syms / 3 + 4; ++esi) {
+        std::vector<T> sym (elements);
+        std::deque<T> deq_sym (elements);
+        auto out = sym.begin();
+        auto deq_out = deq_sym.begin();
+        // in elements
+        if (enc.encode (out, sym.end(), esi) != elements ||
+                deq_enc.encode (deq_out, deq_sym.end(), esi) != elements ||
+                        !std::equal (sym.begin(), sym.end(), deq_sym.begin())) {
+            std::cout << "Different symbol " << esi << "\n";
+            return false;
+        }
+        if (esi < syms && esi % 3 == 0)
+            continue;
+        auto in = sym.begin();
+        auto deq_in = deq_sym.begin();
+        if (dec.add_symbol (in, sym.end(), esi) != RaptorQ::Error::NONE ||
+                    deq_dec.add_symbol (deq_in, deq_sym.end(), esi) !=
+                                                        RaptorQ::Error::NONE) {
+            std::cout << "Could not add symbol " << esi << "\n";
+            return false;
+        }
+    }
+    dec.end_of_input (RaptorQ::Fill_With_Zeros::NO);
+    deq_dec.end_of_input (RaptorQ::Fill_With_Zeros::NO);
+    if (dec.wait_sync().error != RaptorQ::Error::NONE ||
+                        deq_dec.wait_sync().error != RaptorQ::Error::NONE) {
+        std::cout << "Couldn't decode.\n";
+        return false;
+    }
+    // the padding of the last symbol comes back as zeros
+    const size_t total = syms * elements;
+    std::vector<T> received (total, 1);
+    std::deque<T> deq_received (total, 1);
+    auto out = received.begin();
+    auto deq_out = deq_received.begin();
+    if (dec.decode_bytes (out, received.end(), 0, 0).written !=
+                                                    total * sizeof(T) ||
+            deq_dec.decode_bytes (deq_out, deq_received.end(), 0, 0).written !=
+                                                    total * sizeof(T)) {
+        std::cout << "Short output\n";
+        return false;
+    }
+    const auto padding = received.begin() +
+                                        static_cast<int64_t> (input.size());
+    if (!std::equal (input.begin(), input.end(), received.begin()) ||
+            !std::all_of (padding, received.end(),
+                                    [] (const T val) { return val == 0; }) ||
+            !std::equal (received.begin(), received.end(),
+                                                        deq_received.begin())) {
+        std::cout << "Wrong output\n";
+        return false;
+    }
+    return true;
+}
+
+// RAW plain buffers: encode, add_symbol and decode_bytes from any byte.
+static bool buffers (std::mt19937_64 &rnd)
+{
+    std::cout << "RAW buffers\n";
+    using Deq_It = std::deque<uint8_t>::iterator;
+    const RaptorQ::Block_Size block = RaptorQ::Block_Size::Block_26;
+    const size_t symbol_size = 16;
+    const uint32_t syms = static_cast<uint32_t> (block);
+    // the last symbol has a single byte
+    auto input = random_input (rnd, (syms - 1) * symbol_size + 1);
+    std::deque<uint8_t> deq_input (input.begin(), input.end());
+
+    RaptorQ::Encoder<uint8_t*, uint8_t*> enc (block, symbol_size);
+    RaptorQ::Encoder<Deq_It, Deq_It> deq_enc (block, symbol_size);
+    if (!init_encoder (enc, input) ||
+            deq_enc.set_data (deq_input.begin(), deq_input.end()) !=
+                                input.size() || !deq_enc.compute_sync()) {
+        std::cout << "Could not initialize encoder.\n";
+        return false;
+    }
+    RaptorQ::Decoder<uint8_t*, uint8_t*> dec (block, symbol_size,
+                    RaptorQ::Decoder<uint8_t*, uint8_t*>::Report::COMPLETE);
+    for (uint32_t esi = 0; esi < syms + syms / 3 + 4; ++esi) {
+        std::vector<uint8_t> sym (symbol_size);
+        std::deque<uint8_t> deq_sym (symbol_size);
+        auto deq_out = deq_sym.begin();
+        if (enc.encode (sym.data(), sym.size(), esi) != symbol_size ||
+                deq_enc.encode (deq_out, deq_sym.end(), esi) != symbol_size ||
+                        !std::equal (sym.begin(), sym.end(), deq_sym.begin())) {
+            std::cout << "Different symbol " << esi << "\n";
+            return false;
+        }
+        if (esi < syms && esi % 3 == 0)
+            continue;
+        if (dec.add_symbol (sym.data(), sym.size(), esi) !=
+                                                        RaptorQ::Error::NONE) {
+            std::cout << "Could not add symbol " << esi << "\n";
+            return false;
+        }
+    }
+    dec.end_of_input (RaptorQ::Fill_With_Zeros::NO);
+    if (dec.wait_sync().error != RaptorQ::Error::NONE) {
+        std::cout << "Couldn't decode.\n";
+        return false;
+    }
+    // from the start, from the middle of a symbol, and just the last byte
+    const size_t total = syms * symbol_size;
+    for (const size_t from : {size_t (0), symbol_size + 3, input.size() - 1}) {
+        std::vector<uint8_t> received (total - from, 1);
+        const auto padding = received.begin() +
+                                    static_cast<int64_t> (input.size() - from);
+        if (dec.decode_bytes (received.data(), received.size(), from) !=
+                                                            received.size() ||
+                    !std::equal (input.begin() + static_cast<int64_t> (from),
+                                            input.end(), received.begin()) ||
+                    !std::all_of (padding, received.end(),
+                                [] (const uint8_t val) { return val == 0; })) {
+            std::cout << "Wrong output from byte " << from << "\n";
+            return false;
+        }
+    }
+    return true;
+}
+
+// RFC: the plain buffer encoder and decoder against the deque ones,
+// with sub-blocks, which read the source symbols one piece at a time.
+static bool rfc (std::mt19937_64 &rnd, const size_t max_sub_block)
+{
+    std::cout << "RFC, sub-block " << max_sub_block << "\n";
+    using Deq_It = std::deque<uint8_t>::iterator;
+    // the last symbol is short
+    auto input = random_input (rnd, 30000 + 7);
+    std::deque<uint8_t> deq_input (input.begin(), input.end());
+    RFC6330::Encoder<uint8_t*, uint8_t*> enc (input.data(),
+                        input.data() + input.size(), 8, 64, max_sub_block);
+    RFC6330::Encoder<Deq_It, Deq_It> deq_enc (deq_input.begin(),
+                                    deq_input.end(), 8, 64, max_sub_block);
+    if (!init_rfc_encoder (enc) || !init_rfc_encoder (deq_enc))
+        return false;
+    RFC6330::Decoder<Deq_It, Deq_It> dec (enc.OTI_Common(),
+                                                    enc.OTI_Scheme_Specific());
+    dec.compute (RFC6330::Compute::NO_POOL);
+    const size_t symbol_size = enc.symbol_size();
+    for (uint8_t sbn = 0; sbn < enc.blocks(); ++sbn) {
+        const uint32_t syms = enc.symbols (sbn);
+        for (uint32_t esi = 0; esi < syms + syms / 3 + 4; ++esi) {
+            std::vector<uint8_t> sym (symbol_size);
+            std::deque<uint8_t> deq_sym (symbol_size);
+            auto deq_out = deq_sym.begin();
+            if (enc.encode (sym.data(), sym.size(), esi, sbn) != symbol_size ||
+                    deq_enc.encode (deq_out, deq_sym.end(), esi, sbn) !=
+                                                                symbol_size ||
+                        !std::equal (sym.begin(), sym.end(), deq_sym.begin())) {
+                std::cout << "Different symbol " << esi << " of block " <<
+                                            static_cast<uint32_t> (sbn) << "\n";
+                return false;
+            }
+            if (esi < syms && esi % 3 == 0)
+                continue;
+            if (dec.add_symbol (sym.data(), sym.size(), esi, sbn) !=
+                                                        RFC6330::Error::NONE) {
+                std::cout << "Could not add symbol " << esi << "\n";
+                return false;
+            }
+        }
+    }
+    dec.end_of_input (RFC6330::Fill_With_Zeros::NO);
+    std::deque<uint8_t> received (input.size(), 0);
+    auto out = received.begin();
+    if (dec.decode_bytes (out, received.end(), 0) != input.size() ||
+                        !std::equal (input.begin(), input.end(),
+                                                        received.begin())) {
+        std::cout << "Wrong output\n";
+        return false;
+    }
+    return true;
+}
+
+int main (void)
+{
+    std::random_device rd;
+    std::mt19937_64 rnd (rd());
+
+    if (!traits() || !raw<uint8_t> (rnd) || !raw<uint32_t> (rnd) ||
+                                                            !buffers (rnd)) {
+        return -1;
+    }
+    // a single sub-block, and several
+    if (!rfc (rnd, 4000) || !rfc (rnd, 64 * 4))
+        return -1;
+    std::cout << "All tests passed\n";
+    return 0;
+}
@@ -205,6 +205,8 @@ bool decode (const uint32_t mysize, std::mt19937_64 &rnd, float drop_prob,
         abort();
     }
 
+    // the default policy: in the linked version it goes through the wrapper
+    dec.set_decode_policy (RFC6330::Decode_Policy {0, 0, 0});
     auto async_dec = dec.compute (RFC6330::Compute::COMPLETE);
 
     std::vector<out_dec_align> received;
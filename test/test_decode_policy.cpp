@@ -0,0 +1,258 @@
+/*
+ * Copyright (c) 2015-2018, Luca Fulchir<luker@fulchir.it>, All rights reserved.
+ *
+ * This file is part of "libRaptorQ".
+ *
+ * libRaptorQ is free software: you can redistribute it and/or modify
+ * it under the terms of the GNU Lesser General Public License as
+ * published by the Free Software Foundation, either version 3
+ * of the License, or (at your option) any later version.
+ *
+ * libRaptorQ is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ * GNU General Public License for more details.
+ *
+ * You should have received a copy of the GNU General Public License
+ * and a copy of the GNU Lesser General Public License
+ * along with libRaptorQ.  If not, see <http://www.gnu.org/licenses/>.
+ */
+
+#include "../src/RaptorQ/RaptorQ_v1_hdr.hpp"
+#include "../src/RaptorQ/RFC6330_v1_hdr.hpp"
+#include "test_common.hpp"
+#include <chrono>
+#include <iostream>
+#include <random>
+#include <thread>
+#include <vector>
+
+// The decode policy says when a decoding attempt can start:
+// with "missing + overhead" repair symbols, after a quiet period with at
+// least "missing" repair symbols, or with the overhead needed for a
+// maximum failure probability. Many arrivals only start one attempt.
+
+namespace RaptorQ = RaptorQ__v1;
+namespace RFC6330 = RFC6330__v1;
+namespace Impl = RaptorQ__v1::Impl;
+
+using Raw_Enc = RaptorQ::Encoder<uint8_t*, uint8_t*>;
+using Raw_Dec = Impl::Raw_Decoder<uint8_t*>;
+
+static const RaptorQ::Block_Size test_block = RaptorQ::Block_Size::Block_101;
+static const size_t sym_size = 16;
+static const uint32_t holes = 5;
+
+// all the source symbols, and repair symbols up to "holes + 10".
+// The first "holes" source symbols are the lost ones.
+static bool encode (std::mt19937_64 &rnd, std::vector<uint8_t> &sent)
+{
+    const uint32_t syms = static_cast<uint32_t> (test_block);
+    std::vector<uint8_t> input;
+    return encode_block<Raw_Enc> (rnd, test_block, sym_size, syms + holes + 10,
+                                                                input, sent);
+}
+
+static bool add (Raw_Dec &dec, std::vector<uint8_t> &sent, const uint32_t esi)
+{
+    uint8_t *sym = sent.data() + esi * sym_size;
+    if (dec.add_symbol (sym, sym + sym_size, esi, false) !=
+                                                        RaptorQ::Error::NONE) {
+        std::cout << "Could not add symbol " << esi << "\n";
+        return false;
+    }
+    return true;
+}
+
+// the source symbols we did not lose, and the first "repairs" repair ones.
+static bool fill (Raw_Dec &dec, std::vector<uint8_t> &sent,
+                                                        const uint32_t repairs)
+{
+    const uint32_t syms = static_cast<uint32_t> (test_block);
+    for (uint32_t esi = holes; esi < syms + repairs; ++esi) {
+        if (!add (dec, sent, esi))
+            return false;
+    }
+    return true;
+}
+
+static RaptorQ::Decoder_Result attempt (Raw_Dec &dec)
+{
+    RaptorQ::Work_State work = RaptorQ::Work_State::KEEP_WORKING;
+    return dec.decode (&work);
+}
+
+// no attempt before "holes + overhead" repair symbols
+static bool overhead (std::vector<uint8_t> &sent)
+{
+    std::cout << "Overhead\n";
+    const uint32_t syms = static_cast<uint32_t> (test_block);
+    Raw_Dec dec (test_block, sym_size);
+    dec.set_decode_policy ({3, 0, 0});
+    if (!fill (dec, sent, holes + 2))
+        return false;
+    if (dec.can_decode() || dec.needed_symbols() != 1 ||
+                        attempt (dec) != RaptorQ::Decoder_Result::NEED_DATA) {
+        std::cout << "Attempt before the overhead\n";
+        return false;
+    }
+    if (!add (dec, sent, syms + holes + 2))
+        return false;
+    if (!dec.can_decode() ||
+                        attempt (dec) != RaptorQ::Decoder_Result::DECODED) {
+        std::cout << "No attempt with the overhead\n";
+        return false;
+    }
+    return true;
+}
+
+// "max_failure" sets the overhead: 1e-7 needs 3 symbols (1e-8)
+static bool max_failure (std::vector<uint8_t> &sent)
+{
+    std::cout << "Max failure\n";
+    const uint32_t syms = static_cast<uint32_t> (test_block);
+    Raw_Dec dec (test_block, sym_size);
+    dec.set_decode_policy ({1, 0, 1e-7f});
+    if (!fill (dec, sent, holes))
+        return false;
+    if (dec.can_decode() || dec.needed_symbols() != 3) {
+        std::cout << "Wrong overhead: " << dec.needed_symbols() << "\n";
+        return false;
+    }
+    for (uint32_t esi = syms + holes; esi < syms + holes + 2; ++esi) {
+        if (!add (dec, sent, esi))
+            return false;
+    }
+    if (dec.can_decode() || !add (dec, sent, syms + holes + 2) ||
+                                                        !dec.can_decode()) {
+        std::cout << "No attempt with the overhead\n";
+        return false;
+    }
+    return attempt (dec) == RaptorQ::Decoder_Result::DECODED;
+}
+
+// without the overhead, an attempt starts after "quiet_ms"
+static bool quiet (std::vector<uint8_t> &sent)
+{
+    std::cout << "Quiet\n";
+    Raw_Dec dec (test_block, sym_size);
+    dec.set_decode_policy ({5, 50, 0});
+    if (!fill (dec, sent, holes))
+        return false;
+    const int64_t left = dec.quiet_left();
+    if (dec.can_decode() || left <= 0 || left > 50) {
+        std::cout << "Attempt before the quiet period: " << left << "\n";
+        return false;
+    }
+    std::this_thread::sleep_for (std::chrono::milliseconds (60));
+    if (dec.quiet_left() != 0 || !dec.can_decode() ||
+                        attempt (dec) != RaptorQ::Decoder_Result::DECODED) {
+        std::cout << "No attempt after the quiet period\n";
+        return false;
+    }
+    return true;
+}
+
+// symbols arriving from many threads only start one attempt,
+// and only the next symbols start the next one.
+static bool coalesce (std::vector<uint8_t> &sent)
+{
+    std::cout << "Coalesce\n";
+    const uint32_t syms = static_cast<uint32_t> (test_block);
+    Raw_Dec dec (test_block, sym_size);
+    const uint32_t threads_num = 4;
+    std::vector<std::thread> threads;
+    for (uint32_t id = 0; id < threads_num; ++id) {
+        threads.emplace_back ([&dec, &sent, id, syms] () {
+            for (uint32_t esi = holes + id; esi < syms + holes + 4;
+                                                        esi += threads_num) {
+                uint8_t *sym = sent.data() + esi * sym_size;
+                dec.add_symbol (sym, sym + sym_size, esi, false);
+            }
+        });
+    }
+    for (auto &t : threads)
+        t.join();
+    // the first attempt is stopped right away.
+    RaptorQ::Work_State stop = RaptorQ::Work_State::ABORT_COMPUTATION;
+    if (dec.decode (&stop) != RaptorQ::Decoder_Result::STOPPED) {
+        std::cout << "No attempt\n";
+        return false;
+    }
+    if (dec.can_decode() ||
+                        attempt (dec) != RaptorQ::Decoder_Result::NEED_DATA) {
+        std::cout << "More than one attempt\n";
+        return false;
+    }
+    if (!add (dec, sent, syms + holes + 4) ||
+                        attempt (dec) != RaptorQ::Decoder_Result::DECODED) {
+        std::cout << "No attempt after a new symbol\n";
+        return false;
+    }
+    return true;
+}
+
+// RFC: a deferred block is queued when its quiet period ends, even
+// if only the other blocks receive symbols, and nobody called compute().
+static bool rfc_requeue (std::mt19937_64 &rnd)
+{
+    std::cout << "RFC requeue\n";
+    const size_t size = 20000;
+    const uint16_t rfc_symbol = 64;
+    auto input = random_input (rnd, size);
+    RFC6330::Encoder<uint8_t*, uint8_t*> enc (input.data(),
+                            input.data() + size, rfc_symbol, rfc_symbol, 4000);
+    if (!init_rfc_encoder (enc, 2))
+        return false;
+    RFC6330::Decoder<uint8_t*, uint8_t*> dec (enc.OTI_Common(),
+                                                    enc.OTI_Scheme_Specific());
+    dec.set_decode_policy ({10, 30, 0});
+    std::vector<uint8_t> sym (rfc_symbol);
+    auto send = [&] (const uint32_t esi, const uint8_t sbn) {
+            enc.encode (sym.data(), sym.size(), esi, sbn);
+            return dec.add_symbol (sym.data(), sym.size(), esi, sbn);
+        };
+    // block 0: two source symbols lost, two repair symbols.
+    const uint32_t syms = enc.symbols (0);
+    for (uint32_t esi = 2; esi < syms + 2; ++esi) {
+        if (send (esi, 0) != RFC6330::Error::NONE) {
+            std::cout << "Could not add symbol " << esi << "\n";
+            return false;
+        }
+    }
+    std::this_thread::sleep_for (std::chrono::milliseconds (40));
+    if (dec.is_block_ready (0)) {
+        std::cout << "Block decoded before the quiet period\n";
+        return false;
+    }
+    // only block 1 receives symbols now
+    for (uint32_t esi = 0; esi < 10 && !dec.is_block_ready (0); ++esi) {
+        send (esi, 1);
+        std::this_thread::sleep_for (std::chrono::milliseconds (20));
+    }
+    for (uint32_t wait = 0; wait < 100 && !dec.is_block_ready (0); ++wait)
+        std::this_thread::sleep_for (std::chrono::milliseconds (10));
+    if (!dec.is_block_ready (0)) {
+        std::cout << "Deferred block never queued\n";
+        return false;
+    }
+    return true;
+}
+
+int main (void)
+{
+    std::random_device rd;
+    std::mt19937_64 rnd (rd());
+
+    // the coalescing test needs a full elimination, that can be stopped.
+    Impl::DLF<std::vector<uint8_t>, Impl::Cache_Key>::get()->resize (0);
+    std::vector<uint8_t> sent;
+    if (!encode (rnd, sent))
+        return -1;
+    if (!overhead (sent) || !max_failure (sent) || !quiet (sent) ||
+                                    !coalesce (sent) || !rfc_requeue (rnd)) {
+        return -1;
+    }
+    std::cout << "All tests passed\n";
+    return 0;
+}
@@ -0,0 +1,158 @@
+/*
+ * Copyright (c) 2015-2018, Luca Fulchir<luker@fulchir.it>, All rights reserved.
+ *
+ * This file is part of "libRaptorQ".
+ *
+ * libRaptorQ is free software: you can redistribute it and/or modify
+ * it under the terms of the GNU Lesser General Public License as
+ * published by the Free Software Foundation, either version 3
+ * of the License, or (at your option) any later version.
+ *
+ * libRaptorQ is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ * GNU General Public License for more details.
+ *
+ * You should have received a copy of the GNU General Public License
+ * and a copy of the GNU Lesser General Public License
+ * along with libRaptorQ.  If not, see <http://www.gnu.org/licenses/>.
+ */
+
+// we can switch easily between header-only and linked version of the library
+#if defined (TEST_HDR_ONLY)
+    #include "../src/RaptorQ/RaptorQ_v1_hdr.hpp"
+#else
+    #include "../src/RaptorQ/RaptorQ_v1.hpp"
+#endif
+#include "test_common.hpp"
+#include <algorithm>
+#include <iostream>
+#include <random>
+#include <vector>
+
+// Decode in place: the decoder writes the block directly in the caller's
+// buffer. The received source symbols are copied there as they arrive,
+// and only the lost ones are reconstructed. decode_bytes() is never used.
+
+namespace RaptorQ = RaptorQ__v1;
+
+using Enc = RaptorQ::Encoder<uint8_t*, uint8_t*>;
+using Dec = RaptorQ::Decoder<uint8_t*, uint8_t*>;
+
+static const size_t sym_size = 16;
+
+// source symbols with esi % 3 == 0 are lost, as many repair symbols
+// as needed follow. Each symbol is "sym_size" bytes in "sent".
+static bool encode (std::mt19937_64 &rnd, const RaptorQ::Block_Size block,
+                                                    std::vector<uint8_t> &input,
+                                                    std::vector<uint8_t> &sent,
+                                                    std::vector<uint32_t> &esi)
+{
+    const uint32_t syms = static_cast<uint32_t> (block);
+    esi.clear();
+    for (uint32_t id = 0; id < syms; ++id) {
+        if (id % 3 != 0)
+            esi.push_back (id);
+    }
+    for (uint32_t id = syms; esi.size() < syms + 4; ++id)
+        esi.push_back (id);
+    return encode_block<Enc> (rnd, block, sym_size, esi, input, sent);
+}
+
+// through the public decoder (the wrapper, when linked)
+static bool decoder (std::mt19937_64 &rnd, const RaptorQ::Block_Size block)
+{
+    std::cout << "Decoder: " << static_cast<uint32_t> (block) << "\n";
+    std::vector<uint8_t> input, sent;
+    std::vector<uint32_t> esi;
+    if (!encode (rnd, block, input, sent, esi))
+        return false;
+    std::vector<uint8_t> output (input.size(), 0);
+    Dec dec (block, sym_size, Dec::Report::COMPLETE, output.data());
+    for (size_t idx = 0; idx < esi.size(); ++idx) {
+        if (dec.add_symbol (sent.data() + idx * sym_size, sym_size,
+                                            esi[idx]) != RaptorQ::Error::NONE) {
+            std::cout << "Could not add symbol " << esi[idx] << "\n";
+            return false;
+        }
+    }
+    // the received source symbols are already in place
+    const uint32_t syms = static_cast<uint32_t> (block);
+    for (const auto id : esi) {
+        if (id >= syms)
+            break;
+        if (!std::equal (input.begin() + id * sym_size,
+                                        input.begin() + (id + 1) * sym_size,
+                                        output.begin() + id * sym_size)) {
+            std::cout << "Source symbol " << id << " not in place\n";
+            return false;
+        }
+    }
+    dec.end_of_input (RaptorQ::Fill_With_Zeros::NO);
+    if (dec.wait_sync().error != RaptorQ::Error::NONE) {
+        std::cout << "Couldn't decode.\n";
+        return false;
+    }
+    if (output != input) {
+        std::cout << "Wrong output\n";
+        return false;
+    }
+    return true;
+}
+
+#if defined (TEST_HDR_ONLY)
+// the decoder never allocates its own copy of the block
+static bool raw (std::mt19937_64 &rnd, const RaptorQ::Block_Size block)
+{
+    std::cout << "Raw: " << static_cast<uint32_t> (block) << "\n";
+    std::vector<uint8_t> input, sent;
+    std::vector<uint32_t> esi;
+    if (!encode (rnd, block, input, sent, esi))
+        return false;
+    std::vector<uint8_t> output (input.size(), 0);
+    RaptorQ::Impl::Raw_Decoder<uint8_t*> dec (block, sym_size,
+                            reinterpret_cast<RaptorQ::Impl::Octet*> (
+                                                            output.data()));
+    const auto *symbols = dec.get_symbols();
+    if (!dec.in_place() || reinterpret_cast<const uint8_t*> (
+                                        symbols->data()) != output.data()) {
+        std::cout << "Not in place\n";
+        return false;
+    }
+    for (size_t idx = 0; idx < esi.size(); ++idx) {
+        uint8_t *sym = sent.data() + idx * sym_size;
+        if (dec.add_symbol (sym, sym + sym_size, esi[idx], false) !=
+                                                        RaptorQ::Error::NONE) {
+            std::cout << "Could not add symbol " << esi[idx] << "\n";
+            return false;
+        }
+    }
+    RaptorQ::Work_State work = RaptorQ::Work_State::KEEP_WORKING;
+    if (dec.decode (&work) != RaptorQ::Decoder_Result::DECODED) {
+        std::cout << "Couldn't decode.\n";
+        return false;
+    }
+    if (!dec.in_place() || output != input) {
+        std::cout << "Wrong output\n";
+        return false;
+    }
+    return true;
+}
+#endif
+
+int main (void)
+{
+    std::random_device rd;
+    std::mt19937_64 rnd (rd());
+
+    if (!decoder (rnd, RaptorQ::Block_Size::Block_10) ||
+                            !decoder (rnd, RaptorQ::Block_Size::Block_1002)) {
+        return -1;
+    }
+#if defined (TEST_HDR_ONLY)
+    if (!raw (rnd, RaptorQ::Block_Size::Block_101))
+        return -1;
+#endif
+    std::cout << "All tests passed\n";
+    return 0;
+}
@@ -0,0 +1,275 @@
+/*
+ * Copyright (c) 2015-2018, Luca Fulchir<luker@fulchir.it>, All rights reserved.
+ *
+ * This file is part of "libRaptorQ".
+ *
+ * libRaptorQ is free software: you can redistribute it and/or modify
+ * it under the terms of the GNU Lesser General Public License as
+ * published by the Free Software Foundation, either version 3
+ * of the License, or (at your option) any later version.
+ *
+ * libRaptorQ is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ * GNU General Public License for more details.
+ *
+ * You should have received a copy of the GNU General Public License
+ * and a copy of the GNU Lesser General Public License
+ * along with libRaptorQ.  If not, see <http://www.gnu.org/licenses/>.
+ */
+
+#if defined (TEST_HDR_ONLY)
+    #include "../src/RaptorQ/RaptorQ_v1_hdr.hpp"
+    #include "../src/RaptorQ/RFC6330_v1_hdr.hpp"
+#else
+    #include "../src/RaptorQ/RaptorQ_v1.hpp"
+    #include "../src/RaptorQ/RFC6330_v1.hpp"
+#endif
+#include "test_common.hpp"
+#include "../src/RaptorQ/v1/util/Atomic_Bitset.hpp"
+#include <atomic>
+#include <iostream>
+#include <memory>
+#include <random>
+#include <thread>
+#include <vector>
+
+// Several producers feed the same decoder at the same time, each with
+// all the symbols, in a different order. Every symbol must be accepted
+// exactly once, and the object must still decode.
+// Moving the symbols to a scratch file while the producers run must not
+// refuse any of them.
+
+namespace RaptorQ = RaptorQ__v1;
+namespace RFC6330 = RFC6330__v1;
+
+static const uint32_t producers = 4;
+
+// one counter per symbol: how many producers had it accepted.
+using Counters = std::unique_ptr<std::atomic<uint32_t>[]>;
+
+static Counters counters (const size_t size)
+{
+    Counters ret (new std::atomic<uint32_t>[size]);
+    for (size_t idx = 0; idx < size; ++idx)
+        ret[idx].store (0);
+    return ret;
+}
+
+// run "producers" threads on all the symbols, each from a different one.
+template <typename Add>
+static void run (const size_t symbols, Add add)
+{
+    std::vector<std::thread> threads;
+    for (uint32_t id = 0; id < producers; ++id) {
+        threads.emplace_back ([=] () {
+            const size_t start = id * (symbols / producers);
+            for (size_t idx = 0; idx < symbols; ++idx)
+                add ((start + idx) % symbols);
+        });
+    }
+    for (auto &t : threads)
+        t.join();
+}
+
+// every bit is set exactly once
+static bool bitset()
+{
+    std::cout << "Atomic_Bitset\n";
+    const size_t bits = 1000;
+    RaptorQ::Impl::Atomic_Bitset set (bits);
+    auto first = counters (bits);
+    run (bits, [&] (const size_t bit) {
+            if (!set.test_and_set (bit))
+                ++first[bit];
+        });
+    for (size_t bit = 0; bit < bits; ++bit) {
+        if (first[bit].load() != 1 || !set.test (bit)) {
+            std::cout << "Bit " << bit << " set " << first[bit].load() <<
+                                                                    " times\n";
+            return false;
+        }
+    }
+    return true;
+}
+
+static bool raw (std::mt19937_64 &rnd)
+{
+    std::cout << "RAW\n";
+    const auto block = RaptorQ::Block_Size::Block_1002;
+    const size_t symbol_size = 32;
+    const uint32_t syms = static_cast<uint32_t> (block);
+    // one source symbol in 4 is lost, and we get one repair symbol less
+    // than needed from the producers.
+    std::vector<uint32_t> esi;
+    for (uint32_t id = 0; id < syms; ++id) {
+        if (id % 4 != 1)
+            esi.push_back (id);
+    }
+    const uint32_t holes = syms - static_cast<uint32_t> (esi.size());
+    for (uint32_t id = syms; id < syms + holes + 4; ++id)
+        esi.push_back (id);
+    std::vector<uint8_t> input, sent;
+    using Enc = RaptorQ::Encoder<uint8_t*, uint8_t*>;
+    if (!encode_block<Enc> (rnd, block, symbol_size, esi, input, sent))
+        return false;
+
+    RaptorQ::Decoder<uint8_t*, uint8_t*> dec (block, symbol_size,
+                        RaptorQ::Decoder<uint8_t*, uint8_t*>::Report::COMPLETE);
+    auto accepted = counters (esi.size());
+    const size_t shared = esi.size() - 5;
+    run (shared, [&] (const size_t idx) {
+            if (dec.add_symbol (sent.data() + idx * symbol_size, symbol_size,
+                                            esi[idx]) == RaptorQ::Error::NONE) {
+                ++accepted[idx];
+            }
+        });
+    for (size_t idx = 0; idx < shared; ++idx) {
+        if (accepted[idx].load() != 1) {
+            std::cout << "Symbol " << esi[idx] << " accepted " <<
+                                        accepted[idx].load() << " times\n";
+            return false;
+        }
+    }
+    if (dec.needed_symbols() != 1) {
+        std::cout << "Symbols counted wrong: " << dec.needed_symbols() <<
+                                                                    " needed\n";
+        return false;
+    }
+    for (size_t idx = shared; idx < esi.size(); ++idx) {
+        if (dec.add_symbol (sent.data() + idx * symbol_size, symbol_size,
+                                            esi[idx]) != RaptorQ::Error::NONE) {
+            std::cout << "Could not add symbol " << esi[idx] << "\n";
+            return false;
+        }
+    }
+    dec.end_of_input (RaptorQ::Fill_With_Zeros::NO);
+    if (dec.wait_sync().error != RaptorQ::Error::NONE) {
+        std::cout << "Couldn't decode.\n";
+        return false;
+    }
+    return check_output (dec, input);
+}
+
+static bool rfc (std::mt19937_64 &rnd)
+{
+    std::cout << "RFC\n";
+    const size_t size = 50000;
+    const uint16_t symbol_size = 64;
+    auto input = random_input (rnd, size);
+    RFC6330::Encoder<uint8_t*, uint8_t*> enc (input.data(),
+                        input.data() + size, symbol_size, symbol_size, 8000);
+    if (!init_rfc_encoder (enc))
+        return false;
+    std::cout << "Blocks: " << static_cast<uint32_t> (enc.blocks()) << "\n";
+    // (sbn, esi): one source symbol in 3 is lost, plus some repair symbols.
+    std::vector<std::pair<uint8_t, uint32_t>> ids;
+    for (uint8_t sbn = 0; sbn < enc.blocks(); ++sbn) {
+        const uint32_t syms = enc.symbols (sbn);
+        uint32_t holes = 0;
+        for (uint32_t esi = 0; esi < syms; ++esi) {
+            if (esi % 3 == 2)
+                ++holes;
+            else
+                ids.emplace_back (sbn, esi);
+        }
+        for (uint32_t esi = syms; esi < syms + holes + 2; ++esi)
+            ids.emplace_back (sbn, esi);
+    }
+    std::vector<uint8_t> sent (ids.size() * symbol_size);
+    for (size_t idx = 0; idx < ids.size(); ++idx) {
+        if (enc.encode (sent.data() + idx * symbol_size, symbol_size,
+                            ids[idx].second, ids[idx].first) != symbol_size) {
+            std::cout << "Could not encode.\n";
+            return false;
+        }
+    }
+
+    RFC6330::Decoder<uint8_t*, uint8_t*> dec (enc.OTI_Common(),
+                                                    enc.OTI_Scheme_Specific());
+    if (!dec) {
+        std::cout << "Could not initialize decoder.\n";
+        return false;
+    }
+    auto accepted = counters (ids.size());
+    run (ids.size(), [&] (const size_t idx) {
+            if (dec.add_symbol (sent.data() + idx * symbol_size, symbol_size,
+                                        ids[idx].second, ids[idx].first) ==
+                                                        RFC6330::Error::NONE) {
+                ++accepted[idx];
+            }
+        });
+    for (size_t idx = 0; idx < ids.size(); ++idx) {
+        if (accepted[idx].load() != 1) {
+            std::cout << "Symbol " << ids[idx].second << " of block " <<
+                            static_cast<uint32_t> (ids[idx].first) <<
+                            " accepted " << accepted[idx].load() << " times\n";
+            return false;
+        }
+    }
+    auto res = dec.compute (RFC6330::Compute::COMPLETE);
+    dec.end_of_input (RFC6330::Fill_With_Zeros::NO);
+    if (res.get().first != RFC6330::Error::NONE) {
+        std::cout << "Couldn't decode.\n";
+        return false;
+    }
+    return check_rfc_output (dec, input);
+}
+
+// each producer has its own source symbols, set_storage runs halfway.
+static bool storage (std::mt19937_64 &rnd, const uint32_t trials)
+{
+    std::cout << "Storage\n";
+    const auto block = RaptorQ::Block_Size::Block_1002;
+    const size_t symbol_size = 32;
+    const uint32_t syms = static_cast<uint32_t> (block);
+    auto input = random_input (rnd, syms * symbol_size);
+
+    using Dec = RaptorQ::Decoder<uint8_t*, uint8_t*>;
+    for (uint32_t trial = 0; trial < trials; ++trial) {
+        Dec dec (block, symbol_size, Dec::Report::COMPLETE);
+        std::atomic<uint32_t> added (0), refused (0);
+        std::vector<std::thread> threads;
+        for (uint32_t id = 0; id < producers; ++id) {
+            threads.emplace_back ([&, id] () {
+                for (uint32_t esi = id; esi < syms; esi += producers) {
+                    if (dec.add_symbol (input.data() + esi * symbol_size,
+                                    symbol_size, esi) == RaptorQ::Error::NONE) {
+                        ++added;
+                    } else {
+                        ++refused;
+                    }
+                }
+            });
+        }
+        while (added.load() + refused.load() < syms / 2)
+            std::this_thread::yield();
+        const bool moved = dec.set_storage ("/tmp");
+        for (auto &t : threads)
+            t.join();
+        if (!moved || refused.load() != 0 || added.load() != syms) {
+            std::cout << "Symbols refused while moving them: " <<
+                                                    refused.load() << "\n";
+            return false;
+        }
+        dec.end_of_input (RaptorQ::Fill_With_Zeros::NO);
+        if (dec.wait_sync().error != RaptorQ::Error::NONE) {
+            std::cout << "Couldn't decode.\n";
+            return false;
+        }
+        if (!check_output (dec, input))
+            return false;
+    }
+    return true;
+}
+
+int main (void)
+{
+    std::random_device rd;
+    std::mt19937_64 rnd (rd());
+
+    if (!bitset() || !raw (rnd) || !rfc (rnd) || !storage (rnd, 50))
+        return -1;
+    std::cout << "All tests passed\n";
+    return 0;
+}
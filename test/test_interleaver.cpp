@@ -0,0 +1,103 @@
+/*
+ * Copyright (c) 2015-2018, Luca Fulchir<luker@fulchir.it>, All rights reserved.
+ *
+ * This file is part of "libRaptorQ".
+ *
+ * libRaptorQ is free software: you can redistribute it and/or modify
+ * it under the terms of the GNU Lesser General Public License as
+ * published by the Free Software Foundation, either version 3
+ * of the License, or (at your option) any later version.
+ *
+ * libRaptorQ is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ * GNU General Public License for more details.
+ *
+ * You should have received a copy of the GNU General Public License
+ * and a copy of the GNU Lesser General Public License
+ * along with libRaptorQ.  If not, see <http://www.gnu.org/licenses/>.
+ */
+
+#include "../src/RaptorQ/RFC6330_v1_hdr.hpp"
+#include "test_common.hpp"
+#include <cstring>
+#include <deque>
+#include <iostream>
+#include <random>
+#include <vector>
+
+// Symbol_it::copy_to copies a symbol one sub-symbol run at a time.
+// It must give the same bytes as reading the symbol one element at a
+// time, with one or two sub-block partitions, and with the padding
+// after the end of the object.
+
+namespace Impl = RFC6330__v1::Impl;
+
+struct Layout {
+    size_t elements;    // elements in a symbol
+    uint16_t sub_blocks;
+    uint16_t k;         // symbols in the block
+    size_t start;       // first element of the block
+    size_t missing;     // elements of the block after the end of the data
+};
+
+template <typename It>
+static bool same_symbols (It from, It to, const Layout &lay)
+{
+    using T = typename std::iterator_traits<It>::value_type;
+    const Impl::Partition part (lay.elements, lay.sub_blocks);
+    const size_t end = lay.start + lay.k * lay.elements;
+    for (uint16_t id = 0; id < lay.k; ++id) {
+        const Impl::Symbol_it<It> sym (from, to, lay.start, end, 0, part, id,
+                                                                        lay.k);
+        std::vector<uint8_t> slow (lay.elements * sizeof(T), 0xAA);
+        size_t pos = 0;
+        for (auto it = sym.begin(); it != sym.end(); ++it, ++pos) {
+            const T val = *it;
+            std::memcpy (slow.data() + pos * sizeof(T), &val, sizeof(T));
+        }
+        std::vector<uint8_t> fast (lay.elements * sizeof(T), 0xAA);
+        sym.copy_to (fast.data());
+        if (pos != lay.elements || fast != slow) {
+            std::cout << "Different symbol " << id << ": " << lay.elements <<
+                        " elements, " << lay.sub_blocks << " sub-blocks, " <<
+                                            lay.missing << " missing\n";
+            return false;
+        }
+    }
+    return true;
+}
+
+// the same layout on a vector (memcpy runs) and a deque (element runs)
+template <typename T>
+static bool copy_to (std::mt19937_64 &rnd, const Layout &lay)
+{
+    const size_t size = lay.start + lay.k * lay.elements - lay.missing;
+    const auto bytes = random_input (rnd, size * sizeof(T));
+    std::vector<T> vec (size);
+    std::memcpy (vec.data(), bytes.data(), bytes.size());
+    const std::deque<T> deq (vec.begin(), vec.end());
+    return same_symbols (vec.cbegin(), vec.cend(), lay) &&
+                                same_symbols (deq.cbegin(), deq.cend(), lay);
+}
+
+int main (void)
+{
+    std::random_device rd;
+    std::mt19937_64 rnd (rd());
+
+    const std::vector<Layout> layouts = {
+        {16, 1, 10, 0, 0},      // a single sub-block
+        {16, 4, 10, 0, 0},      // even sub-blocks
+        {18, 4, 10, 0, 0},      // two partitions: 5, 5, 4, 4
+        {18, 4, 10, 160, 0},    // not the first block
+        {18, 4, 10, 0, 7},      // the last symbols are padded
+        {18, 4, 10, 0, 50},     // whole sub-symbols after the end
+        {7, 3, 13, 91, 30}};
+    for (const auto &lay : layouts) {
+        if (!copy_to<uint8_t> (rnd, lay) || !copy_to<uint32_t> (rnd, lay))
+            return -1;
+    }
+    std::cout << "All tests passed\n";
+    return 0;
+}
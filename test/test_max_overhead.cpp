@@ -0,0 +1,157 @@
+/*
+ * Copyright (c) 2015-2018, Luca Fulchir<luker@fulchir.it>, All rights reserved.
+ *
+ * This file is part of "libRaptorQ".
+ *
+ * libRaptorQ is free software: you can redistribute it and/or modify
+ * it under the terms of the GNU Lesser General Public License as
+ * published by the Free Software Foundation, either version 3
+ * of the License, or (at your option) any later version.
+ *
+ * libRaptorQ is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ * GNU General Public License for more details.
+ *
+ * You should have received a copy of the GNU General Public License
+ * and a copy of the GNU Lesser General Public License
+ * along with libRaptorQ.  If not, see <http://www.gnu.org/licenses/>.
+ */
+
+#if defined (TEST_HDR_ONLY)
+    #include "../src/RaptorQ/RaptorQ_v1_hdr.hpp"
+#else
+    #include "../src/RaptorQ/RaptorQ_v1.hpp"
+#endif
+#include "test_common.hpp"
+#include <iostream>
+#include <random>
+#include <vector>
+
+// A decoding attempt only uses the repair symbols it needs, plus the
+// maximum overhead. The cached matrices are keyed on the source symbols
+// lost and the repair symbols actually used, so decoders that lost the
+// same source symbols share the cached matrix even if they received
+// different surplus repair symbols.
+
+namespace RaptorQ = RaptorQ__v1;
+namespace Impl = RaptorQ__v1::Impl;
+
+using Enc = RaptorQ::Encoder<uint8_t*, uint8_t*>;
+using Dec = RaptorQ::Decoder<uint8_t*, uint8_t*>;
+using Cache = Impl::DLF<std::vector<uint8_t>, Impl::Cache_Key>;
+
+static const RaptorQ::Block_Size test_block = RaptorQ::Block_Size::Block_101;
+static const size_t sym_size = 16;
+static const uint16_t holes = 3;
+
+// key of a decoder that lost the "lost" symbols, and used "repairs"
+// repair symbols, from the first one.
+static Impl::Cache_Key key (const uint32_t *lost, const uint32_t repairs)
+{
+    const uint16_t syms = static_cast<uint16_t> (test_block);
+    std::vector<bool> sources (syms, true);
+    for (uint16_t idx = 0; idx < holes; ++idx)
+        sources[lost[idx]] = false;
+    const std::vector<bool> used (repairs, true);
+    return Impl::Cache_Key (Impl::Parameters (syms).L, holes, repairs,
+                                                                sources, used);
+}
+
+// decode with the "lost" symbols missing and "repairs" repair symbols.
+// 0 on error, 1 if the data was wrong, 2 if right.
+static int decode (const std::vector<uint8_t> &input,
+                                std::vector<uint8_t> &sent, const uint32_t *lost,
+                                const uint32_t repairs, const uint16_t overhead)
+{
+    const uint32_t syms = static_cast<uint32_t> (test_block);
+    Dec dec (test_block, sym_size, Dec::Report::COMPLETE);
+    if (overhead != 0)
+        dec.set_max_overhead (overhead);
+    for (uint32_t esi = 0; esi < syms + repairs; ++esi) {
+        if (esi == lost[0] || esi == lost[1] || esi == lost[2])
+            continue;
+        uint8_t *sym = sent.data() + esi * sym_size;
+        if (dec.add_symbol (sym, sym + sym_size, esi) !=
+                                                        RaptorQ::Error::NONE) {
+            std::cout << "Could not add symbol " << esi << "\n";
+            return 0;
+        }
+    }
+    if (dec.decode_once() != RaptorQ::Decoder_Result::DECODED) {
+        std::cout << "Couldn't decode\n";
+        return 0;
+    }
+    std::vector<uint8_t> received (input.size(), 0);
+    auto from = received.data();
+    const auto decoded = dec.decode_bytes (from, received.data() +
+                                                    received.size(), 0, 0);
+    if (decoded.written != received.size()) {
+        std::cout << "Short output\n";
+        return 0;
+    }
+    return received == input ? 2 : 1;
+}
+
+static bool cached (const Impl::Cache_Key &k)
+    { return Cache::get()->get (k).second.size() != 0; }
+
+int main (void)
+{
+    std::random_device rd;
+    std::mt19937_64 rnd (rd());
+    const uint32_t syms = static_cast<uint32_t> (test_block);
+    const uint32_t repairs = 30;
+    std::vector<uint8_t> input, sent;
+    if (!encode_block<Enc> (rnd, test_block, sym_size, syms + repairs, input,
+                                                                        sent)) {
+        return -1;
+    }
+    // only the decoders fill the cache from here on.
+    Cache::get()->resize (50 * 1024 * 1024);
+
+    // the default overhead: the matrix has holes + 4 repair symbols.
+    // The same lost symbols with more surplus repair symbols use it, too.
+    std::cout << "Shared matrix\n";
+    const uint32_t shared[holes] = { 3, 7, 20 };
+    if (decode (input, sent, shared, holes + 4, 0) != 2) {
+        std::cout << "Wrong output\n";
+        return -1;
+    }
+    if (!cached (key (shared, holes + 4))) {
+        std::cout << "Matrix not cached\n";
+        return -1;
+    }
+    if (decode (input, sent, shared, repairs, 0) != 2 ||
+                                            cached (key (shared, repairs))) {
+        std::cout << "Matrix cached with all the repair symbols\n";
+        return -1;
+    }
+    // a zero matrix in the cache for the next decoder: if it is used,
+    // the lost symbols come out as zeros.
+    std::cout << "Cache hit\n";
+    const uint32_t poisoned[holes] = { 0, 50, 100 };
+    const auto poison_key = key (poisoned, holes + 4);
+    std::vector<uint8_t> zeros (poison_key.out_size() * poison_key.out_size(),
+                                                                            0);
+    Cache::get()->add (RaptorQ::Compress::NONE, zeros, poison_key);
+    if (decode (input, sent, poisoned, repairs, 0) != 1) {
+        std::cout << "The cached matrix was not used\n";
+        return -1;
+    }
+
+    // set_max_overhead limits the repair symbols used.
+    std::cout << "Max overhead\n";
+    const uint32_t limited[holes] = { 1, 2, 90 };
+    if (decode (input, sent, limited, repairs, 2) != 2) {
+        std::cout << "Wrong output\n";
+        return -1;
+    }
+    if (!cached (key (limited, holes + 2)) ||
+                                        cached (key (limited, holes + 4))) {
+        std::cout << "Overhead not limited\n";
+        return -1;
+    }
+    std::cout << "All tests passed\n";
+    return 0;
+}
@@ -0,0 +1,314 @@
+/*
+ * Copyright (c) 2015-2018, Luca Fulchir<luker@fulchir.it>, All rights reserved.
+ *
+ * This file is part of "libRaptorQ".
+ *
+ * libRaptorQ is free software: you can redistribute it and/or modify
+ * it under the terms of the GNU Lesser General Public License as
+ * published by the Free Software Foundation, either version 3
+ * of the License, or (at your option) any later version.
+ *
+ * libRaptorQ is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ * GNU General Public License for more details.
+ *
+ * You should have received a copy of the GNU General Public License
+ * and a copy of the GNU Lesser General Public License
+ * along with libRaptorQ.  If not, see <http://www.gnu.org/licenses/>.
+ */
+
+#if defined (TEST_HDR_ONLY)
+    #include "../src/RaptorQ/RaptorQ_v1_hdr.hpp"
+    #include "../src/RaptorQ/RFC6330_v1_hdr.hpp"
+#else
+    #include "../src/RaptorQ/RaptorQ_v1.hpp"
+    #include "../src/RaptorQ/RFC6330_v1.hpp"
+#endif
+#include "test_common.hpp"
+#include <chrono>
+#include <condition_variable>
+#include <iostream>
+#include <mutex>
+#include <random>
+#include <vector>
+#if defined(__linux__)
+    #include <poll.h>
+    #include <unistd.h>
+#endif
+
+// Completion notifications: the callback gets one COMPUTE event when the
+// future of compute()/wait() is ready, with its result, and the RFC
+// objects first get one BLOCK event for each ready block.
+// The eventfd counts the same events.
+
+namespace RaptorQ = RaptorQ__v1;
+namespace RFC6330 = RFC6330__v1;
+
+struct Event
+{
+    RaptorQ::Notify_Event event;
+    RaptorQ::Error error;
+    uint8_t sbn;
+};
+
+// the events seen by the callback
+class Listener
+{
+public:
+    RaptorQ::Notify_Callback callback()
+    {
+        return [this] (const RaptorQ::Notify_Event event,
+                                const RaptorQ::Error error, const uint8_t sbn) {
+                std::lock_guard<std::mutex> guard (_mtx);
+                _events.push_back ({event, error, sbn});
+                _cond.notify_all();
+            };
+    }
+
+    // the events, once there are at least "count" of them
+    std::vector<Event> wait (const size_t count)
+    {
+        std::unique_lock<std::mutex> lock (_mtx);
+        _cond.wait_for (lock, std::chrono::seconds (30),
+                                    [&] { return _events.size() >= count; });
+        return _events;
+    }
+
+private:
+    std::mutex _mtx;
+    std::condition_variable _cond;
+    std::vector<Event> _events;
+};
+
+// the eventfd must count exactly "count" events
+static bool fd_count (const int fd, const uint64_t count)
+{
+#if defined(__linux__)
+    if (fd < 0) {
+        std::cout << "No eventfd\n";
+        return false;
+    }
+    // the fd is written after the callback: wait for the last writes.
+    uint64_t total = 0;
+    while (total < count) {
+        struct pollfd pfd = { fd, POLLIN, 0 };
+        if (poll (&pfd, 1, 30000) != 1) {
+            std::cout << "eventfd not readable after " << total << "\n";
+            return false;
+        }
+        uint64_t value = 0;
+        if (read (fd, &value, sizeof(value)) == sizeof(value))
+            total += value;
+    }
+    uint64_t value = 0;
+    if (total != count || read (fd, &value, sizeof(value)) > 0) {
+        std::cout << "eventfd: " << total + value << " events, not " <<
+                                                                count << "\n";
+        return false;
+    }
+    return true;
+#else
+    // no eventfd here
+    RQ_UNUSED (count);
+    return fd == -1;
+#endif
+}
+
+static bool one_compute (const std::vector<Event> &events,
+                                                const RaptorQ::Error expected)
+{
+    if (events.size() != 1 ||
+                        events[0].event != RaptorQ::Notify_Event::COMPUTE ||
+                        events[0].error != expected || events[0].sbn != 0) {
+        std::cout << "Wrong events: " << events.size() << "\n";
+        return false;
+    }
+    return true;
+}
+
+// RAW encoder: the callback, and the fd once the callback is removed.
+static bool raw_encoder (std::mt19937_64 &rnd)
+{
+    std::cout << "RAW encoder\n";
+    const RaptorQ::Block_Size block = RaptorQ::Block_Size::Block_101;
+    const size_t symbol_size = 64;
+    auto input = random_input (rnd, static_cast<size_t> (block) * symbol_size);
+    RaptorQ::Encoder<uint8_t*, uint8_t*> enc (block, symbol_size);
+    Listener listener;
+    enc.set_notify (listener.callback());
+    const int fd = enc.notify_fd();
+    if (enc.set_data (input.data(), input.data() + input.size()) !=
+                                                                input.size()) {
+        std::cout << "Could not initialize encoder.\n";
+        return false;
+    }
+    if (enc.compute().get() != RaptorQ::Error::NONE) {
+        std::cout << "Could not compute.\n";
+        return false;
+    }
+    if (!one_compute (listener.wait (1), RaptorQ::Error::NONE) ||
+                                                            !fd_count (fd, 1)) {
+        return false;
+    }
+
+    // without callback: only the fd
+    RaptorQ::Encoder<uint8_t*, uint8_t*> pre (block, symbol_size);
+    Listener removed;
+    pre.set_notify (removed.callback());
+    pre.set_notify (RaptorQ::Notify_Callback());
+    const int pre_fd = pre.notify_fd();
+    if (pre.precompute().get() != RaptorQ::Error::NONE ||
+                                                        !fd_count (pre_fd, 1)) {
+        return false;
+    }
+    if (removed.wait (0).size() != 0) {
+        std::cout << "Removed callback called\n";
+        return false;
+    }
+    return true;
+}
+
+// RAW decoder: decoded, and not enough symbols.
+static bool raw_decoder (std::mt19937_64 &rnd, const bool enough)
+{
+    std::cout << "RAW decoder, " << (enough ? "" : "not ") << "enough\n";
+    const RaptorQ::Block_Size block = RaptorQ::Block_Size::Block_101;
+    const size_t symbol_size = 64;
+    auto input = random_input (rnd, static_cast<size_t> (block) * symbol_size);
+    RaptorQ::Encoder<uint8_t*, uint8_t*> enc (block, symbol_size);
+    if (!init_encoder (enc, input))
+        return false;
+    using Dec = RaptorQ::Decoder<uint8_t*, uint8_t*>;
+    Dec dec (block, symbol_size, Dec::Report::COMPLETE);
+    Listener listener;
+    dec.set_notify (listener.callback());
+    const int fd = dec.notify_fd();
+    auto waiting = dec.wait();
+    // every other source symbol, replaced by repair symbols
+    const uint32_t syms = enc.symbols();
+    const uint32_t total = enough ? syms + syms / 2 + 4 : syms;
+    std::vector<uint8_t> sym (symbol_size);
+    for (uint32_t esi = 0; esi < total; ++esi) {
+        if (esi < syms && esi % 2 == 0)
+            continue;
+        if (enc.encode (sym.data(), sym.size(), esi) != sym.size() ||
+                dec.add_symbol (sym.data(), sym.size(), esi) !=
+                                                        RaptorQ::Error::NONE) {
+            std::cout << "Could not add symbol " << esi << "\n";
+            return false;
+        }
+    }
+    if (!enough)
+        dec.end_of_input (RaptorQ::Fill_With_Zeros::NO);
+    const RaptorQ::Error expected = enough ? RaptorQ::Error::NONE :
+                                                    RaptorQ::Error::NEED_DATA;
+    if (waiting.get().error != expected) {
+        std::cout << "Wrong wait() result\n";
+        return false;
+    }
+    return one_compute (listener.wait (1), expected) && fd_count (fd, 1);
+}
+
+// the BLOCK events, each block once, and COMPUTE last
+static bool rfc_events (const std::vector<Event> &events,
+                                                        const uint8_t blocks)
+{
+    std::vector<bool> seen (blocks, false);
+    for (size_t idx = 0; idx + 1 < events.size(); ++idx) {
+        if (events[idx].event != RaptorQ::Notify_Event::BLOCK ||
+                                    events[idx].error != RaptorQ::Error::NONE ||
+                                    events[idx].sbn >= blocks ||
+                                    seen[events[idx].sbn]) {
+            std::cout << "Wrong BLOCK event " << idx << "\n";
+            return false;
+        }
+        seen[events[idx].sbn] = true;
+    }
+    if (events.size() != blocks + 1u ||
+                    events.back().event != RaptorQ::Notify_Event::COMPUTE ||
+                    events.back().error != RaptorQ::Error::NONE) {
+        std::cout << "Wrong events: " << events.size() << "\n";
+        return false;
+    }
+    return true;
+}
+
+// RFC encoder and decoder, through the pool
+static bool rfc (std::mt19937_64 &rnd)
+{
+    std::cout << "RFC\n";
+    using Enc = RFC6330::Encoder<uint8_t*, uint8_t*>;
+    using Dec = RFC6330::Decoder<uint8_t*, uint8_t*>;
+    const uint16_t symbol_size = 64;
+    auto input = random_input (rnd, 100000);
+    // about 5 blocks
+    Enc enc (input.data(), input.data() + input.size(), symbol_size,
+                                                    symbol_size, 20000);
+    if (!enc) {
+        std::cout << "Could not initialize encoder.\n";
+        return false;
+    }
+    Listener enc_listener;
+    enc.set_notify (enc_listener.callback());
+    const int enc_fd = enc.notify_fd();
+    if (enc.compute (RFC6330::Compute::COMPLETE).get().first !=
+                                                        RFC6330::Error::NONE) {
+        std::cout << "Could not compute.\n";
+        return false;
+    }
+    const uint8_t blocks = enc.blocks();
+    if (blocks < 2 ||
+            !rfc_events (enc_listener.wait (blocks + 1u), blocks) ||
+                                            !fd_count (enc_fd, blocks + 1u)) {
+        return false;
+    }
+
+    Dec dec (enc.OTI_Common(), enc.OTI_Scheme_Specific());
+    if (!dec) {
+        std::cout << "Could not initialize decoder.\n";
+        return false;
+    }
+    Listener dec_listener;
+    dec.set_notify (dec_listener.callback());
+    const int dec_fd = dec.notify_fd();
+    auto decoded = dec.compute (RFC6330::Compute::COMPLETE);
+    std::vector<uint8_t> sym (symbol_size);
+    for (uint8_t sbn = 0; sbn < blocks; ++sbn) {
+        const uint32_t syms = enc.symbols (sbn);
+        for (uint32_t esi = 0; esi < syms + syms / 3 + 4; ++esi) {
+            if (esi < syms && esi % 3 == 0)
+                continue;
+            if (enc.encode (sym.data(), sym.size(), esi, sbn) != sym.size()) {
+                std::cout << "Could not encode symbol " << esi << "\n";
+                return false;
+            }
+            // decoded blocks do not need the rest of their symbols
+            const auto err = dec.add_symbol (sym.data(), sym.size(), esi, sbn);
+            if (err != RFC6330::Error::NONE &&
+                                        err != RFC6330::Error::NOT_NEEDED) {
+                std::cout << "Could not add symbol " << esi << "\n";
+                return false;
+            }
+        }
+    }
+    if (decoded.get().first != RFC6330::Error::NONE) {
+        std::cout << "Couldn't decode.\n";
+        return false;
+    }
+    return rfc_events (dec_listener.wait (blocks + 1u), blocks) &&
+                                            fd_count (dec_fd, blocks + 1u);
+}
+
+int main (void)
+{
+    std::random_device rd;
+    std::mt19937_64 rnd (rd());
+
+    if (!raw_encoder (rnd) || !raw_decoder (rnd, true) ||
+                                !raw_decoder (rnd, false) || !rfc (rnd)) {
+        return -1;
+    }
+    std::cout << "All tests passed\n";
+    return 0;
+}
@@ -0,0 +1,108 @@
+/*
+ * Copyright (c) 2015-2018, Luca Fulchir<luker@fulchir.it>, All rights reserved.
+ *
+ * This file is part of "libRaptorQ".
+ *
+ * libRaptorQ is free software: you can redistribute it and/or modify
+ * it under the terms of the GNU Lesser General Public License as
+ * published by the Free Software Foundation, either version 3
+ * of the License, or (at your option) any later version.
+ *
+ * libRaptorQ is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ * GNU General Public License for more details.
+ *
+ * You should have received a copy of the GNU General Public License
+ * and a copy of the GNU Lesser General Public License
+ * along with libRaptorQ.  If not, see <http://www.gnu.org/licenses/>.
+ */
+
+#if defined (TEST_HDR_ONLY)
+    #include "../src/RaptorQ/RaptorQ_v1_hdr.hpp"
+#else
+    #include "../src/RaptorQ/RaptorQ_v1.hpp"
+#endif
+#include <iostream>
+
+// Parameters finds its row of the RFC tables and the LT degree with a
+// binary search. It must find the same as a plain scan of the tables,
+// for every number of symbols and every value of "v".
+
+namespace Impl = RaptorQ__v1::Impl;
+
+// the first K' that can hold "symbols", by scanning the whole table
+static size_t scan_K (const uint16_t symbols)
+{
+    for (size_t idx = 0; idx < Impl::K_padded.size(); ++idx) {
+        if (Impl::K_padded[idx] >= symbols)
+            return idx;
+    }
+    return Impl::K_padded.size();
+}
+
+// rfc 6330, pg 27: the first d with v < degree_distribution[d]
+static uint16_t scan_Deg (const uint32_t v, const uint16_t W)
+{
+    for (uint16_t d = 0; d < Impl::degree_distribution.size(); ++d) {
+        if (v < Impl::degree_distribution[d])
+            return (d < (W - 2)) ? d : (W - 2);
+    }
+    return 0;
+}
+
+static bool lookup()
+{
+    std::cout << "K' lookup\n";
+    for (uint32_t symbols = 1; symbols <= Impl::K_max; ++symbols) {
+        const Impl::Parameters params (static_cast<uint16_t> (symbols));
+        const size_t idx = scan_K (static_cast<uint16_t> (symbols));
+        if (idx >= Impl::K_padded.size() ||
+                                params.K_padded != Impl::K_padded[idx] ||
+                                params.J != Impl::J_K_padded[idx] ||
+                                params.S != Impl::S_H_W[idx][0] ||
+                                params.H != Impl::S_H_W[idx][1] ||
+                                params.W != Impl::S_H_W[idx][2] ||
+                                params.L != params.K_padded + params.S +
+                                                                params.H) {
+            std::cout << "Wrong parameters for " << symbols << " symbols\n";
+            return false;
+        }
+    }
+#ifdef NDEBUG
+    // no assert: too many symbols get the biggest block.
+    if (Impl::Parameters (static_cast<uint16_t> (Impl::K_max + 1)).K_padded !=
+                                                                Impl::K_max) {
+        std::cout << "Too many symbols not clamped\n";
+        return false;
+    }
+#endif
+    return true;
+}
+
+static bool degree()
+{
+    std::cout << "Degree\n";
+    // every W in the table: only W - 2 changes the result
+    for (size_t idx = 0; idx < Impl::K_padded.size(); ++idx) {
+        if (idx != 0 && Impl::S_H_W[idx][2] == Impl::S_H_W[idx - 1][2])
+            continue;
+        const Impl::Parameters params (Impl::K_padded[idx]);
+        for (uint32_t v = 0; v < (1u << 20); ++v) {
+            if (params.Deg (v) != scan_Deg (v, params.W)) {
+                std::cout << "Wrong degree for v = " << v << ", W = " <<
+                                                            params.W << "\n";
+                return false;
+            }
+        }
+    }
+    return true;
+}
+
+int main (void)
+{
+    if (!lookup() || !degree())
+        return -1;
+    std::cout << "All tests passed\n";
+    return 0;
+}
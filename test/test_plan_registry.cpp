@@ -0,0 +1,269 @@
+/*
+ * Copyright (c) 2015-2018, Luca Fulchir<luker@fulchir.it>, All rights reserved.
+ *
+ * This file is part of "libRaptorQ".
+ *
+ * libRaptorQ is free software: you can redistribute it and/or modify
+ * it under the terms of the GNU Lesser General Public License as
+ * published by the Free Software Foundation, either version 3
+ * of the License, or (at your option) any later version.
+ *
+ * libRaptorQ is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ * GNU General Public License for more details.
+ *
+ * You should have received a copy of the GNU General Public License
+ * and a copy of the GNU Lesser General Public License
+ * along with libRaptorQ.  If not, see <http://www.gnu.org/licenses/>.
+ */
+
+#if defined (TEST_HDR_ONLY)
+    #include "../src/RaptorQ/RaptorQ_v1_hdr.hpp"
+#else
+    #include "../src/RaptorQ/RaptorQ_v1.hpp"
+#endif
+#include <algorithm>
+#include <deque>
+#include <iostream>
+#include <memory>
+#include <vector>
+
+// The process-wide registry of the per-K' plans:
+// plans are shared between precode matrices, together with their tuples,
+// and the least recently used ones are dropped first.
+// Plans too big for the registry are never built: the precode matrix
+// is generated in place. The size of the registry can be changed.
+
+namespace Impl = RaptorQ__v1::Impl;
+
+using Precode = Impl::Precode_Matrix<Impl::Save_Computation::OFF>;
+
+static bool same (const Impl::Tuple &a, const Impl::Tuple &b)
+{
+    return a.d == b.d && a.a == b.a && a.b == b.b && a.d1 == b.d1 &&
+                                                a.a1 == b.a1 && a.b1 == b.b1;
+}
+
+// plans are built once, and found by everybody else
+static bool hits()
+{
+    std::cout << "Hits\n";
+    auto &registry = Impl::Plan_Registry::get();
+    const Impl::Parameters params (10);
+    if (registry.find (params.K_padded) != nullptr) {
+        std::cout << "Plan found before building it\n";
+        return false;
+    }
+    Precode first (params);
+    if (first.plan() != nullptr) {
+        std::cout << "Plan without gen()\n";
+        return false;
+    }
+    first.gen (0);
+    const auto plan = first.plan();
+    if (plan == nullptr || registry.find (params.K_padded) != plan) {
+        std::cout << "Plan not registered\n";
+        return false;
+    }
+    Precode second (params);
+    second.gen (2);
+    if (second.plan() != plan) {
+        std::cout << "Plan built twice\n";
+        return false;
+    }
+    // the cached tuples, and what is after them
+    for (uint32_t isi = 0; isi < 3u * params.K_padded; ++isi) {
+        const auto idxs = plan->get_idxs (isi);
+        const auto expected = params.get_idxs (isi);
+        if (!same (plan->tuple (isi), params.tuple (isi)) ||
+                                        idxs.size() != expected.size() ||
+                                        !std::equal (idxs.begin(), idxs.end(),
+                                                            expected.begin())) {
+            std::cout << "Wrong tuple for ISI " << isi << "\n";
+            return false;
+        }
+    }
+    return true;
+}
+
+// a plan with the right size, without the expensive matrix
+static std::shared_ptr<const Impl::Plan> fake_plan (const uint16_t symbols)
+{
+    const Impl::Parameters params (symbols);
+    RaptorQ__v1::Impl::DenseMtx A (params.L, params.L);
+    A.setZero();
+    return std::make_shared<const Impl::Plan> (params, std::move (A),
+                                            Impl::Plan::make_tuples (params));
+}
+
+static bool eviction()
+{
+    std::cout << "Eviction\n";
+    auto &registry = Impl::Plan_Registry::get();
+    const uint16_t small = Impl::Parameters (10).K_padded;
+    // ~16MB each: only three fit.
+    const auto a = fake_plan (4000);
+    const auto b = fake_plan (4100);
+    const auto c = fake_plan (4200);
+    const auto d = fake_plan (4300);
+    if (a->bytes() + b->bytes() + c->bytes() + d->bytes() <=
+                                                    registry.max_bytes() ||
+                        a->bytes() + c->bytes() + d->bytes() >
+                                                    registry.max_bytes()) {
+        std::cout << "Wrong plan sizes\n";
+        return false;
+    }
+    registry.add (a);
+    registry.add (b);
+    registry.add (c);
+    // "a" is now the most recently used. "small" and "b" are the oldest.
+    if (registry.find (a->_params.K_padded) != a) {
+        std::cout << "Plan lost too early\n";
+        return false;
+    }
+    registry.add (d);
+    if (registry.find (small) != nullptr ||
+                                registry.find (b->_params.K_padded) != nullptr) {
+        std::cout << "Old plans not dropped\n";
+        return false;
+    }
+    if (registry.find (a->_params.K_padded) != a ||
+                                registry.find (c->_params.K_padded) != c ||
+                                registry.find (d->_params.K_padded) != d) {
+        std::cout << "Recent plans dropped\n";
+        return false;
+    }
+    // dropped, but still usable by whoever has it
+    if (b->_A.rows() != b->_params.L) {
+        std::cout << "Dropped plan freed\n";
+        return false;
+    }
+    // too big to be kept at all
+    const auto big = fake_plan (8000);
+    registry.add (big);
+    if (registry.find (big->_params.K_padded) != nullptr ||
+                                registry.find (d->_params.K_padded) != d) {
+        std::cout << "Plan bigger than the registry was kept\n";
+        return false;
+    }
+    return true;
+}
+
+// K' too big for a plan: A is built in place, nothing is registered.
+static bool in_place()
+{
+    std::cout << "In place\n";
+    auto &registry = Impl::Plan_Registry::get();
+    const Impl::Parameters params (8000);
+    if (registry.fits (Impl::Plan::bytes (params))) {
+        std::cout << "Plan not big enough\n";
+        return false;
+    }
+    const auto kept = registry.find (Impl::Parameters (4000).K_padded);
+    Precode precode (params);
+    precode.gen (2);
+    if (precode.plan() != nullptr ||
+                                registry.find (params.K_padded) != nullptr) {
+        std::cout << "Plan bigger than the registry was built\n";
+        return false;
+    }
+    if (kept == nullptr ||
+                registry.find (Impl::Parameters (4000).K_padded) != kept) {
+        std::cout << "Plans dropped for a plan never kept\n";
+        return false;
+    }
+    // the LDPC and HDPC identities
+    const auto constraints = precode.constraints();
+    if (constraints.rows() != params.S + params.H ||
+                                        constraints.cols() != params.L) {
+        std::cout << "Wrong matrix size\n";
+        return false;
+    }
+    for (uint16_t row = 0; row < params.S + params.H; ++row) {
+        const uint16_t one = row < params.S ? params.B + row :
+                                (params.L - params.H) + (row - params.S);
+        const uint16_t from = row < params.S ? params.B : params.L - params.H;
+        const uint16_t size = row < params.S ? params.S : params.H;
+        for (uint16_t col = from; col < from + size; ++col) {
+            if (constraints (row, col) != (col == one ? 1 : 0)) {
+                std::cout << "Wrong constraint row " << row << "\n";
+                return false;
+            }
+        }
+    }
+    for (uint32_t isi = 0; isi < 3u * params.K_padded; isi += 97) {
+        if (!same (precode.tuple (isi), params.tuple (isi))) {
+            std::cout << "Wrong tuple for ISI " << isi << "\n";
+            return false;
+        }
+    }
+    return true;
+}
+
+// plan_cache_size, clear_plan_cache, and gen() only when needed
+static bool settings()
+{
+    std::cout << "Settings\n";
+    auto &registry = Impl::Plan_Registry::get();
+    const Impl::Parameters params (8000);
+    if (RaptorQ__v1::get_plan_cache_size() !=
+                                    Impl::Plan_Registry::default_bytes ||
+            RaptorQ__v1::plan_cache_size (2 * Impl::Plan::bytes (params)) !=
+                                            2 * Impl::Plan::bytes (params)) {
+        std::cout << "Could not resize\n";
+        return false;
+    }
+    // now K' = 8000 fits
+    Precode big (params);
+    big.gen (0);
+    if (big.plan() == nullptr || registry.find (params.K_padded) == nullptr) {
+        std::cout << "Big plan not kept\n";
+        return false;
+    }
+    if (!big.generated()) {
+        std::cout << "Matrix not generated\n";
+        return false;
+    }
+    RaptorQ__v1::clear_plan_cache();
+    if (registry.find (params.K_padded) != nullptr ||
+                                        big.plan()->_A.rows() != params.L) {
+        std::cout << "Wrong clear\n";
+        return false;
+    }
+    // disabled: nothing is kept
+    RaptorQ__v1::plan_cache_size (0);
+    Precode small (Impl::Parameters (10));
+    small.gen (0);
+    if (small.plan() != nullptr ||
+                registry.find (Impl::Parameters (10).K_padded) != nullptr) {
+        std::cout << "Plan kept with the registry disabled\n";
+        return false;
+    }
+    RaptorQ__v1::plan_cache_size (Impl::Plan_Registry::default_bytes);
+
+    // the solver uses the matrix: it must be generated again after that
+    const Impl::Parameters ten (10);
+    Precode precode (ten);
+    precode.gen (0);
+    RaptorQ__v1::Impl::DenseMtx D (precode._params.L, 4);
+    D.setZero();
+    std::deque<Impl::Operation> ops;
+    bool keep_working = true;
+    const RaptorQ__v1::Work_State state =
+                                    RaptorQ__v1::Work_State::KEEP_WORKING;
+    precode.intermediate (D, ops, keep_working, &state);
+    if (precode.generated()) {
+        std::cout << "Used matrix still marked as generated\n";
+        return false;
+    }
+    return true;
+}
+
+int main (void)
+{
+    if (!hits() || !eviction() || !in_place() || !settings())
+        return -1;
+    std::cout << "All tests passed\n";
+    return 0;
+}
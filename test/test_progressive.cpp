@@ -0,0 +1,156 @@
+/*
+ * Copyright (c) 2015-2018, Luca Fulchir<luker@fulchir.it>, All rights reserved.
+ *
+ * This file is part of "libRaptorQ".
+ *
+ * libRaptorQ is free software: you can redistribute it and/or modify
+ * it under the terms of the GNU Lesser General Public License as
+ * published by the Free Software Foundation, either version 3
+ * of the License, or (at your option) any later version.
+ *
+ * libRaptorQ is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ * GNU General Public License for more details.
+ *
+ * You should have received a copy of the GNU General Public License
+ * and a copy of the GNU Lesser General Public License
+ * along with libRaptorQ.  If not, see <http://www.gnu.org/licenses/>.
+ */
+
+#if defined (TEST_HDR_ONLY)
+    #include "../src/RaptorQ/RaptorQ_v1_hdr.hpp"
+#else
+    #include "../src/RaptorQ/RaptorQ_v1.hpp"
+#endif
+#include "test_common.hpp"
+#include "../src/RaptorQ/v1/Progressive_Solver.hpp"
+#include <algorithm>
+#include <iostream>
+#include <random>
+#include <vector>
+
+// Progressive decoding: every symbol is eliminated as soon as it arrives.
+// The solver must find the same intermediate symbols as the encoder,
+// whatever the order of the symbols, and the decoder must use it.
+
+namespace RaptorQ = RaptorQ__v1;
+
+using Enc = RaptorQ::Encoder<uint8_t*, uint8_t*>;
+using Dec = RaptorQ::Decoder<uint8_t*, uint8_t*>;
+
+// the solver alone: shuffled symbols, duplicates add nothing,
+// and the intermediate symbols give back the source ones.
+static bool solver (std::mt19937_64 &rnd, const RaptorQ::Block_Size block)
+{
+    std::cout << "Solver: " << static_cast<uint32_t> (block) << "\n";
+    const size_t symbol_size = 8;
+    const uint16_t syms = static_cast<uint16_t> (block);
+    const uint32_t total = syms + 40u;
+    std::vector<uint8_t> input, sent;
+    if (!encode_block<Enc> (rnd, block, symbol_size, total, input, sent))
+        return false;
+    const RaptorQ::Impl::Parameters params (syms);
+    std::vector<uint32_t> esi (total);
+    for (uint32_t id = 0; id < total; ++id)
+        esi[id] = id;
+    std::shuffle (esi.begin(), esi.end(), rnd);
+
+    RaptorQ::Impl::Progressive_Solver prog (params,
+                                        static_cast<int32_t> (symbol_size));
+    uint32_t used = 0;
+    for (; used < total && !prog.solved(); ++used) {
+        RaptorQ::Impl::DenseMtx row (1, static_cast<int32_t> (symbol_size));
+        for (size_t byte = 0; byte < symbol_size; ++byte) {
+            row (0, static_cast<int32_t> (byte)) =
+                                        sent[esi[used] * symbol_size + byte];
+        }
+        const uint16_t rank = prog.rank();
+        const bool added = prog.add (esi[used], row);
+        if (added != (prog.rank() == rank + 1)) {
+            std::cout << "Wrong rank\n";
+            return false;
+        }
+        if (prog.add (esi[used], row)) {
+            std::cout << "Duplicate symbol added\n";
+            return false;
+        }
+    }
+    if (!prog.solved() || used < syms) {
+        std::cout << "Not solved after " << used << " symbols\n";
+        return false;
+    }
+    const RaptorQ::Impl::DenseMtx C = prog.intermediate();
+    const RaptorQ::Impl::Precode_Matrix<
+                        RaptorQ::Impl::Save_Computation::OFF> precode (params);
+    for (uint32_t id = 0; id < total; ++id) {
+        const RaptorQ::Impl::DenseMtx sym = precode.encode (C, id);
+        for (size_t byte = 0; byte < symbol_size; ++byte) {
+            if (static_cast<uint8_t> (sym (0, static_cast<int32_t> (byte))) !=
+                                            sent[id * symbol_size + byte]) {
+                std::cout << "Wrong symbol " << id << "\n";
+                return false;
+            }
+        }
+    }
+    return true;
+}
+
+// the decoder switches to progressive with half the symbols already there.
+static bool decoder (std::mt19937_64 &rnd, const RaptorQ::Block_Size block,
+                                                    const size_t symbol_size)
+{
+    std::cout << "Decoder: " << static_cast<uint32_t> (block) << "\n";
+    const uint16_t syms = static_cast<uint16_t> (block);
+    const uint32_t lost = syms / 4 + 1;
+    const uint32_t total = syms + lost + 4;
+    std::vector<uint8_t> input, sent;
+    if (!encode_block<Enc> (rnd, block, symbol_size, total, input, sent))
+        return false;
+    std::vector<uint32_t> esi;
+    for (uint32_t id = 0; id < total; ++id) {
+        if (id >= syms || id % 4 != 1)
+            esi.push_back (id);
+    }
+    std::shuffle (esi.begin(), esi.end(), rnd);
+
+    Dec dec (block, symbol_size, Dec::Report::COMPLETE);
+    for (size_t idx = 0; idx < esi.size(); ++idx) {
+        if (idx == esi.size() / 2)
+            dec.set_progressive (true);
+        if (idx < syms && dec.can_decode()) {
+            std::cout << "Decodable with " << idx << " symbols\n";
+            return false;
+        }
+        uint8_t *sym = sent.data() + esi[idx] * symbol_size;
+        if (dec.add_symbol (sym, sym + symbol_size, esi[idx]) !=
+                                                        RaptorQ::Error::NONE) {
+            std::cout << "Could not add symbol " << esi[idx] << "\n";
+            return false;
+        }
+    }
+    if (!dec.can_decode() ||
+                    dec.decode_once() != RaptorQ::Decoder_Result::DECODED) {
+        std::cout << "Couldn't decode.\n";
+        return false;
+    }
+    return check_output (dec, input);
+}
+
+int main (void)
+{
+    std::random_device rd;
+    std::mt19937_64 rnd (rd());
+
+    if (!solver (rnd, RaptorQ::Block_Size::Block_10) ||
+                                !solver (rnd, RaptorQ::Block_Size::Block_101)) {
+        return -1;
+    }
+    if (!decoder (rnd, RaptorQ::Block_Size::Block_10, 16) ||
+                        !decoder (rnd, RaptorQ::Block_Size::Block_101, 64) ||
+                        !decoder (rnd, RaptorQ::Block_Size::Block_1002, 32)) {
+        return -1;
+    }
+    std::cout << "All tests passed\n";
+    return 0;
+}
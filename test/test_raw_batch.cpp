@@ -0,0 +1,176 @@
+/*
+ * Copyright (c) 2015-2018, Luca Fulchir<luker@fulchir.it>, All rights reserved.
+ *
+ * This file is part of "libRaptorQ".
+ *
+ * libRaptorQ is free software: you can redistribute it and/or modify
+ * it under the terms of the GNU Lesser General Public License as
+ * published by the Free Software Foundation, either version 3
+ * of the License, or (at your option) any later version.
+ *
+ * libRaptorQ is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ * GNU General Public License for more details.
+ *
+ * You should have received a copy of the GNU General Public License
+ * and a copy of the GNU Lesser General Public License
+ * along with libRaptorQ.  If not, see <http://www.gnu.org/licenses/>.
+ */
+
+#if defined (TEST_HDR_ONLY)
+    #include "../src/RaptorQ/RaptorQ_v1_hdr.hpp"
+#else
+    #include "../src/RaptorQ/RaptorQ_v1.hpp"
+#endif
+#include "test_common.hpp"
+#include <algorithm>
+#include <iostream>
+#include <limits>
+#include <random>
+#include <vector>
+
+// Round trip through the batch entry points of the RAW interface:
+// encode_range and encode_list -> add_symbols.
+// The batches must not go past the last repair symbol.
+
+namespace RaptorQ = RaptorQ__v1;
+
+using Enc = RaptorQ::Encoder<uint8_t*, uint8_t*>;
+using Dec = RaptorQ::Decoder<uint8_t*, uint8_t*>;
+
+static bool batch (std::mt19937_64 &rnd, const RaptorQ::Block_Size block,
+                                                    const size_t symbol_size)
+{
+    std::cout << "Batch: " << static_cast<uint32_t> (block) << " symbols of "
+                                                    << symbol_size << "\n";
+    const size_t size = static_cast<size_t> (block) * symbol_size;
+    auto input = random_input (rnd, size);
+
+    Enc enc (block, symbol_size);
+    if (!init_encoder (enc, input))
+        return false;
+    const uint32_t syms = enc.symbols();
+    // the source symbols, in a single batch. one in four gets lost.
+    std::vector<uint8_t> source (syms * symbol_size);
+    if (enc.encode_range (source.data(), source.size(), 0, syms) != syms) {
+        std::cout << "encode_range failed\n";
+        return false;
+    }
+    for (uint32_t esi = 0; esi < syms; ++esi) {
+        const uint8_t *sym = source.data() + esi * symbol_size;
+        for (size_t idx = 0; idx < symbol_size; ++idx) {
+            if (sym[idx] != input[esi * symbol_size + idx]) {
+                std::cout << "Wrong source symbol " << esi << "\n";
+                return false;
+            }
+        }
+    }
+    std::vector<uint32_t> esi;
+    std::vector<uint8_t> sent;
+    for (uint32_t id = 0; id < syms; ++id) {
+        if (id % 4 == 0)
+            continue;
+        esi.push_back (id);
+        const uint8_t *sym = source.data() + id * symbol_size;
+        sent.insert (sent.end(), sym, sym + symbol_size);
+    }
+    // scattered repair symbols
+    std::vector<uint32_t> repair_ids;
+    for (uint32_t id = 0; repair_ids.size() < syms / 4 + 4; id += 3)
+        repair_ids.push_back (syms + id);
+    const uint32_t repairs = static_cast<uint32_t> (repair_ids.size());
+    std::vector<uint8_t> repair (repairs * symbol_size);
+    if (enc.encode_list (repair.data(), repair.size(), repair_ids.data(),
+                                                        repairs) != repairs) {
+        std::cout << "encode_list failed\n";
+        return false;
+    }
+    esi.insert (esi.end(), repair_ids.begin(), repair_ids.end());
+    sent.insert (sent.end(), repair.begin(), repair.end());
+
+    Dec dec (block, symbol_size, Dec::Report::COMPLETE);
+    const uint32_t count = static_cast<uint32_t> (esi.size());
+    // a partial symbol at the end is not added
+    const size_t added = dec.add_symbols (sent.data(), sent.size() - 1,
+                                                            esi.data(), count);
+    if (added != count - 1) {
+        std::cout << "add_symbols: " << added << " vs " << count - 1 << "\n";
+        return false;
+    }
+    if (dec.add_symbols (sent.data() + (count - 1) * symbol_size, symbol_size,
+                                                &esi[count - 1], 1) != 1) {
+        std::cout << "add_symbols refused the last symbol\n";
+        return false;
+    }
+    dec.end_of_input (RaptorQ::Fill_With_Zeros::NO);
+    const auto res = dec.wait_sync();
+    if (res.error != RaptorQ::Error::NONE) {
+        std::cout << "Couldn't decode.\n";
+        return false;
+    }
+    return check_output (dec, input);
+}
+
+// the batch stops at the last repair symbol, and gives the same
+// symbols as encode()
+static bool limits (std::mt19937_64 &rnd)
+{
+    std::cout << "Limits\n";
+    const RaptorQ::Block_Size block = RaptorQ::Block_Size::Block_10;
+    const size_t symbol_size = 16;
+    const size_t size = static_cast<size_t> (block) * symbol_size;
+    auto input = random_input (rnd, size);
+    Enc enc (block, symbol_size);
+    if (!init_encoder (enc, input))
+        return false;
+    const uint32_t max = enc.max_repair();
+    const uint32_t syms = enc.symbols();
+    std::vector<uint8_t> out (5 * symbol_size);
+    const auto same = [&] (const uint32_t idx, const uint32_t esi) {
+            std::vector<uint8_t> single (symbol_size);
+            auto from = single.data();
+            if (enc.encode (from, single.data() + single.size(), esi) !=
+                                                                symbol_size) {
+                return false;
+            }
+            return std::equal (single.begin(), single.end(),
+                                            out.begin() + idx * symbol_size);
+        };
+    if (enc.encode_range (out.data(), out.size(), max - 2, 5) != 3 ||
+                                !same (0, max - 2) || !same (2, max)) {
+        std::cout << "encode_range past max_repair\n";
+        return false;
+    }
+    const uint32_t ids[] = { syms + 1, max, max + 1, syms + 2 };
+    if (enc.encode_list (out.data(), out.size(), ids, 4) != 2 ||
+                                    !same (0, syms + 1) || !same (1, max)) {
+        std::cout << "encode_list past max_repair\n";
+        return false;
+    }
+    // no wrap around
+    const uint32_t last = std::numeric_limits<uint32_t>::max();
+    if (enc.encode_range (out.data(), out.size(), max + 1, 1) != 0 ||
+            enc.encode_range (out.data(), out.size(), last - 1, 5) != 0) {
+        std::cout << "encode_range after max_repair\n";
+        return false;
+    }
+    return true;
+}
+
+int main (void)
+{
+    std::random_device rd;
+    std::mt19937_64 rnd (rd());
+
+    if (!batch (rnd, RaptorQ::Block_Size::Block_10, 16))
+        return -1;
+    if (!batch (rnd, RaptorQ::Block_Size::Block_101, 1024))
+        return -1;
+    if (!batch (rnd, RaptorQ::Block_Size::Block_1002, 64))
+        return -1;
+    if (!limits (rnd))
+        return -1;
+    std::cout << "All tests passed\n";
+    return 0;
+}
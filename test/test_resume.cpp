@@ -0,0 +1,123 @@
+/*
+ * Copyright (c) 2015-2018, Luca Fulchir<luker@fulchir.it>, All rights reserved.
+ *
+ * This file is part of "libRaptorQ".
+ *
+ * libRaptorQ is free software: you can redistribute it and/or modify
+ * it under the terms of the GNU Lesser General Public License as
+ * published by the Free Software Foundation, either version 3
+ * of the License, or (at your option) any later version.
+ *
+ * libRaptorQ is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ * GNU General Public License for more details.
+ *
+ * You should have received a copy of the GNU General Public License
+ * and a copy of the GNU Lesser General Public License
+ * along with libRaptorQ.  If not, see <http://www.gnu.org/licenses/>.
+ */
+
+#if defined (TEST_HDR_ONLY)
+    #include "../src/RaptorQ/RaptorQ_v1_hdr.hpp"
+#else
+    #include "../src/RaptorQ/RaptorQ_v1.hpp"
+#endif
+#include "test_common.hpp"
+#include <algorithm>
+#include <iostream>
+#include <random>
+#include <vector>
+
+// A decoding attempt with just K symbols fails now and then.
+// The next attempts must continue from there as more symbols arrive,
+// and still give back the original data.
+
+namespace RaptorQ = RaptorQ__v1;
+
+using Enc = RaptorQ::Encoder<uint8_t*, uint8_t*>;
+using Dec = RaptorQ::Decoder<uint8_t*, uint8_t*>;
+
+// returns the number of failed attempts that were resumed, -1 on error
+static int32_t resume (std::mt19937_64 &rnd, const RaptorQ::Block_Size block,
+                                const size_t symbol_size, const uint32_t trials)
+{
+    std::cout << "Resume: " << static_cast<uint32_t> (block) << "\n";
+    const uint32_t syms = static_cast<uint32_t> (block);
+    // plenty of repair symbols, so that every trial uses different ones
+    const uint32_t repairs = 1000;
+    std::vector<uint8_t> input, sent;
+    if (!encode_block<Enc> (rnd, block, symbol_size, syms + repairs, input,
+                                                                        sent)) {
+        return -1;
+    }
+    std::vector<uint32_t> sources (syms), repair_ids (repairs);
+    for (uint32_t id = 0; id < syms; ++id)
+        sources[id] = id;
+    for (uint32_t id = 0; id < repairs; ++id)
+        repair_ids[id] = syms + id;
+    std::uniform_int_distribution<uint32_t> lost_distr (1, syms / 2);
+
+    int32_t resumed = 0;
+    for (uint32_t trial = 0; trial < trials; ++trial) {
+        std::shuffle (sources.begin(), sources.end(), rnd);
+        std::shuffle (repair_ids.begin(), repair_ids.end(), rnd);
+        const uint32_t lost = lost_distr (rnd);
+        Dec dec (block, symbol_size, Dec::Report::COMPLETE);
+        const auto add = [&] (const uint32_t esi) {
+                uint8_t *sym = sent.data() + esi * symbol_size;
+                return dec.add_symbol (sym, sym + symbol_size, esi) ==
+                                                        RaptorQ::Error::NONE;
+            };
+        // exactly K symbols
+        for (uint32_t idx = lost; idx < syms; ++idx) {
+            if (!add (sources[idx]))
+                return -1;
+        }
+        uint32_t next = 0;
+        for (; next < lost; ++next) {
+            if (!add (repair_ids[next]))
+                return -1;
+        }
+        auto res = dec.decode_once();
+        if (res != RaptorQ::Decoder_Result::DECODED) {
+            // one more symbol at a time, until it works.
+            ++resumed;
+            while (res != RaptorQ::Decoder_Result::DECODED &&
+                                                        next < lost + 10) {
+                if (!add (repair_ids[next++]))
+                    return -1;
+                res = dec.decode_once();
+            }
+            if (res != RaptorQ::Decoder_Result::DECODED) {
+                std::cout << "Could not resume decoding\n";
+                return -1;
+            }
+        }
+        if (!check_output (dec, input)) {
+            std::cout << "On trial " << trial << "\n";
+            return -1;
+        }
+    }
+    return resumed;
+}
+
+int main (void)
+{
+    std::random_device rd;
+    std::mt19937_64 rnd (rd());
+
+    const int32_t small = resume (rnd, RaptorQ::Block_Size::Block_10, 16,
+                                                                        20000);
+    if (small < 0)
+        return -1;
+    const int32_t big = resume (rnd, RaptorQ::Block_Size::Block_101, 16, 2000);
+    if (big < 0)
+        return -1;
+    // K symbols fail ~1% of the times: make sure we tested something.
+    std::cout << "Resumed: " << small << " + " << big << "\n";
+    if (small + big == 0)
+        return -1;
+    std::cout << "All tests passed\n";
+    return 0;
+}
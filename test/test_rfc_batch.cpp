@@ -0,0 +1,442 @@
+/*
+ * Copyright (c) 2015-2018, Luca Fulchir<luker@fulchir.it>, All rights reserved.
+ *
+ * This file is part of "libRaptorQ".
+ *
+ * libRaptorQ is free software: you can redistribute it and/or modify
+ * it under the terms of the GNU Lesser General Public License as
+ * published by the Free Software Foundation, either version 3
+ * of the License, or (at your option) any later version.
+ *
+ * libRaptorQ is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ * GNU General Public License for more details.
+ *
+ * You should have received a copy of the GNU General Public License
+ * and a copy of the GNU Lesser General Public License
+ * along with libRaptorQ.  If not, see <http://www.gnu.org/licenses/>.
+ */
+
+#if defined (TEST_HDR_ONLY)
+    #include "../src/RaptorQ/RFC6330_v1_hdr.hpp"
+#else
+    #include "../src/RaptorQ/RFC6330_v1.hpp"
+#endif
+#include "test_common.hpp"
+#include <algorithm>
+#include <cstring>
+#include <iostream>
+#include <random>
+#include <vector>
+
+// Round trip through the batch entry points of the RFC interface:
+// encode_packets -> add_packets and encode_range -> add_symbols ->
+// decode_blocks, with one and with more sub-blocks,
+// and the padding of a short last symbol or packet.
+// With more sub-blocks each symbol is made of pieces of all the
+// sub-blocks, so the last symbol of the object is padded in the middle.
+
+namespace RFC6330 = RFC6330__v1;
+
+using Enc = RFC6330::Encoder<uint8_t*, uint8_t*>;
+using Dec = RFC6330::Decoder<uint8_t*, uint8_t*>;
+
+static bool same (const std::vector<uint8_t> &input, const uint8_t *output,
+                                                            const size_t size)
+{
+    if (size != input.size()) {
+        std::cout << "Size: " << size << " vs " << input.size() << "\n";
+        return false;
+    }
+    for (size_t idx = 0; idx < size; ++idx) {
+        if (input[idx] != output[idx]) {
+            std::cout << "First wrong byte: " << idx << "\n";
+            return false;
+        }
+    }
+    return true;
+}
+
+// all the blocks of "dec", decoded and compared to "input"
+static bool check (Dec &dec, const std::vector<uint8_t> &input)
+{
+    dec.end_of_input (RFC6330::Fill_With_Zeros::NO);
+    std::vector<uint8_t> received (input.size(), 0);
+    auto re_it = received.data();
+    const uint64_t decoded = dec.decode_bytes (re_it, received.data() +
+                                                        received.size(), 0);
+    return same (input, received.data(), static_cast<size_t> (decoded));
+}
+
+// the header is in network order: the block number comes first
+static uint8_t sbn_of (const RFC6330::Packet_Desc &pkt)
+{
+    uint8_t header[sizeof(uint32_t)];
+    std::memcpy (header, &pkt.header, sizeof(header));
+    return header[0];
+}
+
+// 8-bit sbn + 24 bit esi, in network order
+static uint32_t net_id (const uint8_t sbn, const uint32_t esi)
+{
+    const uint8_t header[sizeof(uint32_t)] = { sbn,
+                                        static_cast<uint8_t> (esi >> 16),
+                                        static_cast<uint8_t> (esi >> 8),
+                                        static_cast<uint8_t> (esi) };
+    uint32_t id;
+    std::memcpy (&id, header, sizeof(id));
+    return id;
+}
+
+// every third source symbol is lost, and replaced by a repair symbol
+static std::vector<RFC6330::Packet_Desc> encode (Enc &enc,
+                                                std::vector<uint8_t> &buffer)
+{
+    std::vector<RFC6330::Packet_Desc> sent;
+    size_t used = 0;
+    for (uint8_t sbn = 0; sbn < enc.blocks(); ++sbn) {
+        const uint32_t count = enc.symbols (sbn) + enc.symbols (sbn) / 3 + 4;
+        std::vector<RFC6330::Packet_Desc> packets (count);
+        const size_t filled = enc.encode_packets (packets.data(), count, 0,
+                                                    sbn, buffer.data() + used,
+                                                    buffer.size() - used);
+        if (filled != count) {
+            std::cout << "encode_packets: " << filled << " vs " << count <<
+                                                                        "\n";
+            return std::vector<RFC6330::Packet_Desc>();
+        }
+        for (uint32_t idx = 0; idx < count; ++idx) {
+            if (packets[idx].size != enc.symbol_size()) {
+                std::cout << "Short packet " << idx << "\n";
+                return std::vector<RFC6330::Packet_Desc>();
+            }
+            if (packets[idx].symbol >= buffer.data() &&
+                        packets[idx].symbol < buffer.data() + buffer.size()) {
+                used += packets[idx].size;
+            }
+            if (idx < enc.symbols (sbn) && idx % 3 == 0)
+                continue;
+            sent.push_back (packets[idx]);
+        }
+    }
+    return sent;
+}
+
+static bool packets (std::mt19937_64 &rnd, const size_t size,
+                                            const uint16_t min_subsymbol,
+                                            const uint16_t symbol_size,
+                                            const size_t max_sub_block)
+{
+    std::cout << "Packets: " << size << " bytes, symbol " << symbol_size <<
+                                    ", sub-block " << max_sub_block << "\n";
+    auto input = random_input (rnd, size);
+    Enc enc (input.data(), input.data() + input.size(), min_subsymbol,
+                                                symbol_size, max_sub_block);
+    if (!init_rfc_encoder (enc))
+        return false;
+    std::vector<uint8_t> buffer (2 * size + 64 * symbol_size);
+    const auto sent = encode (enc, buffer);
+    if (sent.empty())
+        return false;
+
+    Dec dec (enc.OTI_Common(), enc.OTI_Scheme_Specific());
+    if (!dec) {
+        std::cout << "Could not initialize decoder.\n";
+        return false;
+    }
+    dec.compute (RFC6330::Compute::NO_POOL);
+    RFC6330::Error err;
+    const size_t used = dec.add_packets (sent.data(), sent.size(), err);
+    if (used != sent.size() || err != RFC6330::Error::NONE) {
+        std::cout << "add_packets: " << used << " vs " << sent.size() << "\n";
+        return false;
+    }
+    return check (dec, input);
+}
+
+// the same, through encode_range -> add_symbols -> decode_blocks
+static bool symbols (std::mt19937_64 &rnd, const size_t size,
+                                            const uint16_t min_subsymbol,
+                                            const uint16_t symbol_size,
+                                            const size_t max_sub_block)
+{
+    std::cout << "Symbols: " << size << " bytes, symbol " << symbol_size <<
+                                    ", sub-block " << max_sub_block << "\n";
+    auto input = random_input (rnd, size);
+    Enc enc (input.data(), input.data() + input.size(), min_subsymbol,
+                                                symbol_size, max_sub_block);
+    if (!init_rfc_encoder (enc))
+        return false;
+    std::vector<uint8_t> sent;
+    std::vector<uint32_t> ids;
+    for (uint8_t sbn = 0; sbn < enc.blocks(); ++sbn) {
+        const uint32_t syms = enc.symbols (sbn);
+        const uint32_t count = syms + syms / 3 + 4;
+        std::vector<uint8_t> block (count * symbol_size);
+        if (enc.encode_range (block.data(), block.size(), 0, count, sbn) !=
+                                                                    count) {
+            std::cout << "encode_range failed\n";
+            return false;
+        }
+        for (uint32_t esi = 0; esi < count; ++esi) {
+            if (esi < syms && esi % 3 == 0)
+                continue;
+            const uint8_t *sym = block.data() + esi * symbol_size;
+            sent.insert (sent.end(), sym, sym + symbol_size);
+            ids.push_back (net_id (sbn, esi));
+        }
+    }
+
+    Dec dec (enc.OTI_Common(), enc.OTI_Scheme_Specific());
+    dec.compute (RFC6330::Compute::NO_POOL);
+    const uint32_t count = static_cast<uint32_t> (ids.size());
+    const size_t added = dec.add_symbols (sent.data(), sent.size(),
+                                                            ids.data(), count);
+    if (added != count) {
+        std::cout << "add_symbols: " << added << " vs " << count << "\n";
+        return false;
+    }
+    dec.end_of_input (RFC6330::Fill_With_Zeros::NO);
+    std::vector<uint8_t> sbns;
+    for (uint8_t sbn = 0; sbn < dec.blocks(); ++sbn)
+        sbns.push_back (sbn);
+    std::vector<uint8_t> received (input.size(), 0);
+    auto re_it = received.data();
+    const uint64_t decoded = dec.decode_blocks (re_it, received.data() +
+                                                            received.size(),
+                                                            sbns.data(),
+                                        static_cast<uint16_t> (sbns.size()));
+    return same (input, received.data(), static_cast<size_t> (decoded));
+}
+
+// with a full sink the packets of the later blocks are refused, and
+// can be given again after the first block is delivered.
+static bool refused (std::mt19937_64 &rnd)
+{
+    std::cout << "Refused packets\n";
+    auto input = random_input (rnd, 100000);
+    // one sub-block per block: three blocks
+    Enc enc (input.data(), input.data() + input.size(), 1024, 1024, 40000);
+    if (!init_rfc_encoder (enc, 3))
+        return false;
+    std::vector<uint8_t> buffer (2 * input.size() + 64 * 1024);
+    auto sent = encode (enc, buffer);
+    if (sent.empty())
+        return false;
+    // block 0 last
+    const auto first = std::stable_partition (sent.begin(), sent.end(),
+                                    [] (const RFC6330::Packet_Desc &pkt)
+                                    { return sbn_of (pkt) != 0; });
+    const size_t later = static_cast<size_t> (first - sent.begin());
+
+    Dec dec (enc.OTI_Common(), enc.OTI_Scheme_Specific());
+    dec.compute (RFC6330::Compute::NO_POOL);
+    std::vector<uint8_t> output;
+    uint8_t next = 0;
+    dec.set_sink ([&] (const uint8_t sbn, const uint8_t *data,
+                                                            const size_t size) {
+            if (sbn != next++)
+                return false;
+            output.insert (output.end(), data, data + size);
+            return true;
+        }, 1);
+
+    RFC6330::Error err;
+    size_t used = dec.add_packets (sent.data(), later, err);
+    if (used != 0 || err != RFC6330::Error::WORKING) {
+        std::cout << "The later blocks were not refused\n";
+        return false;
+    }
+    used = dec.add_packets (sent.data() + later, sent.size() - later, err);
+    if (used != sent.size() - later || err != RFC6330::Error::NONE ||
+                                                dec.blocks_delivered() != 1) {
+        std::cout << "The first block was not delivered\n";
+        return false;
+    }
+    used = dec.add_packets (sent.data(), later, err);
+    if (used != later || err != RFC6330::Error::NONE) {
+        std::cout << "The later blocks were refused again\n";
+        return false;
+    }
+    if (!same (input, output.data(), output.size()))
+        return false;
+
+    // a sink that stops: the packets after it are refused with EXITING
+    Dec stopped (enc.OTI_Common(), enc.OTI_Scheme_Specific());
+    stopped.compute (RFC6330::Compute::NO_POOL);
+    stopped.set_sink ([] (const uint8_t, const uint8_t*, const size_t)
+                                                    { return false; }, 0);
+    std::stable_partition (sent.begin(), sent.end(),
+                                    [] (const RFC6330::Packet_Desc &pkt)
+                                    { return sbn_of (pkt) == 0; });
+    used = stopped.add_packets (sent.data(), sent.size(), err);
+    if (used != sent.size() - later || err != RFC6330::Error::EXITING) {
+        std::cout << "The stopped sink did not refuse the packets\n";
+        return false;
+    }
+    return true;
+}
+
+// add_symbol with the last source symbol cut where the object ends:
+// padded with zeros with a single sub-block, refused with more.
+static bool short_last (std::mt19937_64 &rnd, const size_t max_sub_block,
+                                                    const bool single)
+{
+    std::cout << "Short last symbol, sub-block " << max_sub_block << "\n";
+    auto input = random_input (rnd, 100000);
+    Enc enc (input.data(), input.data() + input.size(), 8, 1024,
+                                                            max_sub_block);
+    if (!init_rfc_encoder (enc))
+        return false;
+    Dec dec (enc.OTI_Common(), enc.OTI_Scheme_Specific());
+    dec.compute (RFC6330::Compute::NO_POOL);
+    const size_t symbol_size = enc.symbol_size();
+    std::vector<uint8_t> symbols;
+    size_t offset = 0;
+    for (uint8_t sbn = 0; sbn < enc.blocks(); ++sbn) {
+        const uint16_t syms = enc.symbols (sbn);
+        symbols.resize (syms * symbol_size);
+        for (uint16_t esi = 0; esi < syms; ++esi) {
+            if (enc.encode (symbols.data() + esi * symbol_size, symbol_size,
+                                                    esi, sbn) != symbol_size) {
+                std::cout << "encode failed\n";
+                return false;
+            }
+        }
+        for (uint16_t esi = 0; esi < syms; ++esi, offset += symbol_size) {
+            const uint8_t *sym = symbols.data() + esi * symbol_size;
+            if (offset + symbol_size <= input.size()) {
+                if (dec.add_symbol (sym, symbol_size, esi, sbn) !=
+                                                        RFC6330::Error::NONE) {
+                    std::cout << "Symbol " << esi << " refused\n";
+                    return false;
+                }
+                continue;
+            }
+            // the short last symbol
+            const auto err = dec.add_symbol (sym, input.size() - offset, esi,
+                                                                        sbn);
+            if (single && err != RFC6330::Error::NONE) {
+                std::cout << "Short symbol refused\n";
+                return false;
+            }
+            if (!single && err != RFC6330::Error::WRONG_INPUT) {
+                std::cout << "Short symbol not refused\n";
+                return false;
+            }
+            if (!single && dec.add_symbol (sym, symbol_size, esi, sbn) !=
+                                                        RFC6330::Error::NONE) {
+                std::cout << "Whole last symbol refused\n";
+                return false;
+            }
+        }
+    }
+    return check (dec, input);
+}
+
+// add_packets with the last source packet cut where the object ends,
+// and 100000 bytes are not a multiple of the symbol size. As in
+// add_symbol: padded with a single sub-block, refused with more.
+// A short packet anywhere else is always refused.
+static bool short_packets (std::mt19937_64 &rnd, const size_t max_sub_block,
+                                                            const bool single)
+{
+    std::cout << "Short last packet, sub-block " << max_sub_block << "\n";
+    auto input = random_input (rnd, 100000);
+    Enc enc (input.data(), input.data() + input.size(), 8, 1024,
+                                                            max_sub_block);
+    if (!init_rfc_encoder (enc))
+        return false;
+    const size_t symbol_size = enc.symbol_size();
+    std::vector<uint8_t> buffer (input.size() + 64 * symbol_size);
+    std::vector<RFC6330::Packet_Desc> sent;
+    size_t used = 0;
+    for (uint8_t sbn = 0; sbn < enc.blocks(); ++sbn) {
+        std::vector<RFC6330::Packet_Desc> packets (enc.symbols (sbn));
+        if (enc.encode_packets (packets.data(), packets.size(), 0, sbn,
+                                                    buffer.data() + used,
+                                buffer.size() - used) != packets.size()) {
+            std::cout << "encode_packets failed\n";
+            return false;
+        }
+        for (const auto &pkt : packets) {
+            if (pkt.symbol >= buffer.data() &&
+                                    pkt.symbol < buffer.data() + buffer.size())
+                used += pkt.size;
+            sent.push_back (pkt);
+        }
+    }
+    // the object ends in the middle of the last source symbol
+    const size_t tail = input.size() - (sent.size() - 1) * symbol_size;
+    if (tail == 0 || tail >= symbol_size) {
+        std::cout << "The last symbol is not short\n";
+        return false;
+    }
+    RFC6330::Error err;
+    Dec other (enc.OTI_Common(), enc.OTI_Scheme_Specific());
+    other.compute (RFC6330::Compute::NO_POOL);
+    auto cut = sent;
+    cut[0].size = tail;
+    if (other.add_packets (cut.data(), cut.size(), err) != 0 ||
+                                        err != RFC6330::Error::WRONG_INPUT) {
+        std::cout << "Short first packet not refused\n";
+        return false;
+    }
+
+    Dec dec (enc.OTI_Common(), enc.OTI_Scheme_Specific());
+    dec.compute (RFC6330::Compute::NO_POOL);
+    cut = sent;
+    cut.back().size = tail;
+    const size_t added = dec.add_packets (cut.data(), cut.size(), err);
+    if (single && (added != cut.size() || err != RFC6330::Error::NONE)) {
+        std::cout << "Short last packet refused\n";
+        return false;
+    }
+    if (!single) {
+        if (added != cut.size() - 1 || err != RFC6330::Error::WRONG_INPUT) {
+            std::cout << "Short last packet not refused\n";
+            return false;
+        }
+        if (dec.add_packets (&sent.back(), 1, err) != 1 ||
+                                                err != RFC6330::Error::NONE) {
+            std::cout << "Whole last packet refused\n";
+            return false;
+        }
+    }
+    return check (dec, input);
+}
+
+int main (void)
+{
+    std::random_device rd;
+    std::mt19937_64 rnd (rd());
+
+    // one sub-block per block
+    if (!packets (rnd, 100000, 8, 1024, 1024 * 1024))
+        return -1;
+    // three sub-blocks: the object ends in the middle of the last symbol
+    if (!packets (rnd, 100000, 8, 1024, 40000))
+        return -1;
+    // more blocks and sub-blocks, and a whole last symbol
+    if (!packets (rnd, 512 * 1024, 256, 1024, 20000))
+        return -1;
+    if (!symbols (rnd, 100000, 8, 1024, 1024 * 1024))
+        return -1;
+    if (!symbols (rnd, 100000, 8, 1024, 40000))
+        return -1;
+    if (!symbols (rnd, 512 * 1024, 256, 1024, 20000))
+        return -1;
+    if (!refused (rnd))
+        return -1;
+    if (!short_last (rnd, 1024 * 1024, true))
+        return -1;
+    if (!short_last (rnd, 40000, false))
+        return -1;
+    if (!short_packets (rnd, 1024 * 1024, true))
+        return -1;
+    if (!short_packets (rnd, 40000, false))
+        return -1;
+    std::cout << "All tests passed\n";
+    return 0;
+}
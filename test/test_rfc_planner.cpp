@@ -0,0 +1,256 @@
+/*
+ * Copyright (c) 2015-2018, Luca Fulchir<luker@fulchir.it>, All rights reserved.
+ *
+ * This file is part of "libRaptorQ".
+ *
+ * libRaptorQ is free software: you can redistribute it and/or modify
+ * it under the terms of the GNU Lesser General Public License as
+ * published by the Free Software Foundation, either version 3
+ * of the License, or (at your option) any later version.
+ *
+ * libRaptorQ is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ * GNU General Public License for more details.
+ *
+ * You should have received a copy of the GNU General Public License
+ * and a copy of the GNU Lesser General Public License
+ * along with libRaptorQ.  If not, see <http://www.gnu.org/licenses/>.
+ */
+
+// header only: there is no linked Planner
+#include "../src/RaptorQ/RFC6330_v1_hdr.hpp"
+#include "test_common.hpp"
+#include <algorithm>
+#include <iostream>
+#include <random>
+#include <vector>
+
+// The planner chooses the OTI parameters of the RFC encoder.
+// The Encoder must make of them what the plan says, the blocks must fit
+// in the memory limit, and the repair symbols of the plan must be enough
+// to decode with the expected loss.
+
+namespace RFC6330 = RFC6330__v1;
+
+using Enc = RFC6330::Encoder<uint8_t*, uint8_t*>;
+using Dec = RFC6330::Decoder<uint8_t*, uint8_t*>;
+
+// bad arguments and bad cost tables
+static bool wrong_input()
+{
+    std::cout << "Wrong input\n";
+    const RFC6330::Planner planner;
+    if (!planner) {
+        std::cout << "Default costs refused\n";
+        return false;
+    }
+    const RFC6330::Planner one_point ({ { 10, 1e-4, 1e-6 } }, 1e-9);
+    const RFC6330::Planner negative ({ { 10, 1e-4, 1e-6 },
+                                            { 100, -1e-2, 1e-5 } }, 1e-9);
+    const RFC6330::Planner same_K ({ { 10, 1e-4, 1e-6 },
+                                            { 10, 1e-2, 1e-5 } }, 1e-9);
+    if (one_point || negative || same_K ||
+                    one_point.plan (1000, 100, 0, 1, 0).error !=
+                                                RFC6330::Error::WRONG_INPUT) {
+        std::cout << "Bad costs accepted\n";
+        return false;
+    }
+    if (planner.plan (0, 100, 0, 1, 0).error != RFC6330::Error::WRONG_INPUT ||
+            planner.plan (1000, 100, 0, 1, 1).error !=
+                                                RFC6330::Error::WRONG_INPUT ||
+            planner.plan (1000, 100, 0, 1, -0.1).error !=
+                                                RFC6330::Error::WRONG_INPUT ||
+            planner.plan (1000, 100, 1, 1, 0).error !=
+                                                RFC6330::Error::WRONG_INPUT ||
+            planner.plan<uint32_t*> (1002, 100, 0, 1, 0).error !=
+                                                RFC6330::Error::WRONG_INPUT ||
+            planner.plan<uint32_t*> (1000, 3, 0, 1, 0).error !=
+                                                RFC6330::Error::WRONG_INPUT) {
+        std::cout << "Bad arguments accepted\n";
+        return false;
+    }
+    // the symbol size is aligned to the input type
+    const RFC6330::Transfer_Plan aligned = planner.plan<uint32_t*> (1000, 103,
+                                                                    0, 1, 0);
+    if (aligned.error != RFC6330::Error::NONE || aligned.symbol_size != 100) {
+        std::cout << "Symbol size not aligned\n";
+        return false;
+    }
+    return true;
+}
+
+// enough symbols for the loss, and more loss asks for more symbols
+static bool sent_symbols()
+{
+    std::cout << "Sent symbols\n";
+    for (const uint16_t symbols : { 10, 101, 1002, 10040 }) {
+        if (RFC6330::Planner::sent_symbols (symbols, 0) != symbols + 2u) {
+            std::cout << "Repair symbols without loss: " << symbols << "\n";
+            return false;
+        }
+        uint32_t last = symbols + 2u;
+        for (const double loss : { 0.01, 0.1, 0.3, 0.6 }) {
+            const uint32_t sent = RFC6330::Planner::sent_symbols (symbols,
+                                                                        loss);
+            if (sent < last || (1 - loss) * sent < symbols + 2.0) {
+                std::cout << "Not enough symbols: " << symbols << " with " <<
+                                                                loss << "\n";
+                return false;
+            }
+            last = sent;
+        }
+    }
+    return true;
+}
+
+// the memory limit, and more cores are never slower
+static bool limits()
+{
+    std::cout << "Limits\n";
+    const RFC6330::Planner planner;
+    const uint64_t size = 20 * 1024 * 1024;
+    const uint16_t packet = 1024;
+    const RFC6330::Transfer_Plan free = planner.plan (size, packet, 0, 1,
+                                                                        0.05);
+    if (free.error != RFC6330::Error::NONE || free.threads != 1) {
+        std::cout << "No plan without limits\n";
+        return false;
+    }
+    const size_t memory = RFC6330::Planner::block_memory (1002, packet);
+    const RFC6330::Transfer_Plan small = planner.plan (size, packet, memory, 1,
+                                                                        0.05);
+    if (small.error != RFC6330::Error::NONE || small.memory > memory ||
+            RFC6330::Planner::block_memory (small.symbols, packet) > memory) {
+        std::cout << "Over the memory limit\n";
+        return false;
+    }
+    const RFC6330::Transfer_Plan cores = planner.plan (size, packet, 0, 8,
+                                                                        0.05);
+    if (cores.error != RFC6330::Error::NONE || cores.threads > 8 ||
+                        cores.threads > cores.blocks ||
+                        cores.encode_seconds + cores.decode_seconds >
+                                    free.encode_seconds + free.decode_seconds) {
+        std::cout << "Slower with more cores\n";
+        return false;
+    }
+    // the memory limit is shared by the blocks worked on together
+    const RFC6330::Transfer_Plan shared = planner.plan (size, packet,
+                                                    2 * memory, 8, 0.05);
+    if (shared.error != RFC6330::Error::NONE || shared.memory > 2 * memory) {
+        std::cout << "Over the memory limit with more cores\n";
+        return false;
+    }
+    return true;
+}
+
+// what the cost model prefers: one block when blocks cost the same
+// whatever their size, small blocks when big ones are much slower.
+static bool costs()
+{
+    std::cout << "Costs\n";
+    const uint64_t size = 2 * 1024 * 1024;
+    const RFC6330::Planner flat ({ { 10, 1, 1e-9 }, { 56403, 1, 1e-9 } }, 0);
+    const RFC6330::Planner steep ({ { 10, 1e-6, 1e-9 },
+                                        { 1000, 1e3, 1e-3 } }, 0);
+    const RFC6330::Transfer_Plan one = flat.plan (size, 1024, 0, 1, 0);
+    const RFC6330::Transfer_Plan many = steep.plan (size, 1024, 0, 1, 0);
+    if (one.error != RFC6330::Error::NONE ||
+                                        many.error != RFC6330::Error::NONE) {
+        std::cout << "No plan\n";
+        return false;
+    }
+    if (one.blocks != 1 || many.blocks <= 1 || many.symbols >= one.symbols) {
+        std::cout << "Wrong layout: " << static_cast<uint32_t> (one.blocks) <<
+                    " and " << static_cast<uint32_t> (many.blocks) << "\n";
+        return false;
+    }
+    return true;
+}
+
+// the Encoder with the planned parameters, and a decoder that gets only
+// the planned symbols minus the lost ones.
+static bool round_trip (std::mt19937_64 &rnd, const size_t size,
+                                            const uint16_t packet,
+                                            const size_t memory,
+                                            const double loss)
+{
+    std::cout << "Round trip: " << size << " bytes, packet " << packet <<
+                                                    ", loss " << loss << "\n";
+    const RFC6330::Planner planner;
+    const RFC6330::Transfer_Plan plan = planner.plan (size, packet, memory, 4,
+                                                                        loss);
+    if (plan.error != RFC6330::Error::NONE) {
+        std::cout << "No plan\n";
+        return false;
+    }
+    std::cout << "  " << static_cast<uint32_t> (plan.blocks) <<
+                            " blocks of " << plan.symbols << " symbols\n";
+    auto input = random_input (rnd, size);
+    Enc enc (input.data(), input.data() + input.size(),
+                        plan.min_subsymbol_size, plan.symbol_size,
+                                                        plan.max_sub_block);
+    if (!init_rfc_encoder (enc))
+        return false;
+    uint16_t biggest = 0;
+    for (uint8_t sbn = 0; sbn < enc.blocks(); ++sbn) {
+        biggest = std::max (biggest,
+                    static_cast<uint16_t> (enc.extended_symbols (sbn)));
+    }
+    if (enc.blocks() != plan.blocks || enc.symbol_size() != plan.symbol_size ||
+                                                    biggest != plan.symbols) {
+        std::cout << "The encoder does not follow the plan\n";
+        return false;
+    }
+
+    Dec dec (enc.OTI_Common(), enc.OTI_Scheme_Specific());
+    if (!dec) {
+        std::cout << "Could not initialize decoder.\n";
+        return false;
+    }
+    dec.compute (RFC6330::Compute::NO_POOL);
+    // decoded blocks do not need the rest of their symbols
+    const auto add = [&dec] (const uint8_t *sym, const size_t sym_size,
+                                    const uint32_t esi, const uint8_t sbn) {
+            const auto err = dec.add_symbol (sym, sym_size, esi, sbn);
+            return err == RFC6330::Error::NONE ||
+                                            err == RFC6330::Error::NOT_NEEDED;
+        };
+    std::vector<uint8_t> sym (plan.symbol_size);
+    for (uint8_t sbn = 0; sbn < enc.blocks(); ++sbn) {
+        const uint32_t sent = enc.symbols (sbn) + plan.repair_symbols;
+        std::vector<uint32_t> esi (sent);
+        for (uint32_t id = 0; id < sent; ++id)
+            esi[id] = id;
+        std::shuffle (esi.begin(), esi.end(), rnd);
+        const uint32_t lost = static_cast<uint32_t> (loss * sent);
+        for (uint32_t idx = lost; idx < sent; ++idx) {
+            if (enc.encode (sym.data(), sym.size(), esi[idx], sbn) !=
+                                                                sym.size() ||
+                                !add (sym.data(), sym.size(), esi[idx], sbn)) {
+                std::cout << "Could not send symbol " << esi[idx] << "\n";
+                return false;
+            }
+        }
+    }
+    dec.end_of_input (RFC6330::Fill_With_Zeros::NO);
+    return check_rfc_output (dec, input);
+}
+
+int main (void)
+{
+    std::random_device rd;
+    std::mt19937_64 rnd (rd());
+
+    if (!wrong_input() || !sent_symbols() || !limits() || !costs())
+        return -1;
+    // small and big objects, with and without a memory limit
+    if (!round_trip (rnd, 100000, 1024, 0, 0.1) ||
+            !round_trip (rnd, 2 * 1024 * 1024 + 100, 1400, 0, 0.05) ||
+            !round_trip (rnd, 1024 * 1024, 512,
+                            RFC6330::Planner::block_memory (337, 512), 0.2)) {
+        return -1;
+    }
+    std::cout << "All tests passed\n";
+    return 0;
+}
@@ -0,0 +1,204 @@
+/*
+ * Copyright (c) 2015-2018, Luca Fulchir<luker@fulchir.it>, All rights reserved.
+ *
+ * This file is part of "libRaptorQ".
+ *
+ * libRaptorQ is free software: you can redistribute it and/or modify
+ * it under the terms of the GNU Lesser General Public License as
+ * published by the Free Software Foundation, either version 3
+ * of the License, or (at your option) any later version.
+ *
+ * libRaptorQ is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ * GNU General Public License for more details.
+ *
+ * You should have received a copy of the GNU General Public License
+ * and a copy of the GNU Lesser General Public License
+ * along with libRaptorQ.  If not, see <http://www.gnu.org/licenses/>.
+ */
+
+#if defined (TEST_HDR_ONLY)
+    #include "../src/RaptorQ/RFC6330_v1_hdr.hpp"
+#else
+    #include "../src/RaptorQ/RFC6330_v1.hpp"
+#endif
+#include "test_common.hpp"
+#include <algorithm>
+#include <iostream>
+#include <random>
+#include <thread>
+#include <vector>
+
+// Sink mode with the thread pool: the blocks are decoded by the pool,
+// and given to the sink in order while two threads keep adding symbols.
+// The memory of the sink counts the repair symbols kept, too.
+
+namespace RFC6330 = RFC6330__v1;
+
+using Enc = RFC6330::Encoder<uint8_t*, uint8_t*>;
+using Dec = RFC6330::Decoder<uint8_t*, uint8_t*>;
+
+struct Symbol {
+    uint32_t esi;
+    uint8_t sbn;
+    std::vector<uint8_t> data;
+};
+
+// add "symbols", starting from "first", every "step". symbols refused
+// because the sink memory is full are tried again later.
+static bool add (Dec *dec, const std::vector<Symbol> *symbols,
+                                        const size_t first, const size_t step)
+{
+    std::vector<size_t> todo;
+    for (size_t idx = first; idx < symbols->size(); idx += step)
+        todo.push_back (idx);
+    while (!todo.empty()) {
+        std::vector<size_t> refused;
+        for (const size_t idx : todo) {
+            const Symbol &sym = (*symbols)[idx];
+            const auto err = dec->add_symbol (sym.data.data(),
+                                            sym.data.size(), sym.esi, sym.sbn);
+            if (err == RFC6330::Error::WORKING)
+                refused.push_back (idx);
+            else if (err != RFC6330::Error::NONE &&
+                                        err != RFC6330::Error::NOT_NEEDED)
+                return false;
+        }
+        if (refused.size() == todo.size())
+            std::this_thread::sleep_for (std::chrono::milliseconds (1));
+        todo.swap (refused);
+    }
+    return true;
+}
+
+static bool sink (std::mt19937_64 &rnd, const size_t size,
+                                                    const size_t max_memory)
+{
+    std::cout << "Sink: " << size << " bytes, memory " << max_memory << "\n";
+    auto input = random_input (rnd, size);
+    Enc enc (input.data(), input.data() + input.size(), 16, 64, 2000);
+    if (!init_rfc_encoder (enc, 2))
+        return false;
+
+    // round robin over the blocks, one source symbol in ten lost
+    std::vector<Symbol> symbols;
+    const auto sent = [&enc] (const uint8_t sbn)
+        { return enc.symbols (sbn) + enc.symbols (sbn) / 10 + 4u; };
+    uint32_t max_esi = 0;
+    for (uint8_t sbn = 0; sbn < enc.blocks(); ++sbn)
+        max_esi = std::max<uint32_t> (max_esi, sent (sbn));
+    for (uint32_t esi = 0; esi < max_esi; ++esi) {
+        for (uint8_t sbn = 0; sbn < enc.blocks(); ++sbn) {
+            if (esi >= sent (sbn) || (esi < enc.symbols (sbn) && esi % 10 == 0))
+                continue;
+            Symbol sym {esi, sbn, std::vector<uint8_t> (enc.symbol_size())};
+            if (enc.encode (sym.data.data(), sym.data.size(), esi, sbn) !=
+                                                            sym.data.size()) {
+                std::cout << "Could not encode.\n";
+                return false;
+            }
+            symbols.push_back (std::move (sym));
+        }
+    }
+
+    Dec dec (enc.OTI_Common(), enc.OTI_Scheme_Specific());
+    std::vector<uint8_t> output;
+    uint8_t next = 0;
+    bool in_order = true;
+    // only one delivery at a time: no need to lock
+    dec.set_sink ([&] (const uint8_t sbn, const uint8_t *data,
+                                                            const size_t len) {
+            in_order = in_order && sbn == next++;
+            output.insert (output.end(), data, data + len);
+            return true;
+        }, max_memory);
+    auto future = dec.compute (RFC6330::Compute::COMPLETE);
+
+    bool ok_1 = false, ok_2 = false;
+    std::thread second ([&] () { ok_2 = add (&dec, &symbols, 1, 2); });
+    ok_1 = add (&dec, &symbols, 0, 2);
+    second.join();
+    if (!ok_1 || !ok_2) {
+        std::cout << "Could not add the symbols\n";
+        return false;
+    }
+    dec.end_of_input (RFC6330::Fill_With_Zeros::NO);
+    const auto res = future.get();
+    if (res.first != RFC6330::Error::NONE) {
+        std::cout << "Could not decode\n";
+        return false;
+    }
+    if (!in_order || dec.blocks_delivered() != enc.blocks() ||
+                                                        output != input) {
+        std::cout << "Wrong output\n";
+        return false;
+    }
+    return true;
+}
+
+// the repair symbols waiting in a block count against the sink memory
+static bool repair_budget (std::mt19937_64 &rnd)
+{
+    std::cout << "Repair symbols in the budget\n";
+    auto input = random_input (rnd, 300000);
+    Enc enc (input.data(), input.data() + input.size(), 16, 64, 2000);
+    if (!init_rfc_encoder (enc, 3))
+        return false;
+    const size_t symbol_size = enc.symbol_size();
+    const uint32_t repairs = enc.symbols (1) / 2;
+    size_t source = 0;
+    for (uint8_t sbn = 0; sbn < 3; ++sbn) {
+        source += static_cast<size_t> (enc.extended_symbols (sbn)) *
+                                                                symbol_size;
+    }
+    std::vector<uint8_t> sym (symbol_size);
+    const auto send = [&] (Dec &dec, const uint32_t esi, const uint8_t sbn) {
+            enc.encode (sym.data(), sym.size(), esi, sbn);
+            return dec.add_symbol (sym.data(), sym.size(), esi, sbn);
+        };
+    // the three blocks fit, but not with the repair symbols of block 1
+    for (const bool with_repair : {false, true}) {
+        Dec dec (enc.OTI_Common(), enc.OTI_Scheme_Specific());
+        dec.set_sink ([] (const uint8_t, const uint8_t*, const size_t)
+                                    { return true; },
+                                    source + repairs * symbol_size / 2);
+        if (send (dec, 0, 0) != RFC6330::Error::NONE ||
+                                    send (dec, 0, 1) != RFC6330::Error::NONE) {
+            std::cout << "Symbol refused\n";
+            return false;
+        }
+        const uint32_t first = enc.symbols (1) + 10;
+        for (uint32_t esi = first; with_repair && esi < first + repairs;
+                                                                    ++esi) {
+            if (send (dec, esi, 1) != RFC6330::Error::NONE) {
+                std::cout << "Repair symbol refused\n";
+                return false;
+            }
+        }
+        const auto expected = with_repair ? RFC6330::Error::WORKING :
+                                                        RFC6330::Error::NONE;
+        if (send (dec, 0, 2) != expected) {
+            std::cout << "Wrong budget, repair symbols: " << with_repair <<
+                                                                        "\n";
+            return false;
+        }
+    }
+    return true;
+}
+
+int main (void)
+{
+    std::random_device rd;
+    std::mt19937_64 rnd (rd());
+
+    for (size_t run = 0; run < 4; ++run) {
+        // no memory limit, then at most a few blocks in memory
+        if (!sink (rnd, 300000, 0) || !sink (rnd, 300000, 40000))
+            return -1;
+    }
+    if (!repair_budget (rnd))
+        return -1;
+    std::cout << "All tests passed\n";
+    return 0;
+}
@@ -0,0 +1,112 @@
+/*
+ * Copyright (c) 2015-2018, Luca Fulchir<luker@fulchir.it>, All rights reserved.
+ *
+ * This file is part of "libRaptorQ".
+ *
+ * libRaptorQ is free software: you can redistribute it and/or modify
+ * it under the terms of the GNU Lesser General Public License as
+ * published by the Free Software Foundation, either version 3
+ * of the License, or (at your option) any later version.
+ *
+ * libRaptorQ is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ * GNU General Public License for more details.
+ *
+ * You should have received a copy of the GNU General Public License
+ * and a copy of the GNU Lesser General Public License
+ * along with libRaptorQ.  If not, see <http://www.gnu.org/licenses/>.
+ */
+
+#if defined (TEST_HDR_ONLY)
+    #include "../src/RaptorQ/RaptorQ_v1_hdr.hpp"
+#else
+    #include "../src/RaptorQ/RaptorQ_v1.hpp"
+#endif
+#include "test_common.hpp"
+#include <iostream>
+#include <random>
+#include <signal.h>
+#include <string>
+#include <sys/resource.h>
+#include <vector>
+
+// Decoding with the symbols in a scratch file.
+// When the file can not get its disk space the decoder stays in RAM.
+//
+// usage: test_storage [directory [full_directory]]
+// "full_directory" should be on a filesystem with less than 64MB free,
+// i.e.: mount -t tmpfs -o size=1m tmpfs /mnt/full
+
+namespace RaptorQ = RaptorQ__v1;
+
+using Enc = RaptorQ::Encoder<uint8_t*, uint8_t*>;
+using Dec = RaptorQ::Decoder<uint8_t*, uint8_t*>;
+
+static bool storage (std::mt19937_64 &rnd, const std::string &directory,
+                                                    const bool expect_file)
+{
+    std::cout << "Storage in " << directory << "\n";
+    const RaptorQ::Block_Size block = RaptorQ::Block_Size::Block_1002;
+    const size_t symbol_size = 2048;
+    const uint32_t syms = static_cast<uint32_t> (block);
+    // one source symbol in four is lost
+    const uint32_t total = syms + syms / 4 + 4;
+    std::vector<uint8_t> input, sent;
+    if (!encode_block<Enc> (rnd, block, symbol_size, total, input, sent))
+        return false;
+
+    Dec dec (block, symbol_size, Dec::Report::COMPLETE);
+    const auto add = [&] (const uint32_t from, const uint32_t to) {
+            for (uint32_t esi = from; esi < to; ++esi) {
+                if (esi < syms && esi % 4 == 0)
+                    continue;
+                const auto err = dec.add_symbol (sent.data() +
+                                        esi * symbol_size, symbol_size, esi);
+                if (err != RaptorQ::Error::NONE)
+                    return false;
+            }
+            return true;
+        };
+    // the symbols we already have are moved to the file.
+    if (!add (0, syms / 2)) {
+        std::cout << "Could not add the symbols.\n";
+        return false;
+    }
+    if (dec.set_storage (directory) != expect_file) {
+        std::cout << "set_storage: expected " << expect_file << "\n";
+        return false;
+    }
+    if (!add (syms / 2, total)) {
+        std::cout << "Could not add the symbols.\n";
+        return false;
+    }
+    dec.end_of_input (RaptorQ::Fill_With_Zeros::NO);
+    if (dec.wait_sync().error != RaptorQ::Error::NONE) {
+        std::cout << "Couldn't decode.\n";
+        return false;
+    }
+    return check_output (dec, input);
+}
+
+int main (int argc, char **argv)
+{
+    std::random_device rd;
+    std::mt19937_64 rnd (rd());
+
+    const std::string directory = argc > 1 ? argv[1] : "/tmp";
+    if (!storage (rnd, directory, true))
+        return -1;
+    if (argc > 2 && !storage (rnd, argv[2], false))
+        return -1;
+    // no room for the file: everything stays in RAM
+    signal (SIGXFSZ, SIG_IGN);
+    struct rlimit limit;
+    limit.rlim_cur = limit.rlim_max = 1024 * 1024;
+    if (setrlimit (RLIMIT_FSIZE, &limit) != 0 ||
+                                        !storage (rnd, directory, false)) {
+        return -1;
+    }
+    std::cout << "All tests passed\n";
+    return 0;
+}
@@ -0,0 +1,150 @@
+/*
+ * Copyright (c) 2015-2018, Luca Fulchir<luker@fulchir.it>, All rights reserved.
+ *
+ * This file is part of "libRaptorQ".
+ *
+ * libRaptorQ is free software: you can redistribute it and/or modify
+ * it under the terms of the GNU Lesser General Public License as
+ * published by the Free Software Foundation, either version 3
+ * of the License, or (at your option) any later version.
+ *
+ * libRaptorQ is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ * GNU General Public License for more details.
+ *
+ * You should have received a copy of the GNU General Public License
+ * and a copy of the GNU Lesser General Public License
+ * along with libRaptorQ.  If not, see <http://www.gnu.org/licenses/>.
+ */
+
+// header only: there is no linked Stream_Encoder
+#include "../src/RaptorQ/RFC6330_v1_hdr.hpp"
+#include "test_common.hpp"
+#include <algorithm>
+#include <iostream>
+#include <random>
+#include <vector>
+
+// The streaming encoder gets the object a piece at a time, and keeps
+// only "window" blocks in memory. Its symbols and OTI must be the same
+// as the ones of the RFC encoder on the whole object.
+
+namespace RFC6330 = RFC6330__v1;
+
+using Enc = RFC6330::Encoder<uint8_t*, uint8_t*>;
+using Stream = RFC6330::Stream_Encoder<uint8_t*, uint8_t*>;
+
+// the source symbols and some repair symbols of block "sbn"
+static bool same_block (Enc &enc, Stream &stream, const uint8_t sbn)
+{
+    if (stream.wait (sbn) != RFC6330::Error::NONE) {
+        std::cout << "Block " << static_cast<uint32_t> (sbn) << " not ready\n";
+        return false;
+    }
+    if (stream.symbols (sbn) != enc.symbols (sbn)) {
+        std::cout << "Different symbols in block " <<
+                                            static_cast<uint32_t> (sbn) << "\n";
+        return false;
+    }
+    const size_t symbol_size = enc.symbol_size();
+    std::vector<uint8_t> expected (symbol_size), got (symbol_size);
+    for (uint32_t esi = 0; esi < enc.symbols (sbn) + 20u; ++esi) {
+        if (enc.encode (expected.data(), symbol_size, esi, sbn) !=
+                                                            symbol_size ||
+                stream.encode (got.data(), symbol_size, esi, sbn) !=
+                                                            symbol_size ||
+                                                        got != expected) {
+            std::cout << "Different symbol " << esi << " in block " <<
+                                            static_cast<uint32_t> (sbn) << "\n";
+            return false;
+        }
+    }
+    stream.free (sbn);
+    if (stream.wait (sbn) != RFC6330::Error::WRONG_INPUT ||
+                    stream.encode (got.data(), symbol_size, 0, sbn) != 0) {
+        std::cout << "Block " << static_cast<uint32_t> (sbn) << " not freed\n";
+        return false;
+    }
+    return true;
+}
+
+static bool stream (std::mt19937_64 &rnd, const size_t size,
+                                            const uint16_t min_subsymbol,
+                                            const uint16_t symbol_size,
+                                            const size_t max_sub_block,
+                                            const uint8_t window)
+{
+    std::cout << "Stream: " << size << " bytes, symbol " << symbol_size <<
+                        ", sub-block " << max_sub_block << ", window " <<
+                                    static_cast<uint32_t> (window) << "\n";
+    auto input = random_input (rnd, size);
+    Enc enc (input.data(), input.data() + input.size(), min_subsymbol,
+                                                symbol_size, max_sub_block);
+    Stream str (size, min_subsymbol, symbol_size, max_sub_block, window);
+    if (!init_rfc_encoder (enc))
+        return false;
+    if (!str) {
+        std::cout << "Could not initialize the stream.\n";
+        return false;
+    }
+    std::cout << "  " << static_cast<uint32_t> (str.blocks()) << " blocks\n";
+    if (str.OTI_Common() != enc.OTI_Common() ||
+                    str.OTI_Scheme_Specific() != enc.OTI_Scheme_Specific() ||
+                                                str.blocks() != enc.blocks()) {
+        std::cout << "Different OTI\n";
+        return false;
+    }
+    // random pieces. When the window is full, the oldest block is
+    // checked and freed.
+    std::uniform_int_distribution<size_t> piece (1, 3 * symbol_size);
+    uint8_t oldest = 0;
+    size_t fed = 0;
+    while (fed < size) {
+        const size_t len = std::min (size - fed, piece (rnd));
+        const size_t used = str.feed (input.data() + fed,
+                                                    input.data() + fed + len);
+        fed += used;
+        // the block being filled counts against the window, too
+        if (str.next_block() - oldest > window) {
+            std::cout << "Too many blocks: " << static_cast<uint32_t> (
+                                str.next_block() - oldest) << "\n";
+            return false;
+        }
+        if (used == len)
+            continue;
+        if (str.next_block() - oldest != window) {
+            std::cout << "Refused data with " << static_cast<uint32_t> (
+                                str.next_block() - oldest) << " blocks\n";
+            return false;
+        }
+        if (!same_block (enc, str, oldest++))
+            return false;
+    }
+    if (str.next_block() != str.blocks()) {
+        std::cout << "Blocks not started\n";
+        return false;
+    }
+    while (oldest < str.blocks()) {
+        if (!same_block (enc, str, oldest++))
+            return false;
+    }
+    return true;
+}
+
+int main (void)
+{
+    std::random_device rd;
+    std::mt19937_64 rnd (rd());
+
+    // one block, the object ends in the middle of the last symbol
+    if (!stream (rnd, 100000, 8, 1024, 1024 * 1024, 1))
+        return -1;
+    // more blocks and sub-blocks
+    if (!stream (rnd, 512 * 1024, 256, 1024, 20000, 1))
+        return -1;
+    if (!stream (rnd, 512 * 1024 + 100, 256, 1024, 20000, 3))
+        return -1;
+    std::cout << "All tests passed\n";
+    return 0;
+}
@@ -0,0 +1,178 @@
+/*
+ * Copyright (c) 2015-2018, Luca Fulchir<luker@fulchir.it>, All rights reserved.
+ *
+ * This file is part of "libRaptorQ".
+ *
+ * libRaptorQ is free software: you can redistribute it and/or modify
+ * it under the terms of the GNU Lesser General Public License as
+ * published by the Free Software Foundation, either version 3
+ * of the License, or (at your option) any later version.
+ *
+ * libRaptorQ is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ * GNU General Public License for more details.
+ *
+ * You should have received a copy of the GNU General Public License
+ * and a copy of the GNU Lesser General Public License
+ * along with libRaptorQ.  If not, see <http://www.gnu.org/licenses/>.
+ */
+
+#if defined (TEST_HDR_ONLY)
+    #include "../src/RaptorQ/RaptorQ_v1_hdr.hpp"
+#else
+    #include "../src/RaptorQ/RaptorQ_v1.hpp"
+#endif
+#include "test_common.hpp"
+#include "../src/RaptorQ/v1/util/Symbol_Store.hpp"
+#include <algorithm>
+#include <iostream>
+#include <random>
+#include <vector>
+
+// The store of the repair symbols keeps them ordered by esi,
+// whatever the order they arrive in, and the decoder uses that order.
+// The index only holds the symbols received, however far apart their
+// esi are.
+
+namespace RaptorQ = RaptorQ__v1;
+
+using Enc = RaptorQ::Encoder<uint8_t*, uint8_t*>;
+using Dec = RaptorQ::Decoder<uint8_t*, uint8_t*>;
+
+// symbols in order, in reverse, and shuffled. Each symbol holds its esi.
+static bool store (std::mt19937_64 &rnd)
+{
+    const uint32_t first = 1000, count = 5000;
+    const size_t symbol_size = 8;
+    std::vector<uint32_t> esi;
+    // leave some holes, and a few symbols far away
+    for (uint32_t id = first; esi.size() < count; ++id) {
+        if (id % 7 != 3)
+            esi.push_back (id);
+    }
+    esi.push_back ((1u << 20) + 5);
+    esi.push_back (1u << 23);
+    std::vector<std::vector<uint32_t>> orders (3, esi);
+    std::reverse (orders[1].begin(), orders[1].end());
+    std::shuffle (orders[2].begin(), orders[2].end(), rnd);
+
+    for (const auto &order : orders) {
+        RaptorQ::Impl::Symbol_Store repair (symbol_size);
+        for (size_t idx = 0; idx < order.size(); ++idx) {
+            const uint32_t slot = repair.reserve();
+            RaptorQ::Impl::Octet *data = repair.slot (slot);
+            for (size_t byte = 0; byte < symbol_size; ++byte) {
+                data[byte] = static_cast<uint8_t> (order[idx] >> (
+                                                            8 * (byte % 4)));
+            }
+            repair.commit (order[idx], slot);
+            // reading in the middle must not lose what comes later
+            if (idx == order.size() / 2 && repair.begin() == repair.end())
+                return false;
+        }
+        if (repair.size() != esi.size()) {
+            std::cout << "Store size: " << repair.size() << "\n";
+            return false;
+        }
+        size_t idx = 0;
+        for (auto it = repair.begin(); it != repair.end(); ++it, ++idx) {
+            const auto row = repair.row (*it);
+            if (it->first != esi[idx] ||
+                        static_cast<uint8_t> (row (0)) !=
+                                            static_cast<uint8_t> (esi[idx]) ||
+                        static_cast<uint8_t> (row (1)) !=
+                                        static_cast<uint8_t> (esi[idx] >> 8)) {
+                std::cout << "Wrong symbol at " << idx << "\n";
+                return false;
+            }
+        }
+        const auto rows = repair.rows (10);
+        if (rows.size() != 10 || static_cast<uint8_t> (rows.row (9) (0)) !=
+                                            static_cast<uint8_t> (esi[9])) {
+            std::cout << "Wrong snapshot\n";
+            return false;
+        }
+    }
+    return true;
+}
+
+// a slot that was reserved but never committed is reserved again
+static bool release()
+{
+    RaptorQ::Impl::Symbol_Store repair (8);
+    const uint32_t first = repair.reserve();
+    const uint32_t lost = repair.reserve();
+    repair.commit (10, first);
+    repair.release (lost);
+    if (repair.reserve() != lost || repair.size() != 1) {
+        std::cout << "Released slot not reused\n";
+        return false;
+    }
+    return true;
+}
+
+// every slot is aligned, across slabs, whatever the symbol size
+static bool aligned()
+{
+    for (const size_t symbol_size : {1, 13, 64, 100}) {
+        RaptorQ::Impl::Symbol_Store repair (symbol_size);
+        for (uint32_t idx = 0; idx < 3000; ++idx) {
+            const uint32_t slot = repair.reserve();
+            const auto addr = reinterpret_cast<uintptr_t> (repair.slot (slot));
+            if (addr % RaptorQ::Impl::Symbol_Store::slot_align != 0) {
+                std::cout << "Unaligned slot " << slot << " of size " <<
+                                                        symbol_size << "\n";
+                return false;
+            }
+            repair.commit (idx, slot);
+        }
+    }
+    return true;
+}
+
+// decode with the repair symbols arriving in reverse order
+static bool reverse_decode (std::mt19937_64 &rnd,
+                    const RaptorQ::Block_Size block, const size_t symbol_size)
+{
+    std::cout << "Reverse: " << static_cast<uint32_t> (block) << "\n";
+    const uint32_t syms = static_cast<uint32_t> (block);
+    // half the source symbols are lost
+    const uint32_t total = syms + syms / 2 + 4;
+    std::vector<uint8_t> input, sent;
+    if (!encode_block<Enc> (rnd, block, symbol_size, total, input, sent))
+        return false;
+    Dec dec (block, symbol_size, Dec::Report::COMPLETE);
+    for (uint32_t esi = total; esi > 0; --esi) {
+        const uint32_t id = esi - 1;
+        if (id < syms && id % 2 == 0)
+            continue;
+        uint8_t *sym = sent.data() + id * symbol_size;
+        if (dec.add_symbol (sym, sym + symbol_size, id) !=
+                                                        RaptorQ::Error::NONE) {
+            std::cout << "Could not add symbol " << id << "\n";
+            return false;
+        }
+    }
+    dec.end_of_input (RaptorQ::Fill_With_Zeros::NO);
+    if (dec.wait_sync().error != RaptorQ::Error::NONE) {
+        std::cout << "Couldn't decode.\n";
+        return false;
+    }
+    return check_output (dec, input);
+}
+
+int main (void)
+{
+    std::random_device rd;
+    std::mt19937_64 rnd (rd());
+
+    if (!store (rnd) || !release() || !aligned())
+        return -1;
+    if (!reverse_decode (rnd, RaptorQ::Block_Size::Block_10, 16) ||
+            !reverse_decode (rnd, RaptorQ::Block_Size::Block_1002, 64)) {
+        return -1;
+    }
+    std::cout << "All tests passed\n";
+    return 0;
+}
@@ -0,0 +1,209 @@
+/*
+ * Copyright (c) 2015-2018, Luca Fulchir<luker@fulchir.it>, All rights reserved.
+ *
+ * This file is part of "libRaptorQ".
+ *
+ * libRaptorQ is free software: you can redistribute it and/or modify
+ * it under the terms of the GNU Lesser General Public License as
+ * published by the Free Software Foundation, either version 3
+ * of the License, or (at your option) any later version.
+ *
+ * libRaptorQ is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ * GNU General Public License for more details.
+ *
+ * You should have received a copy of the GNU General Public License
+ * and a copy of the GNU Lesser General Public License
+ * along with libRaptorQ.  If not, see <http://www.gnu.org/licenses/>.
+ */
+
+#if defined (TEST_HDR_ONLY)
+    #include "../src/RaptorQ/RFC6330_v1_hdr.hpp"
+#else
+    #include "../src/RaptorQ/RFC6330_v1.hpp"
+#endif
+#include <chrono>
+#include <condition_variable>
+#include <iostream>
+#include <memory>
+#include <mutex>
+#include <thread>
+#include <vector>
+
+// Thread pool placement: the cpu list parser, and the per-node queues.
+// Two fake NUMA nodes are made on cpu 0, so this runs everywhere.
+
+namespace RFC6330 = RFC6330__v1;
+namespace Impl = RFC6330__v1::Impl;
+
+static bool cpulist()
+{
+    std::cout << "Cpu list\n";
+    const std::vector<std::pair<std::string, std::vector<uint16_t>>> tests = {
+        {"0", {0}},
+        {"0-3,8,10-11\n", {0, 1, 2, 3, 8, 10, 11}},
+        {"5-5", {5}},
+        {"2,1", {2, 1}},
+        {"65535", {65535}},
+        // bad input gives nothing
+        {"", {}},
+        {"\n", {}},
+        {"1-", {}},
+        {"-2", {}},
+        {"3-1", {}},
+        {"1,,2", {}},
+        {"1,", {}},
+        {"1-2-3", {}},
+        {"0-3,a", {}},
+        {"1 2", {}},
+        {"65536", {}},
+        {"99999999999", {}}};
+    for (const auto &test : tests) {
+        if (Impl::parse_cpulist (test.first) != test.second) {
+            std::cout << "Wrong parsing of \"" << test.first << "\"\n";
+            return false;
+        }
+    }
+    return true;
+}
+
+// remembers where each run happened
+struct Runs {
+    std::mutex mtx;
+    std::condition_variable cond;
+    size_t done = 0;
+    std::vector<size_t> groups;
+    std::vector<int32_t> nodes;
+
+    bool wait (const size_t works)
+    {
+        std::unique_lock<std::mutex> lock (mtx);
+        return cond.wait_for (lock, std::chrono::seconds (30),
+                                    [this, works] { return done >= works; });
+    }
+};
+
+class Test_Work final : public Impl::Pool_Work
+{
+public:
+    Test_Work (Runs *runs, const int32_t bound_to,
+                                        const std::chrono::milliseconds wait)
+        : _runs (runs), _wait (wait)
+        { node = std::make_shared<std::atomic<int32_t>> (bound_to); }
+
+    RFC6330::Work_Exit_Status do_work (RaptorQ__v1::Work_State *state)
+                                                                    override
+    {
+        RQ_UNUSED (state);
+        std::this_thread::sleep_for (_wait);
+        std::lock_guard<std::mutex> lock (_runs->mtx);
+        RQ_UNUSED (lock);
+        _runs->groups.push_back (Impl::Thread_Pool::current_group());
+        _runs->nodes.push_back (*node);
+        ++_runs->done;
+        _runs->cond.notify_all();
+        return RFC6330::Work_Exit_Status::DONE;
+    }
+private:
+    Runs *_runs;
+    const std::chrono::milliseconds _wait;
+};
+
+// "threads" threads, split in two nodes on cpu 0
+static void two_nodes (const size_t threads)
+{
+    RFC6330::set_thread_pool (threads, 1,
+                                    RaptorQ__v1::Work_State::KEEP_WORKING);
+    Impl::Thread_Pool::get().set_groups ({{0}, {0}}, true);
+    // let the threads join their node
+    std::this_thread::sleep_for (std::chrono::milliseconds (200));
+}
+
+static bool first_touch()
+{
+    std::cout << "First touch\n";
+    two_nodes (4);
+    Runs runs;
+    const size_t works = 20;
+    for (size_t idx = 0; idx < works; ++idx) {
+        Impl::Thread_Pool::get().add_work (std::unique_ptr<Impl::Pool_Work> (
+            new Test_Work (&runs, -1, std::chrono::milliseconds (0))));
+    }
+    if (!runs.wait (works)) {
+        std::cout << "Work not finished\n";
+        return false;
+    }
+    // unassigned work gets the node of the first thread that runs it
+    for (size_t idx = 0; idx < works; ++idx) {
+        if (runs.nodes[idx] != static_cast<int32_t> (runs.groups[idx])) {
+            std::cout << "Work not bound to its first node\n";
+            return false;
+        }
+    }
+    return true;
+}
+
+static bool stay_on_node()
+{
+    std::cout << "Stay on node\n";
+    two_nodes (4);
+    Runs runs;
+    // one at a time: node 1 always has a free thread, so node 0
+    // must not take its work.
+    for (size_t idx = 0; idx < 20; ++idx) {
+        Impl::Thread_Pool::get().add_work (std::unique_ptr<Impl::Pool_Work> (
+            new Test_Work (&runs, 1, std::chrono::milliseconds (0))));
+        if (!runs.wait (idx + 1)) {
+            std::cout << "Work not finished\n";
+            return false;
+        }
+    }
+    for (size_t idx = 0; idx < runs.done; ++idx) {
+        if (runs.groups[idx] != 1 || runs.nodes[idx] != 1) {
+            std::cout << "Work left its node\n";
+            return false;
+        }
+    }
+    return true;
+}
+
+static bool stealing()
+{
+    std::cout << "Stealing\n";
+    two_nodes (2);
+    Runs runs;
+    // a single thread per node: node 0 has nothing to do and must help
+    const size_t works = 8;
+    for (size_t idx = 0; idx < works; ++idx) {
+        Impl::Thread_Pool::get().add_work (std::unique_ptr<Impl::Pool_Work> (
+            new Test_Work (&runs, 1, std::chrono::milliseconds (20))));
+    }
+    if (!runs.wait (works)) {
+        std::cout << "Work not finished\n";
+        return false;
+    }
+    size_t stolen = 0;
+    for (size_t idx = 0; idx < works; ++idx) {
+        if (runs.nodes[idx] != 1) {
+            std::cout << "Stolen work moved to another node\n";
+            return false;
+        }
+        if (runs.groups[idx] == 0)
+            ++stolen;
+    }
+    if (stolen == 0) {
+        std::cout << "The idle node did not help\n";
+        return false;
+    }
+    return true;
+}
+
+int main (void)
+{
+    if (!cpulist() || !first_touch() || !stay_on_node() || !stealing())
+        return -1;
+    RFC6330::set_thread_pool_affinity (RFC6330::Pool_Affinity::NONE);
+    std::cout << "All tests passed\n";
+    return 0;
+}
@@ -0,0 +1,132 @@
+/*
+ * Copyright (c) 2015-2018, Luca Fulchir<luker@fulchir.it>, All rights reserved.
+ *
+ * This file is part of "libRaptorQ".
+ *
+ * libRaptorQ is free software: you can redistribute it and/or modify
+ * it under the terms of the GNU Lesser General Public License as
+ * published by the Free Software Foundation, either version 3
+ * of the License, or (at your option) any later version.
+ *
+ * libRaptorQ is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ * GNU General Public License for more details.
+ *
+ * You should have received a copy of the GNU General Public License
+ * and a copy of the GNU Lesser General Public License
+ * along with libRaptorQ.  If not, see <http://www.gnu.org/licenses/>.
+ */
+
+#include "../src/RaptorQ/RFC6330_v1_hdr.hpp"
+#include "test_common.hpp"
+#include <iostream>
+#include <random>
+#include <set>
+#include <vector>
+
+// Compute::WIDE encodes the blocks with the same size with a single
+// elimination. The object has blocks of two different sizes, and is
+// encoded with one and with many pool threads. The repair symbols must be
+// the same as without WIDE, and must decode the object even when most of
+// the source symbols are lost.
+
+namespace RFC6330 = RFC6330__v1;
+
+using Enc = RFC6330::Encoder<uint8_t*, uint8_t*>;
+using Dec = RFC6330::Decoder<uint8_t*, uint8_t*>;
+
+static const uint16_t sym_size = 64;
+static const uint16_t subsymbol = 64;
+static const size_t sub_block_bytes = 4000;
+
+static bool wide (std::mt19937_64 &rnd, std::vector<uint8_t> &input,
+                                                        const size_t threads)
+{
+    std::cout << "Threads: " << threads << "\n";
+    RFC6330::set_thread_pool (threads, 1,
+                                    RFC6330::Work_State::ABORT_COMPUTATION);
+    uint8_t *data = input.data();
+    Enc enc (data, data + input.size(), subsymbol, sym_size,
+                                                            sub_block_bytes);
+    Enc plain (data, data + input.size(), subsymbol, sym_size,
+                                                            sub_block_bytes);
+    if (!enc || !plain) {
+        std::cout << "Could not initialize encoders.\n";
+        return false;
+    }
+    std::set<uint32_t> sizes;
+    for (uint8_t sbn = 0; sbn < enc.blocks(); ++sbn)
+        sizes.insert (static_cast<uint32_t> (enc.extended_symbols (sbn)));
+    if (sizes.size() != 2) {
+        std::cout << "Wrong partition: " << sizes.size() << " sizes\n";
+        return false;
+    }
+    if (enc.compute (RFC6330::Compute::COMPLETE |
+                        RFC6330::Compute::WIDE).get().first !=
+                                                        RFC6330::Error::NONE ||
+            plain.compute (RFC6330::Compute::COMPLETE).get().first !=
+                                                        RFC6330::Error::NONE) {
+        std::cout << "Could not encode.\n";
+        return false;
+    }
+
+    Dec dec (enc.OTI_Common(), enc.OTI_Scheme_Specific());
+    if (!dec) {
+        std::cout << "Could not initialize decoder.\n";
+        return false;
+    }
+    // one source symbol in 4 arrives, the others are repair symbols.
+    std::uniform_int_distribution<uint32_t> first_repair (0, 1000);
+    std::vector<uint8_t> sym (sym_size), reference (sym_size);
+    for (uint8_t sbn = 0; sbn < enc.blocks(); ++sbn) {
+        const uint32_t syms = enc.symbols (sbn);
+        std::vector<uint32_t> esi;
+        for (uint32_t id = 0; id < syms; id += 4)
+            esi.push_back (id);
+        const uint32_t from = syms + first_repair (rnd);
+        for (uint32_t id = from; esi.size() < syms + 2; ++id)
+            esi.push_back (id);
+        for (const auto id : esi) {
+            if (enc.encode (sym.data(), sym.size(), id, sbn) != sym_size ||
+                                    plain.encode (reference.data(),
+                                        reference.size(), id, sbn) !=
+                                                                sym_size) {
+                std::cout << "Could not encode symbol " << id << "\n";
+                return false;
+            }
+            if (sym != reference) {
+                std::cout << "Wrong symbol " << id << " in block " <<
+                                            static_cast<uint32_t> (sbn) << "\n";
+                return false;
+            }
+            const auto err = dec.add_symbol (sym.data(), sym.size(), id, sbn);
+            if (err != RFC6330::Error::NONE &&
+                                        err != RFC6330::Error::NOT_NEEDED) {
+                std::cout << "Could not add symbol " << id << "\n";
+                return false;
+            }
+        }
+    }
+    auto res = dec.compute (RFC6330::Compute::COMPLETE);
+    dec.end_of_input (RFC6330::Fill_With_Zeros::NO);
+    if (res.get().first != RFC6330::Error::NONE) {
+        std::cout << "Couldn't decode.\n";
+        return false;
+    }
+    return check_rfc_output (dec, input);
+}
+
+int main (void)
+{
+    std::random_device rd;
+    std::mt19937_64 rnd (rd());
+
+    // 13 blocks: 11 of 60 symbols, 2 of 61 (K' = 62)
+    auto input = random_input (rnd, 50000);
+
+    if (!wide (rnd, input, 1) || !wide (rnd, input, 4))
+        return -1;
+    std::cout << "All tests passed\n";
+    return 0;
+}